@@ -176,6 +176,11 @@ public:
         addAndMakeVisible(m_externalClockCheckbox);
         m_externalClockCheckbox.onClick = [this]() { OnExternalClockCheckboxChanged(); };
 
+        m_losslessRecordingCheckbox.setButtonText("Lossless Recording");
+        m_losslessRecordingCheckbox.setSize(180, 30);
+        addAndMakeVisible(m_losslessRecordingCheckbox);
+        m_losslessRecordingCheckbox.onClick = [this]() { OnLosslessRecordingCheckboxChanged(); };
+
         addAndMakeVisible(m_audioInputRow);
         addAndMakeVisible(m_audioOutputRow);
 
@@ -186,6 +191,7 @@ public:
         RefreshAudioValues();
         RefreshStereoCheckbox();
         RefreshExternalClockCheckbox();
+        RefreshLosslessRecordingCheckbox();
 
         m_initialAudioInputDeviceName = GetSelectedAudioInputDeviceName();
         m_initialAudioOutputDeviceName = GetSelectedAudioOutputDeviceName();
@@ -212,6 +218,7 @@ public:
         auto stereoBounds = bounds.removeFromTop(40);
         m_stereoCheckbox.setBounds(stereoBounds.removeFromLeft(150).reduced(5));
         m_externalClockCheckbox.setBounds(stereoBounds.removeFromLeft(220).reduced(5));
+        m_losslessRecordingCheckbox.setBounds(stereoBounds.removeFromLeft(220).reduced(5));
 
         const int audioRowHeight = 30;
         const int audioRowWidth = 350;
@@ -575,6 +582,12 @@ public:
         m_nonagon->SetExternalClock(m_configuration->m_externalClock);
     }
 
+    void OnLosslessRecordingCheckboxChanged()
+    {
+        m_configuration->m_losslessRecording = m_losslessRecordingCheckbox.getToggleState();
+        m_nonagon->SetLosslessRecording(m_configuration->m_losslessRecording);
+    }
+
     void RefreshStereoCheckbox()
     {
         m_stereoCheckbox.setToggleState(m_configuration->m_stereo, juce::dontSendNotification);
@@ -587,6 +600,12 @@ public:
         m_externalClockCheckbox.setToggleState(m_configuration->m_externalClock, juce::dontSendNotification);
     }
 
+    void RefreshLosslessRecordingCheckbox()
+    {
+        m_configuration->m_losslessRecording = m_nonagon->IsLosslessRecording();
+        m_losslessRecordingCheckbox.setToggleState(m_configuration->m_losslessRecording, juce::dontSendNotification);
+    }
+
     NonagonWrapper* m_nonagon;
     ControllerSection m_sections[x_numControllers];
     juce::StringArray m_midiInputNames;
@@ -599,6 +618,7 @@ public:
     ConfigDropdownRow m_audioOutputRow;
     juce::ToggleButton m_stereoCheckbox;
     juce::ToggleButton m_externalClockCheckbox;
+    juce::ToggleButton m_losslessRecordingCheckbox;
     juce::String m_initialAudioInputDeviceName;
     juce::String m_initialAudioOutputDeviceName;
     Configuration* m_configuration;
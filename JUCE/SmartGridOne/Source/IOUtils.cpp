@@ -81,6 +81,19 @@ juce::File FileManager::GetLatestPatchFile(const juce::File& patchDir)
     return jsonFiles.getLast();
 }
 
+//==============================================================================
+juce::File FileManager::GetBinaryPatchFile(const juce::File& jsonFile)
+{
+    return jsonFile.withFileExtension(PatchBinary::x_extension);
+}
+
+//==============================================================================
+bool FileManager::HasCurrentBinaryPatchFile(const juce::File& jsonFile)
+{
+    juce::File binaryFile = GetBinaryPatchFile(jsonFile);
+    return binaryFile.existsAsFile() && jsonFile.getLastModificationTime() <= binaryFile.getLastModificationTime();
+}
+
 //==============================================================================
 juce::String FileManager::GenerateTimestampFilename()
 {
@@ -190,30 +203,24 @@ void FileManager::SavePatch(JSON json)
     juce::String filename = GenerateTimestampFilename();
     juce::File patchFile = patchDir.getChildFile(filename);
     
-    // Serialize JSON
+    // Stream the JSON straight to the file rather than dumping it to a string first.
     //
-    char* jsonStr = json.Dumps(JSON_ENCODE_ANY);
-    juce::String jsonString(jsonStr);
-    free(jsonStr);
-
-    juce::Logger::writeToLog("Saving patch: " + patchFile.getFullPathName() + " (" + std::to_string(jsonString.length()) + " bytes)");
-   
-    bool success = patchFile.replaceWithText(jsonString);
-    if (!success)
+    JsonDetail::FileSink sink(patchFile.getFullPathName().toUTF8().getAddress());
+    json.DumpTo(sink);
+    if (!sink.Close() || !patchFile.exists())
     {
         juce::Logger::writeToLog("ERROR: Failed to save patch file: " + patchFile.getFullPathName());
+        return;
     }
-    else
+
+    juce::Logger::writeToLog("Patch saved successfully: " + patchFile.getFullPathName() + " (" + juce::String(patchFile.getSize()) + " bytes)");
+
+    // The binary copy loads without parsing; the JSON stays the canonical, listed version.
+    //
+    juce::File binaryFile = GetBinaryPatchFile(patchFile);
+    if (!PatchBinary::WriteFile(binaryFile.getFullPathName().toUTF8().getAddress(), json))
     {
-        if (patchFile.exists())
-        {
-            int64_t fileSize = patchFile.getSize();
-            juce::Logger::writeToLog("Patch saved successfully. Size: " + juce::String(fileSize) + " bytes");
-        }
-        else
-        {
-            juce::Logger::writeToLog("WARNING: Patch file does not exist after save!");
-        }
+        juce::Logger::writeToLog("WARNING: Failed to save binary patch file: " + binaryFile.getFullPathName());
     }
 }
 
@@ -240,6 +247,19 @@ void FileManager::LoadPatch(juce::String patchName)
         return;
     }
 
+    if (HasCurrentBinaryPatchFile(latestFile))
+    {
+        juce::File binaryFile = GetBinaryPatchFile(latestFile);
+        juce::Logger::writeToLog("Loading binary patch: " + binaryFile.getFullPathName());
+        if (m_mainComponent->RequestLoadFile(binaryFile))
+        {
+            m_currentPatchName = patchName;
+            return;
+        }
+
+        juce::Logger::writeToLog("WARNING: Failed to load binary patch, falling back to JSON: " + binaryFile.getFullPathName());
+    }
+
     juce::String jsonString = latestFile.loadFileAsString();
     if (jsonString.isEmpty())
     {
@@ -275,6 +295,18 @@ void FileManager::LoadPatchVersion(juce::String versionFilePath)
         return;
     }
 
+    if (HasCurrentBinaryPatchFile(versionFile))
+    {
+        juce::File binaryFile = GetBinaryPatchFile(versionFile);
+        juce::Logger::writeToLog("Loading binary patch version: " + binaryFile.getFullPathName());
+        if (m_mainComponent->RequestReloadFile(binaryFile))
+        {
+            return;
+        }
+
+        juce::Logger::writeToLog("WARNING: Failed to load binary patch, falling back to JSON: " + binaryFile.getFullPathName());
+    }
+
     juce::String jsonString = versionFile.loadFileAsString();
     if (jsonString.isEmpty())
     {
@@ -40,6 +40,11 @@ struct FileManager
     //
     static juce::File GetLatestPatchFile(const juce::File& patchDir);
     
+    // The binary copy (.sgpatch) saved next to a patch JSON file, and whether it is at least as new
+    //
+    static juce::File GetBinaryPatchFile(const juce::File& jsonFile);
+    static bool HasCurrentBinaryPatchFile(const juce::File& jsonFile);
+
     // Generate a timestamp filename for saving
     //
     static juce::String GenerateTimestampFilename();
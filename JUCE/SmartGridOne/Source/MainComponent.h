@@ -90,6 +90,7 @@ public:
         JSON nonagonConfig = m_nonagon.ConfigToJSON(arena);
         nonagonConfig.SetNew("stereo", arena.Boolean(m_configuration.m_stereo));
         ClockModeConfigJSON::WriteExternalClock(nonagonConfig, arena, m_configuration.m_externalClock);
+        nonagonConfig.SetNew("lossless_recording", arena.Boolean(m_configuration.m_losslessRecording));
         nonagonConfig.SetNew("audio_input_device", arena.String(m_configuration.m_audioInputDeviceName.toUTF8().getAddress()));
         nonagonConfig.SetNew("audio_output_device", arena.String(m_configuration.m_audioOutputDeviceName.toUTF8().getAddress()));
         config.SetNew("nonagon_config", nonagonConfig);
@@ -117,6 +118,12 @@ public:
 
                 m_configuration.m_externalClock = ClockModeConfigJSON::ReadExternalClock(nonagonConfig, false);
 
+                JSON losslessRecordingJ = nonagonConfig.Get("lossless_recording");
+                if (!losslessRecordingJ.IsNull())
+                {
+                    m_configuration.m_losslessRecording = losslessRecordingJ.BooleanValue();
+                }
+
                 JSON audioInputDeviceJ = nonagonConfig.Get("audio_input_device");
                 const char* audioInputDeviceName = audioInputDeviceJ.StringValue();
                 if (audioInputDeviceName)
@@ -133,6 +140,7 @@ public:
 
                 m_nonagon.ConfigFromJSON(nonagonConfig);
                 m_nonagon.SetExternalClock(m_configuration.m_externalClock);
+                m_nonagon.SetLosslessRecording(m_configuration.m_losslessRecording);
             }
 
             JSON fileConfig = config.Get("file_config");
@@ -194,6 +202,31 @@ public:
         return stateInterchange->RequestLoad(patch, restoreFaders);
     }
 
+    // Same as RequestLoad, from a patch file: a binary patch is decoded from its mapping without parsing,
+    // anything else is parsed as JSON.
+    //
+    bool RequestLoadFile(const juce::File& patchFile)
+    {
+        return RequestLoadFile(patchFile, m_nonagon.ShouldRestoreFadersForPatchLoad(false));
+    }
+
+    bool RequestReloadFile(const juce::File& patchFile)
+    {
+        return RequestLoadFile(patchFile, false);
+    }
+
+    bool RequestLoadFile(const juce::File& patchFile, bool restoreFaders)
+    {
+        StateInterchange* stateInterchange = m_nonagon.GetStateInterchange();
+        JSON patch = stateInterchange->LoadFileForLoad(patchFile.getFullPathName().toUTF8().getAddress());
+        if (patch.IsNull())
+        {
+            return false;
+        }
+
+        return stateInterchange->RequestLoad(patch, restoreFaders);
+    }
+
     //==============================================================================
     void paint (juce::Graphics&) override;
     void resized() override;
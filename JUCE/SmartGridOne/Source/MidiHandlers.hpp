@@ -186,4 +186,13 @@ struct MidiOutputHandler
             m_midiOutput->sendMessageNow(message);
         }
     }
+
+    void SendMessages(const juce::MidiBuffer& buffer)
+    {
+        AutoLockSpin lock(m_mutex);
+        if (m_midiOutput.get())
+        {
+            m_midiOutput->sendBlockOfMessagesNow(buffer);
+        }
+    }
 };
@@ -3,20 +3,36 @@
 #include <JuceHeader.h>
 #include "SmartGridInclude.hpp"
 #include "MidiHandlers.hpp"
+#include "MidiSendScheduler.hpp"
+#include "MidiOutputBudget.hpp"
 #include "ThreadId.hpp"
 
 struct MidiSender : public juce::Thread
 {
-    static constexpr size_t x_maxRoutes = 16;
-    CircularQueue<SmartGrid::BasicMidi, 16384> m_queue;
+    static constexpr size_t x_maxRoutes = SmartGrid::MidiSendScheduler::x_maxRoutes;
+    static constexpr double x_latencyMs = 10;
+
+    // With nothing due the thread still wakes this often to check threadShouldExit.
+    //
+    static constexpr size_t x_idleWaitUs = 100000;
+
+    // SendMessage may be called from any thread; the scheduler's queue is multi-producer.
+    //
+    SmartGrid::MidiSendScheduler m_scheduler;
+
+    // Per-route output bandwidth.  What goes through the scheduler (clock, encoder indicators) is charged as
+    // realtime; LED colour writers spend only what is left.
+    //
+    SmartGrid::MidiOutputBudget m_budget;
     MidiOutputHandler* m_outputHandlers[x_maxRoutes];
+    juce::MidiBuffer m_burst;
     int m_clockRouteId;
-    static constexpr double x_latencyMs = 10;
 
     std::atomic<bool> m_shutdown;
 
     MidiSender()
         : juce::Thread("MidiSender")
+        , m_scheduler(static_cast<size_t>(x_latencyMs * 1000))
         , m_shutdown(false)
     {
         for (size_t i = 0; i < x_maxRoutes; i++)
@@ -25,7 +41,8 @@ struct MidiSender : public juce::Thread
         }
 
         m_clockRouteId = -1;
-        
+        m_burst.ensureSize(SmartGrid::MidiSendScheduler::x_maxBurst * 8);
+
         // Configure real-time options for tight MIDI timing
         //
         juce::Thread::RealtimeOptions realTimeOptions;
@@ -33,25 +50,43 @@ struct MidiSender : public juce::Thread
                                       .withPeriodMs(0.1)
                                       .withProcessingTimeMs(0.05);
         startRealtimeThread(realTimeOptions);
-        
+
         INFO("MidiSenderThread started with real-time scheduling");
     }
 
     ~MidiSender()
     {
+        signalThreadShouldExit();
+        m_scheduler.Wake();
         stopThread(1000);
     }
 
+    static size_t NowUs()
+    {
+        return static_cast<size_t>(juce::Time::getMillisecondCounterHiRes() * 1000.0);
+    }
+
+    // Sends whatever is due, then sleeps until the next message is due or a new one is pushed.
+    //
     void run() override
     {
         SetCurrentThreadId(ThreadId::MidiSender);
 
         while (!threadShouldExit())
         {
-            HandleMessage();
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            if (m_shutdown.load())
+            {
+                m_scheduler.Clear();
+            }
+            else
+            {
+                m_scheduler.Dispatch(NowUs(), this);
+            }
+
+            size_t nowUs = NowUs();
+            m_scheduler.WaitUntil(nowUs, std::min(m_scheduler.NextDueUs(), nowUs + x_idleWaitUs));
         }
-        
+
         INFO("MidiSenderThread stopped");
     }
 
@@ -73,61 +108,48 @@ struct MidiSender : public juce::Thread
     void SendMessage(SmartGrid::BasicMidi msg, int routeId)
     {
         msg.m_routeId = routeId;
-        m_queue.Push(msg);
+        m_scheduler.Push(msg);
+    }
+
+    MPSCQueue<SmartGrid::BasicMidi, 16384>::Metrics GetQueueMetrics() const
+    {
+        return m_scheduler.m_queue.GetMetrics();
+    }
+
+    // Achieved-vs-scheduled send jitter, message and burst counts.
+    //
+    const SmartGrid::MidiSendScheduler::Metrics& GetSendMetrics() const
+    {
+        return m_scheduler.m_metrics;
     }
 
     void Shutdown()
     {
         m_shutdown.store(true);
+        m_scheduler.Wake();
     }
 
-    void HandleMessage()
+    // Called by the scheduler with all of one route's due messages, which go out in a single block.
+    //
+    void SendBurst(int routeId, const SmartGrid::BasicMidi* msgs, size_t count)
     {
-        SmartGrid::BasicMidi msg;
-        
-        // Peek at the next message without removing it
-        //
-        if (!m_queue.Peek(msg))
+        MidiOutputHandler* handler = m_outputHandlers[routeId];
+        if (!handler)
         {
             return;
         }
 
-        if (m_shutdown.load())
-        {
-            m_queue.Pop(msg);
-            return;
-        }
-        
-        // Get current time in milliseconds using JUCE wall clock
-        //
-        double currentTimeMs = juce::Time::getMillisecondCounterHiRes();
-        
-        if (msg.m_timestamp == 0)
-        {
-            // Send immediately
-            //
-            m_queue.Pop(msg);
-            juce::MidiMessage message(msg.m_msg, msg.Size());
-            m_outputHandlers[msg.m_routeId]->SendMessage(message);
-        }
-        else
+        m_burst.clear();
+        size_t bytes = 0;
+        for (size_t i = 0; i < count; ++i)
         {
-            // Convert timestamp from microseconds to milliseconds
-            //
-            double msgTimestampMs = static_cast<double>(msg.m_timestamp) / 1000.0;
-            
-            // Wait until it's time to send (with small latency buffer)
-            //
-            double targetTimeMs = msgTimestampMs + x_latencyMs;
-            if (currentTimeMs >= targetTimeMs)
-            {
-                // Time to send
-                //
-                m_queue.Pop(msg);
-                juce::MidiMessage message(msg.m_msg, msg.Size());
-                m_outputHandlers[msg.m_routeId]->SendMessage(message);
-            }
+            SmartGrid::BasicMidi msg = msgs[i];
+            m_burst.addEvent(msg.m_msg, static_cast<int>(msg.Size()), static_cast<int>(i));
+            bytes += msg.Size();
         }
+
+        handler->SendMessages(m_burst);
+        m_budget.Spend(routeId, bytes, NowUs(), SmartGrid::MidiOutputBudget::Priority::Realtime);
     }
 
     void ProcessMessagesOut(SmartGrid::MessageOutBuffer& buffer, size_t timestamp)
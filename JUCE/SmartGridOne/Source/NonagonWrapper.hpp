@@ -35,15 +35,18 @@ struct NonagonWrapperQuadLaunchpadTwister
     struct MidiLaunchpadOutputHandler : ::MidiOutputHandler
     {
         SmartGrid::LPSysexWriter m_sysexWriter;
+        SmartGrid::MidiOutputBudget* m_budget;
 
         MidiLaunchpadOutputHandler()
+            : m_budget(nullptr)
         {
         }
 
-        void Init(SmartGrid::ControllerShape shape, SmartGrid::SmartBusColor* colorBus)
+        void Init(SmartGrid::ControllerShape shape, SmartGrid::SmartBusColor* colorBus, SmartGrid::MidiOutputBudget* budget)
         {
             m_shape = shape;
             m_sysexWriter = SmartGrid::LPSysexWriter(shape, colorBus);
+            m_budget = budget;
         }
 
         void Open(SmartGrid::ControllerShape shape, const juce::String &deviceIdentifier)
@@ -63,11 +66,23 @@ struct NonagonWrapperQuadLaunchpadTwister
         {
             if (m_midiOutput.get())
             {
+                // Colour is bulk traffic: send only as many pads as the route's budget allows, and leave the
+                // rest pending in the writer, which coalesces them to the latest colour.
+                //
+                size_t nowUs = MidiSender::NowUs();
+                size_t maxPads = SmartGrid::LPSysexWriter::PadsForBytes(m_budget->Available(m_routeId, nowUs));
+
                 uint8_t buffer[SmartGrid::LPSysexWriter::x_maxMessageSize];
-                size_t size = m_sysexWriter.Write(buffer);
+                size_t size = m_sysexWriter.Write(buffer, maxPads);
                 if (size > 0)
                 {
                     m_midiOutput->sendMessageNow(juce::MidiMessage(buffer, static_cast<int>(size)));
+                    m_budget->Spend(m_routeId, size, nowUs, SmartGrid::MidiOutputBudget::Priority::Bulk);
+                }
+
+                if (m_sysexWriter.HasPending())
+                {
+                    m_budget->Defer(m_routeId);
                 }
             }
         }
@@ -76,16 +91,19 @@ struct NonagonWrapperQuadLaunchpadTwister
     struct MidiEncoderOutputHandler : MidiOutputHandler
     {
         SmartGrid::EncoderMidiWriter m_midiWriter;
+        SmartGrid::MidiOutputBudget* m_budget;
 
         MidiEncoderOutputHandler()
             : m_midiWriter(nullptr)
+            , m_budget(nullptr)
         {
             m_shape = SmartGrid::ControllerShape::MidiFighterTwister;
         }
 
-        void Init(EncoderBankUIState* encoderBankState)
+        void Init(EncoderBankUIState* encoderBankState, SmartGrid::MidiOutputBudget* budget)
         {
             m_midiWriter = SmartGrid::EncoderMidiWriter(encoderBankState);
+            m_budget = budget;
         }
 
         void Reset() override
@@ -97,11 +115,18 @@ struct NonagonWrapperQuadLaunchpadTwister
         {
             if (m_midiOutput.get())
             {
+                // Encoder feedback is timing critical, so it always goes out and is charged as realtime.
+                //
+                m_midiWriter.ProcessCoolDown();
+                size_t bytes = 0;
                 for (SmartGrid::BasicMidi msg : m_midiWriter)
                 {
                     juce::MidiMessage message(msg.m_msg, 3);
                     m_midiOutput->sendMessageNow(message);
+                    bytes += 3;
                 }
+
+                m_budget->Spend(m_routeId, bytes, MidiSender::NowUs(), SmartGrid::MidiOutputBudget::Priority::Realtime);
             }
         }
     };
@@ -118,10 +143,10 @@ struct NonagonWrapperQuadLaunchpadTwister
 
         for (int i = 0; i < TheNonagonSquiggleBoyQuadLaunchpadTwister::x_numLaunchpads; ++i)
         {
-            m_midiLaunchpadOutputHandler[i].Init(SmartGrid::ControllerShape::LaunchPadX, &m_nonagon.m_uiState.m_colorBus[i]);
+            m_midiLaunchpadOutputHandler[i].Init(SmartGrid::ControllerShape::LaunchPadX, &m_nonagon.m_uiState.m_colorBus[i], &m_midiSender->m_budget);
         }
 
-        m_midiEncoderOutputHandler.Init(&internal->m_uiState.m_squiggleBoyUIState.m_encoderBankUIState);
+        m_midiEncoderOutputHandler.Init(&internal->m_uiState.m_squiggleBoyUIState.m_encoderBankUIState, &m_midiSender->m_budget);
 
         m_midiSender->AllocateRoute(&m_midiLaunchpadOutputHandler[0]);
         m_midiSender->AllocateRoute(&m_midiLaunchpadOutputHandler[1]);
@@ -179,12 +204,11 @@ struct NonagonWrapperQuadLaunchpadTwister
 
     void SendMidiOutput()
     {
+        m_midiEncoderOutputHandler.Process();
         for (int i = 0; i < TheNonagonSquiggleBoyQuadLaunchpadTwister::x_numLaunchpads; ++i)
         {
             m_midiLaunchpadOutputHandler[i].Process();
         }
-
-        m_midiEncoderOutputHandler.Process();
     }
 
     JSON ConfigToJSON(JsonArena& a)
@@ -270,6 +294,8 @@ struct NonagonWrapperWrldBldr
         SmartGrid::WrldBLDRMidiWriter m_midiWriter;
         MidiSender* m_midiSender;
 
+        static constexpr size_t x_maxMessagesPerFrame = 256;
+
         MidiOutputHandler(TheNonagonSquiggleBoyWrldBldr* owner, MidiSender* midiSender)
             : ::MidiOutputHandler()
             , m_owner(owner)
@@ -282,19 +308,12 @@ struct NonagonWrapperWrldBldr
         {
             if (m_midiOutput.get())
             {
-                size_t budget = 256;
+                size_t nowUs = MidiSender::NowUs();
                 m_midiWriter.ProcessCoolDown();
-                for (size_t i = 0; i < SmartGrid::WrldBLDRMidiWriter::x_numColorWriters; ++i)
-                {
-                    SmartGrid::YaeltexColorSysexBuffer buffer;
-                    m_midiWriter.Write(buffer, budget, i);
-                    if (buffer.HasAny())
-                    {
-                        juce::MidiMessage message(buffer.m_buffer, buffer.m_size);
-                        m_midiOutput->sendMessageNow(message);
-                    }
-                }
 
+                // Indicators go first; MidiSender charges them to the route as realtime when it sends them.
+                //
+                size_t budget = x_maxMessagesPerFrame;
                 for (auto itr = m_midiWriter.m_indicatorWriter.begin(); !itr.Done(); ++itr)
                 {
                     if (budget == 0)
@@ -306,6 +325,22 @@ struct NonagonWrapperWrldBldr
                     m_midiSender->SendMessage(msg, m_routeId);
                     --budget;
                 }
+
+                // Colours get what the route's byte budget has left, four bytes per pad.
+                //
+                SmartGrid::MidiOutputBudget& byteBudget = m_midiSender->m_budget;
+                budget = std::min(x_maxMessagesPerFrame, byteBudget.Available(m_routeId, nowUs) / 4);
+                for (size_t i = 0; i < SmartGrid::WrldBLDRMidiWriter::x_numColorWriters; ++i)
+                {
+                    SmartGrid::YaeltexColorSysexBuffer buffer;
+                    m_midiWriter.Write(buffer, budget, i);
+                    if (buffer.HasAny())
+                    {
+                        juce::MidiMessage message(buffer.m_buffer, buffer.m_size);
+                        m_midiOutput->sendMessageNow(message);
+                        byteBudget.Spend(m_routeId, buffer.m_size, nowUs, SmartGrid::MidiOutputBudget::Priority::Bulk);
+                    }
+                }
             }
         }
 
@@ -583,6 +618,16 @@ struct NonagonWrapper
         return m_internal.IsExternalClock();
     }
 
+    void SetLosslessRecording(bool lossless)
+    {
+        m_internal.SetLosslessRecording(lossless);
+    }
+
+    bool IsLosslessRecording() const
+    {
+        return m_internal.IsLosslessRecording();
+    }
+
     bool IsWrldBldrOpen()
     {
         return m_wrldBldr.IsOpen();
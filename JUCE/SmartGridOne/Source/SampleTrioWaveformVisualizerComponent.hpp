@@ -110,6 +110,22 @@ struct SampleTrioWaveformVisualizerComponent : public SmartGridOneMainVisualizer
                 g.fillRect(x, yTop, segmentWidth + 0.5f, yBot - yTop);
             }
 
+            // A bank still loading on the IO worker pool shows how many of its files are ready; the rest read
+            // as empty until then.
+            //
+            if (snapshot.m_numLoaded < snapshot.m_numBuffers)
+            {
+                float fraction = static_cast<float>(snapshot.m_numLoaded) / static_cast<float>(snapshot.m_numBuffers);
+                g.setColour(voiceColour);
+                g.fillRect(bounds.getX(), sliceY + sliceHeight - 3.0f, fraction * width, 3.0f);
+                g.setColour(juce::Colours::white);
+                g.setFont(juce::FontOptions(12.0f));
+                g.drawText(
+                    "loading " + juce::String(static_cast<int>(snapshot.m_numLoaded)) + "/" + juce::String(static_cast<int>(snapshot.m_numBuffers)),
+                    juce::Rectangle<float>(bounds.getX() + 4.0f, sliceY + 2.0f, width - 8.0f, 14.0f),
+                    juce::Justification::topRight);
+            }
+
             if (machine == VoiceMachine::SourceMachine::Sample)
             {
                 double pos =
@@ -5,64 +5,209 @@
 #include <chrono>
 #include <cstdarg>
 #include <cstdio>
+#include <cstdint>
+#include <cstring>
 #include <ctime>
 #include <filesystem>
 #include <fstream>
+#include <limits>
 #include <string>
+#include <tuple>
+#include <type_traits>
 
 #include "CircularQueue.hpp"
 #include "SampleTimer.hpp"
 #include "ThreadId.hpp"
 
+// Arguments of one INFO call, packed into a LogMessage by the logging thread and formatted by the drain.
+//
+// Each argument is stored as its raw bytes, so it must be trivially copyable.  String arguments (char
+// pointers) are the exception: the pointer may not outlive the call, so the characters are copied, truncated
+// to an equal share of the space the other arguments leave.
+//
+template<typename... Args>
+struct LogArgs
+{
+    template<typename T>
+    static constexpr bool IsString()
+    {
+        return std::is_same_v<std::decay_t<T>, const char*> || std::is_same_v<std::decay_t<T>, char*>;
+    }
+
+    template<typename T>
+    using Stored = std::conditional_t<IsString<T>(), const char*, std::decay_t<T>>;
+
+    static constexpr size_t x_numStrings = (size_t(0) + ... + (IsString<Args>() ? 1 : 0));
+    static constexpr size_t x_fixedBytes = (size_t(0) + ... + (IsString<Args>() ? 0 : sizeof(Stored<Args>)));
+
+    static_assert((... && std::is_trivially_copyable_v<Stored<Args>>), "INFO arguments must be trivially copyable");
+    template<size_t Capacity>
+    static constexpr size_t StringBytes()
+    {
+        return x_numStrings == 0 ? 0 : (Capacity - x_fixedBytes) / x_numStrings;
+    }
+
+    template<size_t Capacity, typename T>
+    static void Encode(unsigned char*& cursor, const T& arg)
+    {
+        if constexpr (IsString<T>())
+        {
+            const char* str = static_cast<const char*>(arg);
+            if (!str)
+            {
+                str = "(null)";
+            }
+
+            size_t length = strnlen(str, StringBytes<Capacity>() - 1);
+            std::memcpy(cursor, str, length);
+            cursor[length] = '\0';
+            cursor += length + 1;
+        }
+        else
+        {
+            std::memcpy(cursor, &arg, sizeof(T));
+            cursor += sizeof(T);
+        }
+    }
+
+    template<typename T>
+    static Stored<T> Decode(const unsigned char*& cursor)
+    {
+        if constexpr (IsString<T>())
+        {
+            const char* str = reinterpret_cast<const char*>(cursor);
+            cursor += strlen(str) + 1;
+            return str;
+        }
+        else
+        {
+            Stored<T> value;
+            std::memcpy(&value, cursor, sizeof(value));
+            cursor += sizeof(value);
+            return value;
+        }
+    }
+
+    template<size_t Capacity>
+    static void Pack(unsigned char* buffer, const Args&... args)
+    {
+        static_assert(x_fixedBytes + 2 * x_numStrings <= Capacity, "INFO arguments do not fit in a LogMessage");
+        unsigned char* cursor = buffer;
+        (Encode<Capacity>(cursor, args), ...);
+    }
+
+    // Drain thread.  Braced initialization decodes the arguments in order.
+    //
+    static int Format(const char* format, const unsigned char* buffer, char* out, size_t capacity)
+    {
+        const unsigned char* cursor = buffer;
+        std::tuple<Stored<Args>...> values{Decode<Args>(cursor)...};
+        (void)cursor;
+        return std::apply([&](const auto&... value)
+        {
+            return snprintf(out, capacity, format, value...);
+        }, values);
+    }
+};
+
+// A message with no arguments is printed as is, like "%s".
+//
+template<>
+struct LogArgs<>
+{
+    template<size_t Capacity>
+    static void Pack(unsigned char*)
+    {
+    }
+
+    static int Format(const char* format, const unsigned char*, char* out, size_t capacity)
+    {
+        return snprintf(out, capacity, "%s", format);
+    }
+};
+
+// One queued INFO call.  Only the format pointer and the packed argument bytes are stored on the calling
+// thread, so logging from the audio thread is a few copies; snprintf runs on the drain thread.  The format
+// must therefore be a string literal, which the INFO macro enforces.
+//
 struct LogMessage
 {
     static constexpr size_t x_maxMessageLength = 256;
-    char m_message[x_maxMessageLength];
-    size_t m_length;
+    static constexpr size_t x_maxArgBytes = 256;
+
+    using FormatFn = int (*)(const char* format, const unsigned char* args, char* out, size_t capacity);
+
+    const char* m_format;
+    FormatFn m_formatFn;
+    unsigned char m_args[x_maxArgBytes];
+    size_t m_suppressed;
     size_t m_sample;
     ThreadId m_threadId;
 
     LogMessage()
-        : m_message{}
-        , m_length(0)
+        : m_format(nullptr)
+        , m_formatFn(nullptr)
+        , m_args{}
+        , m_suppressed(0)
         , m_sample(0)
         , m_threadId(ThreadId::Unknown)
     {
     }
 
-    void Clear()
+    template<typename... Args>
+    void Fill(ThreadId threadId, size_t suppressed, const char* format, const Args&... args)
     {
-        m_length = 0;
-        m_message[0] = '\0';
+        m_format = format;
+        m_formatFn = &LogArgs<Args...>::Format;
+        LogArgs<Args...>::template Pack<x_maxArgBytes>(m_args, args...);
+        m_suppressed = suppressed;
+        m_sample = SampleTimer::GetSample();
+        m_threadId = threadId;
     }
 
-    template<typename... Args>
-    void Fill(ThreadId threadId, const char* format, Args... args)
+    // Drain thread.  Writes the formatted message into out, truncated to x_maxMessageLength.
+    //
+    void Format(char* out) const
     {
-        Clear();
-        m_length = snprintf(m_message, x_maxMessageLength, format, args...);
-        if (m_length >= x_maxMessageLength)
+        int length = m_formatFn ? m_formatFn(m_format, m_args, out, x_maxMessageLength) : -1;
+        if (length < 0)
         {
-            m_length = x_maxMessageLength - 1;
-            m_message[x_maxMessageLength - 1] = '\0';
+            out[0] = '\0';
         }
+    }
+};
 
-        m_sample = SampleTimer::GetSample();
-        m_threadId = threadId;
+// Per-call-site limit for INFO_RATE_LIMITED: at most one message per interval of the steady clock, which keeps
+// running while the audio clock is stopped (SampleTimer only advances inside the audio callback).  Messages dropped
+// in between are counted and reported with the next one.
+//
+struct LogRateLimit
+{
+    static constexpr std::chrono::steady_clock::duration x_defaultInterval = std::chrono::seconds(1);
+
+    std::atomic<int64_t> m_nextTicks;
+    std::atomic<size_t> m_suppressed;
+
+    LogRateLimit()
+        : m_nextTicks(std::numeric_limits<int64_t>::min())
+        , m_suppressed(0)
+    {
     }
 
-    void Fill(ThreadId threadId, const char* message)
+    // Returns true if this call may log, with the number of calls suppressed since the last one.
+    //
+    bool Allow(std::chrono::steady_clock::duration interval, size_t* suppressed)
     {
-        Clear();
-        m_length = snprintf(m_message, x_maxMessageLength, "%s", message);
-        if (m_length >= x_maxMessageLength)
+        int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+        int64_t next = m_nextTicks.load(std::memory_order_relaxed);
+        if (now < next || !m_nextTicks.compare_exchange_strong(next, now + interval.count(), std::memory_order_relaxed))
         {
-            m_length = x_maxMessageLength - 1;
-            m_message[x_maxMessageLength - 1] = '\0';
+            m_suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
         }
 
-        m_sample = SampleTimer::GetSample();
-        m_threadId = threadId;
+        *suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
     }
 };
 
@@ -92,7 +237,13 @@ struct AsyncLogQueue
     }
 
     template<typename... Args>
-    void Log(const char* format, Args... args)
+    void Log(const char* format, const Args&... args)
+    {
+        LogSuppressed(0, format, args...);
+    }
+
+    template<typename... Args>
+    void LogSuppressed(size_t suppressed, const char* format, const Args&... args)
     {
         ThreadId threadId = GetCurrentThreadId();
         size_t queueIndex = ThreadIdToIndex(threadId);
@@ -103,7 +254,7 @@ struct AsyncLogQueue
             return;
         }
 
-        message->Fill(threadId, format, args...);
+        message->Fill(threadId, suppressed, format, args...);
         m_queues[queueIndex].CompletePush();
     }
 
@@ -161,17 +312,27 @@ struct AsyncLogQueue
         localtime_r(&t, &localTm);
 #endif
 
-        char line[LogMessage::x_maxMessageLength + 96];
+        char text[LogMessage::x_maxMessageLength];
+        message->Format(text);
+
+        char suppressed[48] = "";
+        if (message->m_suppressed > 0)
+        {
+            snprintf(suppressed, sizeof(suppressed), " (%zu similar suppressed)", message->m_suppressed);
+        }
+
+        char line[LogMessage::x_maxMessageLength + 144];
         snprintf(
             line,
             sizeof(line),
-            "%02d:%02d:%02d %lu %s %s",
+            "%02d:%02d:%02d %lu %s %s%s",
             localTm.tm_hour,
             localTm.tm_min,
             localTm.tm_sec,
             message->m_sample,
             ThreadIdToString(threadId),
-            message->m_message);
+            text,
+            suppressed);
         return WriteLine(line);
     }
 
@@ -314,4 +475,19 @@ struct AsyncLogQueue
 
 inline AsyncLogQueue AsyncLogQueue::s_instance;
 
-#define INFO(...) AsyncLogQueue::s_instance.Log(__VA_ARGS__)
+// The format must be a string literal: it is read on the drain thread, after the call returns.
+//
+#define INFO(format, ...) AsyncLogQueue::s_instance.Log("" format, ##__VA_ARGS__)
+
+// For messages that can fire every sample or every block: logs at most once a second per call site.
+//
+#define INFO_RATE_LIMITED(format, ...) \
+    do \
+    { \
+        static LogRateLimit s_logRateLimit; \
+        size_t logSuppressed = 0; \
+        if (s_logRateLimit.Allow(LogRateLimit::x_defaultInterval, &logSuppressed)) \
+        { \
+            AsyncLogQueue::s_instance.LogSuppressed(logSuppressed, "" format, ##__VA_ARGS__); \
+        } \
+    } while (0)
@@ -1,17 +1,23 @@
 #pragma once
 
+#include "AudioBufferPageCache.hpp"
 #include "BufferResampler.hpp"
 #include "SampleTimer.hpp"
 #include "SnapshotUIState.hpp"
 #include "WavReader.hpp"
+#include "WorkerPool.hpp"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cctype>
 #include <cmath>
 #include <cstring>
+#include <cstdint>
 #include <dirent.h>
+#include <filesystem>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <sys/stat.h>
 #include <unordered_map>
@@ -21,10 +27,18 @@ struct AudioBuffer
 {
     static constexpr size_t x_numSections = 1024;
 
+    // Files at the host rate with at least this many frames are streamed from the file through an
+    // AudioBufferPageCache instead of being decoded up front (about 22 seconds at 48kHz).
+    //
+    static constexpr size_t x_streamMinFrames = size_t(1) << 20;
+    static_assert(x_numSections == AudioBufferPageCache::x_numSections, "overview section counts must match");
+
     struct UISnapshot
     {
         std::array<float, x_numSections> m_sectionMaximums{};
         std::array<float, x_numSections> m_sectionMinimums{};
+        size_t m_numLoaded = 0;
+        size_t m_numBuffers = 0;
     };
 
     struct UIState : SnapshotUIState<UISnapshot>
@@ -32,16 +46,50 @@ struct AudioBuffer
     };
 
     std::vector<float> m_buffer;
+    std::shared_ptr<AudioBufferPageCache> m_pages;
     std::string m_fileName;
     std::array<float, x_numSections> m_sectionMaximums{};
     std::array<float, x_numSections> m_sectionMinimums{};
 
+    // False while a worker is loading the buffer in the background.  Until it is set, with release after the
+    // load, the buffer reads as empty.
+    //
+    std::atomic<bool> m_loaded{true};
+
+    bool IsLoaded() const
+    {
+        return m_loaded.load(std::memory_order_acquire);
+    }
+
+    bool IsStreamed() const
+    {
+        return IsLoaded() && m_pages;
+    }
+
+    static bool RateMatches(uint32_t sampleRate)
+    {
+        const double hostRate = static_cast<double>(SampleTimer::x_sampleRate);
+        return BufferResampler::x_rateMatchEpsilon > std::abs(static_cast<double>(sampleRate) - hostRate) / hostRate;
+    }
+
+    // True if LoadFromFile would stream the file rather than decode it.  Reads only the file's header.
+    //
+    static bool WouldStream(const char* fileName, size_t streamMinFrames = x_streamMinFrames)
+    {
+        WavReader wavReader;
+        return wavReader.LoadFromFile(fileName) && RateMatches(wavReader.m_sampleRate) && streamMinFrames <= wavReader.m_numFrames;
+    }
+
     // Loads a WAV file; stereo (or more) sums channels 0 and 1 into mono floats.
     // Unsupported format leaves the buffer empty.
     //
-    void LoadFromFile(const char* fileName)
+    // A long file at the host rate is not decoded here: its first pages are, and the rest streams in through
+    // the pager, so the buffer is playable as soon as this returns.  Files needing resampling always decode.
+    //
+    void LoadFromFile(const char* fileName, size_t streamMinFrames = x_streamMinFrames)
     {
         m_buffer.clear();
+        m_pages.reset();
 
         WavReader wavReader;
         if (!wavReader.LoadFromFile(fileName))
@@ -49,14 +97,23 @@ struct AudioBuffer
             return;
         }
 
-        wavReader.WriteLeftRightSum(m_buffer);
-
         const double fileRate = static_cast<double>(wavReader.m_sampleRate);
         const double hostRate = static_cast<double>(SampleTimer::x_sampleRate);
+        const bool rateMatches = RateMatches(wavReader.m_sampleRate);
+        if (rateMatches && streamMinFrames <= wavReader.m_numFrames)
+        {
+            ClearSectionExtrema();
+            m_pages = std::make_shared<AudioBufferPageCache>();
+            m_pages->Init(std::move(wavReader));
+            AudioBufferPager::s_instance.Register(m_pages);
+            return;
+        }
+
+        wavReader.WriteLeftRightSum(m_buffer);
+
         if (0.0 < fileRate)
         {
-            const double rel = std::abs(fileRate - hostRate) / hostRate;
-            if (BufferResampler::x_rateMatchEpsilon <= rel)
+            if (!rateMatches)
             {
                 const size_t inFrames = m_buffer.size();
                 const size_t outFrames = BufferResampler::OutputFrameCount(inFrames, fileRate, hostRate);
@@ -94,24 +151,80 @@ struct AudioBuffer
         ComputeSectionExtrema();
     }
 
+    size_t NumFrames() const
+    {
+        if (!IsLoaded())
+        {
+            return 0;
+        }
+
+        return m_pages ? m_pages->m_numFrames : m_buffer.size();
+    }
+
+    // Decoded memory held by the buffer: the samples, or a streamed buffer's page slots.
+    //
+    size_t MemoryBytes() const
+    {
+        if (!IsLoaded())
+        {
+            return 0;
+        }
+
+        return m_pages
+            ? AudioBufferPageCache::x_numSlots * sizeof(AudioBufferPageCache::Slot)
+            : m_buffer.capacity() * sizeof(float);
+    }
+
+    // A streamed buffer's overview fills in on the pager thread; sections it has not published yet read as zero.
+    //
+    void CopySectionExtrema(std::array<float, x_numSections>& maximums, std::array<float, x_numSections>& minimums) const
+    {
+        if (!IsLoaded())
+        {
+            maximums.fill(0.0f);
+            minimums.fill(0.0f);
+        }
+        else if (m_pages)
+        {
+            m_pages->CopyExtrema(maximums, minimums);
+        }
+        else
+        {
+            maximums = m_sectionMaximums;
+            minimums = m_sectionMinimums;
+        }
+    }
+
     void PopulateUIState(UIState* uiState)
     {
         UISnapshot& snapshot = uiState->BeginSnapshot();
 
-        if (m_buffer.empty())
+        if (NumFrames() == 0)
         {
             snapshot.m_sectionMaximums.fill(0.0f);
             snapshot.m_sectionMinimums.fill(0.0f);
         }
         else
         {
-            snapshot.m_sectionMaximums = m_sectionMaximums;
-            snapshot.m_sectionMinimums = m_sectionMinimums;
+            CopySectionExtrema(snapshot.m_sectionMaximums, snapshot.m_sectionMinimums);
         }
 
+        snapshot.m_numLoaded = IsLoaded() ? 1 : 0;
+        snapshot.m_numBuffers = 1;
         uiState->CommitSnapshot();
     }
 
+    // Audio thread.  Tells a streamed buffer where playback is (normalized, as for Get) so the pages ahead of
+    // it are decoded before they are read.  No-op for a decoded buffer.
+    //
+    void Prefetch(double t, double loopStart) const
+    {
+        if (IsLoaded() && m_pages)
+        {
+            m_pages->SetPlayHead(static_cast<size_t>(GetRealTime(t)), static_cast<size_t>(GetRealTime(loopStart)));
+        }
+    }
+
     void ClearSectionExtrema()
     {
         m_sectionMaximums.fill(0.0f);
@@ -162,7 +275,7 @@ struct AudioBuffer
     //
     double GetRealTime(double t) const
     {
-        size_t n = m_buffer.size();
+        size_t n = NumFrames();
         if (n == 0)
         {
             return 0.0;
@@ -175,6 +288,16 @@ struct AudioBuffer
     //
     float ReadRealTime(double realTime) const
     {
+        if (!IsLoaded())
+        {
+            return 0.0f;
+        }
+
+        if (m_pages)
+        {
+            return ReadPagedRealTime(realTime);
+        }
+
         size_t n = m_buffer.size();
         if (n == 0)
         {
@@ -205,12 +328,200 @@ struct AudioBuffer
         return y0 + static_cast<float>(alpha * static_cast<double>(y1 - y0));
     }
 
+    // Same clamping and interpolation as ReadRealTime, through the page cache.
+    //
+    float ReadPagedRealTime(double realTime) const
+    {
+        size_t n = m_pages->m_numFrames;
+        double maxIndex = static_cast<double>(n - 1);
+        if (n == 1 || realTime <= 0.0)
+        {
+            return m_pages->Read(0, 0.0f);
+        }
+
+        if (maxIndex <= realTime)
+        {
+            return m_pages->Read(n - 1, 0.0f);
+        }
+
+        size_t i0 = static_cast<size_t>(std::floor(realTime));
+        double alpha = realTime - std::floor(realTime);
+        return m_pages->Read(i0, static_cast<float>(alpha));
+    }
+
     float Get(float t) const
     {
         return ReadRealTime(GetRealTime(t));
     }
 };
 
+// Process-wide cache of loaded AudioBuffers, keyed by absolute path and checked against the file's size and
+// modification time, so every bank that lists a file shares one decoded copy.  Voices pointing at the same
+// directory then load it once.
+//
+// A buffer is referenced while any bank holds it.  Unreferenced buffers stay cached up to m_budgetBytes and
+// are evicted least recently used first by Trim, which runs on the I/O thread after a retired bank is deleted,
+// so buffers are never freed on the audio thread.
+//
+// Streamed buffers are the exception to sharing: their page cache follows a single play head, so voices
+// reading one at different positions would evict each other's pages.  While a streamed buffer is held, later
+// holders get their own uncached buffer; the decoded pages are small and the OS still shares the file data.
+//
+struct SampleCache
+{
+    static constexpr size_t x_defaultBudgetBytes = size_t(256) << 20;
+
+    struct Entry
+    {
+        int64_t m_modifiedTime;
+        uintmax_t m_fileSize;
+        uint64_t m_lastUse;
+        std::shared_ptr<AudioBuffer> m_buffer;
+    };
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_entries;
+    size_t m_budgetBytes;
+    uint64_t m_useClock;
+    size_t m_hitCount;
+    size_t m_unsharedCount;
+    size_t m_evictionCount;
+
+    SampleCache()
+        : m_budgetBytes(x_defaultBudgetBytes)
+        , m_useClock(0)
+        , m_hitCount(0)
+        , m_unsharedCount(0)
+        , m_evictionCount(0)
+    {
+    }
+
+    // Returns the cached buffer for the file and sets isNew to false, or caches a new, unloaded buffer and sets
+    // isNew to true; the caller loads it and sets m_loaded.  A file that cannot be stat'ed is not cached, and
+    // neither is a second holder's buffer for a streamed file.
+    //
+    std::shared_ptr<AudioBuffer> Acquire(const std::string& absoluteFileName, bool* isNew)
+    {
+        *isNew = true;
+        std::error_code ec;
+        std::filesystem::path path(absoluteFileName);
+        uintmax_t fileSize = std::filesystem::file_size(path, ec);
+        if (ec)
+        {
+            return NewBuffer();
+        }
+
+        int64_t modifiedTime = static_cast<int64_t>(std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+        if (ec)
+        {
+            return NewBuffer();
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Entry& entry = m_entries[absoluteFileName];
+        entry.m_lastUse = ++m_useClock;
+
+        // A buffer that is unloaded with no other holder lost its load job (the pool shut down); reload it.
+        //
+        bool abandoned = entry.m_buffer && entry.m_buffer.use_count() == 1 && !entry.m_buffer->IsLoaded();
+        if (entry.m_buffer && !abandoned && entry.m_modifiedTime == modifiedTime && entry.m_fileSize == fileSize)
+        {
+            if (1 < entry.m_buffer.use_count() && IsStreamed(*entry.m_buffer, absoluteFileName))
+            {
+                ++m_unsharedCount;
+                return NewBuffer();
+            }
+
+            ++m_hitCount;
+            *isNew = false;
+            return entry.m_buffer;
+        }
+
+        entry.m_modifiedTime = modifiedTime;
+        entry.m_fileSize = fileSize;
+        entry.m_buffer = NewBuffer();
+        return entry.m_buffer;
+    }
+
+    // A buffer still loading has not decided yet, so ask the file.
+    //
+    static bool IsStreamed(const AudioBuffer& buffer, const std::string& absoluteFileName)
+    {
+        return buffer.IsLoaded() ? buffer.IsStreamed() : AudioBuffer::WouldStream(absoluteFileName.c_str());
+    }
+
+    static std::shared_ptr<AudioBuffer> NewBuffer()
+    {
+        std::shared_ptr<AudioBuffer> buf = std::make_shared<AudioBuffer>();
+        buf->m_loaded.store(false, std::memory_order_relaxed);
+        return buf;
+    }
+
+    // I/O thread.  Evicts unreferenced buffers, oldest use first, until they fit in the budget.  A buffer
+    // still loading is never evicted unless it was abandoned.
+    //
+    void Trim()
+    {
+        std::vector<std::shared_ptr<AudioBuffer>> evicted;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::vector<std::unordered_map<std::string, Entry>::iterator> unreferenced;
+            size_t unreferencedBytes = 0;
+            for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+            {
+                if (it->second.m_buffer.use_count() == 1)
+                {
+                    unreferenced.push_back(it);
+                    unreferencedBytes += it->second.m_buffer->MemoryBytes();
+                }
+            }
+
+            std::sort(unreferenced.begin(), unreferenced.end(), [](const auto& a, const auto& b)
+            {
+                return a->second.m_lastUse < b->second.m_lastUse;
+            });
+
+            for (auto it : unreferenced)
+            {
+                const std::shared_ptr<AudioBuffer>& buf = it->second.m_buffer;
+                if (m_budgetBytes < unreferencedBytes || !buf->IsLoaded())
+                {
+                    unreferencedBytes -= buf->MemoryBytes();
+                    evicted.push_back(std::move(it->second.m_buffer));
+                    m_entries.erase(it);
+                    ++m_evictionCount;
+                }
+            }
+        }
+
+        // Freed here, outside the lock.
+        //
+        evicted.clear();
+    }
+
+    void SetBudgetBytes(size_t budgetBytes)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_budgetBytes = budgetBytes;
+    }
+
+    size_t NumEntries()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.size();
+    }
+
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+    }
+
+    static SampleCache s_instance;
+};
+
+inline SampleCache SampleCache::s_instance;
+
 struct AudioBufferBank
 {
     using UISnapshot = AudioBuffer::UISnapshot;
@@ -223,6 +534,11 @@ struct AudioBufferBank
     float m_bankPosition{0.0f};
     std::string m_directoryName;
 
+    // PopulateUIState scratch for the second buffer of a blend.
+    //
+    std::array<float, AudioBuffer::x_numSections> m_blendMaximums{};
+    std::array<float, AudioBuffer::x_numSections> m_blendMinimums{};
+
     struct BankBlend
     {
         size_t m_bankA;
@@ -270,12 +586,18 @@ struct AudioBufferBank
         return result;
     }
 
-    void LoadFromDirectory(const char* absoluteDirectoryPath, const char* relativeDirectoryPath, std::unordered_map<std::string, std::shared_ptr<AudioBuffer>>* existingByFileName)
+    // Lists the directory's WAV and lossless files in filename order, reusing buffers from existingByFileName and then from
+    // sampleCache.  Without a worker pool every new file loads here.  With one, the first new file loads here,
+    // so the bank is playable as soon as this returns, and the rest load in parallel on the pool; each reads as
+    // empty until it is done.
+    //
+    void LoadFromDirectory(const char* absoluteDirectoryPath, const char* relativeDirectoryPath, std::unordered_map<std::string, std::shared_ptr<AudioBuffer>>* existingByFileName, WorkerPool* workerPool = nullptr, SampleCache* sampleCache = nullptr)
     {
         m_audioBuffers.clear();
         m_bankPosition = 0.0f;
         m_directoryName = relativeDirectoryPath ? relativeDirectoryPath : "";
 
+        std::vector<std::string> baseNames;
         DIR* directory = opendir(absoluteDirectoryPath);
         if (!directory)
         {
@@ -287,37 +609,75 @@ struct AudioBufferBank
         {
             const char* baseName = entry->d_name;
             std::string absoluteFileName = GetFileName(absoluteDirectoryPath, baseName);
-            if (IsWavFile(absoluteFileName.c_str()) && IsRegularFile(absoluteFileName.c_str()))
+            if (WavReader::IsReadableFileName(baseName) && IsRegularFile(absoluteFileName.c_str()))
             {
-                bool reused = false;
+                baseNames.push_back(baseName);
+            }
 
-                if (existingByFileName)
+            entry = readdir(directory);
+        }
+
+        closedir(directory);
+        std::sort(baseNames.begin(), baseNames.end());
+
+        bool loadedFirst = false;
+        for (const std::string& baseName : baseNames)
+        {
+            if (existingByFileName)
+            {
+                auto reuseIt = existingByFileName->find(baseName);
+                if (reuseIt != existingByFileName->end())
                 {
-                    auto reuseIt = existingByFileName->find(baseName);
-                    if (reuseIt != existingByFileName->end())
-                    {
-                        m_audioBuffers.push_back(reuseIt->second);
-                        existingByFileName->erase(reuseIt);
-                        reused = true;
-                    }
+                    m_audioBuffers.push_back(reuseIt->second);
+                    existingByFileName->erase(reuseIt);
+                    continue;
                 }
+            }
+
+            std::string absoluteFileName = GetFileName(absoluteDirectoryPath, baseName.c_str());
+            bool isNew = true;
+            std::shared_ptr<AudioBuffer> buf = sampleCache ? sampleCache->Acquire(absoluteFileName, &isNew) : SampleCache::NewBuffer();
+            if (!isNew)
+            {
+                m_audioBuffers.push_back(buf);
+                continue;
+            }
 
-                if (!reused)
+            buf->m_fileName = baseName;
+            if (!workerPool || !loadedFirst)
+            {
+                buf->LoadFromFile(absoluteFileName.c_str());
+                buf->m_loaded.store(true, std::memory_order_release);
+                loadedFirst = true;
+            }
+            else
+            {
+                workerPool->Submit([buf, absoluteFileName]()
                 {
-                    std::shared_ptr<AudioBuffer> buf = std::make_shared<AudioBuffer>();
-                    buf->m_fileName = baseName;
                     buf->LoadFromFile(absoluteFileName.c_str());
-                    m_audioBuffers.push_back(buf);
-                }
+                    buf->m_loaded.store(true, std::memory_order_release);
+                });
             }
 
-            entry = readdir(directory);
+            m_audioBuffers.push_back(buf);
         }
+    }
 
-        closedir(directory);
+    size_t NumLoaded() const
+    {
+        size_t loaded = 0;
+        for (const std::shared_ptr<AudioBuffer>& buf : m_audioBuffers)
+        {
+            if (buf->IsLoaded())
+            {
+                ++loaded;
+            }
+        }
+
+        return loaded;
     }
 
-    AudioBufferBank* ReloadFromDirectory(const char* absoluteDirectoryPath, const char* relativeDirectoryPath)
+    AudioBufferBank* ReloadFromDirectory(const char* absoluteDirectoryPath, const char* relativeDirectoryPath, WorkerPool* workerPool = nullptr, SampleCache* sampleCache = nullptr)
     {
         std::unordered_map<std::string, std::shared_ptr<AudioBuffer>> existingByFileName;
         for (const std::shared_ptr<AudioBuffer>& buf : m_audioBuffers)
@@ -326,7 +686,7 @@ struct AudioBufferBank
         }
 
         AudioBufferBank* bank = new AudioBufferBank();
-        bank->LoadFromDirectory(absoluteDirectoryPath, relativeDirectoryPath, &existingByFileName);
+        bank->LoadFromDirectory(absoluteDirectoryPath, relativeDirectoryPath, &existingByFileName, workerPool, sampleCache);
         bank->m_bankPosition = m_bankPosition;
         return bank;
     }
@@ -343,21 +703,6 @@ struct AudioBufferBank
         return result;
     }
 
-    bool IsWavFile(const char* fileName) const
-    {
-        std::string name = fileName;
-        if (name.size() < 4)
-        {
-            return false;
-        }
-
-        size_t extensionOffset = name.size() - 4;
-        return std::tolower(static_cast<unsigned char>(name[extensionOffset + 0])) == '.'
-            && std::tolower(static_cast<unsigned char>(name[extensionOffset + 1])) == 'w'
-            && std::tolower(static_cast<unsigned char>(name[extensionOffset + 2])) == 'a'
-            && std::tolower(static_cast<unsigned char>(name[extensionOffset + 3])) == 'v';
-    }
-
     bool IsRegularFile(const char* fileName) const
     {
         struct stat fileStatus;
@@ -400,8 +745,8 @@ struct AudioBufferBank
         }
 
         const AudioBuffer& bufB = *m_audioBuffers[blend.m_bankB];
-        size_t nA = bufA.m_buffer.size();
-        size_t nB = bufB.m_buffer.size();
+        size_t nA = bufA.NumFrames();
+        size_t nB = bufB.NumFrames();
         double denomA = static_cast<double>((nA <= 1) ? 1 : (nA - 1));
         double denomB = static_cast<double>((nB <= 1) ? 1 : (nB - 1));
         double p = realTime / denomA;
@@ -436,6 +781,23 @@ struct AudioBufferBank
         return oneMinus * sA + blend.m_blendB * sB;
     }
 
+    // Audio thread.  Forwards the play head to the one or two buffers being read.
+    //
+    void Prefetch(double t, double loopStart) const
+    {
+        if (m_audioBuffers.empty())
+        {
+            return;
+        }
+
+        BankBlend blend = ComputeBankBlend();
+        m_audioBuffers[blend.m_bankA]->Prefetch(t, loopStart);
+        if (!blend.m_single && m_audioBuffers.size() > 1)
+        {
+            m_audioBuffers[blend.m_bankB]->Prefetch(t, loopStart);
+        }
+    }
+
     void PopulateUIState(UIState* uiState)
     {
         UISnapshot& snapshot = uiState->BeginSnapshot();
@@ -451,28 +813,26 @@ struct AudioBufferBank
             const AudioBuffer& bufA = *m_audioBuffers[blend.m_bankA];
             if (blend.m_single || m_audioBuffers.size() == 1)
             {
-                for (size_t i = 0; i < AudioBuffer::x_numSections; ++i)
-                {
-                    snapshot.m_sectionMaximums[i] = bufA.m_sectionMaximums[i];
-                    snapshot.m_sectionMinimums[i] = bufA.m_sectionMinimums[i];
-                }
+                bufA.CopySectionExtrema(snapshot.m_sectionMaximums, snapshot.m_sectionMinimums);
             }
             else
             {
+                // B's copy goes into the scratch arrays, then A's is blended with it in place.
+                //
                 const AudioBuffer& bufB = *m_audioBuffers[blend.m_bankB];
+                bufA.CopySectionExtrema(snapshot.m_sectionMaximums, snapshot.m_sectionMinimums);
+                bufB.CopySectionExtrema(m_blendMaximums, m_blendMinimums);
                 float oneMinus = 1.0f - blend.m_blendB;
                 for (size_t i = 0; i < AudioBuffer::x_numSections; ++i)
                 {
-                    float maxA = bufA.m_sectionMaximums[i];
-                    float maxB = bufB.m_sectionMaximums[i];
-                    float minA = bufA.m_sectionMinimums[i];
-                    float minB = bufB.m_sectionMinimums[i];
-                    snapshot.m_sectionMaximums[i] = oneMinus * maxA + blend.m_blendB * maxB;
-                    snapshot.m_sectionMinimums[i] = oneMinus * minA + blend.m_blendB * minB;
+                    snapshot.m_sectionMaximums[i] = oneMinus * snapshot.m_sectionMaximums[i] + blend.m_blendB * m_blendMaximums[i];
+                    snapshot.m_sectionMinimums[i] = oneMinus * snapshot.m_sectionMinimums[i] + blend.m_blendB * m_blendMinimums[i];
                 }
             }
         }
 
+        snapshot.m_numLoaded = NumLoaded();
+        snapshot.m_numBuffers = m_audioBuffers.size();
         uiState->CommitSnapshot();
     }
 };
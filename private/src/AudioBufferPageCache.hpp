@@ -0,0 +1,412 @@
+#pragma once
+
+#include "ThreadId.hpp"
+#include "WakeSignal.hpp"
+#include "WavReader.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Decoded mono pages of a WAV file, for AudioBuffers too long to decode up front.
+//
+// The cache is direct-mapped: page p lives in slot p % x_numSlots, so it holds at most x_numSlots pages and
+// a page is evicted only when a page x_numSlots away is decoded.  Each slot holds one extra frame (the first
+// frame of the next page) so an interpolated read never spans two slots.
+//
+// The audio thread reads with Read, which never blocks: slots are guarded by a sequence lock, and a page that
+// is not resident reads as silence and is requested from the pager.  SetPlayHead posts where playback is, and
+// the pager keeps the pages around it (and around the loop start) decoded ahead of time.  There is one play
+// head per cache, so SampleCache never shares a streamed buffer between voices.
+//
+// Pages are decoded from bytes WavReader copies out of the file, so truncating the file while it streams turns
+// the lost pages into silence instead of a SIGBUS.
+//
+struct AudioBufferPageCache
+{
+    static constexpr size_t x_pageFrames = 4096;
+    static constexpr size_t x_numSlots = 64;
+    static constexpr size_t x_readaheadPages = 8;
+    static constexpr size_t x_readbehindPages = 2;
+    static constexpr size_t x_numSections = 1024;
+    static constexpr int64_t x_noPage = -1;
+
+    struct Slot
+    {
+        // Odd while the pager is rewriting the slot.
+        //
+        std::atomic<uint64_t> m_version;
+        std::atomic<int64_t> m_page;
+        float m_samples[x_pageFrames + 1];
+
+        Slot()
+            : m_version(0)
+            , m_page(x_noPage)
+        {
+        }
+    };
+
+    WavReader m_reader;
+    size_t m_numFrames;
+    size_t m_numPages;
+    std::unique_ptr<Slot[]> m_slots;
+
+    // Posted by the audio thread, read by the pager.
+    //
+    std::atomic<int64_t> m_playHeadPage;
+    std::atomic<int64_t> m_loopStartPage;
+    std::atomic<int64_t> m_missPage;
+    std::atomic<size_t> m_missCount;
+    WakeSignal* m_wake;
+
+    // Waveform overview, filled in by the pager after the buffer is already playable.  Sections below
+    // m_sectionsScanned are published; read them through CopyExtrema.
+    //
+    std::array<float, x_numSections> m_sectionMaximums{};
+    std::array<float, x_numSections> m_sectionMinimums{};
+    std::atomic<size_t> m_sectionsScanned;
+
+    // Pager thread only.  The last missed page stays wanted until another miss replaces it, so readahead
+    // cannot evict it straight after it is decoded.
+    //
+    std::vector<float> m_scratch;
+    size_t m_pagesDecoded;
+    int64_t m_lastMissPage;
+
+    AudioBufferPageCache()
+        : m_numFrames(0)
+        , m_numPages(0)
+        , m_playHeadPage(0)
+        , m_loopStartPage(0)
+        , m_missPage(x_noPage)
+        , m_missCount(0)
+        , m_wake(nullptr)
+        , m_sectionsScanned(0)
+        , m_pagesDecoded(0)
+        , m_lastMissPage(x_noPage)
+    {
+    }
+
+    // Takes over an opened reader and decodes the first pages, so the buffer plays from the start at once.
+    //
+    void Init(WavReader&& reader)
+    {
+        m_reader = std::move(reader);
+        m_numFrames = m_reader.m_numFrames;
+        m_numPages = (m_numFrames + x_pageFrames - 1) / x_pageFrames;
+        m_slots.reset(new Slot[x_numSlots]);
+        for (size_t page = 0; page < std::min(m_numPages, x_readaheadPages); ++page)
+        {
+            EnsurePage(static_cast<int64_t>(page));
+        }
+    }
+
+    // Audio thread.  Interpolates between frame and frame + 1; frame + 1 must not be past the end.
+    //
+    float Read(size_t frame, float alpha)
+    {
+        int64_t page = static_cast<int64_t>(frame / x_pageFrames);
+        size_t offset = frame % x_pageFrames;
+        Slot& slot = m_slots[static_cast<size_t>(page) % x_numSlots];
+        uint64_t version = slot.m_version.load(std::memory_order_acquire);
+        if ((version & 1) == 0 && slot.m_page.load(std::memory_order_relaxed) == page)
+        {
+            float y0 = slot.m_samples[offset];
+            float y1 = slot.m_samples[offset + 1];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.m_version.load(std::memory_order_relaxed) == version)
+            {
+                return y0 + alpha * (y1 - y0);
+            }
+        }
+
+        m_missCount.fetch_add(1, std::memory_order_relaxed);
+        if (m_missPage.load(std::memory_order_relaxed) != page)
+        {
+            m_missPage.store(page, std::memory_order_relaxed);
+            Wake();
+        }
+
+        return 0.0f;
+    }
+
+    // Audio thread.  Wakes the pager only when the play head or loop start moves to another page.
+    //
+    void SetPlayHead(size_t frame, size_t loopStartFrame)
+    {
+        int64_t page = static_cast<int64_t>(frame / x_pageFrames);
+        int64_t loopStartPage = static_cast<int64_t>(loopStartFrame / x_pageFrames);
+        bool moved = false;
+        if (m_playHeadPage.load(std::memory_order_relaxed) != page)
+        {
+            m_playHeadPage.store(page, std::memory_order_relaxed);
+            moved = true;
+        }
+
+        if (m_loopStartPage.load(std::memory_order_relaxed) != loopStartPage)
+        {
+            m_loopStartPage.store(loopStartPage, std::memory_order_relaxed);
+            moved = true;
+        }
+
+        if (moved)
+        {
+            Wake();
+        }
+    }
+
+    void Wake()
+    {
+        if (m_wake)
+        {
+            m_wake->Signal();
+        }
+    }
+
+    // False while the page is still being decoded into its slot.
+    //
+    bool IsResident(int64_t page) const
+    {
+        const Slot& slot = m_slots[static_cast<size_t>(page) % x_numSlots];
+        uint64_t version = slot.m_version.load(std::memory_order_acquire);
+        return (version & 1) == 0 && slot.m_page.load(std::memory_order_relaxed) == page;
+    }
+
+    // Pager thread.  Decodes page into its slot unless it is already there.  Returns true if it decoded.
+    //
+    bool EnsurePage(int64_t page)
+    {
+        if (page < 0 || static_cast<int64_t>(m_numPages) <= page || IsResident(page))
+        {
+            return false;
+        }
+
+        Slot& slot = m_slots[static_cast<size_t>(page) % x_numSlots];
+        uint64_t version = slot.m_version.load(std::memory_order_relaxed);
+        slot.m_version.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.m_page.store(page, std::memory_order_relaxed);
+
+        size_t first = static_cast<size_t>(page) * x_pageFrames;
+        size_t count = std::min(x_pageFrames + 1, m_numFrames - first);
+        m_reader.DecodeLeftRightSum(first, count, slot.m_samples);
+        for (size_t i = count; i <= x_pageFrames; ++i)
+        {
+            slot.m_samples[i] = slot.m_samples[count - 1];
+        }
+
+        slot.m_version.store(version + 2, std::memory_order_release);
+        ++m_pagesDecoded;
+        return true;
+    }
+
+    // Pager thread.  Brings in the missed page and the pages around the play head and loop start, in that
+    // priority.  A page is skipped if a higher-priority page needs its slot, so two wanted pages x_numSlots
+    // apart cannot evict each other forever.  Returns true if it decoded anything.
+    //
+    bool Service()
+    {
+        static constexpr size_t x_maxWanted = 4 + x_readaheadPages + x_readbehindPages;
+        int64_t wanted[x_maxWanted];
+        size_t numWanted = 0;
+
+        int64_t missPage = m_missPage.exchange(x_noPage, std::memory_order_relaxed);
+        if (missPage != x_noPage)
+        {
+            m_lastMissPage = missPage;
+        }
+
+        int64_t playHeadPage = m_playHeadPage.load(std::memory_order_relaxed);
+        int64_t loopStartPage = m_loopStartPage.load(std::memory_order_relaxed);
+        wanted[numWanted++] = m_lastMissPage;
+        wanted[numWanted++] = playHeadPage;
+        wanted[numWanted++] = loopStartPage;
+        for (int64_t i = 1; i <= static_cast<int64_t>(x_readaheadPages); ++i)
+        {
+            wanted[numWanted++] = playHeadPage + i;
+        }
+
+        for (int64_t i = 1; i <= static_cast<int64_t>(x_readbehindPages); ++i)
+        {
+            wanted[numWanted++] = playHeadPage - i;
+        }
+
+        wanted[numWanted++] = loopStartPage + 1;
+
+        m_reader.WillNeed(static_cast<size_t>(std::max<int64_t>(0, playHeadPage)) * x_pageFrames, (x_readaheadPages + 1) * x_pageFrames);
+
+        bool didWork = false;
+        for (size_t i = 0; i < numWanted; ++i)
+        {
+            bool blocked = false;
+            for (size_t j = 0; j < i; ++j)
+            {
+                if (0 <= wanted[j] && wanted[j] != wanted[i] && static_cast<size_t>(wanted[j]) % x_numSlots == static_cast<size_t>(wanted[i]) % x_numSlots)
+                {
+                    blocked = true;
+                    break;
+                }
+            }
+
+            if (!blocked)
+            {
+                didWork |= EnsurePage(wanted[i]);
+            }
+        }
+
+        return didWork;
+    }
+
+    bool ExtremaComplete() const
+    {
+        return m_sectionsScanned.load(std::memory_order_acquire) == x_numSections;
+    }
+
+    // Any thread.  Copies the sections the pager has published; the rest read as zero.  A published section is
+    // never written again, so this does not race ScanExtrema.
+    //
+    void CopyExtrema(std::array<float, x_numSections>& maximums, std::array<float, x_numSections>& minimums) const
+    {
+        size_t scanned = m_sectionsScanned.load(std::memory_order_acquire);
+        std::copy(m_sectionMaximums.begin(), m_sectionMaximums.begin() + scanned, maximums.begin());
+        std::copy(m_sectionMinimums.begin(), m_sectionMinimums.begin() + scanned, minimums.begin());
+        std::fill(maximums.begin() + scanned, maximums.end(), 0.0f);
+        std::fill(minimums.begin() + scanned, minimums.end(), 0.0f);
+    }
+
+    // Pager thread.  Computes up to maxSections more overview sections straight from the file, without going
+    // through the slots.  Returns true if it computed any.
+    //
+    bool ScanExtrema(size_t maxSections)
+    {
+        size_t section = m_sectionsScanned.load(std::memory_order_relaxed);
+        if (section == x_numSections)
+        {
+            return false;
+        }
+
+        size_t end = std::min(x_numSections, section + maxSections);
+        for (; section < end; ++section)
+        {
+            size_t begin = (section * m_numFrames) / x_numSections;
+            size_t stop = ((section + 1) * m_numFrames) / x_numSections;
+            if (begin == stop)
+            {
+                continue;
+            }
+
+            m_scratch.resize(stop - begin);
+            m_reader.DecodeLeftRightSum(begin, stop - begin, m_scratch.data());
+            auto minMax = std::minmax_element(m_scratch.begin(), m_scratch.end());
+            m_sectionMinimums[section] = *minMax.first;
+            m_sectionMaximums[section] = *minMax.second;
+        }
+
+        m_sectionsScanned.store(end, std::memory_order_release);
+        return true;
+    }
+};
+
+// The thread that decodes pages for every live AudioBufferPageCache.  Caches register from the I/O thread
+// when their buffer loads and drop out when the buffer is destroyed.  Page requests come first; overview
+// scans run only when no cache needs a page.
+//
+struct AudioBufferPager
+{
+    static constexpr size_t x_sectionsPerStep = 16;
+
+    std::mutex m_mutex;
+    std::vector<std::weak_ptr<AudioBufferPageCache>> m_caches;
+    std::vector<std::shared_ptr<AudioBufferPageCache>> m_live;
+    WakeSignal m_wake;
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+
+    AudioBufferPager()
+        : m_running(false)
+    {
+    }
+
+    ~AudioBufferPager()
+    {
+        m_running.store(false);
+        m_wake.Signal();
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    void Register(const std::shared_ptr<AudioBufferPageCache>& cache)
+    {
+        cache->m_wake = &m_wake;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_caches.push_back(cache);
+            if (!m_running.load())
+            {
+                m_running.store(true);
+                m_thread = std::thread(&AudioBufferPager::Run, this);
+            }
+        }
+
+        m_wake.Signal();
+    }
+
+    void Run()
+    {
+        SetCurrentThreadId(ThreadId::AsyncIo);
+        while (m_running.load())
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_live.clear();
+                auto it = std::remove_if(m_caches.begin(), m_caches.end(), [this](const std::weak_ptr<AudioBufferPageCache>& weak)
+                {
+                    std::shared_ptr<AudioBufferPageCache> cache = weak.lock();
+                    if (!cache)
+                    {
+                        return true;
+                    }
+
+                    m_live.push_back(std::move(cache));
+                    return false;
+                });
+
+                m_caches.erase(it, m_caches.end());
+            }
+
+            bool didWork = false;
+            for (const std::shared_ptr<AudioBufferPageCache>& cache : m_live)
+            {
+                didWork |= cache->Service();
+            }
+
+            if (!didWork)
+            {
+                for (const std::shared_ptr<AudioBufferPageCache>& cache : m_live)
+                {
+                    didWork |= cache->ScanExtrema(x_sectionsPerStep);
+                }
+            }
+
+            // Release here, so a cache whose buffer is gone is destroyed on this thread.
+            //
+            m_live.clear();
+            if (!didWork)
+            {
+                m_wake.Wait();
+            }
+        }
+    }
+
+    static AudioBufferPager s_instance;
+};
+
+inline AudioBufferPager AudioBufferPager::s_instance;
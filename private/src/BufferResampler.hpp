@@ -64,10 +64,7 @@ struct BufferResampler
         filter.SetCyclesPerSample(cutoffCycles);
         filter.Reset();
 
-        for (size_t i = 0; i < sampleCount; ++i)
-        {
-            samples[i] = filter.Process(samples[i]);
-        }
+        filter.ProcessBlock(samples, sampleCount);
     }
 
     // Writes resampled audio into out. sourceRate and targetRate are in Hz.
@@ -3,13 +3,16 @@
 #include <cmath>
 #include <algorithm>
 #include <complex>
+#include <cstddef>
 
+// Transposed direct form II: two state words per section instead of four, and the only serial
+// dependency is output -> m_s1 -> next output.
+//
 struct BiquadSection
 {
     float m_b0, m_b1, m_b2;
     float m_a1, m_a2;
-    float m_x1, m_x2;
-    float m_y1, m_y2;
+    float m_s1, m_s2;
 
     BiquadSection()
         : m_b0(1.0f)
@@ -17,28 +20,32 @@ struct BiquadSection
         , m_b2(0.0f)
         , m_a1(0.0f)
         , m_a2(0.0f)
-        , m_x1(0.0f)
-        , m_x2(0.0f)
-        , m_y1(0.0f)
-        , m_y2(0.0f)
+        , m_s1(0.0f)
+        , m_s2(0.0f)
     {
     }
 
     float Process(float input)
     {
-        float output = m_b0 * input + m_b1 * m_x1 + m_b2 * m_x2 - m_a1 * m_y1 - m_a2 * m_y2;
-
-        m_x2 = m_x1;
-        m_x1 = input;
-        m_y2 = m_y1;
-        m_y1 = output;
-
+        float output = m_b0 * input + m_s1;
+        m_s1 = m_b1 * input - m_a1 * output + m_s2;
+        m_s2 = m_b2 * input - m_a2 * output;
         return output;
     }
 
+    // Runs the whole block through this section, so a cascade can be driven section-major.
+    //
+    void ProcessBlock(float* inOut, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            inOut[i] = Process(inOut[i]);
+        }
+    }
+
     void Reset()
     {
-        m_x1 = m_x2 = m_y1 = m_y2 = 0.0f;
+        m_s1 = m_s2 = 0.0f;
     }
 
     void SetCoefficients(float cosw, float sinw, float q, bool isHighPass = false)
@@ -105,21 +112,101 @@ struct BiquadSection
     }
 };
 
+// NumChannels copies of one BiquadSection sharing its coefficients, with the state in lane arrays so
+// every channel (or voice) advances in the same loop. Each lane does exactly the arithmetic of
+// BiquadSection::Process, so the output is identical to NumChannels independent sections.
+//
+template<size_t NumChannels>
+struct MultichannelBiquadSection
+{
+    float m_b0, m_b1, m_b2;
+    float m_a1, m_a2;
+    float m_s1[NumChannels];
+    float m_s2[NumChannels];
+
+    MultichannelBiquadSection()
+        : m_b0(1.0f)
+        , m_b1(0.0f)
+        , m_b2(0.0f)
+        , m_a1(0.0f)
+        , m_a2(0.0f)
+        , m_s1{}
+        , m_s2{}
+    {
+    }
+
+    void SetCoefficients(const BiquadSection& biquad)
+    {
+        m_b0 = biquad.m_b0;
+        m_b1 = biquad.m_b1;
+        m_b2 = biquad.m_b2;
+        m_a1 = biquad.m_a1;
+        m_a2 = biquad.m_a2;
+    }
+
+    void Process(const float* input, float* output)
+    {
+        for (size_t i = 0; i < NumChannels; ++i)
+        {
+            float x = input[i];
+            float y = m_b0 * x + m_s1[i];
+            m_s1[i] = m_b1 * x - m_a1 * y + m_s2[i];
+            m_s2[i] = m_b2 * x - m_a2 * y;
+            output[i] = y;
+        }
+    }
+
+    // frames[i][channel], processed in place.
+    //
+    void ProcessBlock(float (*frames)[NumChannels], size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            Process(frames[i], frames[i]);
+        }
+    }
+
+    void Reset()
+    {
+        for (size_t i = 0; i < NumChannels; ++i)
+        {
+            m_s1[i] = m_s2[i] = 0.0f;
+        }
+    }
+};
+
 struct ButterworthFilter
 {
     static constexpr float x_minCyclesPerSample = 0.0001f;
     static constexpr float x_maxCyclesPerSample = 0.499f;
 
+    static constexpr size_t x_numSections = 4;
+    static constexpr size_t x_stateSize = 2 * x_numSections;
+    static constexpr size_t x_blockSize = 4;
+    static constexpr size_t x_blockVectorSize = x_blockSize + x_stateSize;
+
     BiquadSection m_biquad1;
     BiquadSection m_biquad2;
     BiquadSection m_biquad3;
     BiquadSection m_biquad4;
 
+    // State-space form of the whole cascade, advanced x_blockSize samples per step. The block vector is
+    // x_blockSize samples followed by the eight TDF-II state words (m_s1, m_s2 of each section in order).
+    // One step maps [input block, state] to [output block, next state]:
+    //
+    //   out[d] = sum_j m_blockMatrix[j][d] * in[j]
+    //
+    // No output sample depends on another, so the step is independent multiply-adds rather than a
+    // four-section-deep chain per sample, and the inner loop over d runs lane-parallel.
+    //
+    float m_blockMatrix[x_blockVectorSize][x_blockVectorSize];
+
     float m_cyclesPerSample;
 
     ButterworthFilter()
         : m_cyclesPerSample(0.1f)
     {
+        BuildBlockMatrix();
     }
 
     float Process(float input)
@@ -135,6 +222,54 @@ struct ButterworthFilter
         return stage4Out;
     }
 
+    // Same filter as calling Process on every sample (to float rounding). Any tail shorter than a block
+    // goes through Process, which shares the state.
+    //
+    void ProcessBlock(float* inOut, size_t count)
+    {
+        float vector[x_blockVectorSize];
+        GetState(vector + x_blockSize);
+
+        size_t i = 0;
+        for (; i + x_blockSize <= count; i += x_blockSize)
+        {
+            for (size_t k = 0; k < x_blockSize; ++k)
+            {
+                vector[k] = inOut[i + k];
+            }
+
+            // Even and odd rows accumulate separately to halve the add chain through the state.
+            //
+            float even[x_blockVectorSize] = {};
+            float odd[x_blockVectorSize] = {};
+            for (size_t j = 0; j < x_blockVectorSize; j += 2)
+            {
+                for (size_t d = 0; d < x_blockVectorSize; ++d)
+                {
+                    even[d] += m_blockMatrix[j][d] * vector[j];
+                    odd[d] += m_blockMatrix[j + 1][d] * vector[j + 1];
+                }
+            }
+
+            for (size_t d = 0; d < x_blockVectorSize; ++d)
+            {
+                vector[d] = even[d] + odd[d];
+            }
+
+            for (size_t k = 0; k < x_blockSize; ++k)
+            {
+                inOut[i + k] = vector[k];
+            }
+        }
+
+        SetState(vector + x_blockSize);
+
+        for (; i < count; ++i)
+        {
+            inOut[i] = Process(inOut[i]);
+        }
+    }
+
     void SetCyclesPerSample(float cyclesPerSample)
     {
         m_cyclesPerSample = (cyclesPerSample < x_minCyclesPerSample) ? x_minCyclesPerSample : (cyclesPerSample > x_maxCyclesPerSample) ? x_maxCyclesPerSample : cyclesPerSample;
@@ -159,6 +294,8 @@ struct ButterworthFilter
         m_biquad2.SetCoefficients(cosw, sinw, q2, false);
         m_biquad3.SetCoefficients(cosw, sinw, q3, false);
         m_biquad4.SetCoefficients(cosw, sinw, q4, false);
+
+        BuildBlockMatrix();
     }
 
     void Reset()
@@ -168,4 +305,62 @@ struct ButterworthFilter
         m_biquad3.Reset();
         m_biquad4.Reset();
     }
-}; 
\ No newline at end of file
+
+    void GetState(float* state) const
+    {
+        const BiquadSection* sections[x_numSections] = {&m_biquad1, &m_biquad2, &m_biquad3, &m_biquad4};
+        for (size_t i = 0; i < x_numSections; ++i)
+        {
+            state[2 * i] = sections[i]->m_s1;
+            state[2 * i + 1] = sections[i]->m_s2;
+        }
+    }
+
+    void SetState(const float* state)
+    {
+        BiquadSection* sections[x_numSections] = {&m_biquad1, &m_biquad2, &m_biquad3, &m_biquad4};
+        for (size_t i = 0; i < x_numSections; ++i)
+        {
+            sections[i]->m_s1 = state[2 * i];
+            sections[i]->m_s2 = state[2 * i + 1];
+        }
+    }
+
+    // One sample of the cascade in double, on an explicit state vector. Column j of m_blockMatrix is
+    // x_blockSize of these steps started from the j-th unit block vector.
+    //
+    double StepCascade(double* state, double input) const
+    {
+        const BiquadSection* sections[x_numSections] = {&m_biquad1, &m_biquad2, &m_biquad3, &m_biquad4};
+        for (size_t i = 0; i < x_numSections; ++i)
+        {
+            const BiquadSection& biquad = *sections[i];
+            double output = biquad.m_b0 * input + state[2 * i];
+            state[2 * i] = biquad.m_b1 * input - biquad.m_a1 * output + state[2 * i + 1];
+            state[2 * i + 1] = biquad.m_b2 * input - biquad.m_a2 * output;
+            input = output;
+        }
+
+        return input;
+    }
+
+    void BuildBlockMatrix()
+    {
+        for (size_t j = 0; j < x_blockVectorSize; ++j)
+        {
+            double vector[x_blockVectorSize] = {};
+            vector[j] = 1.0;
+
+            double* state = vector + x_blockSize;
+            for (size_t k = 0; k < x_blockSize; ++k)
+            {
+                vector[k] = StepCascade(state, vector[k]);
+            }
+
+            for (size_t d = 0; d < x_blockVectorSize; ++d)
+            {
+                m_blockMatrix[j][d] = static_cast<float>(vector[d]);
+            }
+        }
+    }
+};
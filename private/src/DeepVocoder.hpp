@@ -5,6 +5,7 @@
 #include "PhaseUtils.hpp"
 #include "TheNonagon.hpp"
 #include "AHD.hpp"
+#include "FastMath.hpp"
 #include <atomic>
 #include <limits>
 
@@ -21,7 +22,7 @@ struct DeepVocoder
         float omegaRatioDown = omegaCenter / omegaTest;
         float omegaRatio = std::max(omegaRatioUp, omegaRatioDown);
         float slope = omegaRatioUp > omegaRatioDown ? slopeUp : slopeDown;
-        float factor = std::powf(omegaRatio, slope);
+        float factor = FastMath::PowFast(omegaRatio, slope);
         return gainThreshold * factor;
     }
 
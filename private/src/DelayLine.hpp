@@ -425,6 +425,10 @@ struct DelayLineMovableWriter
     }
 };
 
+// Grains are mixed by overlap-add: when a grain starts, its whole windowed table is accumulated into
+// a circular bus in one pass, and each output sample is a single read-and-clear of that bus. Per-sample
+// cost no longer depends on how many grains overlap.
+//
 template<typename AudioBufferType>
 struct GrainManager
 {
@@ -435,15 +439,6 @@ struct GrainManager
         {
         }
 
-        void Reset()
-        {
-        }
-
-        float Process()
-        {
-            return m_grain.Process() / 1.5;
-        }
-
         void Start(Resynthesizer::Input& input, double startTime, double warpedTime)
         {
             Resynthesizer::Buffer prevTable;
@@ -466,81 +461,67 @@ struct GrainManager
             m_owner->m_resynthesizer.Process(prevTable, &m_grain, input);
         }
 
-        bool IsRunning() const
-        {
-            return m_grain.m_running;
-        }
-
         Resynthesizer::Grain m_grain;
         AudioBufferType* m_audioBuffer;
         GrainManager* m_owner;
     };
-    
-    static constexpr size_t x_maxGrains = 1024;
-    FixedAllocator<Grain, x_maxGrains> m_grainsAlloc;
-    Grain* m_grainsArray[x_maxGrains];
+
+    static constexpr size_t x_busSize = Resynthesizer::x_tableSize;
+    static constexpr size_t x_busMask = x_busSize - 1;
+    static constexpr float x_grainGain = 1.0f / 1.5f;
+
+    static_assert((x_busSize & x_busMask) == 0, "grain bus size must be a power of two");
+
+    // m_bus[m_busIndex] is the next output sample. A grain started now covers the whole ring,
+    // starting at m_busIndex, which is why the bus only needs to be one grain long.
+    //
+    float m_bus[x_busSize];
+
+    // Number of grains whose last sample sits at each bus position, to retire them from m_numGrains.
+    //
+    uint16_t m_grainEnds[x_busSize];
+    size_t m_busIndex;
+
+    // Metrics: grains currently sounding, and grains started since construction.
+    //
     size_t m_numGrains;
+    size_t m_grainsStarted;
+
+    Grain m_grain;
     AudioBufferType* m_audioBuffer;
     RGen m_rgen;
     int m_samplesToNextGrain;
     double m_lastSampleOffset;
     Resynthesizer m_resynthesizer;
 
-    void CompactGrains()
+    void AccumulateGrain()
     {
-        for (size_t i = 0; i < m_numGrains;)
+        const float* table = m_grain.m_grain.m_buffer.m_table;
+        size_t firstSpan = x_busSize - m_busIndex;
+        float* firstBus = m_bus + m_busIndex;
+        for (size_t i = 0; i < firstSpan; ++i)
         {
-            if (!m_grainsArray[i])        
-            {
-                m_grainsArray[i] = m_grainsArray[m_numGrains - 1];
-                --m_numGrains;
-            }
-            else
-            {
-                ++i;
-            }
+            firstBus[i] += x_grainGain * table[i];
         }
-    }
 
-    Grain* AllocateGrain()
-    {
-        Grain* grain = m_grainsAlloc.Allocate();
-        if (grain)
-        {
-            grain->m_audioBuffer = m_audioBuffer;
-            grain->m_owner = this;
-            ++m_numGrains;
-            m_grainsArray[m_numGrains - 1] = grain;
-        }
-        else
+        const float* secondTable = table + firstSpan;
+        for (size_t i = 0; i < m_busIndex; ++i)
         {
-            INFO("Failed to allocate grain");
+            m_bus[i] += x_grainGain * secondTable[i];
         }
 
-        return grain;
+        ++m_grainEnds[(m_busIndex + x_busMask) & x_busMask];
+        ++m_numGrains;
+        ++m_grainsStarted;
     }
 
-    float ProcessGrains()
+    float ReadBus()
     {
-        bool anyFreed = false;
-        float result = 0.0f;
-        for (size_t i = 0; i < m_numGrains; ++i)
-        {
-            result += m_grainsArray[i]->Process();
-            if (!m_grainsArray[i]->IsRunning())
-            {
-                anyFreed = true;
-                m_grainsArray[i]->Reset();
-                m_grainsAlloc.Free(m_grainsArray[i]);
-                m_grainsArray[i] = nullptr;                
-            }
-        }
-
-        if (anyFreed)
-        {
-            CompactGrains();
-        }
-
+        float result = m_bus[m_busIndex];
+        m_bus[m_busIndex] = 0.0f;
+        m_numGrains -= m_grainEnds[m_busIndex];
+        m_grainEnds[m_busIndex] = 0;
+        m_busIndex = (m_busIndex + 1) & x_busMask;
         return result;
     }
 
@@ -556,16 +537,15 @@ struct GrainManager
             return 0.0f;
         }
 
-        float result = ProcessGrains();
+        float result = ReadBus();
         --m_samplesToNextGrain;
         if (m_samplesToNextGrain <= 0)
         {
-            Grain* grain = AllocateGrain();
-            if (grain)
-            {
-                double startTime = m_audioBuffer->GetRealTime(warpedTime) + sampleOffset;
-                grain->Start(input.m_resynthInput, startTime, warpedTime);
-            }
+            double startTime = m_audioBuffer->GetRealTime(warpedTime) + sampleOffset;
+            m_grain.m_audioBuffer = m_audioBuffer;
+            m_grain.m_owner = this;
+            m_grain.Start(input.m_resynthInput, startTime, warpedTime);
+            AccumulateGrain();
 
             m_samplesToNextGrain = Resynthesizer::GetGrainLaunchSamples();
         }
@@ -576,15 +556,15 @@ struct GrainManager
     }
 
     GrainManager()
-        : m_audioBuffer(nullptr)
+        : m_bus{}
+        , m_grainEnds{}
+        , m_busIndex(0)
+        , m_numGrains(0)
+        , m_grainsStarted(0)
+        , m_audioBuffer(nullptr)
         , m_samplesToNextGrain(0)
         , m_lastSampleOffset(0)
     {
-        m_numGrains = 0;
-        for (size_t i = 0; i < x_maxGrains; ++i)
-        {
-            m_grainsArray[i] = nullptr;
-        }
     }
 };
 
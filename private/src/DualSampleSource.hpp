@@ -94,6 +94,11 @@ struct SampleSource
 
         m_previousTotalPhaseTime = previousTotalPhaseTime;
         m_upsampler.Process(m_uBlockBaseOutput, m_uBlockOutput);
+
+        if (m_grainManager.m_audioBuffer)
+        {
+            m_grainManager.m_audioBuffer->Prefetch(previousTotalPhaseTime, input.m_phasorPlayHeadInput.m_start);
+        }
     }
 
     void PopulateUIState(UIState* uiState) const
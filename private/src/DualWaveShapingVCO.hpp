@@ -28,17 +28,23 @@ struct DualWaveShapingVCO
 
     PhaseUtils::ExpParam m_morphHarmonics[2];
 
-    // Slewed parameters
+    // Slewed parameters, ramped across each micro-block. Per-oscillator params take two slots (+ j).
     //
-    ParamSlew m_vSlew[2];
-    ParamSlew m_dSlew[2];
-    ParamSlew m_wtBlendSlew[2];
-    ParamSlew m_baseFreqSlew;
-    ParamSlew m_fadeSlew;
-    ParamSlew m_bitCrushAmountSlew;
-    ParamSlew m_offsetFreqFactorSlew;
-    ParamSlew m_detuneSlew;
-    ParamSlew m_crossModIndexSlew[2];
+    enum RampParam : size_t
+    {
+        VRamp,
+        DRamp = VRamp + 2,
+        WtBlendRamp = DRamp + 2,
+        CrossModIndexRamp = WtBlendRamp + 2,
+        BaseFreqRamp = CrossModIndexRamp + 2,
+        FadeRamp,
+        BitCrushAmountRamp,
+        OffsetFreqFactorRamp,
+        DetuneRamp,
+        NumRampParams
+    };
+
+    ParamRampBlock<NumRampParams, x_uBlockSize> m_ramps;
 
     struct Input
     {
@@ -74,15 +80,6 @@ struct DualWaveShapingVCO
 
     DualWaveShapingVCO()
         : m_output(0)
-        , m_vSlew{ParamSlew(x_oversample), ParamSlew(x_oversample)}
-        , m_dSlew{ParamSlew(x_oversample), ParamSlew(x_oversample)}
-        , m_wtBlendSlew{ParamSlew(x_oversample), ParamSlew(x_oversample)}
-        , m_baseFreqSlew(x_oversample)
-        , m_fadeSlew(x_oversample)
-        , m_bitCrushAmountSlew(x_oversample)
-        , m_offsetFreqFactorSlew(x_oversample)
-        , m_detuneSlew(x_oversample)
-        , m_crossModIndexSlew{ParamSlew(x_oversample), ParamSlew(x_oversample)}
     {
     }
 
@@ -90,21 +87,22 @@ struct DualWaveShapingVCO
     {
         m_output = 0;
 
-        // Update slew targets
+        // Set ramp targets and generate the whole micro-block of parameter values
         //
         for (int j = 0; j < 2; ++j)
         {
-            m_vSlew[j].Update(input.m_v[j]);
-            m_dSlew[j].Update(input.m_d[j]);
-            m_wtBlendSlew[j].Update(input.m_wtBlend[j]);
-            m_crossModIndexSlew[j].Update(input.m_crossModIndex[j].m_expParam);
+            m_ramps.Update(VRamp + j, input.m_v[j]);
+            m_ramps.Update(DRamp + j, input.m_d[j]);
+            m_ramps.Update(WtBlendRamp + j, input.m_wtBlend[j]);
+            m_ramps.Update(CrossModIndexRamp + j, input.m_crossModIndex[j].m_expParam);
         }
 
-        m_baseFreqSlew.Update(input.m_baseFreq);
-        m_fadeSlew.Update(input.m_fade);
-        m_bitCrushAmountSlew.Update(input.m_bitCrushAmount);
-        m_offsetFreqFactorSlew.Update(input.m_offsetFreqFactor.m_expParam);
-        m_detuneSlew.Update(input.m_detune.m_expParam);
+        m_ramps.Update(BaseFreqRamp, input.m_baseFreq);
+        m_ramps.Update(FadeRamp, input.m_fade);
+        m_ramps.Update(BitCrushAmountRamp, input.m_bitCrushAmount);
+        m_ramps.Update(OffsetFreqFactorRamp, input.m_offsetFreqFactor.m_expParam);
+        m_ramps.Update(DetuneRamp, input.m_detune.m_expParam);
+        m_ramps.Ramp();
 
         bool top[2] = {false, false};
 
@@ -117,16 +115,16 @@ struct DualWaveShapingVCO
 
             for (int j = 0; j < 2; ++j)
             {
-                vcoInput[j].m_v = m_vSlew[j].Process();
-                vcoInput[j].m_d = m_dSlew[j].Process();
-                vcoInput[j].m_wtBlend = m_wtBlendSlew[j].Process();
+                vcoInput[j].m_v = m_ramps.Get(VRamp + j, i);
+                vcoInput[j].m_d = m_ramps.Get(DRamp + j, i);
+                vcoInput[j].m_wtBlend = m_ramps.Get(WtBlendRamp + j, i);
             }
 
-            float baseFreq = m_baseFreqSlew.Process() / x_oversample;
-            float offsetFreqFactor = m_offsetFreqFactorSlew.Process();
-            float detune = m_detuneSlew.Process();
+            float baseFreq = m_ramps.Get(BaseFreqRamp, i) / x_oversample;
+            float offsetFreqFactor = m_ramps.Get(OffsetFreqFactorRamp, i);
+            float detune = m_ramps.Get(DetuneRamp, i);
 
-            vcoInput[0].m_phaseMod = m_crossModIndexSlew[0].Process() * m_vco[1].m_out;
+            vcoInput[0].m_phaseMod = m_ramps.Get(CrossModIndexRamp, i) * m_vco[1].m_out;
             vcoInput[0].m_freq = baseFreq * detune;
             vcoInput[1].m_freq = baseFreq * offsetFreqFactor / detune;
 
@@ -136,16 +134,16 @@ struct DualWaveShapingVCO
             }
 
             m_vco[0].Process(vcoInput[0], 0 /*unused*/);
-            vcoInput[1].m_phaseMod = m_vco[0].m_out * m_crossModIndexSlew[1].Process();
+            vcoInput[1].m_phaseMod = m_vco[0].m_out * m_ramps.Get(CrossModIndexRamp + 1, i);
             m_vco[1].Process(vcoInput[1], 0 /*unused*/);
 
             top[0] = top[0] || m_vco[0].m_top;
             top[1] = top[1] || m_vco[1].m_top;
 
-            float fade = m_fadeSlew.Process();
+            float fade = m_ramps.Get(FadeRamp, i);
             float mixed = m_vco[0].m_out * Math::Cos2pi(fade / 4) + m_vco[1].m_out * Math::Cos2pi(fade / 4 + 0.75);
 
-            float bitCrushAmount = m_bitCrushAmountSlew.Process();
+            float bitCrushAmount = m_ramps.Get(BitCrushAmountRamp, i);
             m_bitRateReducer.SetAmount(bitCrushAmount);
             float crushed = m_bitRateReducer.Process(mixed);
 
@@ -151,7 +151,7 @@ struct StateEncoderCell : public EncoderCell
     {
         for (size_t i = 0; i < m_numTracks; ++i)
         {
-            m_values[i][scene] = GetNormalizedValueForTrack(i);
+            m_values[scene][i] = GetNormalizedValueForTrack(i);
         }
 
         SetState();
@@ -162,12 +162,12 @@ struct StateEncoderCell : public EncoderCell
         size_t track = m_sharedEncoderState->m_currentTrack;
         if (m_sceneManager->m_blendFactor < 1)
         {
-            m_values[track][m_sceneManager->m_scene1] = 0;
+            m_values[m_sceneManager->m_scene1][track] = 0;
         }
 
         if (m_sceneManager->m_blendFactor > 0)
         {
-            m_values[track][m_sceneManager->m_scene2] = 0;
+            m_values[m_sceneManager->m_scene2][track] = 0;
         }
 
         SetStateForTrack(track);
@@ -177,12 +177,12 @@ struct StateEncoderCell : public EncoderCell
     {
         for (size_t i = 0; i < m_numTracks; ++i)
         {
-            if (m_values[i][m_sceneManager->m_scene1] != 0 && m_sceneManager->m_blendFactor < 1)
+            if (m_values[m_sceneManager->m_scene1][i] != 0 && m_sceneManager->m_blendFactor < 1)
             {
                 return false;
             }
 
-            if (m_values[i][m_sceneManager->m_scene2] != 0 && m_sceneManager->m_blendFactor > 0)
+            if (m_values[m_sceneManager->m_scene2][i] != 0 && m_sceneManager->m_blendFactor > 0)
             {
                 return false;
             }
@@ -193,12 +193,12 @@ struct StateEncoderCell : public EncoderCell
 
     bool IsZeroCurrentSceneForTrack(size_t track)
     {
-        if (m_values[track][m_sceneManager->m_scene1] != 0 && m_sceneManager->m_blendFactor < 1)
+        if (m_values[m_sceneManager->m_scene1][track] != 0 && m_sceneManager->m_blendFactor < 1)
         {
             return false;
         }
         
-        if (m_values[track][m_sceneManager->m_scene2] != 0 && m_sceneManager->m_blendFactor > 0)
+        if (m_values[m_sceneManager->m_scene2][track] != 0 && m_sceneManager->m_blendFactor > 0)
         {
             return false;
         }
@@ -206,7 +206,9 @@ struct StateEncoderCell : public EncoderCell
         return true;
     }
 
-    float m_values[x_maxPoly][SceneManager::x_numScenes];
+    // Scene-major: m_values[scene][track].
+    //
+    float m_values[SceneManager::x_numScenes][x_maxPoly];
     float* m_state[x_maxPoly];
     size_t m_numTracks;
     SceneManager* m_sceneManager;
@@ -221,7 +223,7 @@ struct StateEncoderCell : public EncoderCell
             JSON sceneValues = a.Array();
             for (size_t j = 0; j < m_numTracks; ++j)
             {
-                sceneValues.AppendNew(a.Real(m_values[j][i]));
+                sceneValues.AppendNew(a.Real(m_values[i][j]));
             }
 
             values.AppendNew(sceneValues);
@@ -240,7 +242,7 @@ struct StateEncoderCell : public EncoderCell
             m_numTracks = sceneValues.Size();
             for (size_t j = 0; j < m_numTracks; ++j)
             {
-                m_values[j][i] = static_cast<float>(sceneValues.GetAt(j).NumberValue());
+                m_values[i][j] = static_cast<float>(sceneValues.GetAt(j).NumberValue());
             }
         }
 
@@ -258,7 +260,7 @@ struct StateEncoderCell : public EncoderCell
         {
             for (size_t j = 0; j < SceneManager::x_numScenes; ++j)
             {
-                m_values[i][j] = 0;
+                m_values[j][i] = 0;
             }
         }
 
@@ -279,7 +281,7 @@ struct StateEncoderCell : public EncoderCell
         {
             for (size_t j = 0; j < SceneManager::x_numScenes; ++j)
             {
-                m_values[i][j] = 0;
+                m_values[j][i] = 0;
             }
         }
 
@@ -312,7 +314,7 @@ struct StateEncoderCell : public EncoderCell
 
     float GetNormalizedValueForTrack(size_t track)
     {
-        return m_sceneManager->GetSceneValue(m_values[track]);
+        return m_sceneManager->GetSceneValue(m_values, track);
     }
 
     bool AllZero()
@@ -321,7 +323,7 @@ struct StateEncoderCell : public EncoderCell
         {
             for (size_t j = 0; j < SceneManager::x_numScenes; ++j)
             {
-                if (m_values[i][j] != 0)
+                if (m_values[j][i] != 0)
                 {
                     return false;
                 }
@@ -338,9 +340,11 @@ struct StateEncoderCell : public EncoderCell
 
     void SetState()
     {
+        float blended[x_maxPoly];
+        m_sceneManager->GetSceneValues(m_values, blended);
         for (size_t i = 0; i < m_numTracks; ++i)
         {
-            SetStateForTrack(i);
+            *m_state[i] = blended[i];
         }
     }
 
@@ -362,31 +366,31 @@ struct StateEncoderCell : public EncoderCell
         size_t track = m_sharedEncoderState->m_currentTrack;
         if (t <= 0)
         {
-            m_values[track][s1] = std::max(0.0f, std::min(1.0f, m_values[track][s1] + delta));
+            m_values[s1][track] = std::max(0.0f, std::min(1.0f, m_values[s1][track] + delta));
         }
         else if (t >= 1)
         {
-            m_values[track][s2] = std::max(0.0f, std::min(1.0f, m_values[track][s2] + delta));
+            m_values[s2][track] = std::max(0.0f, std::min(1.0f, m_values[s2][track] + delta));
         }
         else
         {
             float value = std::max(0.0f, std::min(1.0f, GetNormalizedValueForTrack(track) + delta));
-            float newValue1 = m_values[track][s1] + delta * (1.0f - t);
-            float newValue2 = m_values[track][s2] + delta * t;
+            float newValue1 = m_values[s1][track] + delta * (1.0f - t);
+            float newValue2 = m_values[s2][track] + delta * t;
             if (newValue1 < 0 || newValue1 > 1)
             {
-                m_values[track][s1] = std::max(0.0f, std::min(1.0f, newValue1));
-                m_values[track][s2] = (value - m_values[track][s1] * (1 - t)) / t;
+                m_values[s1][track] = std::max(0.0f, std::min(1.0f, newValue1));
+                m_values[s2][track] = (value - m_values[s1][track] * (1 - t)) / t;
             }
             else if (newValue2 < 0 || newValue2 > 1)
             {
-                m_values[track][s2] = std::max(0.0f, std::min(1.0f, newValue2));
-                m_values[track][s1] = (value - m_values[track][s2] * t) / (1 - t);
+                m_values[s2][track] = std::max(0.0f, std::min(1.0f, newValue2));
+                m_values[s1][track] = (value - m_values[s2][track] * t) / (1 - t);
             }
             else
             {
-                m_values[track][s1] = newValue1;
-                m_values[track][s2] = newValue2;
+                m_values[s1][track] = newValue1;
+                m_values[s2][track] = newValue2;
             }
         }
 
@@ -405,7 +409,7 @@ struct StateEncoderCell : public EncoderCell
         {
             for (size_t j = 0; j < SceneManager::x_numScenes; ++j)
             {
-                m_values[i][j] = value;
+                m_values[j][i] = value;
             }
 
             SetStateForTrack(i);
@@ -446,7 +450,7 @@ struct StateEncoderCell : public EncoderCell
                     }
                 }
 
-                m_values[t][scene] = value;
+                m_values[scene][t] = value;
             }
 
             SetStateForTrack(t);
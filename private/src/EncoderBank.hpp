@@ -32,10 +32,17 @@ struct BankedEncoderCell : public StateEncoderCell
         size_t m_numVoices;
         ModulatorValues* m_modulatorValues;
 
+        // Raised whenever a cell sharing this state is forced to recompute.  If it is clear and no modulator
+        // or gesture changed this control frame, no cell of the mode can produce new output, and
+        // EncoderBankBank skips the mode's Compute pass entirely.
+        //
+        bool m_computePending;
+
         SharedEncoderState()
             : SharedEncoderStateBase()
             , m_numVoices(0)
             , m_modulatorValues(nullptr)
+            , m_computePending(true)
         {
         }
     };
@@ -117,6 +124,11 @@ struct BankedEncoderCell : public StateEncoderCell
             }                    
         }
 
+        bool AnyChanged() const
+        {
+            return !m_changedModulators.IsZero() || !m_changedGestures.IsZero();
+        }
+
         void SetModulatorColor(size_t index, Color color)
         {
             m_modulatorColor[index] = color;
@@ -151,12 +163,26 @@ struct BankedEncoderCell : public StateEncoderCell
         size_t m_numActiveModulators;
         BankedEncoderCell* m_owner;
 
+        // Compiled routes: the modulators that currently affect the owner, in m_activeModulators order, as
+        // flat source-index and cell arrays.  Compute sweeps these instead of re-walking the active list.
+        // Any change to the children or to an affecting set marks them dirty, and they are rebuilt on
+        // the next Compute.
+        //
+        int m_routeSource[x_numModulators];
+        BankedEncoderCell* m_routeCell[x_numModulators];
+        size_t m_numRoutes;
+        bool m_routesDirty;
+
         Modulators(BankedEncoderCell* owner)
             : m_modulators{}
             , m_gestures{}
             , m_activeModulators{}
             , m_numActiveModulators(0)
             , m_owner(owner)
+            , m_routeSource{}
+            , m_routeCell{}
+            , m_numRoutes(0)
+            , m_routesDirty(true)
         {
             for (size_t i = 0; i < x_numModulators; ++i)
             {
@@ -179,6 +205,8 @@ struct BankedEncoderCell : public StateEncoderCell
                     ++m_numActiveModulators;
                 }
             }
+
+            m_routesDirty = true;
         }
 
         void AddGesture(BankedEncoderCell* parent, size_t gestureIx)
@@ -204,6 +232,7 @@ struct BankedEncoderCell : public StateEncoderCell
             }
 
             m_numActiveModulators = 0;
+            m_routesDirty = true;
         }
 
         BankedEncoderCell* GetModulator(size_t i)
@@ -232,6 +261,30 @@ struct BankedEncoderCell : public StateEncoderCell
                     m_gestures[i] = nullptr;
                 }
             }
+
+            m_routesDirty = true;
+        }
+
+        // SetModulatorsAffecting sorts the affecting modulators to the front of m_activeModulators, so the
+        // routes are that prefix.
+        //
+        void CompileRoutes()
+        {
+            m_numRoutes = 0;
+            for (size_t i = 0; i < m_numActiveModulators; ++i)
+            {
+                BankedEncoderCell* cell = GetModulator(i);
+                if (cell->m_modulatorsAffecting.IsZero())
+                {
+                    break;
+                }
+
+                m_routeSource[m_numRoutes] = m_activeModulators[i];
+                m_routeCell[m_numRoutes] = cell;
+                ++m_numRoutes;
+            }
+
+            m_routesDirty = false;
         }
 
         void ComputePostGestureValues(
@@ -279,33 +332,31 @@ struct BankedEncoderCell : public StateEncoderCell
             size_t numTracks = m_owner->m_sharedEncoderState->m_numTracks;
             size_t numVoices = m_owner->GetSharedEncoderState()->m_numVoices;
 
-            float modValue[16];
-            float modWeight[16];
-            for (size_t i = 0; i < numTracks * numVoices; ++i)
+            if (m_routesDirty)
             {
-                modValue[i] = 0;
-                modWeight[i] = 0;
+                CompileRoutes();
             }
-            
-            for (size_t i = 0; i < m_numActiveModulators; ++i)
+
+            for (size_t r = 0; r < m_numRoutes; ++r)
             {
-                if (GetModulator(i)->m_modulatorsAffecting.IsZero())
-                {
-                    break;
-                }
+                m_routeCell[r]->Compute();
+            }
 
-                BankedEncoderCell* cell = GetModulator(i);
-                cell->Compute();
-                for (size_t j = 0; j < numTracks; ++j)
+            // One sweep per route over all 16 lanes (tracks x voices, unused lanes are harmless), so the inner
+            // loop has a fixed trip count and no indirection.
+            //
+            float modValue[16] = {};
+            float modWeight[16] = {};
+            for (size_t r = 0; r < m_numRoutes; ++r)
+            {
+                const float* depth = m_routeCell[r]->m_output;
+                const float* value = modulatorValues->m_value[m_routeSource[r]];
+                const float* amp = modulatorValues->m_amplitude[m_routeSource[r]];
+                for (size_t ix = 0; ix < 16; ++ix)
                 {
-                    for (size_t k = 0; k < numVoices; ++k)
-                    {
-                        size_t ix = j * numVoices + k;
-                        float amp = modulatorValues->m_amplitude[m_activeModulators[i]][ix];
-                        modValue[ix] += cell->m_output[ix] * modulatorValues->m_value[m_activeModulators[i]][ix] * amp;
-                        modWeight[ix] += cell->m_output[ix] * amp;
-                    }
-                }                
+                    modValue[ix] += depth[ix] * value[ix] * amp[ix];
+                    modWeight[ix] += depth[ix] * amp[ix];
+                }
             }
 
             for (size_t i = 0; i < numTracks; ++i)
@@ -334,20 +385,26 @@ struct BankedEncoderCell : public StateEncoderCell
             m_owner->m_brightness = std::max(0.0f, std::min(1.0f, brightnessVal));
         }
 
-        void SetAllStates()
+        // Returns true if any child's state changed (or it has gestures, see SetStateRecursive).
+        //
+        bool SetAllStates(bool force)
         {
+            bool changed = false;
             for (size_t i = 0; i < m_numActiveModulators; ++i)
             {
-                GetModulator(i)->SetStateRecursive();
+                changed = GetModulator(i)->SetStateRecursive(force) || changed;
             }
 
             for (size_t i = 0; i < x_numGestureParams; ++i)
             {
                 if (m_gestures[i])
                 {
-                    m_gestures[i]->SetStateRecursive();
+                    m_gestures[i]->SetStateRecursive(force);
+                    changed = true;
                 }
             }
+
+            return changed;
         }
     };
     
@@ -460,7 +517,7 @@ struct BankedEncoderCell : public StateEncoderCell
         m_isVisible = false;
         m_modulatorsAffecting.Clear();
         m_gesturesAffecting.Clear();
-        m_forceUpdate = true;
+        SetForceUpdate();
         for (size_t i = 0; i < 16; ++i)
         {
             m_bankedValue[i] = 0;
@@ -478,9 +535,18 @@ struct BankedEncoderCell : public StateEncoderCell
         return Color::FromTwister((124 + 67 * depth) / 2);
     }
 
-    void SetForceUpdateRecursive()
+    void SetForceUpdate()
     {
         m_forceUpdate = true;
+        if (m_sharedEncoderState)
+        {
+            GetSharedEncoderState()->m_computePending = true;
+        }
+    }
+
+    void SetForceUpdateRecursive()
+    {
+        SetForceUpdate();
         if (m_parent)
         {
             m_parent->SetForceUpdateRecursive();
@@ -519,13 +585,13 @@ struct BankedEncoderCell : public StateEncoderCell
                 {
                     float weight = gestureCell->m_effectiveModulatorWeights[m_sharedEncoderState->m_currentTrack];
                     gestureCell->IncrementInternal(delta * weight * weight / gestureWeightSum);
-                    gestureCell->m_forceUpdate = true;
+                    gestureCell->SetForceUpdate();
                     mainWeight += weight * (1 - weight);
                 }
             }
 
             IncrementInternal(delta * mainWeight / gestureWeightSum);
-            m_forceUpdate = true;
+            SetForceUpdate();
         }
         else
         {
@@ -903,7 +969,7 @@ struct BankedEncoderCell : public StateEncoderCell
             SetModulatorsAffecting();
         }
 
-        m_forceUpdate = true;
+        SetForceUpdate();
     }
 
     void FillModulators(SceneManager* sceneManager)
@@ -917,11 +983,25 @@ struct BankedEncoderCell : public StateEncoderCell
         m_modulators.GarbageCollect();
     }
 
-    void SetStateRecursive()
+    // Re-reads the scene-blended values into m_bankedValue.  Unless forced, only cells whose values (or whose
+    // children's values) actually moved are marked for recompute, so a crossfade between scenes that agree on a
+    // parameter leaves it alone.  Gesture weights are scene-blended themselves, so cells with gestures always
+    // recompute.  Returns whether this cell was marked.
+    //
+    bool SetStateRecursive(bool force = true)
     {
+        float prevValue[16];
+        memcpy(prevValue, m_bankedValue, sizeof(m_bankedValue));
         SetState();
-        m_modulators.SetAllStates();
-        m_forceUpdate = true;
+        bool changed = memcmp(prevValue, m_bankedValue, sizeof(m_bankedValue)) != 0;
+        changed = m_modulators.SetAllStates(force) || changed;
+        if (force || changed)
+        {
+            SetForceUpdate();
+            return true;
+        }
+
+        return false;
     }
 
     bool IsActiveForTrack(size_t track)
@@ -967,7 +1047,7 @@ struct BankedEncoderCell : public StateEncoderCell
         {
             if (active && !m_isActive[m_sceneManager->m_scene2][m_sharedEncoderState->m_currentTrack])
             {
-                m_values[m_sharedEncoderState->m_currentTrack][m_sceneManager->m_scene2] = m_parent->m_values[m_sharedEncoderState->m_currentTrack][m_sceneManager->m_scene2];
+                m_values[m_sceneManager->m_scene2][m_sharedEncoderState->m_currentTrack] = m_parent->m_values[m_sceneManager->m_scene2][m_sharedEncoderState->m_currentTrack];
                 SetStateForTrack(m_sharedEncoderState->m_currentTrack);
             }
 
@@ -978,7 +1058,7 @@ struct BankedEncoderCell : public StateEncoderCell
         {
             if (active && !m_isActive[m_sceneManager->m_scene1][m_sharedEncoderState->m_currentTrack])
             {
-                m_values[m_sharedEncoderState->m_currentTrack][m_sceneManager->m_scene1] = m_parent->m_values[m_sharedEncoderState->m_currentTrack][m_sceneManager->m_scene1];
+                m_values[m_sceneManager->m_scene1][m_sharedEncoderState->m_currentTrack] = m_parent->m_values[m_sceneManager->m_scene1][m_sharedEncoderState->m_currentTrack];
                 SetStateForTrack(m_sharedEncoderState->m_currentTrack);
             }
 
@@ -1028,6 +1108,12 @@ struct BankedEncoderCell : public StateEncoderCell
 
     void SetModulatorsAffecting()
     {
+        m_modulators.m_routesDirty = true;
+        if (m_parent)
+        {
+            m_parent->m_modulators.m_routesDirty = true;
+        }
+
         m_modulatorsAffecting.Clear();
         for (size_t i = 0; i < m_numTracks; ++i)
         {
@@ -1071,6 +1157,11 @@ struct BankedEncoderCell : public StateEncoderCell
             }
         }
 
+        // The reorder above changes the summation order of the modulation blend (and the affecting set may have
+        // changed), so recompute rather than keep an output built from the old order.
+        //
+        SetForceUpdate();
+
         m_gesturesAffecting.Clear();
         for (size_t j = 0; j < 16; ++j)
         {
@@ -23,6 +23,11 @@ struct EncoderBankBank
             , m_sharedEncoderState()
         {
         }
+
+        bool NeedsCompute() const
+        {
+            return m_sharedEncoderState.m_computePending || m_modulatorValues.AnyChanged();
+        }
     };
 
     struct BankConfig
@@ -277,11 +282,32 @@ struct EncoderBankBank
 
         if (SampleTimer::IsControlFrame())
         {
-            ForEachNamedEncoder(
-                [](size_t, SmartGrid::BankedEncoderCell* cell)
+            // Compute is change-driven per cell; a mode with nothing forced and no changed modulator or
+            // gesture has nothing to recompute, so a static patch skips the walk altogether.
+            //
+            bool anyPending = false;
+            for (size_t i = 0; i < m_numModes; ++i)
+            {
+                anyPending = anyPending || m_bankModes[i].NeedsCompute();
+            }
+
+            if (anyPending)
+            {
+                ForEachNamedEncoder(
+                    [](size_t, SmartGrid::BankedEncoderCell* cell)
+                    {
+                        if (cell->GetSharedEncoderState()->m_computePending ||
+                            cell->GetSharedEncoderState()->m_modulatorValues->AnyChanged())
+                        {
+                            cell->Compute();
+                        }
+                    });
+
+                for (size_t i = 0; i < m_numModes; ++i)
                 {
-                    cell->Compute();
-                });
+                    m_bankModes[i].m_sharedEncoderState.m_computePending = false;
+                }
+            }
 
             for (size_t i = 0; i < m_numBanks; ++i)
             {
@@ -293,9 +319,12 @@ struct EncoderBankBank
     void HandleChangedSceneManager()
     {
         ForEachNamedEncoder(
-            [](size_t, SmartGrid::BankedEncoderCell* cell)
+            [this](size_t, SmartGrid::BankedEncoderCell* cell)
             {
-                cell->SetStateRecursive();
+                // A scene switch (or reaching either end of the blend) also changes which modulators
+                // affect a cell, so only an in-between blend move is allowed to skip unchanged cells.
+                //
+                cell->SetStateRecursive(m_sceneManager->m_changedScene);
             });
     }
 
@@ -53,22 +53,45 @@ namespace SmartGrid
         }
     };
 
+    // Sends Twister LED state as a delta stream: each encoder's colour, brightness and value ring are kept as
+    // the codes last sent, and a CC goes out only when the code the hardware would show changes.  Value rings
+    // follow modulation at control rate, so each encoder's ring is also rate limited to one CC per
+    // x_valueCoolDownFrames calls to ProcessCoolDown; a ring that moved during its cool-down is sent with its
+    // latest value once the cool-down ends.
+    //
     struct EncoderMidiWriter
     {
         static constexpr int x_numPhases = 3;
+        static constexpr uint8_t x_valueCoolDownFrames = 2;
 
         bool m_sent[4][4];
+        uint8_t m_colorCode[4][4];
+        uint8_t m_brightnessCode[4][4];
+        uint8_t m_valueCode[4][4];
+        uint8_t m_cooldown[4][4];
+
+        // Last raw value seen per encoder and indicator, so changes that produce no CC can be counted.
+        //
         Color m_color[4][4];
         float m_brightness[4][4];
         float m_values[4][4];
 
+        size_t m_sentCount;
+        size_t m_suppressedCount;
+
         EncoderBankUIState* m_encoderBankState;
 
         EncoderMidiWriter(EncoderBankUIState* encoderBankState)
             : m_sent{}
+            , m_colorCode{}
+            , m_brightnessCode{}
+            , m_valueCode{}
+            , m_cooldown{}
             , m_color{}
             , m_brightness{}
             , m_values{}
+            , m_sentCount(0)
+            , m_suppressedCount(0)
             , m_encoderBankState(encoderBankState)
         {
             for (size_t i = 0; i < 4; ++i)
@@ -90,8 +113,56 @@ namespace SmartGrid
                 for (size_t j = 0; j < 4; ++j)
                 {
                     m_sent[i][j] = false;
+                    m_cooldown[i][j] = 0;
+                }
+            }
+        }
+
+        void ProcessCoolDown()
+        {
+            for (size_t i = 0; i < 4; ++i)
+            {
+                for (size_t j = 0; j < 4; ++j)
+                {
+                    if (m_cooldown[i][j] > 0)
+                    {
+                        --m_cooldown[i][j];
+                    }
+                }
+            }
+        }
+
+        static uint8_t BrightnessCode(float brightness)
+        {
+            return 17 + brightness * 30;
+        }
+
+        static uint8_t ValueCode(float value)
+        {
+            return value * 127;
+        }
+
+        float GetCurrentValue(size_t x, size_t y)
+        {
+            size_t currentTrack = m_encoderBankState->GetCurrentTrack() * m_encoderBankState->GetNumVoices();
+            return m_encoderBankState->GetValue(x, y, currentTrack);
+        }
+
+        // Counts a raw change that did not produce a CC.
+        //
+        template<typename T>
+        bool Suppress(T* last, T current, bool send)
+        {
+            if (*last != current)
+            {
+                *last = current;
+                if (!send)
+                {
+                    ++m_suppressedCount;
                 }
             }
+
+            return send;
         }
 
         struct Iterator
@@ -161,23 +232,28 @@ namespace SmartGrid
                 
             bool NeedsToSend() const
             {
-                if (!m_owner->m_sent[m_x][m_y])
-                {
-                    return true;
-                }
-
+                bool sent = m_owner->m_sent[m_x][m_y];
                 if (m_phase == 0)
                 {
-                    return m_owner->m_color[m_x][m_y] != m_encoderBankState->GetColor(m_x, m_y) &&
-                           m_encoderBankState->GetBrightness(m_x, m_y) > 0;
+                    Color color = m_encoderBankState->GetColor(m_x, m_y);
+                    bool send = !sent || 
+                                (m_owner->m_colorCode[m_x][m_y] != color.ToTwister() &&
+                                 m_encoderBankState->GetBrightness(m_x, m_y) > 0);
+                    return m_owner->Suppress(&m_owner->m_color[m_x][m_y], color, send);
                 }
                 else if (m_phase == 1)
                 {
-                    return m_owner->m_brightness[m_x][m_y] != m_encoderBankState->GetBrightness(m_x, m_y);
+                    float brightness = m_encoderBankState->GetBrightness(m_x, m_y);
+                    bool send = !sent || m_owner->m_brightnessCode[m_x][m_y] != BrightnessCode(brightness);
+                    return m_owner->Suppress(&m_owner->m_brightness[m_x][m_y], brightness, send);
                 }
                 else if (m_phase == 2)
                 {
-                    return m_owner->m_values[m_x][m_y] != m_encoderBankState->GetValue(m_x, m_y, m_phase);
+                    float value = m_owner->GetCurrentValue(m_x, m_y);
+                    bool send = !sent || 
+                                (m_owner->m_valueCode[m_x][m_y] != ValueCode(value) &&
+                                 m_owner->m_cooldown[m_x][m_y] == 0);
+                    return m_owner->Suppress(&m_owner->m_values[m_x][m_y], value, send);
                 }
 
                 return false;
@@ -199,23 +275,24 @@ namespace SmartGrid
                 if (m_phase == 0)
                 {
                     Color color = m_encoderBankState->GetColor(m_x, m_y);
-                    m_owner->m_color[m_x][m_y] = color;
                     uint8_t mfTwisterCode = color.ToTwister();
+                    m_owner->m_colorCode[m_x][m_y] = mfTwisterCode;
+                    ++m_owner->m_sentCount;
                     return BasicMidi::CC(0, -1, 1 /*channel*/, EncoderMidi::PosToNote(m_x, m_y), mfTwisterCode);
                 }
                 else if (m_phase == 1)
                 {
-                    float brightnessF = m_encoderBankState->GetBrightness(m_x, m_y);
-                    uint8_t brightness = 17 + brightnessF * 30;
-                    m_owner->m_brightness[m_x][m_y] = brightnessF;
+                    uint8_t brightness = BrightnessCode(m_encoderBankState->GetBrightness(m_x, m_y));
+                    m_owner->m_brightnessCode[m_x][m_y] = brightness;
+                    ++m_owner->m_sentCount;
                     return BasicMidi::CC(0, -1, 2 /*channel*/, EncoderMidi::PosToNote(m_x, m_y), brightness);
                 }
                 else if (m_phase == 2)
                 {
-                    size_t currentTrack = m_encoderBankState->GetCurrentTrack() * m_encoderBankState->GetNumVoices();
-                    float valueF = m_encoderBankState->GetValue(m_x, m_y, currentTrack);
-                    uint8_t value = valueF * 127;
-                    m_owner->m_values[m_x][m_y] = valueF;
+                    uint8_t value = ValueCode(m_owner->GetCurrentValue(m_x, m_y));
+                    m_owner->m_valueCode[m_x][m_y] = value;
+                    m_owner->m_cooldown[m_x][m_y] = x_valueCoolDownFrames;
+                    ++m_owner->m_sentCount;
                     return BasicMidi::CC(0, -1, 0 /*channel*/, EncoderMidi::PosToNote(m_x, m_y), value);
                 }
                 else
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "QuadUtils.hpp"
+
+// Polynomial / bit-trick transcendentals for per-sample code.
+//
+// Each function comes in accuracy tiers; pick the cheapest one the call site can tolerate.
+// Max errors below are measured over the documented domain in float (see dsp_fastmath.cpp):
+//
+//   Exp2Fast    rel 2.3e-4     x in [-126, 127] (clamped, NaN reads as -126)
+//   Exp2Precise rel 3e-7       x in [-126, 127] (clamped)
+//   Log2Fast    abs 2.2e-4     x > 0 (x <= FLT_MIN is clamped, so Log2(0) = -126)
+//   Log2Precise abs 3e-7       x > 0 (same clamp); far from 1 the float result itself is the limit (~1 ulp)
+//   PowFast     rel ~ 1.6e-4 * (1 + |y log2 x|)    x > 0
+//   PowPrecise  rel ~ 3e-7 * (1 + |y log2 x|)      x > 0
+//   Sin2piFast  abs 1.1e-4     any phase, period 1
+//   Sin2piPrecise abs 5e-7     any phase, period 1 (Cos2pi adds the rounding of phase + 1/4, 8e-7 for |phase| < 4)
+//   TanhPade    abs 2.4e-2     rational x(27 + x^2)/(27 + 9x^2) clamped to [-1, 1] (the classic saturator curve)
+//   TanhPrecise abs 3e-7       any x
+//
+// Everything is branch-free (min/max clamps only) and inlines to plain float/int arithmetic, so the
+// Apply helpers below (block and QuadFloat) auto-vectorize on SSE and NEON. Clang does this at -O2;
+// GCC only if-converts the clamps in front of the float->int conversions with -fno-trapping-math.
+//
+struct FastMath
+{
+    static constexpr float x_log2e = 1.4426950408889634f;
+    static constexpr float x_ln2 = 0.6931471805599453f;
+    static constexpr float x_minNormal = 1.17549435e-38f;
+
+    static float BitsToFloat(int32_t bits)
+    {
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    static int32_t FloatToBits(float x)
+    {
+        int32_t result;
+        std::memcpy(&result, &x, sizeof(result));
+        return result;
+    }
+
+    template<int N>
+    static float PowInt(float x)
+    {
+        static_assert(0 <= N, "PowInt needs a non-negative exponent");
+        if constexpr (N == 0)
+        {
+            return 1.0f;
+        }
+        else if constexpr (N % 2 == 0)
+        {
+            float half = PowInt<N / 2>(x);
+            return half * half;
+        }
+        else
+        {
+            return x * PowInt<N - 1>(x);
+        }
+    }
+
+    // Splits x into round(x) and a fraction in [-0.5, 0.5], returns 2^round(x) built in the exponent field.
+    // The +126.5 offset keeps the truncating int conversion equal to floor, so no floor call is needed.
+    // The clamp takes the bound as the first argument so a NaN input becomes -126 before the int conversion.
+    //
+    static float Exp2Split(float x, float& fraction)
+    {
+        x = std::min(127.0f, std::max(-126.0f, x));
+        int32_t shifted = static_cast<int32_t>(x + 126.5f);
+        fraction = x - static_cast<float>(shifted - 126);
+        return BitsToFloat((shifted + 1) << 23);
+    }
+
+    static float Exp2Fast(float x)
+    {
+        float f;
+        float scale = Exp2Split(x, f);
+        float p = 1.0f + f * (0.69312636f + f * (0.24203008f + f * 0.05592174f));
+        return p * scale;
+    }
+
+    static float Exp2Precise(float x)
+    {
+        float f;
+        float scale = Exp2Split(x, f);
+        float p = 0.00015469710f;
+        p = 0.0013390846f + f * p;
+        p = 0.0096180309f + f * p;
+        p = 0.055503572f + f * p;
+        p = 0.24022651f + f * p;
+        p = 0.69314719f + f * p;
+        p = 1.0f + f * p;
+        return p * scale;
+    }
+
+    // Splits positive x into an integer exponent and a mantissa in [sqrt(1/2), sqrt(2)).
+    //
+    static float Log2Split(float x, float& mantissa)
+    {
+        int32_t bits = FloatToBits(std::max(x, x_minNormal));
+        int32_t exponent = (bits - 0x3f3504f3) >> 23;
+        mantissa = BitsToFloat(bits - (exponent << 23));
+        return static_cast<float>(exponent);
+    }
+
+    static float Log2Fast(float x)
+    {
+        float m;
+        float exponent = Log2Split(x, m);
+        float t = m - 1.0f;
+        float p = 1.4422278f + t * (-0.72364241f + t * (0.51268245f + t * -0.33566804f));
+        return exponent + t * p;
+    }
+
+    // log2(m) = 2 atanh(s) / ln2 with s = (m - 1) / (m + 1), |s| <= 0.1716.
+    //
+    static float Log2Precise(float x)
+    {
+        float m;
+        float exponent = Log2Split(x, m);
+        float s = (m - 1.0f) / (m + 1.0f);
+        float s2 = s * s;
+        float p = 1.0f / 9.0f;
+        p = 1.0f / 7.0f + s2 * p;
+        p = 1.0f / 5.0f + s2 * p;
+        p = 1.0f / 3.0f + s2 * p;
+        p = 1.0f + s2 * p;
+        return exponent + (2.0f * x_log2e) * s * p;
+    }
+
+    static float ExpFast(float x)
+    {
+        return Exp2Fast(x * x_log2e);
+    }
+
+    static float ExpPrecise(float x)
+    {
+        return Exp2Precise(x * x_log2e);
+    }
+
+    static float LogFast(float x)
+    {
+        return Log2Fast(x) * x_ln2;
+    }
+
+    static float LogPrecise(float x)
+    {
+        return Log2Precise(x) * x_ln2;
+    }
+
+    // base must be positive.
+    //
+    static float PowFast(float base, float exponent)
+    {
+        return Exp2Fast(exponent * Log2Fast(base));
+    }
+
+    static float PowPrecise(float base, float exponent)
+    {
+        return Exp2Precise(exponent * Log2Precise(base));
+    }
+
+    // Folds any phase into [-1/4, 1/4] with the same sin(2 pi x), so only the odd polynomial is needed.
+    //
+    static float Sin2piReduce(float phase)
+    {
+        float x = phase - std::floor(phase + 0.5f);
+        return std::max(std::min(x, 0.5f - x), -0.5f - x);
+    }
+
+    static float Sin2piFast(float phase)
+    {
+        float x = Sin2piReduce(phase);
+        float x2 = x * x;
+        return x * (6.2824988f + x2 * (-41.166201f + x2 * 74.451268f));
+    }
+
+    static float Sin2piPrecise(float phase)
+    {
+        float x = Sin2piReduce(phase);
+        float x2 = x * x;
+        float p = 39.710822f;
+        p = -76.574967f + x2 * p;
+        p = 81.602229f + x2 * p;
+        p = -41.341677f + x2 * p;
+        p = 6.2831853f + x2 * p;
+        return x * p;
+    }
+
+    static float Cos2piFast(float phase)
+    {
+        return Sin2piFast(phase + 0.25f);
+    }
+
+    static float Cos2piPrecise(float phase)
+    {
+        return Sin2piPrecise(phase + 0.25f);
+    }
+
+    static float TanhPade(float x)
+    {
+        float y = x * (27.0f + x * x) / (27.0f + 9.0f * x * x);
+        return std::min(1.0f, std::max(-1.0f, y));
+    }
+
+    // tanh(x) = (e^2x - 1) / (e^2x + 1); |x| beyond 9 is already 1 in float.
+    //
+    static float TanhPrecise(float x)
+    {
+        x = std::min(9.0f, std::max(-9.0f, x));
+        float e = Exp2Precise(2.0f * x_log2e * x);
+        return (e - 1.0f) / (e + 1.0f);
+    }
+
+    // Lane-parallel forms, e.g. FastMath::Apply<FastMath::Exp2Fast>(in, out, n).
+    //
+    template<float (*Fn)(float)>
+    static void Apply(const float* input, float* output, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            output[i] = Fn(input[i]);
+        }
+    }
+
+    template<float (*Fn)(float)>
+    static void Apply(float* inOut, size_t count)
+    {
+        Apply<Fn>(inOut, inOut, count);
+    }
+
+    template<float (*Fn)(float)>
+    static QuadFloat Apply(const QuadFloat& input)
+    {
+        QuadFloat output;
+        for (size_t i = 0; i < QuadFloat::x_numChannels; ++i)
+        {
+            output[i] = Fn(input[i]);
+        }
+
+        return output;
+    }
+
+    template<float (*Fn)(float, float)>
+    static void Apply(const float* base, const float* exponent, float* output, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            output[i] = Fn(base[i], exponent[i]);
+        }
+    }
+};
@@ -3,6 +3,7 @@
 #include "CircularQueue.hpp"
 #include "AsyncLogger.hpp"
 #include "ThreadId.hpp"
+#include "WakeSignal.hpp"
 #include <atomic>
 #include <thread>
 #include <fstream>
@@ -19,6 +20,7 @@ struct FileWriter
     std::atomic<bool> m_error{false};
     std::thread m_writeThread;
     std::ofstream m_file;
+    WakeSignal m_wake;
 
     ~FileWriter()
     {
@@ -62,6 +64,7 @@ struct FileWriter
         // Signal the thread to stop
         //
         m_done = true;
+        m_wake.Signal();
 
         // Wait for the thread to finish
         //
@@ -70,7 +73,16 @@ struct FileWriter
 
     size_t Write(const uint8_t* data, size_t length)
     {
-        return m_queue.Write(data, length);
+        size_t written = m_queue.Write(data, length);
+
+        // Only full buffers reach the queue, so this wakes the writer about once per buffer.
+        //
+        if (!m_queue.IsEmpty())
+        {
+            m_wake.Signal();
+        }
+
+        return written;
     }
 
     void WriteThreadFunction(const std::string& filename)
@@ -107,9 +119,9 @@ struct FileWriter
             }
             else
             {
-                // No data available, sleep briefly
+                // No data available, sleep until Write or Close signals
                 //
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                m_wake.Wait();
             }
         }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AsyncLogger.hpp"
+#include "FastMath.hpp"
 #include "QuadUtils.hpp"
 #include "TransferFunction.hpp"
 #include <atomic>
@@ -444,8 +445,7 @@ struct TanhSaturator
 
     float Tanh(float x)
     {
-        float y = x * (27.0f + x * x) / (27.0f + 9.0f * x * x);
-        return std::min(1.0f, std::max(-1.0f, y));
+        return FastMath::TanhPade(x);
     }
 
     // Derivative of Process w.r.t. input
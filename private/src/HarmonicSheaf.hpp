@@ -14,6 +14,19 @@ struct HarmonicSheaf
     static constexpr size_t x_dimension = 6;
     static constexpr size_t x_numBasePoints = 1 << x_dimension;
 
+    // Bitsliced base points: bit p of x_basePointsWithBit[i] is set iff base point p has bit i set.  A
+    // boolean function of the time slice is then a uint64_t with bit p holding its value at p, and logic
+    // over time slices is logic over these masks.
+    //
+    static constexpr uint64_t x_basePointsWithBit[x_dimension] = {
+        0xAAAAAAAAAAAAAAAAull,
+        0xCCCCCCCCCCCCCCCCull,
+        0xF0F0F0F0F0F0F0F0ull,
+        0xFF00FF00FF00FF00ull,
+        0xFFFF0000FFFF0000ull,
+        0xFFFFFFFF00000000ull,
+    };
+
     struct BitVector
     {
         BitVector()
@@ -102,6 +115,22 @@ struct HarmonicSheaf
         {
             return BitVector(m_bits & timeSlice.m_bits);
         }
+
+        // All time slices equivalent to timeSlice under the lens, as a mask over base points.
+        //
+        uint64_t ClassMask(BitVector timeSlice) const
+        {
+            uint64_t mask = ~0ull;
+            for (size_t i = 0; i < x_dimension; ++i)
+            {
+                if (m_bits & (1 << i))
+                {
+                    mask &= (timeSlice.m_bits & (1 << i)) ? x_basePointsWithBit[i] : ~x_basePointsWithBit[i];
+                }
+            }
+
+            return mask;
+        }
     };
 
     struct Section
@@ -403,31 +432,31 @@ struct HarmonicSheaf
         }
     };
 
+    // Visits the time slices in the lens class of defaultVector in increasing order, by walking the set bits
+    // of the class mask.
+    //
     struct TimeSliceClassIterator
     {
-        uint8_t m_ordinal = 0;
-        BitVector m_defaultVector;
-        TimeSliceClassOrdinalConverter m_converter;
+        uint64_t m_remaining;
 
         TimeSliceClassIterator(Lens lens, BitVector defaultVector)
-            : m_defaultVector(defaultVector)
-            , m_converter(lens)
+            : m_remaining(lens.ClassMask(defaultVector))
         {
         }
 
         BitVector Get()
         {
-            return m_converter.Convert(m_defaultVector, m_ordinal);
+            return BitVector(static_cast<uint8_t>(__builtin_ctzll(m_remaining)));
         }
         
         void Next()
         {
-            ++m_ordinal;
+            m_remaining &= m_remaining - 1;
         }
         
         bool Done()
         {
-            return (1 << m_converter.m_lensCoDimension) <= m_ordinal;
+            return m_remaining == 0;
         }        
     };
 
@@ -38,7 +38,9 @@ struct IoTaskElement
     void* m_sink;
     AudioBufferBank* m_audioBufferBank;
     AudioBufferBank* m_pendingDeleteAudioBufferBank;
-    RecordingBuffer* m_recordingBuffer;
+    RecordingTake m_recordingTake;
+    WorkerPool* m_workerPool;
+    SampleCache* m_sampleCache;
     bool m_createDirectory;
     int m_voiceID;
     char m_pathRelative[x_pathBufferSize];
@@ -57,7 +59,9 @@ struct IoTaskElement
         m_sink = nullptr;
         m_audioBufferBank = nullptr;
         m_pendingDeleteAudioBufferBank = nullptr;
-        m_recordingBuffer = nullptr;
+        m_recordingTake = RecordingTake();
+        m_workerPool = nullptr;
+        m_sampleCache = nullptr;
         m_createDirectory = false;
         m_voiceID = -1;
         std::memset(m_pathRelative, 0, x_pathBufferSize);
@@ -129,11 +133,11 @@ struct IoTaskElement
         m_audioBufferBank = audioBufferBank;
     }
 
-    void SetPersistRecording(const char* relativePath, RecordingBuffer* recordingBuffer, bool createDirectory, void* sink, int voiceID)
+    void SetPersistRecording(const char* relativePath, const RecordingTake& recordingTake, bool createDirectory, void* sink, int voiceID)
     {
         Reset();
         m_taskType = TaskType::PersistRecording;
-        m_recordingBuffer = recordingBuffer;
+        m_recordingTake = recordingTake;
         m_createDirectory = createDirectory;
         m_voiceID = voiceID;
         m_sink = sink;
@@ -189,24 +193,17 @@ struct IoTaskElement
         static constexpr const char* x_prefix = "_recording_";
         static constexpr size_t x_prefixSize = 11;
 
-        if (fileName.size() <= x_prefixSize + 4)
-        {
-            return false;
-        }
-
         if (fileName.compare(0, x_prefixSize, x_prefix) != 0)
         {
             return false;
         }
 
-        size_t extensionOffset = fileName.size() - 4;
-        bool wavExtension =
-            fileName[extensionOffset] == '.'
-            && (fileName[extensionOffset + 1] == 'w' || fileName[extensionOffset + 1] == 'W')
-            && (fileName[extensionOffset + 2] == 'a' || fileName[extensionOffset + 2] == 'A')
-            && (fileName[extensionOffset + 3] == 'v' || fileName[extensionOffset + 3] == 'V');
-
-        if (!wavExtension)
+        // PCM and lossless takes share one sequence of indices.
+        //
+        size_t extensionOffset = fileName.rfind('.');
+        if (extensionOffset == std::string::npos
+            || extensionOffset <= x_prefixSize
+            || !WavReader::IsReadableFileName(fileName.c_str()))
         {
             return false;
         }
@@ -270,7 +267,7 @@ struct IoTaskElement
         return highestIndex + 1;
     }
 
-    std::filesystem::path MakeNextRecordingFilePath(const std::filesystem::path& dirPath, std::error_code& ec) const
+    std::filesystem::path MakeNextRecordingFilePath(const std::filesystem::path& dirPath, const char* extension, std::error_code& ec) const
     {
         size_t nextIndex = FindNextRecordingFileIndex(dirPath, ec);
         if (ec)
@@ -282,7 +279,7 @@ struct IoTaskElement
         {
             char suffix[32];
             std::snprintf(suffix, sizeof(suffix), "%05zu", nextIndex);
-            std::filesystem::path filePath = dirPath / (std::string("_recording_") + suffix + ".wav");
+            std::filesystem::path filePath = dirPath / (std::string("_recording_") + suffix + extension);
 
             bool exists = std::filesystem::exists(filePath, ec);
             if (ec || !exists)
@@ -296,7 +293,7 @@ struct IoTaskElement
 
     void ProcessPersistRecording(const std::filesystem::path& rootPath)
     {
-        if (rootPath.empty() || m_recordingBuffer == nullptr)
+        if (rootPath.empty() || m_recordingTake.IsEmpty())
         {
             return;
         }
@@ -354,7 +351,8 @@ struct IoTaskElement
             return;
         }
 
-        std::filesystem::path filePath = MakeNextRecordingFilePath(dirPath, ec);
+        const char* extension = m_recordingTake.m_lossless ? LosslessCodec::x_fileExtension : ".wav";
+        std::filesystem::path filePath = MakeNextRecordingFilePath(dirPath, extension, ec);
         if (ec)
         {
             return;
@@ -365,7 +363,7 @@ struct IoTaskElement
             return;
         }
 
-        bool writeSuccess = m_recordingBuffer->WriteToFile(filePath.string().c_str());
+        bool writeSuccess = m_recordingTake.WriteToFile(filePath.string().c_str(), m_workerPool);
         if (!writeSuccess)
         {
             return;
@@ -388,7 +386,7 @@ struct IoTaskElement
         }
 
         AudioBufferBank* audioBufferBank = new AudioBufferBank();
-        audioBufferBank->LoadFromDirectory(absolutePath.c_str(), relativePath.c_str(), nullptr);
+        audioBufferBank->LoadFromDirectory(absolutePath.c_str(), relativePath.c_str(), nullptr, m_workerPool, m_sampleCache);
         m_result = audioBufferBank;
     }
 
@@ -408,7 +406,7 @@ struct IoTaskElement
             return;
         }
 
-        m_result = m_audioBufferBank->ReloadFromDirectory(absolutePath.c_str(), relativePath.c_str());
+        m_result = m_audioBufferBank->ReloadFromDirectory(absolutePath.c_str(), relativePath.c_str(), m_workerPool, m_sampleCache);
     }
 
     void InstallAudioBufferBankIntoSink(AudioBufferBank* audioBufferBank)
@@ -443,18 +441,13 @@ struct IoTaskElement
         m_result = nullptr;
     }
 
-    void AcknowledgePersistRecording()
-    {
-        if (!m_recordingBuffer)
-        {
-            return;
-        }
-
-        m_recordingBuffer->Reset();
-    }
-
-    void Process(const std::filesystem::path& rootPath)
+    // Bank loads hand all but their first file to workerPool when one is given, and share buffers through
+    // sampleCache.  Deleting a bank trims the cache, so evicted buffers are freed here too.
+    //
+    void Process(const std::filesystem::path& rootPath, WorkerPool* workerPool = nullptr, SampleCache* sampleCache = nullptr)
     {
+        m_workerPool = workerPool;
+        m_sampleCache = sampleCache;
         switch (m_taskType)
         {
             case TaskType::DirectoryExplorerCommand:
@@ -511,12 +504,20 @@ struct IoTaskElement
                     m_audioBufferBank = nullptr;
                 }
 
+                if (m_sampleCache)
+                {
+                    m_sampleCache->Trim();
+                }
+
                 break;
             }
 
             case TaskType::PersistRecording:
             {
+                // The take's chunks go back to the pool whether or not the write succeeded.
+                //
                 ProcessPersistRecording(rootPath);
+                m_recordingTake.Release();
                 break;
             }
 
@@ -547,11 +548,6 @@ struct IoTaskElement
         {
             AcknowledgeAudioBufferBankIntoSink();
         }
-
-        if (m_taskType == TaskType::PersistRecording)
-        {
-            AcknowledgePersistRecording();
-        }
     }
 };
 
@@ -563,27 +559,50 @@ struct IoTaskThread
     CircularQueue<IoTaskElement, x_queueSize> m_acknowledgmentQueue;
     std::atomic<bool> m_running;
     std::filesystem::path m_sampleDirectoryRootAbsolute;
+    WakeSignal m_wake;
+    WorkerPool m_workerPool;
+    bool m_refillUser;
     std::thread m_thread;
 
+    // The recording chunk pool refills on its own thread, not this one, so tasks here cannot starve a take.
+    //
     IoTaskThread()
         : m_running(true)
         , m_sampleDirectoryRootAbsolute()
+        , m_refillUser(true)
         , m_thread(&IoTaskThread::Run, this)
     {
+        RecordingChunkPool::s_instance.Refill();
+        RecordingChunkPool::s_instance.AddRefillUser();
     }
 
     // Stop and join the worker thread. Idempotent. Owners that hold objects the
-    // in-flight tasks reference (recording buffers, sample banks) should call
+    // in-flight tasks reference (sample banks, directory explorers) should call
     // this before tearing those objects down, otherwise a task still executing
-    // on the worker thread dereferences freed memory.
+    // on the worker thread dereferences freed memory. Recording takes still
+    // queued are dropped and their chunks returned to the pool.
     //
     void Shutdown()
     {
         m_running.store(false);
+        m_wake.Signal();
         if (m_thread.joinable())
         {
             m_thread.join();
         }
+
+        IoTaskElement task;
+        while (m_taskQueue.Pop(task))
+        {
+            task.m_recordingTake.Release();
+        }
+
+        m_workerPool.Shutdown();
+        if (m_refillUser)
+        {
+            RecordingChunkPool::s_instance.RemoveRefillUser();
+            m_refillUser = false;
+        }
     }
 
     ~IoTaskThread()
@@ -591,18 +610,29 @@ struct IoTaskThread
         Shutdown();
     }
 
+    bool PushTask(const IoTaskElement& task)
+    {
+        if (!m_taskQueue.Push(task))
+        {
+            return false;
+        }
+
+        m_wake.Signal();
+        return true;
+    }
+
     bool PushDirectoryExplorerCommand(DirectoryExplorer* directoryExplorer, DirectoryExplorer::MessageType messageType)
     {
         IoTaskElement task;
         task.SetDirectoryExplorerCommand(directoryExplorer, messageType);
-        return m_taskQueue.Push(task);
+        return PushTask(task);
     }
 
     bool PushDirectoryExplorerCommand(DirectoryExplorer* directoryExplorer, DirectoryExplorer::MessageType messageType, AudioBufferBank** audioBufferBankSink)
     {
         IoTaskElement task;
         task.SetDirectoryExplorerCommand(directoryExplorer, messageType, audioBufferBankSink);
-        return m_taskQueue.Push(task);
+        return PushTask(task);
     }
 
     void SetSampleDirectoryRootAbsolute(const std::filesystem::path& absolutePath)
@@ -619,35 +649,37 @@ struct IoTaskThread
     {
         IoTaskElement task;
         task.SetDirectoryExplorerInit(relativePath, directoryExplorer);
-        return m_taskQueue.Push(task);
+        return PushTask(task);
     }
 
     bool PushLoadAudioBufferBankFromDirectory(const char* relativePath, AudioBufferBank** sink)
     {
         IoTaskElement task;
         task.SetLoadAudioBufferBankFromDirectory(relativePath, sink);
-        return m_taskQueue.Push(task);
+        return PushTask(task);
     }
 
     bool PushReloadDirectory(const char* relativePath, AudioBufferBank** sink)
     {
         IoTaskElement task;
         task.SetReloadDirectory(relativePath, sink);
-        return m_taskQueue.Push(task);
+        return PushTask(task);
     }
 
     bool PushDeleteAudioBuffer(AudioBufferBank* audioBufferBank)
     {
         IoTaskElement task;
         task.SetDeleteAudioBuffer(audioBufferBank);
-        return m_taskQueue.Push(task);
+        return PushTask(task);
     }
 
-    bool PushPersistRecording(const char* relativePath, RecordingBuffer* recordingBuffer, bool createDirectory, void* sink, int voiceID)
+    // On success the task owns the take's chunks; on failure the caller still does.
+    //
+    bool PushPersistRecording(const char* relativePath, const RecordingTake& recordingTake, bool createDirectory, void* sink, int voiceID)
     {
         IoTaskElement task;
-        task.SetPersistRecording(relativePath, recordingBuffer, createDirectory, sink, voiceID);
-        return m_taskQueue.Push(task);
+        task.SetPersistRecording(relativePath, recordingTake, createDirectory, sink, voiceID);
+        return PushTask(task);
     }
 
     void Run()
@@ -659,12 +691,12 @@ struct IoTaskThread
             IoTaskElement task;
             if (m_taskQueue.Pop(task))
             {
-                task.Process(m_sampleDirectoryRootAbsolute);
+                task.Process(m_sampleDirectoryRootAbsolute, &m_workerPool, &SampleCache::s_instance);
                 PushAcknowledgment(task);
             }
             else
             {
-                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                m_wake.Wait();
             }
         }
     }
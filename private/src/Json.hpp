@@ -14,11 +14,19 @@
 // (arena.Failed() or root.IsNull()). The owning (message) thread then frees the
 // arena, doubles its capacity, and retries.
 
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <cstdio>
 #include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 // ---------------------------------------------------------------------------
 // Compatibility shims for the former jansson/JuceSon surface.
@@ -184,6 +192,13 @@ struct JSON
     //
     char* Dumps(size_t flags) const;
 
+    // Streams the same text to any sink with FileWriter's
+    // size_t Write(const uint8_t*, size_t), in 4 KB chunks. Returns false (and
+    // writes nothing) on a null tree.
+    //
+    template<typename Sink>
+    bool DumpTo(Sink& sink) const;
+
     // Parsing convenience kept on JSON for source-compat at call sites that have
     // an arena in scope is provided by JsonArena::Loads (see below). A JSON-level
     // static parse needs an arena, so it is intentionally NOT offered here.
@@ -563,162 +578,641 @@ inline size_t JSON::Size() const
 }
 
 // ---------------------------------------------------------------------------
-// Serialization
+// Serialization (streaming)
 // ---------------------------------------------------------------------------
 namespace JsonDetail
 {
 
-inline void DumpString(std::string& out, const char* s)
+// Buffers output in fixed chunks and hands each full chunk to a sink with
+// FileWriter's signature, size_t Write(const uint8_t*, size_t), so a document
+// streams to its destination without being assembled as one string first.
+//
+template<typename Sink>
+struct Writer
 {
-    out.push_back('"');
-    for (const unsigned char* p = reinterpret_cast<const unsigned char*>(s); *p; ++p)
-    {
-        unsigned char c = *p;
-        switch (c)
-        {
-            case '"':  out += "\\\""; break;
-            case '\\': out += "\\\\"; break;
-            case '\b': out += "\\b";  break;
-            case '\f': out += "\\f";  break;
-            case '\n': out += "\\n";  break;
-            case '\r': out += "\\r";  break;
-            case '\t': out += "\\t";  break;
-            default:
-                if (c < 0x20)
-                {
-                    char buf[8];
-                    snprintf(buf, sizeof(buf), "\\u%04x", c);
-                    out += buf;
-                }
-                else
-                {
-                    out.push_back(static_cast<char>(c));
-                }
-                break;
+    static constexpr size_t x_bufferSize = 4096;
+
+    Sink& m_sink;
+    size_t m_size;
+    char m_buffer[x_bufferSize];
+
+    explicit Writer(Sink& sink)
+        : m_sink(sink)
+        , m_size(0)
+    {
+    }
+
+    void Flush()
+    {
+        if (m_size)
+        {
+            m_sink.Write(reinterpret_cast<const uint8_t*>(m_buffer), m_size);
+            m_size = 0;
         }
     }
-    out.push_back('"');
-}
 
-inline void DumpValue(std::string& out, const JsonNode* node)
-{
-    if (!node)
+    void Put(char c)
     {
-        out += "null";
-        return;
+        if (m_size == x_bufferSize)
+        {
+            Flush();
+        }
+
+        m_buffer[m_size++] = c;
+    }
+
+    void Put(const char* s, size_t n)
+    {
+        if (n > x_bufferSize - m_size)
+        {
+            Flush();
+            if (n > x_bufferSize)
+            {
+                m_sink.Write(reinterpret_cast<const uint8_t*>(s), n);
+                return;
+            }
+        }
+
+        memcpy(m_buffer + m_size, s, n);
+        m_size += n;
     }
 
-    switch (node->m_type)
+    // Same text as snprintf("%lld").
+    //
+    void PutInteger(int64_t value)
     {
-        case JsonType::Null:
-            out += "null";
-            break;
-        case JsonType::Boolean:
-            out += node->m_bool ? "true" : "false";
-            break;
-        case JsonType::Integer:
+        char buf[24];
+        char* end = buf + sizeof(buf);
+        char* p = end;
+        uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+        do
         {
-            char buf[32];
-            snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(node->m_int));
-            out += buf;
-            break;
+            *--p = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
         }
-        case JsonType::Real:
+        while (magnitude);
+
+        if (value < 0)
         {
-            char buf[32];
-            snprintf(buf, sizeof(buf), "%.17g", node->m_real);
-            out += buf;
-            break;
+            *--p = '-';
         }
-        case JsonType::String:
-            DumpString(out, node->m_str ? node->m_str : "");
-            break;
-        case JsonType::Array:
+
+        Put(p, static_cast<size_t>(end - p));
+    }
+
+    // Runs of characters that need no escaping are copied in one go.
+    //
+    void PutString(const char* s)
+    {
+        Put('"');
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(s);
+        while (*p)
         {
-            out.push_back('[');
-            const JsonContainer& c = node->m_container;
-            JsonNode* const* values = static_cast<JsonNode* const*>(c.m_entries);
-            for (uint32_t i = 0; i < c.m_size; ++i)
+            const unsigned char* run = p;
+            while (*p >= 0x20 && *p != '"' && *p != '\\')
             {
-                if (i)
+                ++p;
+            }
+
+            Put(reinterpret_cast<const char*>(run), static_cast<size_t>(p - run));
+            if (!*p)
+            {
+                break;
+            }
+
+            unsigned char c = *p++;
+            switch (c)
+            {
+                case '"':  Put("\\\"", 2); break;
+                case '\\': Put("\\\\", 2); break;
+                case '\b': Put("\\b", 2);  break;
+                case '\f': Put("\\f", 2);  break;
+                case '\n': Put("\\n", 2);  break;
+                case '\r': Put("\\r", 2);  break;
+                case '\t': Put("\\t", 2);  break;
+                default:
                 {
-                    out.push_back(',');
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    Put(buf, 6);
+                    break;
                 }
-                DumpValue(out, values[i]);
             }
-            out.push_back(']');
-            break;
         }
-        case JsonType::Object:
+
+        Put('"');
+    }
+
+    void PutValue(const JsonNode* node)
+    {
+        if (!node)
+        {
+            Put("null", 4);
+            return;
+        }
+
+        switch (node->m_type)
         {
-            out.push_back('{');
-            const JsonContainer& c = node->m_container;
-            const JsonMember* members = static_cast<const JsonMember*>(c.m_entries);
-            for (uint32_t i = 0; i < c.m_size; ++i)
+            case JsonType::Null:
+                Put("null", 4);
+                break;
+            case JsonType::Boolean:
+                node->m_bool ? Put("true", 4) : Put("false", 5);
+                break;
+            case JsonType::Integer:
+                PutInteger(node->m_int);
+                break;
+            case JsonType::Real:
+            {
+                char buf[32];
+                int n = snprintf(buf, sizeof(buf), "%.17g", node->m_real);
+                Put(buf, static_cast<size_t>(n));
+                break;
+            }
+            case JsonType::String:
+                PutString(node->m_str ? node->m_str : "");
+                break;
+            case JsonType::Array:
+            {
+                Put('[');
+                const JsonContainer& c = node->m_container;
+                JsonNode* const* values = static_cast<JsonNode* const*>(c.m_entries);
+                for (uint32_t i = 0; i < c.m_size; ++i)
+                {
+                    if (i)
+                    {
+                        Put(',');
+                    }
+                    PutValue(values[i]);
+                }
+                Put(']');
+                break;
+            }
+            case JsonType::Object:
             {
-                if (i)
+                Put('{');
+                const JsonContainer& c = node->m_container;
+                const JsonMember* members = static_cast<const JsonMember*>(c.m_entries);
+                for (uint32_t i = 0; i < c.m_size; ++i)
                 {
-                    out.push_back(',');
+                    if (i)
+                    {
+                        Put(',');
+                    }
+                    PutString(members[i].m_key ? members[i].m_key : "");
+                    Put(':');
+                    PutValue(members[i].m_value);
                 }
-                DumpString(out, members[i].m_key ? members[i].m_key : "");
-                out.push_back(':');
-                DumpValue(out, members[i].m_value);
+                Put('}');
+                break;
             }
-            out.push_back('}');
-            break;
         }
     }
-}
+};
+
+// Sink for Dumps: grows one malloc'd block, so the result needs no final copy.
+//
+struct MallocSink
+{
+    char* m_data;
+    size_t m_size;
+    size_t m_cap;
+    bool m_failed;
+
+    MallocSink()
+        : m_data(nullptr)
+        , m_size(0)
+        , m_cap(0)
+        , m_failed(false)
+    {
+    }
+
+    size_t Write(const uint8_t* data, size_t length)
+    {
+        if (m_failed)
+        {
+            return 0;
+        }
+
+        if (m_size + length + 1 > m_cap)
+        {
+            size_t cap = m_cap ? m_cap : 4096;
+            while (m_size + length + 1 > cap)
+            {
+                cap *= 2;
+            }
+
+            char* grown = static_cast<char*>(realloc(m_data, cap));
+            if (!grown)
+            {
+                m_failed = true;
+                return 0;
+            }
+
+            m_data = grown;
+            m_cap = cap;
+        }
+
+        memcpy(m_data + m_size, data, length);
+        m_size += length;
+        return length;
+    }
+};
+
+// Sink that appends to a std::string.
+//
+struct StringSink
+{
+    std::string& m_out;
+
+    explicit StringSink(std::string& out)
+        : m_out(out)
+    {
+    }
+
+    size_t Write(const uint8_t* data, size_t length)
+    {
+        m_out.append(reinterpret_cast<const char*>(data), length);
+        return length;
+    }
+};
+
+// Sink that writes straight to a file, for synchronous saves.  Close reports whether every byte reached the file.
+//
+struct FileSink
+{
+    FILE* m_file;
+    bool m_failed;
+
+    explicit FileSink(const char* path)
+        : m_file(fopen(path, "wb"))
+        , m_failed(m_file == nullptr)
+    {
+    }
+
+    ~FileSink()
+    {
+        Close();
+    }
+
+    FileSink(const FileSink&) = delete;
+    FileSink& operator=(const FileSink&) = delete;
+
+    size_t Write(const uint8_t* data, size_t length)
+    {
+        if (m_failed)
+        {
+            return 0;
+        }
+
+        size_t written = fwrite(data, 1, length, m_file);
+        m_failed = written != length;
+        return written;
+    }
+
+    bool Close()
+    {
+        if (m_file)
+        {
+            m_failed = fclose(m_file) != 0 || m_failed;
+            m_file = nullptr;
+        }
+
+        return !m_failed;
+    }
+};
 
 } // namespace JsonDetail
 
-inline char* JSON::Dumps(size_t flags) const
+template<typename Sink>
+inline bool JSON::DumpTo(Sink& sink) const
 {
     if (!m_node)
     {
-        return nullptr;
+        return false;
     }
 
-    std::string out;
-    JsonDetail::DumpValue(out, m_node);
+    JsonDetail::Writer<Sink> writer(sink);
+    writer.PutValue(m_node);
+    writer.Flush();
+    return true;
+}
 
-    char* result = static_cast<char*>(malloc(out.size() + 1));
-    if (!result)
+inline char* JSON::Dumps(size_t flags) const
+{
+    JsonDetail::MallocSink sink;
+    if (!DumpTo(sink) || sink.m_failed)
     {
+        free(sink.m_data);
         return nullptr;
     }
 
-    memcpy(result, out.data(), out.size());
-    result[out.size()] = '\0';
-    return result;
+    // A non-null tree always writes something, so the block exists and has room for the terminator.
+    //
+    sink.m_data[sink.m_size] = '\0';
+    return sink.m_data;
 }
 
 // ---------------------------------------------------------------------------
-// Parsing (recursive descent)
+// Parsing, in two stages
 // ---------------------------------------------------------------------------
+// Stage 1 (StructuralIndex) classifies the text 64 bytes at a time, with SSE2
+// or NEON where available, and records the offset of every token: each
+// structural character and quote outside strings, and the first byte of each
+// number or literal. Stage 2 (Parser) walks that list recursively, so it
+// never skips whitespace or scans string bodies byte by byte; a string's
+// closing quote is simply the token after its opening one.
+//
 namespace JsonDetail
 {
 
-struct Parser
+struct StructuralIndex
 {
-    const char* m_p;
-    JsonArena* m_arena;
-    bool m_error;
+#if defined(__SSE2__) || defined(_M_X64)
+    static constexpr bool x_simd = true;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    static constexpr bool x_simd = true;
+#else
+    static constexpr bool x_simd = false;
+#endif
 
-    Parser(const char* p, JsonArena* arena)
-        : m_p(p)
-        , m_arena(arena)
-        , m_error(false)
+    static constexpr size_t x_blockSize = 64;
+
+    // One bit per byte of a block.
+    //
+    struct BlockMasks
+    {
+        uint64_t m_quote;
+        uint64_t m_backslash;
+        uint64_t m_structural;
+        uint64_t m_space;
+    };
+
+    // Sized for the worst case of one token per byte and reused between
+    // builds; only the first m_numTokens entries are valid.
+    //
+    std::vector<uint32_t> m_tokens;
+    size_t m_numTokens = 0;
+
+    // Indexes input[0, length). Returns false for an unterminated string or a
+    // text too long for 32-bit offsets.
+    //
+    bool Build(const char* input, size_t length, bool simd = x_simd)
+    {
+        m_numTokens = 0;
+        if (length > UINT32_MAX - x_blockSize)
+        {
+            return false;
+        }
+
+        if (m_tokens.size() < length + x_blockSize)
+        {
+            m_tokens.resize(length + x_blockSize);
+        }
+
+        uint64_t escapeCarry = 0;
+        uint64_t stringCarry = 0;
+        uint64_t scalarCarry = 0;
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(input);
+        size_t offset = 0;
+        for (; offset + x_blockSize <= length; offset += x_blockSize)
+        {
+            BlockMasks masks;
+            simd ? Classify(bytes + offset, masks) : ClassifyScalar(bytes + offset, masks);
+            AddTokens(masks, static_cast<uint32_t>(offset), escapeCarry, stringCarry, scalarCarry);
+        }
+
+        if (offset < length)
+        {
+            // Pad the tail with whitespace, which adds no tokens.
+            //
+            unsigned char tail[x_blockSize];
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, bytes + offset, length - offset);
+            BlockMasks masks;
+            simd ? Classify(tail, masks) : ClassifyScalar(tail, masks);
+            AddTokens(masks, static_cast<uint32_t>(offset), escapeCarry, stringCarry, scalarCarry);
+        }
+
+        return stringCarry == 0;
+    }
+
+    static void ClassifyScalar(const unsigned char* block, BlockMasks& masks)
+    {
+        masks = BlockMasks{0, 0, 0, 0};
+        for (size_t i = 0; i < x_blockSize; ++i)
+        {
+            uint64_t bit = uint64_t(1) << i;
+            switch (block[i])
+            {
+                case '"':  masks.m_quote |= bit; break;
+                case '\\': masks.m_backslash |= bit; break;
+                case '{': case '}': case '[': case ']': case ':': case ',':
+                    masks.m_structural |= bit;
+                    break;
+                case ' ': case '\t': case '\n': case '\r':
+                    masks.m_space |= bit;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+#if defined(__SSE2__) || defined(_M_X64)
+    static void Classify(const unsigned char* block, BlockMasks& masks)
+    {
+        masks = BlockMasks{0, 0, 0, 0};
+        for (size_t i = 0; i < x_blockSize; i += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+
+            // Setting bit 5 folds '[' onto '{' and ']' onto '}'.
+            //
+            __m128i folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+            __m128i structural = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'))),
+                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')), _mm_cmpeq_epi8(v, _mm_set1_epi8(','))));
+            __m128i space = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+
+            masks.m_quote |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('"'))))) << i;
+            masks.m_backslash |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))))) << i;
+            masks.m_structural |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(structural))) << i;
+            masks.m_space |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(space))) << i;
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    // NEON has no movemask: weight each lane by its bit and add across the halves.
+    //
+    static uint64_t MoveMask(uint8x16_t matches)
     {
+        static const uint8_t x_weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+        uint8x16_t weighted = vandq_u8(matches, vld1q_u8(x_weights));
+        return static_cast<uint64_t>(vaddv_u8(vget_low_u8(weighted)))
+            | (static_cast<uint64_t>(vaddv_u8(vget_high_u8(weighted))) << 8);
     }
 
-    void SkipWs()
+    static void Classify(const unsigned char* block, BlockMasks& masks)
     {
-        while (*m_p == ' ' || *m_p == '\t' || *m_p == '\n' || *m_p == '\r')
+        masks = BlockMasks{0, 0, 0, 0};
+        for (size_t i = 0; i < x_blockSize; i += 16)
         {
-            ++m_p;
+            uint8x16_t v = vld1q_u8(block + i);
+
+            // Setting bit 5 folds '[' onto '{' and ']' onto '}'.
+            //
+            uint8x16_t folded = vorrq_u8(v, vdupq_n_u8(0x20));
+            uint8x16_t structural = vorrq_u8(
+                vorrq_u8(vceqq_u8(folded, vdupq_n_u8('{')), vceqq_u8(folded, vdupq_n_u8('}'))),
+                vorrq_u8(vceqq_u8(v, vdupq_n_u8(':')), vceqq_u8(v, vdupq_n_u8(','))));
+            uint8x16_t space = vorrq_u8(
+                vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')), vceqq_u8(v, vdupq_n_u8('\t'))),
+                vorrq_u8(vceqq_u8(v, vdupq_n_u8('\n')), vceqq_u8(v, vdupq_n_u8('\r'))));
+
+            masks.m_quote |= MoveMask(vceqq_u8(v, vdupq_n_u8('"'))) << i;
+            masks.m_backslash |= MoveMask(vceqq_u8(v, vdupq_n_u8('\\'))) << i;
+            masks.m_structural |= MoveMask(structural) << i;
+            masks.m_space |= MoveMask(space) << i;
         }
     }
+#else
+    static void Classify(const unsigned char* block, BlockMasks& masks)
+    {
+        ClassifyScalar(block, masks);
+    }
+#endif
+
+    // Inclusive prefix XOR: bit i is the parity of bits [0, i].
+    //
+    static uint64_t PrefixXor(uint64_t bits)
+    {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    // Bytes escaped by a backslash. Backslashes are rare in patch files, so
+    // this walks them one by one. carry is 1 when the previous block ended in
+    // an escaping backslash.
+    //
+    static uint64_t EscapedMask(uint64_t backslash, uint64_t& carry)
+    {
+        uint64_t escaped = carry;
+        backslash &= ~carry;
+        carry = 0;
+        while (backslash)
+        {
+            uint64_t bit = backslash & (0 - backslash);
+            if (bit >> 63)
+            {
+                carry = 1;
+            }
+
+            escaped |= bit << 1;
+            backslash &= ~(bit | (bit << 1));
+        }
+
+        return escaped;
+    }
+
+    void AddTokens(const BlockMasks& masks, uint32_t offset, uint64_t& escapeCarry, uint64_t& stringCarry, uint64_t& scalarCarry)
+    {
+        uint64_t quote = masks.m_quote & ~EscapedMask(masks.m_backslash, escapeCarry);
+
+        // Set from each opening quote up to, not including, its closing quote.
+        //
+        uint64_t inString = PrefixXor(quote) ^ stringCarry;
+        stringCarry = 0 - (inString >> 63);
+
+        uint64_t structural = masks.m_structural & ~inString;
+        uint64_t scalar = ~(masks.m_structural | masks.m_space | quote | inString);
+        uint64_t scalarStart = scalar & ~((scalar << 1) | scalarCarry);
+        scalarCarry = scalar >> 63;
+
+        uint64_t tokens = structural | quote | scalarStart;
+        uint32_t* out = m_tokens.data() + m_numTokens;
+        m_numTokens += static_cast<size_t>(__builtin_popcountll(tokens));
+        while (tokens)
+        {
+            *out++ = offset + static_cast<uint32_t>(__builtin_ctzll(tokens));
+            tokens &= tokens - 1;
+        }
+    }
+};
+
+// Buffers kept per thread between parses: the token index, and the stacks
+// that collect each container's entries until it closes, so that every
+// container gets one exactly-sized block instead of growing by copies.
+//
+// The token index costs four bytes per input byte, so anything grown past
+// x_retainedEntries by one large text is freed after that parse instead of
+// staying pinned for the life of the thread. Patch-sized texts fit well
+// under it and keep reusing the same buffers.
+//
+struct ParseScratch
+{
+    static constexpr size_t x_retainedEntries = 1 << 18;
+
+    StructuralIndex m_index;
+    std::vector<JsonNode*> m_values;
+    std::vector<JsonMember> m_members;
+
+    static ParseScratch& ForThread()
+    {
+        static thread_local ParseScratch scratch;
+        return scratch;
+    }
+
+    void Trim()
+    {
+        if (m_index.m_tokens.capacity() > x_retainedEntries)
+        {
+            std::vector<uint32_t>().swap(m_index.m_tokens);
+            m_index.m_numTokens = 0;
+        }
+
+        if (m_values.capacity() > x_retainedEntries)
+        {
+            std::vector<JsonNode*>().swap(m_values);
+        }
+
+        if (m_members.capacity() > x_retainedEntries)
+        {
+            std::vector<JsonMember>().swap(m_members);
+        }
+    }
+};
+
+struct Parser
+{
+    const char* m_input;
+    const uint32_t* m_tokens;
+    size_t m_numTokens;
+    size_t m_next;
+    size_t m_length;
+    std::vector<JsonNode*>& m_values;
+    std::vector<JsonMember>& m_members;
+    JsonArena* m_arena;
+    bool m_error;
+
+    Parser(const char* input, size_t length, ParseScratch& scratch, JsonArena* arena)
+        : m_input(input)
+        , m_tokens(scratch.m_index.m_tokens.data())
+        , m_numTokens(scratch.m_index.m_numTokens)
+        , m_next(0)
+        , m_length(length)
+        , m_values(scratch.m_values)
+        , m_members(scratch.m_members)
+        , m_arena(arena)
+        , m_error(false)
+    {
+    }
 
     JSON Fail()
     {
@@ -726,140 +1220,188 @@ struct Parser
         return JSON::Null();
     }
 
-    static void EncodeUtf8(std::string& out, uint32_t cp)
+    // The character of the next token, or NUL at the end.
+    //
+    char Peek() const
+    {
+        return m_next < m_numTokens ? m_input[m_tokens[m_next]] : '\0';
+    }
+
+    bool AtEnd() const
+    {
+        return m_next == m_numTokens;
+    }
+
+    static size_t EncodeUtf8(char* out, uint32_t cp)
     {
         if (cp < 0x80)
         {
-            out.push_back(static_cast<char>(cp));
+            out[0] = static_cast<char>(cp);
+            return 1;
         }
         else if (cp < 0x800)
         {
-            out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
-            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            out[0] = static_cast<char>(0xC0 | (cp >> 6));
+            out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+            return 2;
         }
         else if (cp < 0x10000)
         {
-            out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
-            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
-            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            out[0] = static_cast<char>(0xE0 | (cp >> 12));
+            out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+            return 3;
         }
         else
         {
-            out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
-            out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
-            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
-            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            out[0] = static_cast<char>(0xF0 | (cp >> 18));
+            out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+            return 4;
         }
     }
 
-    bool ParseHex4(uint32_t& out)
+    static bool ParseHex4(const char*& p, uint32_t& out)
     {
         out = 0;
         for (int i = 0; i < 4; ++i)
         {
-            char c = *m_p;
+            char c = *p;
             uint32_t d;
             if (c >= '0' && c <= '9') d = c - '0';
             else if (c >= 'a' && c <= 'f') d = c - 'a' + 10;
             else if (c >= 'A' && c <= 'F') d = c - 'A' + 10;
             else return false;
             out = (out << 4) | d;
-            ++m_p;
+            ++p;
         }
         return true;
     }
 
-    // Parses a string literal (m_p is at the opening quote) into the arena.
-    // Returns the arena copy, or nullptr on error/exhaustion.
+    // Decodes the escaped body [p, end) into dst, which has room for end - p
+    // bytes (no escape expands). Returns the decoded length, or -1 on a bad
+    // escape.
     //
-    const char* ParseRawString()
+    static ptrdiff_t Unescape(const char* p, const char* end, char* dst)
     {
-        if (*m_p != '"')
+        char* out = dst;
+        while (p < end)
         {
-            m_error = true;
-            return nullptr;
-        }
-        ++m_p;
+            if (*p != '\\')
+            {
+                *out++ = *p++;
+                continue;
+            }
 
-        std::string buf;
-        while (*m_p && *m_p != '"')
-        {
-            unsigned char c = static_cast<unsigned char>(*m_p);
-            if (c == '\\')
+            ++p;
+            switch (*p)
             {
-                ++m_p;
-                switch (*m_p)
+                case '"':  *out++ = '"';  ++p; break;
+                case '\\': *out++ = '\\'; ++p; break;
+                case '/':  *out++ = '/';  ++p; break;
+                case 'b':  *out++ = '\b'; ++p; break;
+                case 'f':  *out++ = '\f'; ++p; break;
+                case 'n':  *out++ = '\n'; ++p; break;
+                case 'r':  *out++ = '\r'; ++p; break;
+                case 't':  *out++ = '\t'; ++p; break;
+                case 'u':
                 {
-                    case '"':  buf.push_back('"');  ++m_p; break;
-                    case '\\': buf.push_back('\\'); ++m_p; break;
-                    case '/':  buf.push_back('/');  ++m_p; break;
-                    case 'b':  buf.push_back('\b'); ++m_p; break;
-                    case 'f':  buf.push_back('\f'); ++m_p; break;
-                    case 'n':  buf.push_back('\n'); ++m_p; break;
-                    case 'r':  buf.push_back('\r'); ++m_p; break;
-                    case 't':  buf.push_back('\t'); ++m_p; break;
-                    case 'u':
+                    ++p;
+                    uint32_t cp;
+                    if (!ParseHex4(p, cp))
                     {
-                        ++m_p;
-                        uint32_t cp;
-                        if (!ParseHex4(cp))
-                        {
-                            m_error = true;
-                            return nullptr;
-                        }
-                        if (cp >= 0xD800 && cp <= 0xDBFF)
+                        return -1;
+                    }
+                    if (cp >= 0xD800 && cp <= 0xDBFF)
+                    {
+                        // High surrogate; expect a low surrogate.
+                        //
+                        if (p[0] == '\\' && p[1] == 'u')
                         {
-                            // High surrogate; expect a low surrogate.
-                            //
-                            if (m_p[0] == '\\' && m_p[1] == 'u')
+                            p += 2;
+                            uint32_t lo;
+                            if (!ParseHex4(p, lo))
                             {
-                                m_p += 2;
-                                uint32_t lo;
-                                if (!ParseHex4(lo))
-                                {
-                                    m_error = true;
-                                    return nullptr;
-                                }
-                                cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                                return -1;
                             }
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
                         }
-                        EncodeUtf8(buf, cp);
-                        break;
                     }
-                    default:
-                        m_error = true;
-                        return nullptr;
+                    out += EncodeUtf8(out, cp);
+                    break;
                 }
-            }
-            else
-            {
-                buf.push_back(static_cast<char>(c));
-                ++m_p;
+                default:
+                    return -1;
             }
         }
 
-        if (*m_p != '"')
+        return out - dst;
+    }
+
+    // Consumes a string's opening and closing quote tokens and copies the body
+    // into the arena. Returns the arena copy, or nullptr on error/exhaustion.
+    //
+    const char* ParseRawString()
+    {
+        if (Peek() != '"' || m_next + 1 >= m_numTokens)
         {
             m_error = true;
             return nullptr;
         }
-        ++m_p;
 
-        const char* copied = m_arena->CopyBytes(buf.data(), buf.size());
-        if (!copied)
+        const char* begin = m_input + m_tokens[m_next] + 1;
+        const char* end = m_input + m_tokens[m_next + 1];
+        m_next += 2;
+        size_t length = static_cast<size_t>(end - begin);
+        if (!memchr(begin, '\\', length))
+        {
+            const char* copied = m_arena->CopyBytes(begin, length);
+            if (!copied)
+            {
+                m_error = true;  // arena exhaustion
+            }
+            return copied;
+        }
+
+        char* dst = static_cast<char*>(m_arena->Alloc(length + 1, 1));
+        if (!dst)
         {
             m_error = true;  // arena exhaustion
+            return nullptr;
         }
-        return copied;
+
+        ptrdiff_t decoded = Unescape(begin, end, dst);
+        if (decoded < 0)
+        {
+            m_error = true;
+            return nullptr;
+        }
+
+        dst[decoded] = '\0';
+        return dst;
+    }
+
+    // A number or literal must end at whitespace, the next token, or the end of the text.
+    //
+    bool ScalarEndsAt(const char* p) const
+    {
+        const char* limit = m_input + (m_next < m_numTokens ? m_tokens[m_next] : m_length);
+        return p == limit || *p == ' ' || *p == '\t' || *p == '\n' || *p == '\r';
     }
 
     JSON ParseValue()
     {
-        SkipWs();
-        switch (*m_p)
+        if (AtEnd())
         {
-            case '{': return ParseObject();
-            case '[': return ParseArray();
+            return Fail();
+        }
+
+        const char* p = m_input + m_tokens[m_next];
+        switch (*p)
+        {
+            case '{': ++m_next; return ParseObject();
+            case '[': ++m_next; return ParseArray();
             case '"':
             {
                 const char* s = ParseRawString();
@@ -875,49 +1417,71 @@ struct Parser
                 node->m_str = s;
                 return JSON(node);
             }
-            case 't':
-                if (strncmp(m_p, "true", 4) == 0) { m_p += 4; JsonNode* n = m_arena->NewNode(JsonType::Boolean); if (!n) return Fail(); n->m_bool = true; return JSON(n); }
+            case '}': case ']': case ':': case ',':
                 return Fail();
+            default:
+                ++m_next;
+                return ParseScalar(p);
+        }
+    }
+
+    JSON ParseScalar(const char* p)
+    {
+        switch (*p)
+        {
+            case 't':
             case 'f':
-                if (strncmp(m_p, "false", 5) == 0) { m_p += 5; JsonNode* n = m_arena->NewNode(JsonType::Boolean); if (!n) return Fail(); n->m_bool = false; return JSON(n); }
-                return Fail();
+            {
+                bool value = *p == 't';
+                if (strncmp(p, value ? "true" : "false", value ? 4 : 5) != 0 || !ScalarEndsAt(p + (value ? 4 : 5))) return Fail();
+                JsonNode* n = m_arena->NewNode(JsonType::Boolean);
+                if (!n) return Fail();
+                n->m_bool = value;
+                return JSON(n);
+            }
             case 'n':
-                if (strncmp(m_p, "null", 4) == 0) { m_p += 4; JsonNode* n = m_arena->NewNode(JsonType::Null); if (!n) return Fail(); return JSON(n); }
-                return Fail();
+            {
+                if (strncmp(p, "null", 4) != 0 || !ScalarEndsAt(p + 4)) return Fail();
+                JsonNode* n = m_arena->NewNode(JsonType::Null);
+                if (!n) return Fail();
+                return JSON(n);
+            }
             default:
-                return ParseNumber();
+                return ParseNumber(p);
         }
     }
 
-    JSON ParseNumber()
+    JSON ParseNumber(const char* start)
     {
-        const char* start = m_p;
+        const char* p = start;
         bool isReal = false;
 
-        if (*m_p == '-')
+        if (*p == '-')
         {
-            ++m_p;
+            ++p;
         }
 
-        while ((*m_p >= '0' && *m_p <= '9'))
+        const char* digits = p;
+        while (*p >= '0' && *p <= '9')
         {
-            ++m_p;
+            ++p;
         }
-        if (*m_p == '.')
+        size_t numDigits = static_cast<size_t>(p - digits);
+        if (*p == '.')
         {
             isReal = true;
-            ++m_p;
-            while (*m_p >= '0' && *m_p <= '9') ++m_p;
+            ++p;
+            while (*p >= '0' && *p <= '9') ++p;
         }
-        if (*m_p == 'e' || *m_p == 'E')
+        if (*p == 'e' || *p == 'E')
         {
             isReal = true;
-            ++m_p;
-            if (*m_p == '+' || *m_p == '-') ++m_p;
-            while (*m_p >= '0' && *m_p <= '9') ++m_p;
+            ++p;
+            if (*p == '+' || *p == '-') ++p;
+            while (*p >= '0' && *p <= '9') ++p;
         }
 
-        if (m_p == start || (m_p == start + 1 && start[0] == '-'))
+        if (p == start || (p == start + 1 && start[0] == '-') || !ScalarEndsAt(p))
         {
             return Fail();
         }
@@ -932,26 +1496,65 @@ struct Parser
 
         JsonNode* node = m_arena->NewNode(JsonType::Integer);
         if (!node) return Fail();
-        node->m_int = static_cast<int64_t>(strtoll(start, nullptr, 10));
+
+        // Up to 18 digits cannot overflow; longer ones keep strtoll's clamping.
+        //
+        if (numDigits <= 18)
+        {
+            int64_t value = 0;
+            for (const char* d = digits; d < digits + numDigits; ++d)
+            {
+                value = value * 10 + (*d - '0');
+            }
+            node->m_int = start[0] == '-' ? -value : value;
+        }
+        else
+        {
+            node->m_int = static_cast<int64_t>(strtoll(start, nullptr, 10));
+        }
+
         return JSON(node);
     }
 
+    // Moves the entries collected since base into one exactly-sized arena block.
+    //
+    template<typename Entry>
+    bool TakeEntries(JsonContainer& c, std::vector<Entry>& stack, size_t base)
+    {
+        uint32_t count = static_cast<uint32_t>(stack.size() - base);
+        if (count)
+        {
+            void* block = m_arena->Alloc(count * sizeof(Entry), alignof(JsonMember));
+            if (!block)
+            {
+                return false;
+            }
+
+            memcpy(block, stack.data() + base, count * sizeof(Entry));
+            c.m_entries = block;
+            c.m_size = count;
+            c.m_cap = count;
+        }
+
+        stack.resize(base);
+        return true;
+    }
+
     JSON ParseArray()
     {
-        ++m_p; // '['
         JSON arr = m_arena->Array();
         if (arr.IsNull())
         {
             return Fail();
         }
 
-        SkipWs();
-        if (*m_p == ']')
+        if (Peek() == ']')
         {
-            ++m_p;
+            ++m_next;
             return arr;
         }
 
+        size_t base = m_values.size();
         while (true)
         {
             JSON value = ParseValue();
@@ -959,58 +1562,57 @@ struct Parser
             {
                 return JSON::Null();
             }
-            arr.Append(value);
-            if (m_arena->Failed())
-            {
-                return Fail();
-            }
+            m_values.push_back(value.m_node);
 
-            SkipWs();
-            if (*m_p == ',')
+            char c = Peek();
+            ++m_next;
+            if (c == ',')
             {
-                ++m_p;
                 continue;
             }
-            if (*m_p == ']')
+            if (c == ']')
             {
-                ++m_p;
-                return arr;
+                break;
             }
             return Fail();
         }
+
+        if (!TakeEntries(arr.m_node->m_container, m_values, base))
+        {
+            return Fail();
+        }
+
+        return arr;
     }
 
     JSON ParseObject()
     {
-        ++m_p; // '{'
         JSON obj = m_arena->Object();
         if (obj.IsNull())
         {
             return Fail();
         }
 
-        SkipWs();
-        if (*m_p == '}')
+        if (Peek() == '}')
         {
-            ++m_p;
+            ++m_next;
             return obj;
         }
 
+        size_t base = m_members.size();
         while (true)
         {
-            SkipWs();
             const char* key = ParseRawString();
             if (m_error)
             {
                 return JSON::Null();
             }
 
-            SkipWs();
-            if (*m_p != ':')
+            if (Peek() != ':')
             {
                 return Fail();
             }
-            ++m_p;
+            ++m_next;
 
             JSON value = ParseValue();
             if (m_error)
@@ -1018,38 +1620,29 @@ struct Parser
                 return JSON::Null();
             }
 
-            // Insert directly (key already arena-copied) to avoid re-copying.
+            // The key is already arena-copied; the member takes it as is.
             //
-            JsonContainer& c = obj.m_node->m_container;
-            if (c.m_size == c.m_cap)
-            {
-                uint32_t newCap = c.m_cap;
-                void* block = c.m_arena->GrowEntries(c.m_entries, c.m_size, newCap, sizeof(JsonMember));
-                if (!block)
-                {
-                    return Fail();
-                }
-                c.m_entries = block;
-                c.m_cap = newCap;
-            }
-            JsonMember* members = static_cast<JsonMember*>(c.m_entries);
-            members[c.m_size].m_key = key;
-            members[c.m_size].m_value = value.m_node;
-            c.m_size++;
+            m_members.push_back(JsonMember{key, value.m_node});
 
-            SkipWs();
-            if (*m_p == ',')
+            char next = Peek();
+            ++m_next;
+            if (next == ',')
             {
-                ++m_p;
                 continue;
             }
-            if (*m_p == '}')
+            if (next == '}')
             {
-                ++m_p;
-                return obj;
+                break;
             }
             return Fail();
         }
+
+        if (!TakeEntries(obj.m_node->m_container, m_members, base))
+        {
+            return Fail();
+        }
+
+        return obj;
     }
 };
 
@@ -1068,20 +1661,22 @@ inline JSON JsonArena::Loads(const char* input, size_t flags, json_error_t* erro
         return JSON::Null();
     }
 
-    JsonDetail::Parser parser(input, this);
-    JSON root = parser.ParseValue();
-    if (parser.m_error || m_failed)
+    JsonDetail::ParseScratch& scratch = JsonDetail::ParseScratch::ForThread();
+    size_t length = strlen(input);
+    if (!scratch.m_index.Build(input, length))
     {
+        scratch.Trim();
         return JSON::Null();
     }
 
-    parser.SkipWs();
-    if (*parser.m_p != '\0')
-    {
-        // Trailing garbage after a complete value.
-        //
-        return JSON::Null();
-    }
+    scratch.m_values.clear();
+    scratch.m_members.clear();
+    JsonDetail::Parser parser(input, length, scratch, this);
+    JSON root = parser.ParseValue();
 
-    return root;
+    // Trailing garbage after a complete value fails the parse as well.
+    //
+    bool ok = !parser.m_error && !m_failed && parser.AtEnd();
+    scratch.Trim();
+    return ok ? root : JSON::Null();
 }
@@ -90,7 +90,7 @@ struct LadderFilterLP
         //
         float smallSignalGain = m_saturator.DerivativeZero();
         float perStageGain = (m_stage4.m_alpha / (2.0f - m_stage4.m_alpha)) * smallSignalGain;
-        float Cpi = std::pow(perStageGain, 4.0f);
+        float Cpi = FastMath::PowInt<4>(perStageGain);
         float kSafe = 0.9f / (Cpi + 1e-8f);
         m_kEff = std::min(m_feedback, kSafe);
 
@@ -199,7 +199,7 @@ struct LadderFilterLP
         float smallSignalGain = m_saturator.DerivativeZero();
         float satInputGain = m_saturator.m_inputGain;
         float perStageGain = (m_stage4.m_alpha / (2.0f - m_stage4.m_alpha)) * smallSignalGain;
-        float Cpi = std::pow(perStageGain, 4.0f);
+        float Cpi = FastMath::PowInt<4>(perStageGain);
 
         printf("=== LadderFilterLP Debug ===\n");
         printf("Cutoff: %.6f  Alpha: %.6f\n", m_cutoff, m_stage1.m_alpha);
@@ -413,7 +413,7 @@ struct LadderFilterLPZDF
         // Calculate effective feedback with saturation compensation
         //
         float smallSignalGain = m_saturator.DerivativeZero();
-        float effectiveG4 = m_G4 * std::pow(smallSignalGain, 4.0f);
+        float effectiveG4 = m_G4 * FastMath::PowInt<4>(smallSignalGain);
         float kSafe = 0.95f / (effectiveG4 + 1e-8f);
         m_kEff = std::min(m_feedback, kSafe);
 
@@ -666,7 +666,7 @@ struct LadderFilterHP
         //
         float smallSignalGain = m_saturator.DerivativeZero();
         float perStageGain = (m_stage4.m_alpha / (2.0f - m_stage4.m_alpha)) * smallSignalGain;
-        float Cpi = std::pow(perStageGain, 4.0f);
+        float Cpi = FastMath::PowInt<4>(perStageGain);
         float kSafe = 0.9f / (Cpi + 1e-8f);
         m_kEff = std::min(m_feedback, kSafe);
 
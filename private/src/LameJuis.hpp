@@ -98,6 +98,47 @@ struct LameJuisInternal
                 m_inverted.Set(i, switchVal == MatrixSwitch::Inverted);
             }
         }
+
+        // Evaluates the operation at all 64 time slices at once.  Each active input contributes a bitsliced
+        // literal, a bitsliced adder counts the high literals per time slice into three bit planes, and the
+        // RHS table selects the counts that pass.
+        //
+        void CompileTruthTable()
+        {
+            uint64_t count[3] = {0, 0, 0};
+            for (size_t i = 0; i < x_numInputs; ++i)
+            {
+                if (!m_active.Get(i))
+                {
+                    continue;
+                }
+
+                uint64_t literal = HarmonicSheaf::x_basePointsWithBit[i];
+                if (m_inverted.Get(i))
+                {
+                    literal = ~literal;
+                }
+
+                uint64_t carry = literal;
+                for (size_t j = 0; j < 3; ++j)
+                {
+                    uint64_t sum = count[j] ^ carry;
+                    carry &= count[j];
+                    count[j] = sum;
+                }
+            }
+
+            m_truthTable = 0;
+            for (size_t k = 0; k < x_numInputs + 1; ++k)
+            {
+                if (m_rhs[k])
+                {
+                    m_truthTable |= ((k & 1) ? count[0] : ~count[0]) &
+                                    ((k & 2) ? count[1] : ~count[1]) &
+                                    ((k & 4) ? count[2] : ~count[2]);
+                }
+            }
+        }
         
         void Init(LameJuisInternal* owner)
         {
@@ -117,6 +158,9 @@ struct LameJuisInternal
             {
                 m_rhs[i] = i % 2 == 1;
             }
+
+            SetBitVectors();
+            CompileTruthTable();
         }
 
         void GetTotalAndHigh(HarmonicSheaf::BitVector inputVector, size_t* countTotal, size_t* countHigh)
@@ -138,10 +182,7 @@ struct LameJuisInternal
 
         bool GetValue(HarmonicSheaf::BitVector inputVector)
         {
-            size_t countTotal;
-            size_t countHigh;
-            GetTotalAndHigh(inputVector, &countTotal, &countHigh);            
-            return ComputeOperation(countHigh);
+            return (m_truthTable >> inputVector.m_bits) & 1;
         }
 
         // Up is output zero but input id 2, so invert.
@@ -155,6 +196,7 @@ struct LameJuisInternal
         {
             bool anyEffect = false;
             bool switchChange = false;
+            bool rhsChange = false;
 
             for (size_t i = 0; i < x_numInputs; ++i)
             {
@@ -185,8 +227,14 @@ struct LameJuisInternal
                     {
                         m_rhs[i] = input.m_rhs[i];
                         m_owner->m_needsInvalidateCache = true;
+                        rhsChange = true;
                     }
                 }
+
+                if (switchChange || rhsChange)
+                {
+                    CompileTruthTable();
+                }
                 
                 if (m_switch != input.m_switch)
                 {
@@ -195,7 +243,7 @@ struct LameJuisInternal
                 }
 
                 GetTotalAndHigh(*input.m_inputVector, &m_countTotal, &m_countHigh);            
-                m_gate = ComputeOperation(m_countHigh);                
+                m_gate = GetValue(*input.m_inputVector);
                 for (size_t i = 0; i < x_numInputs; ++i)
                 {
                     bool up = input.m_inputVector->Get(i);
@@ -208,6 +256,10 @@ struct LameJuisInternal
         HarmonicSheaf::BitVector m_active;
         HarmonicSheaf::BitVector m_inverted;
 
+        // Bit p is the operation's value at time slice p.
+        //
+        uint64_t m_truthTable{0};
+
         bool m_rhs[x_numInputs + 1]{};
         SwitchVal m_switch{SwitchVal::Up};
         size_t m_countTotal{0};
@@ -329,21 +381,24 @@ struct LameJuisInternal
         }
     }
 
+    // Fills every time slice's section from the operations' truth tables.
+    //
     void RebuildSheaf()
     {       
+        size_t target[x_numOperations];
+        for (size_t j = 0; j < x_numOperations; ++j)
+        {
+            target[j] = m_operations[j].GetOutputTarget();
+        }
+
         for (uint8_t i = 0; i < HarmonicSheaf::x_numBasePoints; ++i)
         {
-            HarmonicSheaf::BitVector index(i);
-            HarmonicSheaf::Section& section = m_sheaf.Get(index);
+            HarmonicSheaf::Section& section = m_sheaf.m_sections[i];
             section.Clear();
             for (size_t j = 0; j < x_numOperations; ++j)
             {
-                bool isHigh = m_operations[j].GetValue(index);
-                ++section.m_total[m_operations[j].GetOutputTarget()];
-                if (isHigh)
-                {
-                    ++section.m_high[m_operations[j].GetOutputTarget()];
-                }
+                ++section.m_total[target[j]];
+                section.m_high[target[j]] += (m_operations[j].m_truthTable >> i) & 1;
             }
         }
     }
@@ -112,13 +112,22 @@ namespace SmartGrid
 
     struct LPSysexWriter
     {
-        static constexpr size_t x_maxMessageSize = 8 + 5 * x_gridMaxSize * x_gridMaxSize;
+        static constexpr size_t x_headerSize = 7;
+        static constexpr size_t x_bytesPerPad = 5;
+        static constexpr size_t x_maxPads = x_gridMaxSize * x_gridMaxSize;
+        static constexpr size_t x_maxMessageSize = 8 + x_bytesPerPad * x_maxPads;
 
         ControllerShape m_shape;
         Color m_color[x_gridMaxSize][x_gridMaxSize];
         bool m_set[x_gridMaxSize][x_gridMaxSize];
         SmartBusColor* m_bus;
         uint64_t m_epoch;
+        bool m_fullScan;
+
+        // Pads taken from the bus's dirty bits but not yet written.  A pad that changes again while pending
+        // is still written once, with whatever colour the bus holds when its turn comes.
+        //
+        uint32_t m_pending[x_gridMaxSize];
 
         LPSysexWriter()
             : m_shape(ControllerShape::LaunchPadX)
@@ -126,6 +135,8 @@ namespace SmartGrid
             , m_set{}
             , m_bus(nullptr)
             , m_epoch(0)
+            , m_fullScan(true)
+            , m_pending{}
         {
             memset(m_set, 0, sizeof(m_set));
         }
@@ -136,6 +147,8 @@ namespace SmartGrid
             , m_set{}
             , m_bus(bus)
             , m_epoch(0)
+            , m_fullScan(true)
+            , m_pending{}
         {
             memset(m_set, 0, sizeof(m_set));
         }
@@ -144,11 +157,79 @@ namespace SmartGrid
         {
             memset(m_set, 0, sizeof(m_set));
             m_epoch = 0;
+            m_fullScan = true;
+        }
+
+        bool HasPending() const
+        {
+            for (int i = 0; i < x_gridXSize; ++i)
+            {
+                if (m_pending[i])
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // Largest pad count whose sysex fits in the given number of bytes.
+        //
+        static size_t PadsForBytes(size_t bytes)
+        {
+            return bytes <= x_headerSize + 1 ? 0 : (bytes - x_headerSize - 1) / x_bytesPerPad;
+        }
+
+        bool WritePad(uint8_t* buffer, size_t* pos, int xPhysical, int yPhysical)
+        {
+            int x = xPhysical + x_gridXMin;
+            int y = yPhysical + x_gridYMin;
+            if (!LPMidi::ShapeSupports(m_shape, x, y))
+            {
+                return false;
+            }
+
+            Color color = m_bus->Load(xPhysical, yPhysical);
+            if (!m_set[xPhysical][yPhysical] || color != m_color[xPhysical][yPhysical])
+            {
+                buffer[(*pos)++] = 3;
+                buffer[(*pos)++] = LPMidi::PosToNote(x, y);
+                buffer[(*pos)++] = color.m_red / 2;
+                buffer[(*pos)++] = color.m_green / 2;
+                buffer[(*pos)++] = color.m_blue / 2;
+
+                m_set[xPhysical][yPhysical] = true;
+                m_color[xPhysical][yPhysical] = color;
+                return true;
+            }
+
+            return false;
         }
 
-        size_t Write(uint8_t* buffer)
+        // Writes one RGB sysex with the pads whose colour changed since the last write (every pad after a
+        // Reset), found from the bus's dirty bits, and at most maxPads of them.  Pads over the limit stay
+        // pending for the next write.  Returns 0 if there is nothing to send.
+        //
+        size_t Write(uint8_t* buffer, size_t maxPads = x_maxPads)
         {
-            bool writtenAny = false;
+            uint64_t epoch = m_bus->m_epoch.load();
+            if (m_fullScan || epoch != m_epoch)
+            {
+                m_epoch = epoch;
+                for (int i = 0; i < x_gridXSize; ++i)
+                {
+                    uint32_t dirty = m_bus->TakeDirtyRow(i);
+                    m_pending[i] |= m_fullScan ? (1u << x_gridYSize) - 1 : dirty;
+                }
+
+                m_fullScan = false;
+            }
+
+            if (maxPads == 0 || !HasPending())
+            {
+                return 0;
+            }
+
             size_t pos = 0;
 
             buffer[pos++] = 240;
@@ -167,34 +248,23 @@ namespace SmartGrid
             }
             
             buffer[pos++] = 3;
-            
-            SmartBusOutput::Iterator itr = m_bus->begin(&m_epoch);
-            while (!itr.Done()) 
-            {
-                if (!LPMidi::ShapeSupports(m_shape, itr.m_x, itr.m_y))
-                {
-                    continue;
-                }
+            size_t headerSize = pos;
 
-                Color color = m_bus->Get(itr.m_x, itr.m_y);
-                if (!m_set[itr.GetXPhysical()][itr.GetYPhysical()] || 
-                    color != m_color[itr.GetXPhysical()][itr.GetYPhysical()])
+            size_t pads = 0;
+            for (int i = 0; i < x_gridXSize && pads < maxPads; ++i)
+            {
+                while (m_pending[i] && pads < maxPads)
                 {
-                    writtenAny = true;
-                    buffer[pos++] = 3;
-                    buffer[pos++] = LPMidi::PosToNote(itr.m_x, itr.m_y);
-                    buffer[pos++] = color.m_red / 2;
-                    buffer[pos++] = color.m_green / 2;
-                    buffer[pos++] = color.m_blue / 2;
-
-                    m_set[itr.GetXPhysical()][itr.GetYPhysical()] = true;
-                    m_color[itr.GetXPhysical()][itr.GetYPhysical()] = color;
+                    int j = __builtin_ctz(m_pending[i]);
+                    m_pending[i] &= m_pending[i] - 1;
+                    if (WritePad(buffer, &pos, i, j))
+                    {
+                        ++pads;
+                    }
                 }
-
-                ++itr;
             }
 
-            if (!writtenAny)
+            if (pos == headerSize)
             {
                 return 0;
             }
@@ -110,3 +110,63 @@ struct LinkwitzRileyCrossover
         m_highBiquad2.Reset();
     }
 };
+
+// NumChannels LR4 crossovers sharing one cutoff. Coefficients are computed once (and only when the
+// cutoff moves); each section is a MultichannelBiquadSection, so the output is identical to
+// NumChannels independent LinkwitzRileyCrossovers.
+//
+template<size_t NumChannels>
+struct MultichannelLinkwitzRileyCrossover
+{
+    MultichannelBiquadSection<NumChannels> m_lowBiquad1;
+    MultichannelBiquadSection<NumChannels> m_lowBiquad2;
+    MultichannelBiquadSection<NumChannels> m_highBiquad1;
+    MultichannelBiquadSection<NumChannels> m_highBiquad2;
+
+    // Negative until the first SetCyclesPerSample, so that call always computes coefficients.
+    //
+    float m_cyclesPerSample;
+
+    MultichannelLinkwitzRileyCrossover()
+        : m_cyclesPerSample(-1.0f)
+    {
+    }
+
+    void SetCyclesPerSample(float cyclesPerSample)
+    {
+        if (cyclesPerSample == m_cyclesPerSample)
+        {
+            return;
+        }
+
+        m_cyclesPerSample = cyclesPerSample;
+
+        LinkwitzRileyCrossover prototype;
+        prototype.SetCyclesPerSample(cyclesPerSample);
+        m_lowBiquad1.SetCoefficients(prototype.m_lowBiquad1);
+        m_lowBiquad2.SetCoefficients(prototype.m_lowBiquad2);
+        m_highBiquad1.SetCoefficients(prototype.m_highBiquad1);
+        m_highBiquad2.SetCoefficients(prototype.m_highBiquad2);
+    }
+
+    // input, lowPass and highPass each hold NumChannels samples.
+    //
+    void Process(const float* input, float* lowPass, float* highPass)
+    {
+        float stage1[NumChannels];
+
+        m_lowBiquad1.Process(input, stage1);
+        m_lowBiquad2.Process(stage1, lowPass);
+
+        m_highBiquad1.Process(input, stage1);
+        m_highBiquad2.Process(stage1, highPass);
+    }
+
+    void Reset()
+    {
+        m_lowBiquad1.Reset();
+        m_lowBiquad2.Reset();
+        m_highBiquad1.Reset();
+        m_highBiquad2.Reset();
+    }
+};
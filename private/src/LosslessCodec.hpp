@@ -0,0 +1,858 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// In-tree lossless codec for 24-bit recordings, in the style of FLAC: each channel of a block is coded as a
+// constant, verbatim, or as the residual of a fixed polynomial or quantized LPC predictor, and residuals are
+// Rice coded in partitions with their own parameters.  Blocks are independent, so they encode in parallel
+// and decode from any block boundary.
+//
+// The bitstream is our own, not FLAC's.  Files carry it as the data chunk of an RF64 WAVE file whose format
+// tag is x_formatTag (see LosslessWavWriter and WavReader).  Other WAV tools cannot decode that, so the files
+// are named with x_fileExtension rather than .wav.
+//
+// Parameters are chosen from estimated costs, so an encoder picks the cheaper predictor, not the provably
+// cheapest encoding.
+//
+// Block layout, MSB-first bits:
+//   16          frames in the block
+//   per channel:
+//     2         subframe type (Constant, Verbatim, Fixed, Lpc)
+//     Constant: 24 value
+//     Verbatim: frames x 24
+//     Fixed:    3 order (0..4), order x 24 warm-up, residual
+//     Lpc:      3 order - 1, 4 shift, order x 24 warm-up, order x x_coefficientBits coefficients, residual
+//   residual:   3 partition order p, then per partition 5 Rice parameter k and its values.  Partition i covers
+//               frames [i * n >> p, (i + 1) * n >> p), less the warm-up.  A quotient of x_escapeQuotient or
+//               more is written as x_escapeQuotient zeros and the 32-bit folded value.
+//   padding to a byte boundary.
+//
+namespace LosslessDetail
+{
+    struct BitWriter
+    {
+        std::vector<uint8_t>& m_out;
+        uint64_t m_accumulator;
+        int m_numBits;
+
+        explicit BitWriter(std::vector<uint8_t>& out)
+            : m_out(out)
+            , m_accumulator(0)
+            , m_numBits(0)
+        {
+        }
+
+        // count <= 32.
+        //
+        void Put(uint32_t value, int count)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            m_accumulator = (m_accumulator << count) | (static_cast<uint64_t>(value) & ((uint64_t(1) << count) - 1));
+            m_numBits += count;
+            while (m_numBits >= 8)
+            {
+                m_numBits -= 8;
+                m_out.push_back(static_cast<uint8_t>(m_accumulator >> m_numBits));
+            }
+        }
+
+        void PutSigned(int32_t value, int count)
+        {
+            Put(static_cast<uint32_t>(value), count);
+        }
+
+        void PutZeros(uint32_t count)
+        {
+            while (count >= 32)
+            {
+                Put(0, 32);
+                count -= 32;
+            }
+
+            Put(0, static_cast<int>(count));
+        }
+
+        void Flush()
+        {
+            if (m_numBits > 0)
+            {
+                Put(0, 8 - m_numBits);
+            }
+        }
+    };
+
+    // Reads past the end return zeros and set m_overrun, so a corrupt block fails its checks instead of
+    // reading out of bounds.
+    //
+    struct BitReader
+    {
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_bytePos;
+        uint64_t m_accumulator;
+        int m_numBits;
+        bool m_overrun;
+
+        BitReader(const uint8_t* data, size_t size)
+            : m_data(data)
+            , m_size(size)
+            , m_bytePos(0)
+            , m_accumulator(0)
+            , m_numBits(0)
+            , m_overrun(false)
+        {
+        }
+
+        void Fill()
+        {
+            while (m_numBits <= 56)
+            {
+                uint8_t byte = 0;
+                if (m_bytePos < m_size)
+                {
+                    byte = m_data[m_bytePos];
+                }
+                else if (m_bytePos > m_size + 8)
+                {
+                    m_overrun = true;
+                }
+
+                ++m_bytePos;
+                m_accumulator |= static_cast<uint64_t>(byte) << (56 - m_numBits);
+                m_numBits += 8;
+            }
+        }
+
+        // count <= 32.
+        //
+        uint32_t Get(int count)
+        {
+            if (count == 0)
+            {
+                return 0;
+            }
+
+            if (m_numBits < count)
+            {
+                Fill();
+            }
+
+            uint32_t value = static_cast<uint32_t>(m_accumulator >> (64 - count));
+            m_accumulator <<= count;
+            m_numBits -= count;
+            return value;
+        }
+
+        int32_t GetSigned(int count)
+        {
+            uint32_t value = Get(count);
+            uint32_t sign = uint32_t(1) << (count - 1);
+            return static_cast<int32_t>((value ^ sign) - sign);
+        }
+
+        // Counts zeros up to limit, consuming the terminating one if it comes first.
+        //
+        uint32_t GetUnary(uint32_t limit)
+        {
+            uint32_t count = 0;
+            while (count < limit)
+            {
+                if (m_numBits == 0)
+                {
+                    Fill();
+                }
+
+                if (m_accumulator == 0)
+                {
+                    uint32_t zeros = std::min<uint32_t>(static_cast<uint32_t>(m_numBits), limit - count);
+                    count += zeros;
+                    m_numBits -= static_cast<int>(zeros);
+                    m_accumulator = 0;
+                    if (m_overrun)
+                    {
+                        return limit;
+                    }
+
+                    continue;
+                }
+
+                uint32_t leading = static_cast<uint32_t>(__builtin_clzll(m_accumulator));
+                if (count + leading >= limit)
+                {
+                    uint32_t zeros = limit - count;
+                    m_accumulator <<= zeros;
+                    m_numBits -= static_cast<int>(zeros);
+                    return limit;
+                }
+
+                m_accumulator <<= leading + 1;
+                m_numBits -= static_cast<int>(leading + 1);
+                return count + leading;
+            }
+
+            return limit;
+        }
+
+        // True if no more than the block's own bits were consumed.
+        //
+        bool Ok() const
+        {
+            return !m_overrun && m_bytePos * 8 - static_cast<size_t>(m_numBits) <= m_size * 8;
+        }
+    };
+
+    inline uint32_t Fold(int64_t value)
+    {
+        return static_cast<uint32_t>((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    inline int32_t Unfold(uint32_t value)
+    {
+        return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+    }
+}
+
+struct LosslessCodec
+{
+    static constexpr uint16_t x_formatTag = 0x5347;
+    static constexpr const char* x_fileExtension = ".sgwav";
+    static constexpr char x_seekChunkId[4] = {'s', 'g', 's', 'k'};
+    static constexpr size_t x_blockFrames = 4096;
+
+    // The most channels a file may have: the stem recorder's widest layout, with room to spare.  Readers reject
+    // more, so a damaged header cannot size the block buffer.
+    //
+    static constexpr size_t x_maxChannels = 256;
+    static constexpr int x_sampleBits = 24;
+    static constexpr int x_maxFixedOrder = 4;
+    static constexpr int x_maxLpcOrder = 8;
+    static constexpr int x_coefficientBits = 14;
+    static constexpr int x_maxShift = 15;
+    static constexpr int x_maxPartitionOrder = 6;
+    static constexpr int x_riceParameterBits = 5;
+    static constexpr uint32_t x_maxRiceParameter = 30;
+    static constexpr uint32_t x_escapeQuotient = 32;
+
+    enum class SubframeType : uint32_t
+    {
+        Constant = 0,
+        Verbatim = 1,
+        Fixed = 2,
+        Lpc = 3
+    };
+
+    // Per-thread working memory, sized on first use.
+    //
+    struct Scratch
+    {
+        std::vector<int32_t> m_channel;
+        std::vector<int64_t> m_residual;
+        std::vector<int64_t> m_bestResidual;
+        std::vector<double> m_windowed;
+    };
+
+    struct Predictor
+    {
+        SubframeType m_type;
+        int m_order;
+        int m_shift;
+        int32_t m_coefficients[x_maxLpcOrder];
+        int m_partitionOrder;
+        uint32_t m_parameters[1 << x_maxPartitionOrder];
+        uint64_t m_bits;
+    };
+
+    static constexpr uint64_t x_unusable = ~uint64_t(0);
+
+    // ---------------------------------------------------------------------------------------------------------
+    // Encoding
+    // ---------------------------------------------------------------------------------------------------------
+
+    // Appends one encoded block.  interleaved holds numFrames x numChannels samples within 24 bits.
+    //
+    static void EncodeBlock(const int32_t* interleaved, size_t numFrames, size_t numChannels, std::vector<uint8_t>& out, Scratch& scratch)
+    {
+        scratch.m_channel.resize(numFrames);
+        scratch.m_residual.resize(numFrames);
+        scratch.m_bestResidual.resize(numFrames);
+        scratch.m_windowed.resize(numFrames);
+
+        LosslessDetail::BitWriter writer(out);
+        writer.Put(static_cast<uint32_t>(numFrames), 16);
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            int32_t* samples = scratch.m_channel.data();
+            for (size_t i = 0; i < numFrames; ++i)
+            {
+                samples[i] = interleaved[i * numChannels + channel];
+            }
+
+            EncodeSubframe(samples, numFrames, writer, scratch);
+        }
+
+        writer.Flush();
+    }
+
+    static void EncodeSubframe(const int32_t* samples, size_t n, LosslessDetail::BitWriter& writer, Scratch& scratch)
+    {
+        bool constant = true;
+        for (size_t i = 1; i < n && constant; ++i)
+        {
+            constant = samples[i] == samples[0];
+        }
+
+        if (constant)
+        {
+            writer.Put(static_cast<uint32_t>(SubframeType::Constant), 2);
+            writer.PutSigned(n > 0 ? samples[0] : 0, x_sampleBits);
+            return;
+        }
+
+        Predictor best = {};
+        best.m_type = SubframeType::Verbatim;
+        best.m_bits = static_cast<uint64_t>(n) * x_sampleBits;
+
+        Predictor candidate = {};
+        if (TryFixed(samples, n, candidate, scratch) && candidate.m_bits < best.m_bits)
+        {
+            best = candidate;
+            std::swap(scratch.m_residual, scratch.m_bestResidual);
+        }
+
+        if (TryLpc(samples, n, candidate, scratch) && candidate.m_bits < best.m_bits)
+        {
+            best = candidate;
+            std::swap(scratch.m_residual, scratch.m_bestResidual);
+        }
+
+        writer.Put(static_cast<uint32_t>(best.m_type), 2);
+        if (best.m_type == SubframeType::Verbatim)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                writer.PutSigned(samples[i], x_sampleBits);
+            }
+
+            return;
+        }
+
+        if (best.m_type == SubframeType::Fixed)
+        {
+            writer.Put(static_cast<uint32_t>(best.m_order), 3);
+        }
+        else
+        {
+            writer.Put(static_cast<uint32_t>(best.m_order - 1), 3);
+            writer.Put(static_cast<uint32_t>(best.m_shift), 4);
+        }
+
+        for (int i = 0; i < best.m_order; ++i)
+        {
+            writer.PutSigned(samples[i], x_sampleBits);
+        }
+
+        if (best.m_type == SubframeType::Lpc)
+        {
+            for (int i = 0; i < best.m_order; ++i)
+            {
+                writer.PutSigned(best.m_coefficients[i], x_coefficientBits);
+            }
+        }
+
+        WriteResidual(scratch.m_bestResidual.data(), n, best, writer);
+    }
+
+    // Picks the fixed order with the smallest absolute residual sum, as FLAC does, and costs it exactly.
+    //
+    static bool TryFixed(const int32_t* x, size_t n, Predictor& predictor, Scratch& scratch)
+    {
+        if (n <= static_cast<size_t>(x_maxFixedOrder))
+        {
+            return false;
+        }
+
+        uint64_t sums[x_maxFixedOrder + 1] = {};
+        for (size_t i = x_maxFixedOrder; i < n; ++i)
+        {
+            int64_t e0 = x[i];
+            int64_t e1 = e0 - x[i - 1];
+            int64_t e2 = e1 - (static_cast<int64_t>(x[i - 1]) - x[i - 2]);
+            int64_t e3 = e2 - (static_cast<int64_t>(x[i - 1]) - 2 * static_cast<int64_t>(x[i - 2]) + x[i - 3]);
+            int64_t e4 = e3 - (static_cast<int64_t>(x[i - 1]) - 3 * static_cast<int64_t>(x[i - 2]) + 3 * static_cast<int64_t>(x[i - 3]) - x[i - 4]);
+            sums[0] += static_cast<uint64_t>(std::abs(e0));
+            sums[1] += static_cast<uint64_t>(std::abs(e1));
+            sums[2] += static_cast<uint64_t>(std::abs(e2));
+            sums[3] += static_cast<uint64_t>(std::abs(e3));
+            sums[4] += static_cast<uint64_t>(std::abs(e4));
+        }
+
+        int order = 0;
+        for (int k = 1; k <= x_maxFixedOrder; ++k)
+        {
+            if (sums[k] < sums[order])
+            {
+                order = k;
+            }
+        }
+
+        int64_t* residual = scratch.m_residual.data();
+        FixedResidual(x, n, order, residual);
+        predictor.m_type = SubframeType::Fixed;
+        predictor.m_order = order;
+        predictor.m_shift = 0;
+        uint64_t bits = ChooseRiceParameters(residual, n, order, predictor);
+        if (bits == x_unusable)
+        {
+            return false;
+        }
+
+        predictor.m_bits = 2 + 3 + static_cast<uint64_t>(order) * x_sampleBits + bits;
+        return true;
+    }
+
+    static void FixedResidual(const int32_t* x, size_t n, int order, int64_t* residual)
+    {
+        for (size_t i = static_cast<size_t>(order); i < n; ++i)
+        {
+            residual[i] = static_cast<int64_t>(x[i]) - FixedPrediction(x + i, order);
+        }
+    }
+
+    // p points at the sample being predicted.
+    //
+    static int64_t FixedPrediction(const int32_t* p, int order)
+    {
+        switch (order)
+        {
+            case 1: return p[-1];
+            case 2: return 2 * static_cast<int64_t>(p[-1]) - p[-2];
+            case 3: return 3 * static_cast<int64_t>(p[-1]) - 3 * static_cast<int64_t>(p[-2]) + p[-3];
+            case 4: return 4 * static_cast<int64_t>(p[-1]) - 6 * static_cast<int64_t>(p[-2]) + 4 * static_cast<int64_t>(p[-3]) - p[-4];
+            default: return 0;
+        }
+    }
+
+    // Welch-windowed autocorrelation, Levinson-Durbin, then the order whose estimated cost is lowest, quantized
+    // to x_coefficientBits with error feedback.
+    //
+    static bool TryLpc(const int32_t* x, size_t n, Predictor& predictor, Scratch& scratch)
+    {
+        if (n <= static_cast<size_t>(4 * x_maxLpcOrder))
+        {
+            return false;
+        }
+
+        double* windowed = scratch.m_windowed.data();
+        double half = 0.5 * static_cast<double>(n - 1);
+        for (size_t i = 0; i < n; ++i)
+        {
+            double t = (static_cast<double>(i) - half) / (half + 1.0);
+            windowed[i] = static_cast<double>(x[i]) * (1.0 - t * t);
+        }
+
+        double autocorrelation[x_maxLpcOrder + 1];
+        for (int lag = 0; lag <= x_maxLpcOrder; ++lag)
+        {
+            double sum = 0.0;
+            for (size_t i = static_cast<size_t>(lag); i < n; ++i)
+            {
+                sum += windowed[i] * windowed[i - lag];
+            }
+
+            autocorrelation[lag] = sum;
+        }
+
+        if (autocorrelation[0] <= 0.0)
+        {
+            return false;
+        }
+
+        // Levinson-Durbin keeps every order's coefficients and prediction error.
+        //
+        double coefficients[x_maxLpcOrder][x_maxLpcOrder];
+        double error[x_maxLpcOrder];
+        double current[x_maxLpcOrder] = {};
+        double e = autocorrelation[0];
+        int maxOrder = 0;
+        for (int m = 0; m < x_maxLpcOrder; ++m)
+        {
+            double acc = -autocorrelation[m + 1];
+            for (int j = 0; j < m; ++j)
+            {
+                acc -= current[j] * autocorrelation[m - j];
+            }
+
+            double reflection = acc / e;
+            double previous[x_maxLpcOrder];
+            std::memcpy(previous, current, sizeof(previous));
+            current[m] = reflection;
+            for (int j = 0; j < m; ++j)
+            {
+                current[j] = previous[j] + reflection * previous[m - 1 - j];
+            }
+
+            e *= 1.0 - reflection * reflection;
+            for (int j = 0; j <= m; ++j)
+            {
+                coefficients[m][j] = -current[j];
+            }
+
+            error[m] = e;
+            maxOrder = m + 1;
+            if (e <= 0.0)
+            {
+                break;
+            }
+        }
+
+        int order = 1;
+        double bestEstimate = 0.0;
+        for (int m = 1; m <= maxOrder; ++m)
+        {
+            double perSample = error[m - 1] > 0.0 ? 0.5 * std::log2(2.0 * error[m - 1] / static_cast<double>(n)) : 0.0;
+            double estimate = std::max(0.0, perSample) * static_cast<double>(n - m)
+                + static_cast<double>(m * (x_sampleBits + x_coefficientBits));
+            if (m == 1 || estimate < bestEstimate)
+            {
+                bestEstimate = estimate;
+                order = m;
+            }
+        }
+
+        if (!Quantize(coefficients[order - 1], order, predictor))
+        {
+            return false;
+        }
+
+        int64_t* residual = scratch.m_residual.data();
+        for (size_t i = static_cast<size_t>(order); i < n; ++i)
+        {
+            residual[i] = static_cast<int64_t>(x[i]) - LpcPrediction(x + i, predictor.m_coefficients, order, predictor.m_shift);
+        }
+
+        predictor.m_type = SubframeType::Lpc;
+        predictor.m_order = order;
+        uint64_t bits = ChooseRiceParameters(residual, n, order, predictor);
+        if (bits == x_unusable)
+        {
+            return false;
+        }
+
+        predictor.m_bits = 2 + 3 + 4 + static_cast<uint64_t>(order) * (x_sampleBits + x_coefficientBits) + bits;
+        return true;
+    }
+
+    static bool Quantize(const double* coefficients, int order, Predictor& predictor)
+    {
+        double largest = 0.0;
+        for (int i = 0; i < order; ++i)
+        {
+            largest = std::max(largest, std::abs(coefficients[i]));
+        }
+
+        if (!(largest > 0.0) || !std::isfinite(largest))
+        {
+            return false;
+        }
+
+        int exponent = 0;
+        std::frexp(largest, &exponent);
+        int shift = std::min(x_maxShift, x_coefficientBits - 1 - exponent);
+        if (shift < 0)
+        {
+            return false;
+        }
+
+        const int32_t limit = (1 << (x_coefficientBits - 1)) - 1;
+        double carried = 0.0;
+        for (int i = 0; i < order; ++i)
+        {
+            carried += coefficients[i] * static_cast<double>(1 << shift);
+            long rounded = std::lround(carried);
+            rounded = std::max<long>(-limit - 1, std::min<long>(limit, rounded));
+            predictor.m_coefficients[i] = static_cast<int32_t>(rounded);
+            carried -= static_cast<double>(rounded);
+        }
+
+        predictor.m_shift = shift;
+        return true;
+    }
+
+    // coefficients[j] weighs p[-1 - j].
+    //
+    static int64_t LpcPrediction(const int32_t* p, const int32_t* coefficients, int order, int shift)
+    {
+        int64_t sum = 0;
+        for (int j = 0; j < order; ++j)
+        {
+            sum += static_cast<int64_t>(coefficients[j]) * p[-1 - j];
+        }
+
+        return sum >> shift;
+    }
+
+    static size_t PartitionStart(size_t n, int partitionOrder, size_t partition, int order)
+    {
+        return std::max<size_t>(static_cast<size_t>(order), (partition * n) >> partitionOrder);
+    }
+
+    static size_t PartitionEnd(size_t n, int partitionOrder, size_t partition, int order)
+    {
+        return std::max<size_t>(static_cast<size_t>(order), ((partition + 1) * n) >> partitionOrder);
+    }
+
+    // Cost of a partition at parameter k, counting each value as if it were the mean (as FLAC estimates).
+    //
+    static uint64_t RiceBits(uint64_t sum, uint64_t count, uint32_t k)
+    {
+        return count * (k + 1) + (sum >> k);
+    }
+
+    // Sums folded residuals over the finest partitions in one pass, then merges pairs for each coarser order,
+    // choosing every partition's parameter from its sum.  Returns x_unusable if a residual does not fit 32
+    // folded bits.
+    //
+    static uint64_t ChooseRiceParameters(const int64_t* residual, size_t n, int order, Predictor& predictor)
+    {
+        int finest = 0;
+        while (finest < x_maxPartitionOrder && (n >> (finest + 1)) >= 16)
+        {
+            ++finest;
+        }
+
+        uint64_t sums[1 << x_maxPartitionOrder];
+        uint64_t counts[1 << x_maxPartitionOrder];
+        for (size_t p = 0; p < (size_t(1) << finest); ++p)
+        {
+            size_t begin = PartitionStart(n, finest, p, order);
+            size_t end = PartitionEnd(n, finest, p, order);
+            uint64_t sum = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (residual[i] > INT32_MAX || residual[i] < INT32_MIN)
+                {
+                    return x_unusable;
+                }
+
+                sum += LosslessDetail::Fold(residual[i]);
+            }
+
+            sums[p] = sum;
+            counts[p] = end > begin ? end - begin : 0;
+        }
+
+        uint64_t bestBits = x_unusable;
+        for (int partitionOrder = finest; partitionOrder >= 0; --partitionOrder)
+        {
+            size_t numPartitions = size_t(1) << partitionOrder;
+            if (partitionOrder < finest)
+            {
+                for (size_t p = 0; p < numPartitions; ++p)
+                {
+                    sums[p] = sums[2 * p] + sums[2 * p + 1];
+                    counts[p] = counts[2 * p] + counts[2 * p + 1];
+                }
+            }
+
+            uint64_t bits = 3;
+            uint32_t parameters[1 << x_maxPartitionOrder];
+            for (size_t p = 0; p < numPartitions; ++p)
+            {
+                uint32_t parameter = 0;
+                uint64_t partitionBits = RiceBits(sums[p], counts[p], 0);
+                for (uint32_t k = 1; k <= x_maxRiceParameter; ++k)
+                {
+                    uint64_t kBits = RiceBits(sums[p], counts[p], k);
+                    if (kBits < partitionBits)
+                    {
+                        partitionBits = kBits;
+                        parameter = k;
+                    }
+                }
+
+                parameters[p] = parameter;
+                bits += x_riceParameterBits + partitionBits;
+            }
+
+            if (bits < bestBits)
+            {
+                bestBits = bits;
+                predictor.m_partitionOrder = partitionOrder;
+                std::memcpy(predictor.m_parameters, parameters, numPartitions * sizeof(uint32_t));
+            }
+        }
+
+        return bestBits;
+    }
+
+    static void WriteResidual(const int64_t* residual, size_t n, const Predictor& predictor, LosslessDetail::BitWriter& writer)
+    {
+        writer.Put(static_cast<uint32_t>(predictor.m_partitionOrder), 3);
+        size_t numPartitions = size_t(1) << predictor.m_partitionOrder;
+        for (size_t p = 0; p < numPartitions; ++p)
+        {
+            uint32_t k = predictor.m_parameters[p];
+            writer.Put(k, x_riceParameterBits);
+            size_t begin = PartitionStart(n, predictor.m_partitionOrder, p, predictor.m_order);
+            size_t end = PartitionEnd(n, predictor.m_partitionOrder, p, predictor.m_order);
+            for (size_t i = begin; i < end; ++i)
+            {
+                uint32_t folded = LosslessDetail::Fold(residual[i]);
+                uint32_t quotient = folded >> k;
+                if (quotient < x_escapeQuotient)
+                {
+                    writer.PutZeros(quotient);
+                    writer.Put(1, 1);
+                    writer.Put(folded, static_cast<int>(k));
+                }
+                else
+                {
+                    writer.PutZeros(x_escapeQuotient);
+                    writer.Put(folded, 32);
+                }
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------------------
+    // Decoding
+    // ---------------------------------------------------------------------------------------------------------
+
+    // Returns the frame count the block header declares, or 0 if the block is too short to have one.
+    //
+    static size_t BlockFrames(const uint8_t* data, size_t size)
+    {
+        return size < 2 ? 0 : (static_cast<size_t>(data[0]) << 8) | data[1];
+    }
+
+    // Decodes a whole block into interleaved, which holds BlockFrames x numChannels samples.  False if the block
+    // is malformed; interleaved is then unspecified.
+    //
+    static bool DecodeBlock(const uint8_t* data, size_t size, size_t numChannels, int32_t* interleaved, Scratch& scratch)
+    {
+        LosslessDetail::BitReader reader(data, size);
+        size_t n = reader.Get(16);
+        if (n == 0)
+        {
+            return false;
+        }
+
+        scratch.m_channel.resize(n);
+        int32_t* samples = scratch.m_channel.data();
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            if (!DecodeSubframe(reader, n, samples) || !reader.Ok())
+            {
+                return false;
+            }
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                interleaved[i * numChannels + channel] = samples[i];
+            }
+        }
+
+        return reader.Ok();
+    }
+
+    static bool DecodeSubframe(LosslessDetail::BitReader& reader, size_t n, int32_t* samples)
+    {
+        SubframeType type = static_cast<SubframeType>(reader.Get(2));
+        if (type == SubframeType::Constant)
+        {
+            int32_t value = reader.GetSigned(x_sampleBits);
+            std::fill(samples, samples + n, value);
+            return true;
+        }
+
+        if (type == SubframeType::Verbatim)
+        {
+            for (size_t i = 0; i < n && !reader.m_overrun; ++i)
+            {
+                samples[i] = reader.GetSigned(x_sampleBits);
+            }
+
+            return true;
+        }
+
+        int order = 0;
+        int shift = 0;
+        int32_t coefficients[x_maxLpcOrder] = {};
+        if (type == SubframeType::Fixed)
+        {
+            order = static_cast<int>(reader.Get(3));
+            if (order > x_maxFixedOrder)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            order = static_cast<int>(reader.Get(3)) + 1;
+            shift = static_cast<int>(reader.Get(4));
+        }
+
+        if (static_cast<size_t>(order) > n)
+        {
+            return false;
+        }
+
+        for (int i = 0; i < order; ++i)
+        {
+            samples[i] = reader.GetSigned(x_sampleBits);
+        }
+
+        if (type == SubframeType::Lpc)
+        {
+            for (int i = 0; i < order; ++i)
+            {
+                coefficients[i] = reader.GetSigned(x_coefficientBits);
+            }
+        }
+
+        int partitionOrder = static_cast<int>(reader.Get(3));
+        if (partitionOrder > x_maxPartitionOrder)
+        {
+            return false;
+        }
+
+        size_t numPartitions = size_t(1) << partitionOrder;
+        for (size_t p = 0; p < numPartitions; ++p)
+        {
+            uint32_t k = reader.Get(x_riceParameterBits);
+            if (k > x_maxRiceParameter)
+            {
+                return false;
+            }
+
+            size_t begin = PartitionStart(n, partitionOrder, p, order);
+            size_t end = PartitionEnd(n, partitionOrder, p, order);
+            for (size_t i = begin; i < end; ++i)
+            {
+                uint32_t quotient = reader.GetUnary(x_escapeQuotient);
+                uint32_t folded = quotient < x_escapeQuotient ? (quotient << k) | reader.Get(static_cast<int>(k)) : reader.Get(32);
+                int64_t prediction = type == SubframeType::Fixed
+                    ? FixedPrediction(samples + i, order)
+                    : LpcPrediction(samples + i, coefficients, order, shift);
+                samples[i] = static_cast<int32_t>(prediction + LosslessDetail::Unfold(folded));
+            }
+
+            if (reader.m_overrun)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
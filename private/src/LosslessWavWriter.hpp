@@ -0,0 +1,289 @@
+#pragma once
+
+#include "AsyncLogger.hpp"
+#include "LosslessCodec.hpp"
+#include "WavWriter.hpp"
+#include "WorkerPool.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Streams interleaved 24-bit samples into an RF64 file whose data chunk is LosslessCodec blocks.  The thread
+// calling Write (a recorder's writer thread) fills blocks; up to x_blocksInFlight of them encode at once on
+// a WorkerPool, and the calling thread appends them to the file in order as they finish.  The pool is the
+// writer's own or one shared with its caller (the I/O thread's, for persisted takes).  With no pool, blocks
+// encode inline.
+//
+// The data chunk is followed by a seek chunk: block size, frame count, and each block's offset within the data,
+// so WavReader can decode any range without scanning.  Both are written by Close, which also patches the
+// header; a file that was never closed does not load.
+//
+struct LosslessWavWriter
+{
+    static constexpr size_t x_blocksInFlight = 8;
+
+    struct Block
+    {
+        std::vector<int32_t> m_samples;
+        std::vector<uint8_t> m_encoded;
+        size_t m_numFrames;
+
+        // Guarded by m_mutex.
+        //
+        bool m_ready;
+    };
+
+    std::unique_ptr<WorkerPool> m_ownedWorkerPool;
+    WorkerPool* m_workerPool;
+    Block m_blocks[x_blocksInFlight];
+    size_t m_fillIndex;
+    size_t m_writeIndex;
+    std::mutex m_mutex;
+    std::condition_variable m_readyCondition;
+    LosslessCodec::Scratch m_scratch;
+
+    std::ofstream m_file;
+    Rf64Header m_header;
+    std::string m_filename;
+    uint16_t m_numChannels;
+    std::vector<uint64_t> m_blockOffsets;
+    uint64_t m_dataSize;
+    uint64_t m_numFrames;
+    bool m_isOpen;
+    bool m_error;
+
+    // Encodes on a pool of its own with numWorkers threads, or inline with none.
+    //
+    explicit LosslessWavWriter(size_t numWorkers = WorkerPool::DefaultNumWorkers())
+        : LosslessWavWriter(static_cast<WorkerPool*>(nullptr))
+    {
+        if (numWorkers > 0)
+        {
+            m_ownedWorkerPool = std::make_unique<WorkerPool>(numWorkers);
+            m_workerPool = m_ownedWorkerPool.get();
+        }
+    }
+
+    // Encodes on workerPool, or inline if it is null.  The pool must not shut down before Close returns, or
+    // Close waits for blocks that never encode.
+    //
+    explicit LosslessWavWriter(WorkerPool* workerPool)
+        : m_ownedWorkerPool()
+        , m_workerPool(workerPool)
+        , m_blocks{}
+        , m_fillIndex(0)
+        , m_writeIndex(0)
+        , m_numChannels(0)
+        , m_dataSize(0)
+        , m_numFrames(0)
+        , m_isOpen(false)
+        , m_error(false)
+    {
+    }
+
+    ~LosslessWavWriter()
+    {
+        Close();
+    }
+
+    LosslessWavWriter(const LosslessWavWriter&) = delete;
+    LosslessWavWriter& operator=(const LosslessWavWriter&) = delete;
+
+    bool Open(uint16_t numChannels, const std::string& filename, uint32_t sampleRate)
+    {
+        if (m_isOpen)
+        {
+            Close();
+        }
+
+        if (numChannels == 0 || LosslessCodec::x_maxChannels < numChannels)
+        {
+            m_error = true;
+            INFO("LosslessWavWriter error: %d channels is not supported", static_cast<int>(numChannels));
+            return false;
+        }
+
+        m_numChannels = numChannels;
+        m_filename = filename;
+        m_error = false;
+        m_fillIndex = 0;
+        m_writeIndex = 0;
+        m_dataSize = 0;
+        m_numFrames = 0;
+        m_blockOffsets.clear();
+
+        // Buffers only grow, so reopening with the same channel count does not allocate.
+        //
+        for (Block& block : m_blocks)
+        {
+            block.m_samples.resize(LosslessCodec::x_blockFrames * numChannels);
+            block.m_numFrames = 0;
+            block.m_ready = false;
+        }
+
+        m_header.Init(numChannels, sampleRate);
+        m_header.subFormat[0] = static_cast<uint8_t>(LosslessCodec::x_formatTag & 0xFF);
+        m_header.subFormat[1] = static_cast<uint8_t>(LosslessCodec::x_formatTag >> 8);
+
+        m_file.open(filename, std::ios::binary | std::ios::trunc);
+        if (!m_file.is_open())
+        {
+            m_error = true;
+            INFO("LosslessWavWriter error: Failed to open file %s", filename.c_str());
+            return false;
+        }
+
+        m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(Rf64Header));
+        m_isOpen = true;
+        return true;
+    }
+
+    // interleaved holds numFrames x m_numChannels samples within 24 bits.
+    //
+    void Write(const int32_t* interleaved, size_t numFrames)
+    {
+        if (!m_isOpen)
+        {
+            return;
+        }
+
+        while (numFrames > 0)
+        {
+            Block& block = m_blocks[m_fillIndex % x_blocksInFlight];
+            size_t count = std::min(numFrames, LosslessCodec::x_blockFrames - block.m_numFrames);
+            std::memcpy(block.m_samples.data() + block.m_numFrames * m_numChannels, interleaved, count * m_numChannels * sizeof(int32_t));
+            block.m_numFrames += count;
+            interleaved += count * m_numChannels;
+            numFrames -= count;
+            if (block.m_numFrames == LosslessCodec::x_blockFrames)
+            {
+                Dispatch();
+            }
+        }
+    }
+
+    bool Close()
+    {
+        if (!m_isOpen)
+        {
+            return !m_error;
+        }
+
+        if (m_blocks[m_fillIndex % x_blocksInFlight].m_numFrames > 0)
+        {
+            Dispatch();
+        }
+
+        WriteFinished(0);
+        m_isOpen = false;
+
+        // Seek chunk after the (padded) data chunk.
+        //
+        uint64_t fileSize = sizeof(Rf64Header) + m_dataSize;
+        if (m_dataSize & 1)
+        {
+            m_file.put(0);
+            ++fileSize;
+        }
+
+        uint32_t seekSize = static_cast<uint32_t>(16 + 8 * m_blockOffsets.size());
+        uint32_t blockFrames = static_cast<uint32_t>(LosslessCodec::x_blockFrames);
+        uint32_t reserved = 0;
+        m_file.write(LosslessCodec::x_seekChunkId, 4);
+        m_file.write(reinterpret_cast<const char*>(&seekSize), 4);
+        m_file.write(reinterpret_cast<const char*>(&blockFrames), 4);
+        m_file.write(reinterpret_cast<const char*>(&reserved), 4);
+        m_file.write(reinterpret_cast<const char*>(&m_numFrames), 8);
+        m_file.write(reinterpret_cast<const char*>(m_blockOffsets.data()), static_cast<std::streamsize>(8 * m_blockOffsets.size()));
+        fileSize += 8 + seekSize;
+
+        m_header.Finish(m_dataSize, m_numFrames);
+        m_header.riffSize = fileSize - 8;
+        m_file.seekp(0);
+        m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(Rf64Header));
+        if (!m_file.good())
+        {
+            m_error = true;
+            INFO("LosslessWavWriter error: Failed to finish %s", m_filename.c_str());
+        }
+
+        m_file.close();
+        return !m_error;
+    }
+
+    // Hands the current block to a worker (or encodes it), then writes whatever has finished, waiting only if
+    // every block is in flight.
+    //
+    void Dispatch()
+    {
+        Block& block = m_blocks[m_fillIndex % x_blocksInFlight];
+        size_t numChannels = m_numChannels;
+        if (!m_workerPool)
+        {
+            block.m_encoded.clear();
+            LosslessCodec::EncodeBlock(block.m_samples.data(), block.m_numFrames, numChannels, block.m_encoded, m_scratch);
+            block.m_ready = true;
+        }
+        else
+        {
+            m_workerPool->Submit([this, &block, numChannels]()
+            {
+                static thread_local LosslessCodec::Scratch scratch;
+                block.m_encoded.clear();
+                LosslessCodec::EncodeBlock(block.m_samples.data(), block.m_numFrames, numChannels, block.m_encoded, scratch);
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    block.m_ready = true;
+                }
+
+                m_readyCondition.notify_one();
+            });
+        }
+
+        ++m_fillIndex;
+        WriteFinished(x_blocksInFlight - 1);
+    }
+
+    // Writes finished blocks in order until at most maxInFlight remain, waiting for the oldest as needed, and
+    // then any further ones that are already done.
+    //
+    void WriteFinished(size_t maxInFlight)
+    {
+        while (m_writeIndex < m_fillIndex)
+        {
+            Block& block = m_blocks[m_writeIndex % x_blocksInFlight];
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (!block.m_ready)
+                {
+                    if (m_fillIndex - m_writeIndex <= maxInFlight)
+                    {
+                        return;
+                    }
+
+                    m_readyCondition.wait(lock, [&block]() { return block.m_ready; });
+                }
+
+                block.m_ready = false;
+            }
+
+            m_blockOffsets.push_back(m_dataSize);
+            m_file.write(reinterpret_cast<const char*>(block.m_encoded.data()), static_cast<std::streamsize>(block.m_encoded.size()));
+            if (!m_file.good() && !m_error)
+            {
+                m_error = true;
+                INFO("LosslessWavWriter error: Write failed for file %s", m_filename.c_str());
+            }
+
+            m_dataSize += block.m_encoded.size();
+            m_numFrames += block.m_numFrames;
+            block.m_numFrames = 0;
+            ++m_writeIndex;
+        }
+    }
+};
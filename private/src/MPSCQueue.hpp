@@ -0,0 +1,194 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded multi-producer single-consumer ring.  Any number of threads may Push; one thread pops.
+//
+// Each cell carries a sequence number (the bounded queue of Dmitry Vyukov): a producer claims a slot with a
+// CAS on m_enqueuePos and publishes it by storing pos + 1 into the cell's sequence; the consumer releases the
+// cell for the next lap by storing pos + N.  Producers never write the same cell, and the consumer never
+// reads a claimed cell before it is published, so neither side takes a lock.  A cell that is claimed but not
+// yet published reads as empty until its producer finishes.
+//
+// Push on a full ring fails and counts an overflow rather than blocking.
+//
+template <typename T, size_t N>
+struct MPSCQueue
+{
+    static_assert((N & (N - 1)) == 0, "MPSCQueue size must be a power of two");
+    static constexpr size_t x_mask = N - 1;
+    static constexpr size_t x_cacheLine = 64;
+
+    struct Metrics
+    {
+        size_t m_pushCount;
+        size_t m_overflowCount;
+        size_t m_highWater;
+    };
+
+    struct Cell
+    {
+        std::atomic<size_t> m_sequence;
+        T m_value;
+    };
+
+    // The producer and consumer indices live on their own cache lines, so producers contending on
+    // m_enqueuePos do not invalidate the consumer's line and vice versa.
+    //
+    alignas(x_cacheLine) std::atomic<size_t> m_enqueuePos;
+    alignas(x_cacheLine) std::atomic<size_t> m_dequeuePos;
+    alignas(x_cacheLine) std::atomic<size_t> m_pushCount;
+    std::atomic<size_t> m_overflowCount;
+
+    // Only the consumer stores it; GetMetrics may read it from any thread.
+    //
+    std::atomic<size_t> m_highWater;
+    alignas(x_cacheLine) Cell m_cells[N];
+
+    MPSCQueue()
+        : m_enqueuePos(0)
+        , m_dequeuePos(0)
+        , m_pushCount(0)
+        , m_overflowCount(0)
+        , m_highWater(0)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool Push(const T& value)
+    {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &m_cells[pos & x_mask];
+            size_t sequence = cell->m_sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                m_overflowCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->m_value = value;
+        cell->m_sequence.store(pos + 1, std::memory_order_release);
+        m_pushCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Consumer side.
+    //
+    T* PeekPtr()
+    {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell = &m_cells[pos & x_mask];
+        if (cell->m_sequence.load(std::memory_order_acquire) != pos + 1)
+        {
+            return nullptr;
+        }
+
+        return &cell->m_value;
+    }
+
+    bool Peek(T& value)
+    {
+        T* ptr = PeekPtr();
+        if (!ptr)
+        {
+            return false;
+        }
+
+        value = *ptr;
+        return true;
+    }
+
+    // Releases the cell returned by PeekPtr.
+    //
+    void Pop()
+    {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        size_t depth = m_enqueuePos.load(std::memory_order_relaxed) - pos;
+        if (depth > m_highWater.load(std::memory_order_relaxed))
+        {
+            m_highWater.store(depth, std::memory_order_relaxed);
+        }
+
+        m_cells[pos & x_mask].m_sequence.store(pos + N, std::memory_order_release);
+        m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+    }
+
+    bool Pop(T& value)
+    {
+        if (!Peek(value))
+        {
+            return false;
+        }
+
+        Pop();
+        return true;
+    }
+
+    // Pops up to maxCount published values in order, stopping at the first unpublished cell.
+    //
+    size_t PopBatch(T* values, size_t maxCount)
+    {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        size_t depth = m_enqueuePos.load(std::memory_order_relaxed) - pos;
+        if (depth > m_highWater.load(std::memory_order_relaxed))
+        {
+            m_highWater.store(depth, std::memory_order_relaxed);
+        }
+
+        size_t count = 0;
+        while (count < maxCount)
+        {
+            Cell* cell = &m_cells[(pos + count) & x_mask];
+            if (cell->m_sequence.load(std::memory_order_acquire) != pos + count + 1)
+            {
+                break;
+            }
+
+            values[count] = cell->m_value;
+            cell->m_sequence.store(pos + count + N, std::memory_order_release);
+            ++count;
+        }
+
+        m_dequeuePos.store(pos + count, std::memory_order_relaxed);
+        return count;
+    }
+
+    size_t Size() const
+    {
+        return m_enqueuePos.load(std::memory_order_relaxed) - m_dequeuePos.load(std::memory_order_relaxed);
+    }
+
+    bool IsEmpty() const
+    {
+        return Size() == 0;
+    }
+
+    Metrics GetMetrics() const
+    {
+        return Metrics{
+            m_pushCount.load(std::memory_order_relaxed),
+            m_overflowCount.load(std::memory_order_relaxed),
+            m_highWater.load(std::memory_order_relaxed)};
+    }
+};
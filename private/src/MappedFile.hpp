@@ -0,0 +1,215 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only view of a whole file.  On POSIX the file is mmapped, so opening costs no copy and pages are only
+// read from disk when touched.  Elsewhere it falls back to reading the file into memory.
+//
+// Move-only; the view stays valid until Close or destruction.
+//
+// Touching the mapping after the file is truncated raises SIGBUS, so readers that keep a file open (streamed
+// sample files) copy bytes out with Read instead, which comes up short rather than faulting.
+//
+struct MappedFile
+{
+    const uint8_t* m_bytes;
+    size_t m_size;
+    void* m_mapping;
+    int m_fd;
+    std::vector<uint8_t> m_fallback;
+
+    MappedFile()
+        : m_bytes(nullptr)
+        , m_size(0)
+        , m_mapping(nullptr)
+        , m_fd(-1)
+    {
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other)
+        : MappedFile()
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile& operator=(MappedFile&& other)
+    {
+        if (this != &other)
+        {
+            Close();
+            m_bytes = other.m_bytes;
+            m_size = other.m_size;
+            m_mapping = other.m_mapping;
+            m_fd = other.m_fd;
+            m_fallback = std::move(other.m_fallback);
+            other.m_bytes = nullptr;
+            other.m_size = 0;
+            other.m_mapping = nullptr;
+            other.m_fd = -1;
+        }
+
+        return *this;
+    }
+
+    ~MappedFile()
+    {
+        Close();
+    }
+
+    bool Open(const char* fileName)
+    {
+        Close();
+
+#if !defined(_WIN32)
+        int fd = ::open(fileName, O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat fileStatus;
+        if (::fstat(fd, &fileStatus) != 0 || fileStatus.st_size <= 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        size_t size = static_cast<size_t>(fileStatus.st_size);
+        void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        m_mapping = mapping;
+        m_fd = fd;
+        m_bytes = static_cast<const uint8_t*>(mapping);
+        m_size = size;
+        return true;
+#else
+        std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            return false;
+        }
+
+        std::streamoff end = file.tellg();
+        if (end <= 0)
+        {
+            return false;
+        }
+
+        m_fallback.resize(static_cast<size_t>(end));
+        file.seekg(0, std::ios::beg);
+        if (!file.read(reinterpret_cast<char*>(m_fallback.data()), end))
+        {
+            m_fallback.clear();
+            return false;
+        }
+
+        m_bytes = m_fallback.data();
+        m_size = m_fallback.size();
+        return true;
+#endif
+    }
+
+    void Close()
+    {
+#if !defined(_WIN32)
+        if (m_mapping)
+        {
+            ::munmap(m_mapping, m_size);
+        }
+
+        if (0 <= m_fd)
+        {
+            ::close(m_fd);
+        }
+#endif
+
+        m_mapping = nullptr;
+        m_fd = -1;
+        m_fallback.clear();
+        m_bytes = nullptr;
+        m_size = 0;
+    }
+
+    bool IsOpen() const
+    {
+        return m_bytes != nullptr;
+    }
+
+    // Copies [offset, offset + length) of the file as opened into dest and returns the bytes copied.  Bytes past
+    // the end, or lost to a truncation since Open, read as zero.
+    //
+    size_t Read(size_t offset, void* dest, size_t length) const
+    {
+        uint8_t* out = static_cast<uint8_t*>(dest);
+        size_t wanted = offset < m_size ? std::min(length, m_size - offset) : 0;
+        size_t done = 0;
+#if !defined(_WIN32)
+        while (done < wanted)
+        {
+            ssize_t count = ::pread(m_fd, out + done, wanted - done, static_cast<off_t>(offset + done));
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if (count <= 0)
+            {
+                break;
+            }
+
+            done += static_cast<size_t>(count);
+        }
+#else
+        if (0 < wanted)
+        {
+            std::memcpy(out, m_bytes + offset, wanted);
+            done = wanted;
+        }
+#endif
+
+        std::memset(out + done, 0, length - done);
+        return done;
+    }
+
+    // Tells the OS the range will be read soon.  Only a hint; harmless if ignored.
+    //
+    void WillNeed(size_t offset, size_t length) const
+    {
+#if !defined(_WIN32)
+        if (!m_mapping || m_size <= offset)
+        {
+            return;
+        }
+
+        static const size_t x_pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        size_t begin = offset - offset % x_pageSize;
+        size_t end = std::min(m_size, offset + length);
+        ::madvise(const_cast<uint8_t*>(m_bytes) + begin, end - begin, MADV_WILLNEED);
+#else
+        (void)offset;
+        (void)length;
+#endif
+    }
+};
@@ -1,6 +1,7 @@
 #pragma once
 
-#include "CircularQueue.hpp"
+#include "MPSCQueue.hpp"
+#include "PriorityQueue.hpp"
 #include "MessageIn.hpp"
 #include "BasicMidi.hpp"
 #include "MessageInLatency.hpp"
@@ -10,22 +11,59 @@ namespace SmartGrid
 {
     struct MessageInBus
     {
-        CircularQueue<MessageIn, 16384> m_queue;
+        static constexpr size_t x_numRoutes = 16;
+        static constexpr size_t x_maxStaged = 1024;
+        static constexpr size_t x_stageBatch = 64;
+
+        // Messages the consumer has seen, keyed by release time.  Ties release in arrival order.
+        //
+        struct Staged
+        {
+            MessageIn m_msg;
+            size_t m_sequence;
+
+            bool operator<(const Staged& other) const
+            {
+                if (m_msg.m_timestamp != other.m_msg.m_timestamp)
+                {
+                    return m_msg.m_timestamp > other.m_msg.m_timestamp;
+                }
+
+                return m_sequence > other.m_sequence;
+            }
+        };
+
+        // Every MIDI input callback, the UI thread and the audio thread push here, so the ring is
+        // multi-producer.
+        //
+        MPSCQueue<MessageIn, 16384> m_queue;
         MidiToMessageIn m_midiToMessageIn;
 
+        // The producer pushes source timestamps.  The consumer moves new arrivals into m_staged, measures
+        // their delay on their route and schedules them at source time plus that route's latency.  Messages
+        // with an out-of-range route share the last slot.
+        //
+        PriorityQueue<Staged, x_maxStaged> m_staged;
+        MessageIn m_stageBatch[x_stageBatch];
+        MessageInLatency::Route m_routes[x_numRoutes + 1];
+        size_t m_sequence;
+        size_t m_pollUs;
+        size_t m_prevPollUs;
+
         MessageInBus()
             : m_queue{}
             , m_midiToMessageIn{}
+            , m_sequence(0)
+            , m_pollUs(0)
+            , m_prevPollUs(0)
         {
         }
 
         bool Push(MessageIn msg)
         {
-            msg.m_timestamp = MessageInLatency::WithLatency(msg.m_timestamp);
-
             if (!m_queue.Push(msg))
             {
-                INFO("MessageInBus push failed");
+                INFO_RATE_LIMITED("MessageInBus push failed");
                 return false;
             }
 
@@ -48,22 +86,90 @@ namespace SmartGrid
             m_midiToMessageIn.SetRouteType(route, routeType);
         }
 
-        bool Pop(MessageIn& msg, size_t timestamp)
+        MessageInLatency::Route& GetRoute(int route)
         {
-            if (!m_queue.Peek(msg))
+            if (route < 0 || route >= static_cast<int>(x_numRoutes))
             {
-                return false;
+                return m_routes[x_numRoutes];
             }
-            
-            if (msg.Visible(timestamp))
+
+            return m_routes[route];
+        }
+
+        // Fixed mode releases every message of the route exactly latencyUs after its source timestamp.
+        //
+        void SetFixedLatency(int route, size_t latencyUs)
+        {
+            GetRoute(route).SetFixed(latencyUs);
+        }
+
+        void SetFixedLatency(size_t latencyUs)
+        {
+            for (MessageInLatency::Route& route : m_routes)
             {
-                m_queue.Pop();
-                return true;
+                route.SetFixed(latencyUs);
+            }
+        }
+
+        void SetAdaptiveLatency(float lateTarget = MessageInLatency::x_defaultLateTarget)
+        {
+            for (MessageInLatency::Route& route : m_routes)
+            {
+                route.SetAdaptive(lateTarget);
             }
-            else
+        }
+
+        const MessageInLatency::Metrics& GetMetrics(int route)
+        {
+            return GetRoute(route).m_metrics;
+        }
+
+        MPSCQueue<MessageIn, 16384>::Metrics GetQueueMetrics() const
+        {
+            return m_queue.GetMetrics();
+        }
+
+        // A message is late if it could have been released at an earlier poll, so the previous distinct poll
+        // time is kept alongside the current one.
+        //
+        void Stage(size_t timestamp)
+        {
+            if (timestamp != m_pollUs)
+            {
+                m_prevPollUs = m_pollUs;
+                m_pollUs = timestamp;
+            }
+
+            while (m_queue.PeekPtr())
+            {
+                size_t room = std::min(x_stageBatch, x_maxStaged - m_staged.Size());
+                size_t count = m_queue.PopBatch(m_stageBatch, room);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    MessageIn& msg = m_stageBatch[i];
+                    msg.m_timestamp = GetRoute(msg.m_routeId).Observe(msg.m_timestamp, timestamp, m_prevPollUs);
+                    m_staged.Push(Staged{msg, m_sequence});
+                    ++m_sequence;
+                }
+
+                if (count < room || room == 0)
+                {
+                    break;
+                }
+            }
+        }
+
+        bool Pop(MessageIn& msg, size_t timestamp)
+        {
+            Stage(timestamp);
+
+            if (m_staged.IsEmpty() || !m_staged.Peek().m_msg.Visible(timestamp))
             {
                 return false;
             }
+
+            msg = m_staged.Pop().m_msg;
+            return true;
         }
 
         template<class T>
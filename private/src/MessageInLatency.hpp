@@ -1,16 +1,209 @@
 #pragma once
 
 #include <cstddef>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
 
 namespace SmartGrid
 {
     struct MessageInLatency
     {
+        // Fixed-mode latency, and the ceiling (and warm-up value) of the adaptive latency.
+        //
         static constexpr size_t x_latencyUs = 20000;
+        static constexpr size_t x_minLatencyUs = 1000;
+
+        // Arrival delays are histogrammed in x_binUs bins up to x_latencyUs, with one overflow bin.
+        //
+        static constexpr size_t x_binUs = 250;
+        static constexpr size_t x_numBins = x_latencyUs / x_binUs + 1;
+
+        // The histogram covers the last one to two windows of arrivals.  Until x_warmupCount arrivals
+        // have been seen the route keeps the fixed latency.
+        //
+        static constexpr size_t x_windowSize = 256;
+        static constexpr size_t x_warmupCount = 64;
+        static constexpr float x_defaultLateTarget = 0.01f;
 
         static size_t WithLatency(size_t timestamp)
         {
             return timestamp + x_latencyUs;
         }
+
+        enum class Mode : int
+        {
+            Fixed,
+            Adaptive
+        };
+
+        struct Metrics
+        {
+            float m_jitterUs;
+            size_t m_latencyUs;
+            size_t m_lateCount;
+            size_t m_messageCount;
+
+            Metrics()
+                : m_jitterUs(0)
+                , m_latencyUs(x_latencyUs)
+                , m_lateCount(0)
+                , m_messageCount(0)
+            {
+            }
+        };
+
+        // Per-route de-jitter state.  Observe() is called by the consumer with the delay between a message's
+        // source timestamp and the first poll that saw it.  The chosen latency is the smallest bin edge such
+        // that the fraction of recent delays above it is at most the late target.  It is chosen again at each
+        // window roll, and after any delay above the current latency, in which case it can only go up.
+        //
+        struct Route
+        {
+            Mode m_mode;
+            float m_lateTarget;
+            size_t m_fixedLatencyUs;
+
+            size_t m_counts[2][x_numBins];
+            size_t m_windowCount[2];
+            size_t m_currentWindow;
+
+            size_t m_prevDelayUs;
+            size_t m_lastReleaseUs;
+            Metrics m_metrics;
+
+            Route()
+                : m_mode(Mode::Adaptive)
+                , m_lateTarget(x_defaultLateTarget)
+                , m_fixedLatencyUs(x_latencyUs)
+                , m_currentWindow(0)
+                , m_prevDelayUs(0)
+                , m_lastReleaseUs(0)
+            {
+                Reset();
+            }
+
+            void Reset()
+            {
+                memset(m_counts, 0, sizeof(m_counts));
+                m_windowCount[0] = 0;
+                m_windowCount[1] = 0;
+                m_prevDelayUs = 0;
+                m_metrics = Metrics();
+                m_metrics.m_latencyUs = m_mode == Mode::Fixed ? m_fixedLatencyUs : x_latencyUs;
+            }
+
+            void SetFixed(size_t latencyUs)
+            {
+                m_mode = Mode::Fixed;
+                m_fixedLatencyUs = latencyUs;
+                m_metrics.m_latencyUs = latencyUs;
+            }
+
+            void SetAdaptive(float lateTarget)
+            {
+                m_mode = Mode::Adaptive;
+                m_lateTarget = lateTarget;
+                m_metrics.m_latencyUs = ChooseLatency();
+            }
+
+            size_t LatencyUs() const
+            {
+                return m_metrics.m_latencyUs;
+            }
+
+            static size_t BinForDelay(size_t delayUs)
+            {
+                return std::min((delayUs + x_binUs - 1) / x_binUs, x_numBins - 1);
+            }
+
+            size_t ChooseLatency() const
+            {
+                size_t total = m_windowCount[0] + m_windowCount[1];
+                if (total < x_warmupCount)
+                {
+                    return x_latencyUs;
+                }
+
+                // Walk down from the overflow bin while the delays above the bin edge stay within the target.
+                //
+                size_t allowed = static_cast<size_t>(static_cast<float>(total) * m_lateTarget);
+                size_t above = 0;
+                size_t bin = x_numBins - 1;
+                while (bin > 0)
+                {
+                    size_t count = m_counts[0][bin] + m_counts[1][bin];
+                    if (above + count > allowed)
+                    {
+                        break;
+                    }
+
+                    above += count;
+                    --bin;
+                }
+
+                return std::clamp(bin * x_binUs, x_minLatencyUs, x_latencyUs);
+            }
+
+            // Returns the release time for a message with source timestamp sourceUs, first seen at nowUs, and
+            // records it.  A message is late if its release time had already passed at the previous poll.
+            //
+            size_t Observe(size_t sourceUs, size_t nowUs, size_t prevPollUs)
+            {
+                size_t delayUs = nowUs > sourceUs ? nowUs - sourceUs : 0;
+
+                // Interarrival jitter as in RFC 3550: a 1/16 smoothed mean of the change in delay.
+                //
+                float delta = std::abs(static_cast<float>(delayUs) - static_cast<float>(m_prevDelayUs));
+                if (m_metrics.m_messageCount > 0)
+                {
+                    m_metrics.m_jitterUs += (delta - m_metrics.m_jitterUs) / 16.0f;
+                }
+
+                m_prevDelayUs = delayUs;
+                ++m_metrics.m_messageCount;
+
+                // Never release a route's messages out of order, even when the latency drops.
+                //
+                size_t releaseUs = std::max(sourceUs + LatencyUs(), m_lastReleaseUs);
+                m_lastReleaseUs = releaseUs;
+                if (releaseUs <= prevPollUs)
+                {
+                    ++m_metrics.m_lateCount;
+                }
+
+                if (m_mode == Mode::Adaptive)
+                {
+                    AddDelay(delayUs);
+                }
+
+                return releaseUs;
+            }
+
+            void AddDelay(size_t delayUs)
+            {
+                ++m_counts[m_currentWindow][BinForDelay(delayUs)];
+                ++m_windowCount[m_currentWindow];
+
+                bool rolled = false;
+                if (m_windowCount[m_currentWindow] == x_windowSize)
+                {
+                    m_currentWindow = 1 - m_currentWindow;
+                    memset(m_counts[m_currentWindow], 0, sizeof(m_counts[m_currentWindow]));
+                    m_windowCount[m_currentWindow] = 0;
+                    rolled = true;
+                }
+
+                size_t total = m_windowCount[0] + m_windowCount[1];
+                if (rolled || total == x_warmupCount)
+                {
+                    m_metrics.m_latencyUs = ChooseLatency();
+                }
+                else if (total > x_warmupCount && delayUs > m_metrics.m_latencyUs)
+                {
+                    m_metrics.m_latencyUs = std::max(m_metrics.m_latencyUs, ChooseLatency());
+                }
+            }
+        };
     };
 }
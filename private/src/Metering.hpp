@@ -59,11 +59,21 @@ struct Meter
         m_reduction = m_reduction * (1 - x_smoothingAlphaReduction) + reduction * x_smoothingAlphaReduction;
     }
 
+    static float Saturate(float input)
+    {
+        return std::atan(input * M_PI / 2) / (M_PI / 2);
+    }
+
+    static float Reduction(float input, float output)
+    {
+        return std::max(0.00000000001f, std::abs(output)) / std::max(0.00000000001f, std::abs(input));
+    }
+
     float ProcessAndSaturate(float input, float* reduction)
     {
-        float output = std::atan(input * M_PI / 2) / (M_PI / 2);
+        float output = Saturate(input);
         Process(output);
-        *reduction = std::max(0.00000000001f, std::abs(output)) / std::max(0.00000000001f, std::abs(input));
+        *reduction = Reduction(input, output);
         ProcessReduction(*reduction);
         return output;
     }
@@ -182,6 +192,24 @@ struct MultichannelMeter
         }
         return input;
     }
+
+    // Lane form: saturate every channel in one sweep, then run the (branchy) meter updates.
+    //
+    void ProcessAndSaturate(float* inOut)
+    {
+        float saturated[Size];
+        for (size_t i = 0; i < Size; ++i)
+        {
+            saturated[i] = Meter::Saturate(inOut[i]);
+        }
+
+        for (size_t i = 0; i < Size; ++i)
+        {
+            m_meters[i].Process(saturated[i]);
+            m_meters[i].ProcessReduction(Meter::Reduction(inOut[i], saturated[i]));
+            inOut[i] = saturated[i];
+        }
+    }
 };
 
 template<size_t Size>
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+namespace SmartGrid
+{
+    // Per-route MIDI output bandwidth limit, as a generic cell rate algorithm: each route keeps the time at
+    // which its link will have drained everything charged to it so far.  A route may run up to x_burstUs
+    // ahead of now before it counts as full.
+    //
+    // Timing-critical output (clock, encoder feedback) is charged with Spend and always goes out.  Bulk
+    // output (LED colours) asks Available first and sends only what fits, so it soaks up whatever the
+    // timing-critical traffic leaves over.
+    //
+    // Lock-free, so the sender thread and the frame thread can share routes.  Times are on the caller's
+    // clock, in microseconds.
+    //
+    struct MidiOutputBudget
+    {
+        static constexpr size_t x_maxRoutes = 16;
+
+        // About what a Launchpad's USB MIDI endpoint sustains without falling behind.
+        //
+        static constexpr size_t x_defaultBytesPerMs = 32;
+        static constexpr size_t x_burstUs = 4000;
+
+        enum class Priority : int
+        {
+            Realtime = 0,
+            Bulk = 1,
+            NumPriorities = 2
+        };
+
+        struct Route
+        {
+            std::atomic<size_t> m_drainedUs;
+            std::atomic<size_t> m_bytes[static_cast<int>(Priority::NumPriorities)];
+            std::atomic<size_t> m_deferredCount;
+
+            Route()
+                : m_drainedUs(0)
+                , m_bytes{}
+                , m_deferredCount(0)
+            {
+            }
+        };
+
+        size_t m_bytesPerMs;
+        Route m_routes[x_maxRoutes];
+
+        MidiOutputBudget()
+            : m_bytesPerMs(x_defaultBytesPerMs)
+        {
+        }
+
+        size_t CostUs(size_t bytes) const
+        {
+            return bytes * 1000 / m_bytesPerMs;
+        }
+
+        // Bytes the route can take now without running more than x_burstUs ahead.
+        //
+        size_t Available(int routeId, size_t nowUs) const
+        {
+            if (routeId < 0 || static_cast<size_t>(routeId) >= x_maxRoutes)
+            {
+                return 0;
+            }
+
+            size_t drainedUs = std::max(m_routes[routeId].m_drainedUs.load(std::memory_order_relaxed), nowUs);
+            size_t headroomUs = nowUs + x_burstUs - std::min(drainedUs, nowUs + x_burstUs);
+            return headroomUs * m_bytesPerMs / 1000;
+        }
+
+        // Charges bytes already committed to the route.
+        //
+        void Spend(int routeId, size_t bytes, size_t nowUs, Priority priority)
+        {
+            if (routeId < 0 || static_cast<size_t>(routeId) >= x_maxRoutes)
+            {
+                return;
+            }
+
+            Route& route = m_routes[routeId];
+            size_t costUs = CostUs(bytes);
+            size_t drainedUs = route.m_drainedUs.load(std::memory_order_relaxed);
+            while (!route.m_drainedUs.compare_exchange_weak(
+                       drainedUs, std::max(drainedUs, nowUs) + costUs, std::memory_order_relaxed))
+            {
+            }
+
+            route.m_bytes[static_cast<int>(priority)].fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        // Bulk output the route had to hold back for lack of budget.
+        //
+        void Defer(int routeId)
+        {
+            if (routeId < 0 || static_cast<size_t>(routeId) >= x_maxRoutes)
+            {
+                return;
+            }
+
+            m_routes[routeId].m_deferredCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        size_t GetBytes(int routeId, Priority priority) const
+        {
+            return m_routes[routeId].m_bytes[static_cast<int>(priority)].load(std::memory_order_relaxed);
+        }
+
+        size_t GetDeferredCount(int routeId) const
+        {
+            return m_routes[routeId].m_deferredCount.load(std::memory_order_relaxed);
+        }
+    };
+}
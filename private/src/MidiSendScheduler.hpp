@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+
+#include "BasicMidi.hpp"
+#include "MPSCQueue.hpp"
+#include "PriorityQueue.hpp"
+#include "WakeSignal.hpp"
+
+namespace SmartGrid
+{
+    // Timestamped MIDI output scheduling for MidiSender.  Any thread may Push; one sender thread calls
+    // Dispatch with the current time, which sends every due message (coalesced into one burst per route),
+    // then sleeps in WaitUntil until the next due time or until a Push wakes it.
+    //
+    // A message is due at its timestamp plus the send latency.  Timestamp 0 means send at once.
+    //
+    // Push is called from the audio thread, so it never blocks: the sleeper publishes its deadline, and Push
+    // only signals the WakeSignal for a message due before it.  Messages due later are picked up when the
+    // sender wakes anyway.
+    //
+    struct MidiSendScheduler
+    {
+        static constexpr size_t x_maxRoutes = 16;
+        static constexpr size_t x_maxPending = 4096;
+        static constexpr size_t x_maxBurst = 64;
+        static constexpr size_t x_never = std::numeric_limits<size_t>::max();
+
+        struct Pending
+        {
+            size_t m_dueUs;
+            size_t m_sequence;
+            BasicMidi m_msg;
+
+            bool operator<(const Pending& other) const
+            {
+                if (m_dueUs != other.m_dueUs)
+                {
+                    return m_dueUs > other.m_dueUs;
+                }
+
+                return m_sequence > other.m_sequence;
+            }
+        };
+
+        // Send jitter is the dispatch time minus the due time, over scheduled (non-immediate) messages.
+        //
+        struct Metrics
+        {
+            size_t m_sentCount;
+            size_t m_burstCount;
+            float m_jitterUs;
+            size_t m_maxJitterUs;
+            size_t m_wakeCount;
+        };
+
+        MPSCQueue<BasicMidi, 16384> m_queue;
+        PriorityQueue<Pending, x_maxPending> m_pending;
+        size_t m_latencyUs;
+        size_t m_sequence;
+
+        BasicMidi m_bursts[x_maxRoutes][x_maxBurst];
+        size_t m_burstSize[x_maxRoutes];
+
+        WakeSignal m_wake;
+
+        // The deadline the sender is sleeping until, or 0 while it is awake (it drains the queue before it
+        // sleeps again, so nothing pushed meanwhile needs a wake).
+        //
+        std::atomic<size_t> m_deadlineUs;
+
+        Metrics m_metrics;
+
+        explicit MidiSendScheduler(size_t latencyUs)
+            : m_latencyUs(latencyUs)
+            , m_sequence(0)
+            , m_deadlineUs(0)
+            , m_metrics{}
+        {
+            for (size_t i = 0; i < x_maxRoutes; ++i)
+            {
+                m_burstSize[i] = 0;
+            }
+        }
+
+        bool Push(const BasicMidi& msg)
+        {
+            bool pushed = m_queue.Push(msg);
+
+            // Pairs with the fence in WaitUntil: either the sender drains this message after publishing its
+            // deadline, or this sees the deadline and wakes it if the message is due first.
+            //
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (DueUs(msg) < m_deadlineUs.load(std::memory_order_relaxed))
+            {
+                m_wake.Signal();
+            }
+
+            return pushed;
+        }
+
+        void Wake()
+        {
+            m_wake.Signal();
+        }
+
+        size_t DueUs(const BasicMidi& msg) const
+        {
+            return msg.m_timestamp == 0 ? 0 : msg.m_timestamp + m_latencyUs;
+        }
+
+        // Sender thread only.
+        //
+        void Drain()
+        {
+            BasicMidi* msg;
+            while (m_pending.Size() < x_maxPending && (msg = m_queue.PeekPtr()))
+            {
+                m_pending.Push(Pending{DueUs(*msg), m_sequence, *msg});
+                ++m_sequence;
+                m_queue.Pop();
+            }
+        }
+
+        size_t NextDueUs()
+        {
+            Drain();
+            return m_pending.IsEmpty() ? x_never : m_pending.Peek().m_dueUs;
+        }
+
+        // Drops everything queued or pending.
+        //
+        void Clear()
+        {
+            Drain();
+            while (!m_pending.IsEmpty())
+            {
+                m_pending.Pop();
+                Drain();
+            }
+        }
+
+        // Sends every message due at nowUs.  sink->SendBurst(routeId, msgs, count) is called once per route
+        // with that route's messages in order, more than once only if a route has over x_maxBurst due.
+        // Returns the number of messages sent.
+        //
+        template<class Sink>
+        size_t Dispatch(size_t nowUs, Sink* sink)
+        {
+            size_t sent = 0;
+            Drain();
+            while (!m_pending.IsEmpty() && m_pending.Peek().m_dueUs <= nowUs)
+            {
+                Pending pending = m_pending.Pop();
+                int route = pending.m_msg.m_routeId;
+                if (route < 0 || route >= static_cast<int>(x_maxRoutes))
+                {
+                    continue;
+                }
+
+                if (pending.m_dueUs != 0)
+                {
+                    size_t jitterUs = nowUs - pending.m_dueUs;
+                    m_metrics.m_jitterUs += (static_cast<float>(jitterUs) - m_metrics.m_jitterUs) / 16.0f;
+                    m_metrics.m_maxJitterUs = std::max(m_metrics.m_maxJitterUs, jitterUs);
+                }
+
+                m_bursts[route][m_burstSize[route]] = pending.m_msg;
+                ++m_burstSize[route];
+                ++sent;
+                if (m_burstSize[route] == x_maxBurst)
+                {
+                    Flush(route, sink);
+                }
+
+                Drain();
+            }
+
+            for (size_t route = 0; route < x_maxRoutes; ++route)
+            {
+                if (m_burstSize[route] > 0)
+                {
+                    Flush(route, sink);
+                }
+            }
+
+            m_metrics.m_sentCount += sent;
+            return sent;
+        }
+
+        template<class Sink>
+        void Flush(size_t route, Sink* sink)
+        {
+            sink->SendBurst(static_cast<int>(route), m_bursts[route], m_burstSize[route]);
+            m_burstSize[route] = 0;
+            ++m_metrics.m_burstCount;
+        }
+
+        // Sleeps until deadlineUs (on the caller's clock, now being nowUs) or until Wake or a Push due before
+        // it.  Returns true if woken early.
+        //
+        bool WaitUntil(size_t nowUs, size_t deadlineUs)
+        {
+            if (deadlineUs <= nowUs)
+            {
+                return false;
+            }
+
+            m_deadlineUs.store(deadlineUs, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            // Anything pushed before the deadline was published is drained here instead of signalled.
+            //
+            if (NextDueUs() < deadlineUs)
+            {
+                m_deadlineUs.store(0, std::memory_order_relaxed);
+                return true;
+            }
+
+            bool woken = m_wake.Wait(std::chrono::microseconds(deadlineUs - nowUs));
+            m_deadlineUs.store(0, std::memory_order_relaxed);
+            ++m_metrics.m_wakeCount;
+            return woken;
+        }
+    };
+}
@@ -10,7 +10,9 @@
 template<size_t NumBands, size_t NumChannels>
 struct MultibandSaturator
 {
-    LinkwitzRileyCrossover m_linkwitzRileyCrossover[NumChannels][NumBands - 1];
+    // One crossover per cut, with the channels in lanes: bands are built for all channels at once.
+    //
+    MultichannelLinkwitzRileyCrossover<NumChannels> m_linkwitzRileyCrossover[NumBands - 1];
 
     float m_output[NumChannels];
     float m_sub;
@@ -131,24 +133,27 @@ struct MultibandSaturator
         }
     };
 
-    void BuildBandsRecursive(float* bands, float in, size_t size, size_t index, size_t channel)
+    void BuildBandsRecursive(float (*bands)[NumChannels], const float* in, size_t size, size_t index)
     {
         if (size == 1)
         {
-            bands[index] = in;
+            for (size_t i = 0; i < NumChannels; ++i)
+            {
+                bands[index][i] = in[i];
+            }
         }
         else if (size == 2)
         {
-            LinkwitzRileyCrossover::CrossoverOutput crossover = m_linkwitzRileyCrossover[channel][index].Process(in);
-            bands[index] = crossover.m_lowPass;
-            bands[index + 1] = crossover.m_highPass;        
+            m_linkwitzRileyCrossover[index].Process(in, bands[index], bands[index + 1]);
         }
         else
         {
             size_t cutIndex = index + size / 2;
-            LinkwitzRileyCrossover::CrossoverOutput crossover = m_linkwitzRileyCrossover[channel][cutIndex - 1].Process(in);
-            BuildBandsRecursive(bands, crossover.m_lowPass, size / 2, index, channel);
-            BuildBandsRecursive(bands, crossover.m_highPass, (size + 1) / 2, cutIndex, channel);
+            float lowPass[NumChannels];
+            float highPass[NumChannels];
+            m_linkwitzRileyCrossover[cutIndex - 1].Process(in, lowPass, highPass);
+            BuildBandsRecursive(bands, lowPass, size / 2, index);
+            BuildBandsRecursive(bands, highPass, (size + 1) / 2, cutIndex);
         }
     }
 
@@ -207,55 +212,61 @@ struct MultibandSaturator
         return std::abs(TransferFunction(uiState, freq));
     }
     
-    void Process(const Input& input, float* in, bool monoTheBass)
+    void SetCrossoverFrequencies(const Input& input)
     {
-        float bands[NumChannels][NumBands];
-        for (size_t i = 0; i < NumChannels; ++i)
+        m_linkwitzRileyCrossover[0].SetCyclesPerSample(input.m_bassFreq.m_expParam);
+        float crossoverFreq = input.m_bassFreq.m_expParam;
+        for (size_t j = 1; j < NumBands - 1; ++j)
         {
-            for (size_t j = 0; j < NumBands; ++j)
-            {
-                bands[i][j] = 0.0f;
-            }
-
-            m_linkwitzRileyCrossover[i][0].SetCyclesPerSample(input.m_bassFreq.m_expParam);
-            float crossoverFreq = input.m_bassFreq.m_expParam;
-            for (size_t j = 1; j < NumBands - 1; ++j)
-            {
-                crossoverFreq *= input.m_crossoverFreqFactor[j - 1].m_expParam;
-                m_linkwitzRileyCrossover[i][j].SetCyclesPerSample(crossoverFreq);
-            }
+            crossoverFreq *= input.m_crossoverFreqFactor[j - 1].m_expParam;
+            m_linkwitzRileyCrossover[j].SetCyclesPerSample(crossoverFreq);
         }
+    }
+
+    void Process(const Input& input, float* in, bool monoTheBass)
+    {
+        SetCrossoverFrequencies(input);
+
+        float bands[NumBands][NumChannels];
+        BuildBandsRecursive(bands, in, NumBands, 0);
 
         for (size_t i = 0; i < NumChannels; ++i)
         {
-            BuildBandsRecursive(bands[i], in[i], NumBands, 0, i);
+            m_output[i] = 0.0f;
         }
 
-        m_sub = 0;
-        for (size_t i = 0; i < NumChannels; ++i)
+        for (size_t j = monoTheBass ? 1 : 0; j < NumBands; ++j)
         {
-            m_output[i] = 0.0f;
-            for (size_t j = monoTheBass ? 1 : 0; j < NumBands; ++j)
+            float band[NumChannels];
+            for (size_t i = 0; i < NumChannels; ++i)
             {
-                m_output[i] += m_meter[j].m_meters[i].ProcessAndSaturate(input.m_gain[j].m_expParam * bands[i][j]);
+                band[i] = input.m_gain[j].m_expParam * bands[j][i];
             }
 
-            if (monoTheBass)
+            m_meter[j].ProcessAndSaturate(band);
+            for (size_t i = 0; i < NumChannels; ++i)
             {
-                m_sub += bands[i][0];
+                m_output[i] += band[i];
             }
         }
 
+        m_sub = 0;
         if (monoTheBass)
         {
+            for (size_t i = 0; i < NumChannels; ++i)
+            {
+                m_sub += bands[0][i];
+            }
+
             m_sub = m_meter[0].m_meters[0].ProcessAndSaturate(input.m_gain[0].m_expParam * m_sub / NumChannels);
         }
 
         for (size_t i = 0; i < NumChannels; ++i)
         {
-            m_output[i] += m_sub;
-            m_output[i] = m_masterMeter.m_meters[i].ProcessAndSaturate(input.m_masterGain.m_expParam * m_output[i]);
+            m_output[i] = input.m_masterGain.m_expParam * (m_output[i] + m_sub);
         }
+
+        m_masterMeter.ProcessAndSaturate(m_output);
     }
 
     MultiChannelFloat<NumChannels> Process(const Input& input, MultiChannelFloat<NumChannels> in, bool monoTheBass)
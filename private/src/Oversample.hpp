@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include "ButterworthFilter.hpp"
 #include "SampleTimer.hpp"
 
@@ -21,21 +22,22 @@ struct Upsampler
 
     void Process(const float* input, float* output)
     {
+        // Zero-fill: place source sample at every m_oversampleRate position
+        //
         size_t outputSize = SampleTimer::x_controlFrameRate * m_oversampleRate;
         for (size_t i = 0; i < outputSize; ++i)
         {
-            // Zero-fill: place source sample at every m_oversampleRate position
-            //
-            float sample = 0.0f;
-            if (i % m_oversampleRate == 0)
-            {
-                sample = input[i / m_oversampleRate] * m_oversampleRate;
-            }
+            output[i] = 0.0f;
+        }
 
-            // Lowpass filter to remove imaging
-            //
-            output[i] = m_filter.Process(sample);
+        for (size_t i = 0; i < SampleTimer::x_controlFrameRate; ++i)
+        {
+            output[i * m_oversampleRate] = input[i] * m_oversampleRate;
         }
+
+        // Lowpass filter to remove imaging
+        //
+        m_filter.ProcessBlock(output, outputSize);
     }
 };
 
@@ -43,14 +45,17 @@ struct Downsampler
 {
     ButterworthFilter m_filter;
     size_t m_oversampleRate;
+    std::vector<float> m_filtered;
 
     Downsampler()
         : m_oversampleRate(1)
+        , m_filtered(SampleTimer::x_controlFrameRate)
     {
     }
 
     Downsampler(size_t oversampleRate)
         : m_oversampleRate(oversampleRate)
+        , m_filtered(SampleTimer::x_controlFrameRate * oversampleRate)
     {
         m_filter.SetCyclesPerSample(0.40 / m_oversampleRate);
     }
@@ -60,11 +65,13 @@ struct Downsampler
         size_t inputSize = SampleTimer::x_controlFrameRate * m_oversampleRate;
         for (size_t i = 0; i < inputSize; ++i)
         {
-            float filtered = m_filter.Process(input[i]);
-            if ((i + 1) % m_oversampleRate == 0)
-            {
-                output[i / m_oversampleRate] = filtered;
-            }
+            m_filtered[i] = input[i];
+        }
+
+        m_filter.ProcessBlock(m_filtered.data(), inputSize);
+        for (size_t i = 0; i < SampleTimer::x_controlFrameRate; ++i)
+        {
+            output[i] = m_filtered[(i + 1) * m_oversampleRate - 1];
         }
     }
 };
@@ -0,0 +1,421 @@
+#pragma once
+
+#include "JuceSon.hpp"
+#include "MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Binary patch files.  A patch is stored as its JSON tree flattened into fixed-size tables, so loading it is
+// a table walk into a JsonArena instead of a parse: no tokenizing, number conversion or string unescaping.
+// The decoded tree is an ordinary JSON tree and goes through the same FromJSON path as a parsed one.
+//
+// Layout, little-endian, version x_version:
+//
+//   Header
+//   Node     m_nodes[m_numNodes]        preorder; a container's children come after it
+//   uint32_t m_entries[m_numEntries]    array: child node indices; object: (key offset, child index) pairs
+//   char     m_strings[m_stringBytes]   NUL-terminated strings, keys deduplicated
+//
+// The conversion is lossless both ways: member order, duplicate keys, and the integer/real distinction are
+// kept, and reals are stored bit-exact.  A file that does not start with the magic is treated as JSON text,
+// so LoadFile reads either format.  Decode validates every offset and index, so a corrupt file fails to load
+// rather than producing a tree with dangling pointers or cycles.
+//
+struct PatchBinary
+{
+    static constexpr uint32_t x_version = 1;
+    static constexpr uint32_t x_byteOrderMark = 0x01020304;
+    static constexpr const char* x_extension = ".sgpatch";
+
+    struct Header
+    {
+        char m_magic[8];
+        uint32_t m_version;
+        uint32_t m_byteOrderMark;
+        uint32_t m_numNodes;
+        uint32_t m_rootIndex;
+        uint32_t m_numEntries;
+        uint32_t m_stringBytes;
+    };
+
+    // m_value holds the integer, the real's bits, the boolean, a string's offset, or a container's first
+    // entry.  m_count is a string's length or a container's size.
+    //
+    struct Node
+    {
+        uint8_t m_type;
+        uint8_t m_pad[3];
+        uint32_t m_count;
+        uint64_t m_value;
+    };
+
+    static_assert(sizeof(Header) == 32, "PatchBinary::Header layout");
+    static_assert(sizeof(Node) == 16, "PatchBinary::Node layout");
+
+    static const char* Magic()
+    {
+        return "SGPATCH";
+    }
+
+    static bool IsBinary(const uint8_t* data, size_t size)
+    {
+        return data && sizeof(Header) <= size && std::memcmp(data, Magic(), 8) == 0;
+    }
+
+    // ---- Encode ----
+    //
+    struct Encoder
+    {
+        std::vector<Node> m_nodes;
+        std::vector<uint32_t> m_entries;
+        std::string m_strings;
+        std::unordered_map<std::string, uint32_t> m_keyOffsets;
+
+        uint32_t AddString(const char* str)
+        {
+            uint32_t offset = static_cast<uint32_t>(m_strings.size());
+            m_strings.append(str ? str : "");
+            m_strings.push_back('\0');
+            return offset;
+        }
+
+        uint32_t AddKey(const char* key)
+        {
+            std::string name(key ? key : "");
+            auto it = m_keyOffsets.find(name);
+            if (it != m_keyOffsets.end())
+            {
+                return it->second;
+            }
+
+            uint32_t offset = AddString(name.c_str());
+            m_keyOffsets.emplace(std::move(name), offset);
+            return offset;
+        }
+
+        uint32_t AddNode(const JsonNode* node)
+        {
+            uint32_t index = static_cast<uint32_t>(m_nodes.size());
+            m_nodes.push_back(Node{});
+            Node encoded{};
+            encoded.m_type = static_cast<uint8_t>(node ? node->m_type : JsonType::Null);
+            switch (node ? node->m_type : JsonType::Null)
+            {
+                case JsonType::Null:
+                {
+                    break;
+                }
+
+                case JsonType::Boolean:
+                {
+                    encoded.m_value = node->m_bool ? 1 : 0;
+                    break;
+                }
+
+                case JsonType::Integer:
+                {
+                    std::memcpy(&encoded.m_value, &node->m_int, sizeof(encoded.m_value));
+                    break;
+                }
+
+                case JsonType::Real:
+                {
+                    std::memcpy(&encoded.m_value, &node->m_real, sizeof(encoded.m_value));
+                    break;
+                }
+
+                case JsonType::String:
+                {
+                    const char* str = node->m_str ? node->m_str : "";
+                    encoded.m_count = static_cast<uint32_t>(std::strlen(str));
+                    encoded.m_value = AddString(str);
+                    break;
+                }
+
+                case JsonType::Array:
+                {
+                    const JsonContainer& c = node->m_container;
+                    size_t first = m_entries.size();
+                    m_entries.resize(first + c.m_size);
+                    JsonNode* const* values = static_cast<JsonNode* const*>(c.m_entries);
+                    for (uint32_t i = 0; i < c.m_size; ++i)
+                    {
+                        uint32_t child = AddNode(values[i]);
+                        m_entries[first + i] = child;
+                    }
+
+                    encoded.m_count = c.m_size;
+                    encoded.m_value = first;
+                    break;
+                }
+
+                case JsonType::Object:
+                {
+                    const JsonContainer& c = node->m_container;
+                    size_t first = m_entries.size();
+                    m_entries.resize(first + 2 * static_cast<size_t>(c.m_size));
+                    const JsonMember* members = static_cast<const JsonMember*>(c.m_entries);
+                    for (uint32_t i = 0; i < c.m_size; ++i)
+                    {
+                        uint32_t key = AddKey(members[i].m_key);
+                        uint32_t child = AddNode(members[i].m_value);
+                        m_entries[first + 2 * i] = key;
+                        m_entries[first + 2 * i + 1] = child;
+                    }
+
+                    encoded.m_count = c.m_size;
+                    encoded.m_value = first;
+                    break;
+                }
+            }
+
+            m_nodes[index] = encoded;
+            return index;
+        }
+    };
+
+    // Flattens root into out.  Fails on a null tree.
+    //
+    static bool Encode(JSON root, std::vector<uint8_t>& out)
+    {
+        out.clear();
+        if (root.IsNull())
+        {
+            return false;
+        }
+
+        Encoder encoder;
+        uint32_t rootIndex = encoder.AddNode(root.m_node);
+
+        Header header{};
+        std::memcpy(header.m_magic, Magic(), 8);
+        header.m_version = x_version;
+        header.m_byteOrderMark = x_byteOrderMark;
+        header.m_numNodes = static_cast<uint32_t>(encoder.m_nodes.size());
+        header.m_rootIndex = rootIndex;
+        header.m_numEntries = static_cast<uint32_t>(encoder.m_entries.size());
+        header.m_stringBytes = static_cast<uint32_t>(encoder.m_strings.size());
+
+        size_t nodeBytes = encoder.m_nodes.size() * sizeof(Node);
+        size_t entryBytes = encoder.m_entries.size() * sizeof(uint32_t);
+        out.resize(sizeof(Header) + nodeBytes + entryBytes + encoder.m_strings.size());
+        uint8_t* cursor = out.data();
+        std::memcpy(cursor, &header, sizeof(Header));
+        cursor += sizeof(Header);
+        std::memcpy(cursor, encoder.m_nodes.data(), nodeBytes);
+        cursor += nodeBytes;
+        std::memcpy(cursor, encoder.m_entries.data(), entryBytes);
+        cursor += entryBytes;
+        std::memcpy(cursor, encoder.m_strings.data(), encoder.m_strings.size());
+        return true;
+    }
+
+    // ---- Decode ----
+    //
+    // Builds the tree into arena.  Returns JSON::Null() if the data is not a valid binary patch, or if the
+    // arena ran out (arena.Failed(); grow and retry as for JsonArena::Loads).
+    //
+    static JSON Decode(const uint8_t* data, size_t size, JsonArena& arena)
+    {
+        if (!IsBinary(data, size))
+        {
+            return JSON::Null();
+        }
+
+        Header header;
+        std::memcpy(&header, data, sizeof(Header));
+        if (header.m_version != x_version || header.m_byteOrderMark != x_byteOrderMark || header.m_numNodes == 0)
+        {
+            return JSON::Null();
+        }
+
+        uint64_t expectedSize = sizeof(Header)
+            + static_cast<uint64_t>(header.m_numNodes) * sizeof(Node)
+            + static_cast<uint64_t>(header.m_numEntries) * sizeof(uint32_t)
+            + header.m_stringBytes;
+        if (expectedSize != size || header.m_numNodes <= header.m_rootIndex)
+        {
+            return JSON::Null();
+        }
+
+        const uint8_t* nodeBytes = data + sizeof(Header);
+        const uint8_t* entryBytes = nodeBytes + static_cast<size_t>(header.m_numNodes) * sizeof(Node);
+        const char* strings = reinterpret_cast<const char*>(entryBytes + static_cast<size_t>(header.m_numEntries) * sizeof(uint32_t));
+        if (header.m_stringBytes > 0 && strings[header.m_stringBytes - 1] != '\0')
+        {
+            return JSON::Null();
+        }
+
+        // One copy of the string table; string values and keys point into it.
+        //
+        const char* arenaStrings = arena.CopyBytes(strings, header.m_stringBytes);
+        JsonNode* nodes = static_cast<JsonNode*>(arena.Alloc(static_cast<size_t>(header.m_numNodes) * sizeof(JsonNode), alignof(JsonNode)));
+        if (!arenaStrings || !nodes)
+        {
+            return JSON::Null();
+        }
+
+        auto entryAt = [entryBytes](uint64_t i)
+        {
+            uint32_t entry;
+            std::memcpy(&entry, entryBytes + i * sizeof(uint32_t), sizeof(entry));
+            return entry;
+        };
+
+        auto validString = [&header](uint64_t offset)
+        {
+            return offset < header.m_stringBytes;
+        };
+
+        for (uint32_t index = 0; index < header.m_numNodes; ++index)
+        {
+            Node encoded;
+            std::memcpy(&encoded, nodeBytes + static_cast<size_t>(index) * sizeof(Node), sizeof(Node));
+            JsonNode& node = nodes[index];
+            node.m_type = static_cast<JsonType>(encoded.m_type);
+            bool isObject = node.m_type == JsonType::Object;
+            switch (node.m_type)
+            {
+                case JsonType::Null:
+                {
+                    break;
+                }
+
+                case JsonType::Boolean:
+                {
+                    node.m_bool = encoded.m_value != 0;
+                    break;
+                }
+
+                case JsonType::Integer:
+                {
+                    std::memcpy(&node.m_int, &encoded.m_value, sizeof(node.m_int));
+                    break;
+                }
+
+                case JsonType::Real:
+                {
+                    std::memcpy(&node.m_real, &encoded.m_value, sizeof(node.m_real));
+                    break;
+                }
+
+                case JsonType::String:
+                {
+                    if (!validString(encoded.m_value) || !validString(encoded.m_value + encoded.m_count) || strings[encoded.m_value + encoded.m_count] != '\0')
+                    {
+                        return JSON::Null();
+                    }
+
+                    node.m_str = arenaStrings + encoded.m_value;
+                    break;
+                }
+
+                case JsonType::Array:
+                case JsonType::Object:
+                {
+                    uint64_t width = isObject ? 2 : 1;
+                    if (header.m_numEntries < encoded.m_value || header.m_numEntries - encoded.m_value < width * encoded.m_count)
+                    {
+                        return JSON::Null();
+                    }
+
+                    JsonContainer& c = node.m_container;
+                    c.m_arena = &arena;
+                    c.m_size = encoded.m_count;
+                    c.m_cap = encoded.m_count;
+                    c.m_entries = nullptr;
+                    if (encoded.m_count == 0)
+                    {
+                        break;
+                    }
+
+                    size_t elemSize = isObject ? sizeof(JsonMember) : sizeof(JsonNode*);
+                    c.m_entries = arena.Alloc(encoded.m_count * elemSize, alignof(JsonMember));
+                    if (!c.m_entries)
+                    {
+                        return JSON::Null();
+                    }
+
+                    for (uint32_t i = 0; i < encoded.m_count; ++i)
+                    {
+                        uint32_t child = entryAt(encoded.m_value + width * i + width - 1);
+
+                        // Children follow their parent, so the tree has no cycles.
+                        //
+                        if (child <= index || header.m_numNodes <= child)
+                        {
+                            return JSON::Null();
+                        }
+
+                        if (isObject)
+                        {
+                            uint32_t key = entryAt(encoded.m_value + 2 * i);
+                            if (!validString(key))
+                            {
+                                return JSON::Null();
+                            }
+
+                            JsonMember* members = static_cast<JsonMember*>(c.m_entries);
+                            members[i].m_key = arenaStrings + key;
+                            members[i].m_value = &nodes[child];
+                        }
+                        else
+                        {
+                            static_cast<JsonNode**>(c.m_entries)[i] = &nodes[child];
+                        }
+                    }
+
+                    break;
+                }
+
+                default:
+                {
+                    return JSON::Null();
+                }
+            }
+        }
+
+        return JSON(&nodes[header.m_rootIndex]);
+    }
+
+    // ---- Files ----
+    //
+    static bool WriteFile(const char* fileName, JSON root)
+    {
+        std::vector<uint8_t> bytes;
+        if (!Encode(root, bytes))
+        {
+            return false;
+        }
+
+        std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return static_cast<bool>(out);
+    }
+
+    // Loads a binary patch, or parses the file as JSON text if it is not one.  The file is memory-mapped, so
+    // a binary patch is decoded straight from the mapping.
+    //
+    static JSON LoadFile(const char* fileName, JsonArena& arena)
+    {
+        MappedFile file;
+        if (!file.Open(fileName))
+        {
+            return JSON::Null();
+        }
+
+        if (IsBinary(file.m_bytes, file.m_size))
+        {
+            return Decode(file.m_bytes, file.m_size, arena);
+        }
+
+        std::string text(reinterpret_cast<const char*>(file.m_bytes), file.m_size);
+        return arena.Loads(text.c_str());
+    }
+};
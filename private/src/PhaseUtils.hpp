@@ -1,6 +1,7 @@
 #pragma once
 #include <cmath>
 #include "AsyncLogger.hpp"
+#include "FastMath.hpp"
 
 namespace PhaseUtils
 {
@@ -124,7 +125,7 @@ struct ExpParam
         if (m_baseParam != value)
         {
             m_baseParam = value;
-            m_expParam = m_factor * std::powf(m_base, value);
+            m_expParam = m_factor * FastMath::PowPrecise(m_base, value);
         }
 
         return m_expParam;
@@ -132,7 +133,7 @@ struct ExpParam
 
     static float Compute(float min, float max, float value)
     {
-        return min * std::powf(max / min, value);
+        return min * FastMath::PowPrecise(max / min, value);
     }
 
     float Update(float min, float max, float value)
@@ -142,7 +143,7 @@ struct ExpParam
             m_factor = min;
             m_max = max;
             m_base = max / min;
-            m_expParam = m_factor * std::powf(m_base, value);
+            m_expParam = m_factor * FastMath::PowPrecise(m_base, value);
             m_baseParam = value;
         }
 
@@ -213,7 +214,7 @@ struct ZeroedExpParam
         float discriminant = 1 - 4 * center * (1 - center);
         float sqrt_base = (1 + std::sqrt(discriminant)) / (2 * center);
         m_base = sqrt_base * sqrt_base;
-        m_expParam = (std::powf(m_base, m_baseParam) - 1) / (m_base - 1);
+        m_expParam = (FastMath::PowPrecise(m_base, m_baseParam) - 1) / (m_base - 1);
     }
 
     void SetMax(float max)
@@ -223,7 +224,7 @@ struct ZeroedExpParam
 
     static float Compute(float base, float value)
     {
-        return (std::powf(base, value) - 1) / (base - 1);
+        return (FastMath::PowPrecise(base, value) - 1) / (base - 1);
     }
 
     float Update(float value)
@@ -104,13 +104,19 @@ struct PhysicalModelingSource
     float m_output;
     bool m_top;
 
-    // Slewed parameters for oversampled processing
+    // Parameters ramped across each micro-block
     // Note: Comb filter params (freq, feedback, damping) are slewed inside the comb filter
     //
-    ParamSlew m_sampleRateReducerFreqSlew;
-    ParamSlew m_mainSVFCutoffSlew;
-    ParamSlew m_mainSVFResonanceSlew;
-    ParamSlew m_mainSVFMorphSlew;    
+    enum RampParam : size_t
+    {
+        SampleRateReducerFreqRamp,
+        MainSVFCutoffRamp,
+        MainSVFResonanceRamp,
+        MainSVFMorphRamp,
+        NumRampParams
+    };
+
+    ParamRampBlock<NumRampParams, x_uBlockSize> m_ramps;
 
     struct Input
     {
@@ -163,21 +169,18 @@ struct PhysicalModelingSource
         , m_combFilter(x_oversample)
         , m_output(0.0f)
         , m_top(false)
-        , m_sampleRateReducerFreqSlew(x_oversample)
-        , m_mainSVFCutoffSlew(x_oversample)
-        , m_mainSVFResonanceSlew(x_oversample)
-        , m_mainSVFMorphSlew(x_oversample)
     {
     }
 
     void ProcessUBlock(Input& input)
     {
-        // Update slew targets at start of block
+        // Set ramp targets at start of block and generate the block's parameter ramps
         //
-        m_sampleRateReducerFreqSlew.Update(input.m_sampleRateReducerFreq.m_expParam);
-        m_mainSVFCutoffSlew.Update(input.m_mainSVFCutoff.m_expParam);
-        m_mainSVFResonanceSlew.Update(input.m_mainSVFResonance.m_expParam);
-        m_mainSVFMorphSlew.Update(input.m_mainSVFMorph);
+        m_ramps.Update(SampleRateReducerFreqRamp, input.m_sampleRateReducerFreq.m_expParam);
+        m_ramps.Update(MainSVFCutoffRamp, input.m_mainSVFCutoff.m_expParam);
+        m_ramps.Update(MainSVFResonanceRamp, input.m_mainSVFResonance.m_expParam);
+        m_ramps.Update(MainSVFMorphRamp, input.m_mainSVFMorph);
+        m_ramps.Ramp();
 
         // Set comb filter params once per block
         // Comb filter internally slews feedback and compensated delay
@@ -205,12 +208,12 @@ struct PhysicalModelingSource
             input.m_ahdInputSetter.Process(input.m_ahdInput);
             float ahdEnv = m_ahd.Process(input.m_ahdInput);
 
-            // Process slews
+            // Read ramped params
             //
-            float sampleRateReducerFreq = m_sampleRateReducerFreqSlew.Process();
-            float mainSVFCutoff = m_mainSVFCutoffSlew.Process();
-            float mainSVFResonance = m_mainSVFResonanceSlew.Process();
-            float mainSVFMorph = m_mainSVFMorphSlew.Process();
+            float sampleRateReducerFreq = m_ramps.Get(SampleRateReducerFreqRamp, i);
+            float mainSVFCutoff = m_ramps.Get(MainSVFCutoffRamp, i);
+            float mainSVFResonance = m_ramps.Get(MainSVFResonanceRamp, i);
+            float mainSVFMorph = m_ramps.Get(MainSVFMorphRamp, i);
 
             // 1. Generate white noise
             //
@@ -275,7 +278,7 @@ struct PhysicalModelingSource
     {
         uiState->m_mainSVFG.store(m_mainSVF.m_g);
         uiState->m_mainSVFK.store(m_mainSVF.m_k);
-        uiState->m_mainSVFMorph.store(m_mainSVFMorphSlew.m_filter.m_output);
+        uiState->m_mainSVFMorph.store(m_ramps.Current(MainSVFMorphRamp));
         m_combFilter.PopulateUIState(&uiState->m_combFilter);
     }
 
@@ -3,7 +3,7 @@
 #include "QuadUtils.hpp"
 #include "DelayLine.hpp"
 #include "QuadLFO.hpp"
-#include "WavWriter.hpp"
+#include "StemRecorder.hpp"
 #include <filesystem>
 #include <iomanip>
 #include <sstream>
@@ -18,12 +18,15 @@ struct QuadMixerInternal
 {
     static constexpr size_t x_numSends = 3;
     static constexpr size_t x_maxInputs = 32;
+    static constexpr size_t x_maxRecorderChannels = (x_maxInputs + x_numSends + 1) * 4 + 2;
+    static_assert(x_maxRecorderChannels <= LosslessCodec::x_maxChannels, "lossless stems must hold every recorder channel");
 
     QuadFloatWithStereoAndSub m_output;
     QuadFloat m_send[x_numSends];
-    MultichannelWavWriter m_wavWriter;
+    StemRecorder m_stemRecorder;
     std::string m_recordingDirectory;
     bool m_isRecording = false;
+    bool m_losslessRecording = false;
     PinkNoise m_pinkNoise;
 
     Meter m_voiceMeters[x_maxInputs];
@@ -96,12 +99,12 @@ struct QuadMixerInternal
 
     bool Open(size_t numInputs, const std::string& filename, uint32_t sampleRate)
     {
-        return m_wavWriter.Open(static_cast<uint16_t>(numInputs + x_numSends + 1) * 4 + 2, filename, sampleRate);
+        return m_stemRecorder.Open(static_cast<uint16_t>(numInputs + x_numSends + 1) * 4 + 2, filename, sampleRate, m_losslessRecording);
     }
 
     void Close()
     {
-        m_wavWriter.Close();
+        m_stemRecorder.Close();
     }
 
     void StartRecording(size_t numInputs, uint32_t sampleRate)
@@ -133,7 +136,7 @@ struct QuadMixerInternal
         oss << std::setfill('0') << std::setw(2) << timeInfo.tm_sec;
         oss << ".";
         oss << std::setfill('0') << std::setw(3) << ms.count();
-        oss << ".wav";
+        oss << (m_losslessRecording ? LosslessCodec::x_fileExtension : ".wav");
         
         std::string filename = oss.str();
 
@@ -216,9 +219,9 @@ struct QuadMixerInternal
                 {
                     m_output.m_output += postFader;
                 }
-                // Write post-fader input to wave file
+                // Write post-fader input to the stem recording
                 //
-                m_wavWriter.WriteSampleIfOpen(4 * static_cast<uint16_t>(i), postFader);
+                m_stemRecorder.Write(4 * static_cast<uint16_t>(i), postFader);
             }
         }
 
@@ -236,21 +239,22 @@ struct QuadMixerInternal
                 postReturn = m_returnMeters[j].ProcessAndSaturate(postReturn);
                 m_output.m_output += postReturn;            
 
-                m_wavWriter.WriteSampleIfOpen(4 * static_cast<uint16_t>(input.m_numInputs + j), postReturn);
+                m_stemRecorder.Write(4 * static_cast<uint16_t>(input.m_numInputs + j), postReturn);
             }
         }
 
         m_output = m_masterChain.Process(input.m_masterChainInput, m_output.m_output, m_quadToStereoMixdown.m_output);
         
-        m_wavWriter.WriteSampleIfOpen(4 * static_cast<uint16_t>(input.m_numInputs + x_numSends), m_output.m_output);
-        m_wavWriter.WriteSampleIfOpen(4 * static_cast<uint16_t>(input.m_numInputs + x_numSends + 1), m_output.m_stereoOutput);
+        m_stemRecorder.Write(4 * static_cast<uint16_t>(input.m_numInputs + x_numSends), m_output.m_output);
+        m_stemRecorder.Write(4 * static_cast<uint16_t>(input.m_numInputs + x_numSends + 1), m_output.m_stereoOutput);
+        m_stemRecorder.CommitFrame();
         
         m_masterMeter.Process(m_output.m_output);
         m_stereoMeter.Process(m_output.m_stereoOutput);
 
-        if (m_isRecording && m_wavWriter.m_error)
+        if (m_isRecording && m_stemRecorder.m_error)
         {
-            INFO("QuadMixer error: WavWriter reported error during recording");
+            INFO("QuadMixer error: StemRecorder reported error during recording");
             StopRecording();
         }
 
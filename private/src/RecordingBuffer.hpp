@@ -1,5 +1,8 @@
 #pragma once
 
+#include "AsyncLogger.hpp"
+#include "LosslessWavWriter.hpp"
+#include "RecordingChunkPool.hpp"
 #include "SampleTimer.hpp"
 #include "TheoryOfTime.hpp"
 #include "WavWriter.hpp"
@@ -12,11 +15,162 @@
 #include <string>
 #include <vector>
 
-struct RecordingBuffer
+// A finished recording detached from its RecordingBuffer: the chunk chain plus the loop positions needed to
+// align it.  The persist task writes it on the I/O thread and then returns its chunks to the pool, while the
+// voice is already free to record again.
+//
+struct RecordingTake
 {
-    static constexpr size_t x_byteCapacity = 16 * 1024 * 1024;
-    static constexpr size_t x_capacity = x_byteCapacity / sizeof(float);
+    RecordingChunk* m_head;
+    RecordingChunkPool* m_pool;
+    size_t m_numSamples;
+    double m_loopPositionRecordingStart;
+    double m_loopPositionRecordingStop;
+    int m_recordingRepeats;
+
+    // Written through LosslessWavWriter rather than as 24-bit PCM.
+    //
+    bool m_lossless;
+
+    RecordingTake()
+        : m_head(nullptr)
+        , m_pool(nullptr)
+        , m_numSamples(0)
+        , m_loopPositionRecordingStart(0.0)
+        , m_loopPositionRecordingStop(0.0)
+        , m_recordingRepeats(0)
+        , m_lossless(false)
+    {
+    }
+
+    bool IsEmpty() const
+    {
+        return m_head == nullptr;
+    }
+
+    void Release()
+    {
+        if (m_pool)
+        {
+            m_pool->Release(m_head);
+        }
+
+        m_head = nullptr;
+        m_numSamples = 0;
+    }
+
+    // A lossless take encodes on workerPool, or inline if it is null.
+    //
+    bool WriteToFile(const char* filename, WorkerPool* workerPool = nullptr) const
+    {
+        double startPosition = m_loopPositionRecordingStart;
+        double stopPosition = m_loopPositionRecordingStop;
+        size_t bufferSize = m_numSamples;
+        int numRepeats = m_recordingRepeats;
+        double spanAsMasterFraction = stopPosition - startPosition;
+
+        if (bufferSize == 0 || spanAsMasterFraction <= 0.0 || numRepeats <= 0)
+        {
+            return false;
+        }
+
+        double sourceSamplesPerMaster = static_cast<double>(bufferSize) / spanAsMasterFraction;
+        size_t masterSamples = static_cast<size_t>(std::lround(sourceSamplesPerMaster));
+        if (masterSamples == 0)
+        {
+            return false;
+        }
+
+        // Every chunk but the last is full, so a sample index splits into chunk and offset.
+        //
+        std::vector<const RecordingChunk*> chunks;
+        for (const RecordingChunk* chunk = m_head; chunk; chunk = chunk->m_next)
+        {
+            chunks.push_back(chunk);
+        }
+
+        double loopFraction = 1.0 / static_cast<double>(numRepeats);
+        double outputSamplesPerMaster = static_cast<double>(masterSamples);
+        static constexpr double x_positionEpsilon = 1.0e-9;
+
+        auto outputSample = [&](size_t i)
+        {
+            double outputFraction = static_cast<double>(i) / outputSamplesPerMaster;
+            double loopPhase = std::fmod(outputFraction, loopFraction);
+            if (loopPhase < 0.0)
+            {
+                loopPhase += loopFraction;
+            }
+
+            double sourcePosition =
+                std::floor((startPosition - loopPhase) / loopFraction) * loopFraction + loopPhase;
+            while (sourcePosition < startPosition - x_positionEpsilon)
+            {
+                sourcePosition += loopFraction;
+            }
+
+            if (sourcePosition < startPosition)
+            {
+                sourcePosition = startPosition;
+            }
+
+            double sample = 0.0;
+            if (sourcePosition < stopPosition)
+            {
+                double sourceOffset = sourcePosition - startPosition;
+                size_t sourceIndex = static_cast<size_t>(std::floor(sourceOffset * sourceSamplesPerMaster));
+                sourceIndex = std::min(sourceIndex, bufferSize - 1);
+                const RecordingChunk* chunk = chunks[sourceIndex / RecordingChunk::x_numSamples];
+                sample = static_cast<double>(chunk->m_samples[sourceIndex % RecordingChunk::x_numSamples]);
+            }
 
+            return sample;
+        };
+
+        if (m_lossless)
+        {
+            // Same rounding as MultichannelWavWriter::WriteSample, so both files decode to the same samples.
+            //
+            auto writer = std::make_unique<LosslessWavWriter>(workerPool);
+            if (!writer->Open(1, std::string(filename), static_cast<uint32_t>(SampleTimer::x_sampleRate)))
+            {
+                return false;
+            }
+
+            std::vector<int32_t> block(LosslessCodec::x_blockFrames);
+            for (size_t i = 0; i < masterSamples; i += block.size())
+            {
+                size_t count = std::min(block.size(), masterSamples - i);
+                for (size_t j = 0; j < count; ++j)
+                {
+                    double clampedSample = std::max<double>(-1.0, std::min<double>(1.0, outputSample(i + j)));
+                    block[j] = static_cast<int32_t>(std::lround(clampedSample * 8388607));
+                }
+
+                writer->Write(block.data(), count);
+            }
+
+            return writer->Close();
+        }
+
+        auto writer = std::make_unique<MultichannelWavWriter>();
+        writer->Open(1, std::string(filename), static_cast<uint32_t>(SampleTimer::x_sampleRate));
+        for (size_t i = 0; i < masterSamples; ++i)
+        {
+            writer->WriteSample(0, outputSample(i));
+        }
+
+        writer->Close();
+        return !writer->m_error;
+    }
+};
+
+// Mono capture for one voice.  Samples go into chunks taken from a RecordingChunkPool as the take grows, so
+// an idle buffer holds no sample memory.  When the pool has nothing left the take is dropped (Error) and its
+// chunks go straight back for the other voices.
+//
+struct RecordingBuffer
+{
     enum class State
     {
         Idle,
@@ -26,11 +180,13 @@ struct RecordingBuffer
     };
 
     State m_state;
-    std::vector<float> m_buffer;
+    RecordingChunkPool* m_pool;
+    RecordingChunk* m_head;
+    RecordingChunk* m_tail;
+    size_t m_numSamples;
 
-    // The audio thread owns state and buffer mutation. The I/O thread only
-    // reads these atomics after a completed recording has been handed off for
-    // persistence.
+    // The audio thread owns state and chunk mutation. Finished takes reach the
+    // I/O thread through DetachTake, which copies these.
     //
     std::atomic<TheoryOfTimeBase*> m_theoryOfTime;
     std::atomic<double> m_loopPositionRecordingStart;
@@ -39,12 +195,46 @@ struct RecordingBuffer
 
     RecordingBuffer()
         : m_state(State::Idle)
+        , m_pool(&RecordingChunkPool::s_instance)
+        , m_head(nullptr)
+        , m_tail(nullptr)
+        , m_numSamples(0)
         , m_theoryOfTime(nullptr)
         , m_loopPositionRecordingStart(0.0)
         , m_loopPositionRecordingStop(0.0)
         , m_recordingRepeats(0)
     {
-        m_buffer.reserve(x_capacity);
+    }
+
+    ~RecordingBuffer()
+    {
+        Reset();
+    }
+
+    RecordingBuffer(const RecordingBuffer&) = delete;
+    RecordingBuffer& operator=(const RecordingBuffer&) = delete;
+
+    size_t NumSamples() const
+    {
+        return m_numSamples;
+    }
+
+    // Random access walks the chunk chain; for inspection, not the per-sample path.
+    //
+    float* SampleAt(size_t index)
+    {
+        if (index >= m_numSamples)
+        {
+            return nullptr;
+        }
+
+        RecordingChunk* chunk = m_head;
+        for (size_t i = index / RecordingChunk::x_numSamples; i > 0; --i)
+        {
+            chunk = chunk->m_next;
+        }
+
+        return &chunk->m_samples[index % RecordingChunk::x_numSamples];
     }
 
     double SampleUnwoundMasterIndependent() const
@@ -86,6 +276,13 @@ struct RecordingBuffer
         return repeats;
     }
 
+    void ReportOverflow()
+    {
+        INFO_RATE_LIMITED("RecordingBuffer: chunk pool exhausted (%zu of %zu MB in use), take dropped",
+                          m_pool->NumInUse() * RecordingChunkPool::x_chunkBytes >> 20,
+                          m_pool->BudgetBytes() >> 20);
+    }
+
     void Process(float input)
     {
         if (m_state != State::Recording)
@@ -93,16 +290,28 @@ struct RecordingBuffer
             return;
         }
 
-        if (m_buffer.size() >= x_capacity)
+        if (m_tail->m_size == RecordingChunk::x_numSamples)
         {
-            m_loopPositionRecordingStop.store(SampleUnwoundMasterIndependent());
-            m_state = State::Error;
-            return;
+            RecordingChunk* next = m_pool->Acquire();
+            if (!next)
+            {
+                ReportOverflow();
+                m_loopPositionRecordingStop.store(SampleUnwoundMasterIndependent());
+                ReleaseChunks();
+                LeaveRecording(State::Error);
+                return;
+            }
+
+            m_tail->m_next = next;
+            m_tail = next;
         }
 
-        m_buffer.push_back(input);
+        m_tail->m_samples[m_tail->m_size++] = input;
+        ++m_numSamples;
     }
 
+    // Stays Idle if the pool has no chunk to start with.
+    //
     void StartRecording()
     {
         if (m_state != State::Idle)
@@ -110,7 +319,17 @@ struct RecordingBuffer
             return;
         }
 
-        m_buffer.clear();
+        ReleaseChunks();
+        m_pool->AddRecorder();
+        m_head = m_pool->Acquire();
+        if (!m_head)
+        {
+            m_pool->RemoveRecorder();
+            ReportOverflow();
+            return;
+        }
+
+        m_tail = m_head;
         m_recordingRepeats.store(0);
         m_loopPositionRecordingStart.store(SampleUnwoundMasterIndependent());
         m_state = State::Recording;
@@ -129,7 +348,7 @@ struct RecordingBuffer
         if (delta > 1.0 || delta <= 0.0)
         {
             m_recordingRepeats.store(0);
-            m_state = State::Error;
+            LeaveRecording(State::Error);
             return;
         }
 
@@ -137,81 +356,58 @@ struct RecordingBuffer
         m_recordingRepeats.store(repeats);
         if (repeats <= 0)
         {
-            m_state = State::Error;
+            LeaveRecording(State::Error);
             return;
         }
 
-        m_state = State::Done;
+        LeaveRecording(State::Done);
     }
 
-    void Reset()
+    void LeaveRecording(State state)
     {
-        m_state = State::Idle;
-        m_buffer.clear();
+        m_pool->RemoveRecorder();
+        m_state = state;
     }
 
-    bool WriteToFile(const char* filename)
+    // Hands a Done take's chunks to the caller; the buffer keeps its loop positions for inspection.
+    //
+    RecordingTake DetachTake()
     {
-        double startPosition = m_loopPositionRecordingStart.load();
-        double stopPosition = m_loopPositionRecordingStop.load();
-        size_t bufferSize = m_buffer.size();
-        int numRepeats = m_recordingRepeats.load();
-        double spanAsMasterFraction = stopPosition - startPosition;
-
-        if (bufferSize == 0 || spanAsMasterFraction <= 0.0 || numRepeats <= 0)
+        RecordingTake take;
+        if (m_state != State::Done)
         {
-            return false;
+            return take;
         }
 
-        double sourceSamplesPerMaster = static_cast<double>(bufferSize) / spanAsMasterFraction;
-        size_t masterSamples = static_cast<size_t>(std::lround(sourceSamplesPerMaster));
-        if (masterSamples == 0)
-        {
-            return false;
-        }
-
-        auto writer = std::make_unique<MultichannelWavWriter>();
-        writer->Open(1, std::string(filename), static_cast<uint32_t>(SampleTimer::x_sampleRate));
+        take.m_head = m_head;
+        take.m_pool = m_pool;
+        take.m_numSamples = m_numSamples;
+        take.m_loopPositionRecordingStart = m_loopPositionRecordingStart.load();
+        take.m_loopPositionRecordingStop = m_loopPositionRecordingStop.load();
+        take.m_recordingRepeats = m_recordingRepeats.load();
+        m_head = nullptr;
+        m_tail = nullptr;
+        m_numSamples = 0;
+        return take;
+    }
 
-        double loopFraction = 1.0 / static_cast<double>(numRepeats);
-        double outputSamplesPerMaster = static_cast<double>(masterSamples);
-        static constexpr double x_positionEpsilon = 1.0e-9;
+    void ReleaseChunks()
+    {
+        m_pool->Release(m_head);
+        m_head = nullptr;
+        m_tail = nullptr;
+        m_numSamples = 0;
+    }
 
-        for (size_t i = 0; i < masterSamples; ++i)
+    void Reset()
+    {
+        if (m_state == State::Recording)
         {
-            double outputFraction = static_cast<double>(i) / outputSamplesPerMaster;
-            double loopPhase = std::fmod(outputFraction, loopFraction);
-            if (loopPhase < 0.0)
-            {
-                loopPhase += loopFraction;
-            }
-
-            double sourcePosition =
-                std::floor((startPosition - loopPhase) / loopFraction) * loopFraction + loopPhase;
-            while (sourcePosition < startPosition - x_positionEpsilon)
-            {
-                sourcePosition += loopFraction;
-            }
-
-            if (sourcePosition < startPosition)
-            {
-                sourcePosition = startPosition;
-            }
-
-            double sample = 0.0;
-            if (sourcePosition < stopPosition)
-            {
-                double sourceOffset = sourcePosition - startPosition;
-                size_t sourceIndex = static_cast<size_t>(std::floor(sourceOffset * sourceSamplesPerMaster));
-                sourceIndex = std::min(sourceIndex, bufferSize - 1);
-                sample = static_cast<double>(m_buffer[sourceIndex]);
-            }
-
-            writer->WriteSample(0, sample);
+            m_pool->RemoveRecorder();
         }
 
-        writer->Close();
-        return !writer->m_error;
+        m_state = State::Idle;
+        ReleaseChunks();
     }
 };
 
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "ThreadId.hpp"
+#include "WakeSignal.hpp"
+
+// One fixed-size piece of a recording.  A take is a singly linked chain of chunks; every chunk but the last
+// is full.
+//
+struct RecordingChunk
+{
+    static constexpr size_t x_numSamples = 64 * 1024;
+
+    RecordingChunk* m_next;
+    uint32_t m_slot;
+    uint32_t m_size;
+    float m_samples[x_numSamples];
+};
+
+// Process-wide pool of recording chunks shared by every voice's RecordingBuffer and the takes in flight to
+// the I/O thread.  Memory is only held while something records or persists: the pool keeps ReadyTarget()
+// chunks free for the audio thread and allocates or frees the rest on its refill thread, within a byte budget.
+//
+// Acquire and Release are lock-free and never allocate, so the audio thread may call them.  Free chunks sit
+// on a Treiber stack of slot indices whose head carries a tag against ABA.
+//
+// Refill runs on a thread of its own, started while any IoTaskThread exists, so a long bank load or persist
+// on the I/O thread cannot starve a take.  Acquire wakes it when the free count drops below half the target,
+// and it also runs every WakeSignal::x_idleTimeout.  The target grows by x_readyChunksPerRecorder for each
+// recording voice, about five seconds of audio each at 48 kHz.
+//
+struct RecordingChunkPool
+{
+    static constexpr size_t x_chunkBytes = sizeof(RecordingChunk);
+    static constexpr size_t x_maxChunks = 4096;
+    static constexpr size_t x_readyChunks = 16;
+    static constexpr size_t x_readyChunksPerRecorder = 4;
+    static constexpr size_t x_defaultBudgetBytes = 144 * 1024 * 1024;
+
+    struct Stats
+    {
+        size_t m_numAllocated;
+        size_t m_numFree;
+        size_t m_peakInUse;
+        size_t m_overflowCount;
+    };
+
+    // Slots are written only under m_refillMutex.  The audio thread reads a slot only after popping its index,
+    // which the release in Push orders after the write.
+    //
+    RecordingChunk* m_slots[x_maxChunks];
+    std::atomic<uint32_t> m_freeNext[x_maxChunks];
+
+    // Low 32 bits: free slot index + 1 (0 == empty).  High 32 bits: tag.
+    //
+    std::atomic<uint64_t> m_freeHead;
+    std::atomic<size_t> m_numFree;
+    std::atomic<size_t> m_numAllocated;
+    std::atomic<size_t> m_budgetChunks;
+    std::atomic<size_t> m_peakInUse;
+    std::atomic<size_t> m_overflowCount;
+    std::atomic<size_t> m_numRecorders;
+    std::mutex m_refillMutex;
+
+    // The refill thread runs while m_numRefillUsers > 0.
+    //
+    WakeSignal m_refillWake;
+    std::atomic<bool> m_refillRunning;
+    std::mutex m_refillThreadMutex;
+    size_t m_numRefillUsers;
+    std::thread m_refillThread;
+
+    static RecordingChunkPool s_instance;
+
+    RecordingChunkPool()
+        : m_slots{}
+        , m_freeHead(0)
+        , m_numFree(0)
+        , m_numAllocated(0)
+        , m_budgetChunks(x_defaultBudgetBytes / x_chunkBytes)
+        , m_peakInUse(0)
+        , m_overflowCount(0)
+        , m_numRecorders(0)
+        , m_refillRunning(false)
+        , m_numRefillUsers(0)
+    {
+        for (std::atomic<uint32_t>& next : m_freeNext)
+        {
+            next.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ~RecordingChunkPool()
+    {
+        StopRefillThread();
+        for (RecordingChunk*& chunk : m_slots)
+        {
+            delete chunk;
+            chunk = nullptr;
+        }
+    }
+
+    RecordingChunkPool(const RecordingChunkPool&) = delete;
+    RecordingChunkPool& operator=(const RecordingChunkPool&) = delete;
+
+    // Returns an empty chunk, or nullptr (counted as an overflow) when none is free.
+    //
+    RecordingChunk* Acquire()
+    {
+        RecordingChunk* chunk = Pop();
+        if (m_numFree.load(std::memory_order_relaxed) < ReadyTarget() / 2)
+        {
+            m_refillWake.Signal();
+        }
+
+        if (!chunk)
+        {
+            m_overflowCount.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        chunk->m_next = nullptr;
+        chunk->m_size = 0;
+
+        size_t inUse = NumInUse();
+        size_t peak = m_peakInUse.load(std::memory_order_relaxed);
+        while (peak < inUse && !m_peakInUse.compare_exchange_weak(peak, inUse, std::memory_order_relaxed))
+        {
+        }
+
+        return chunk;
+    }
+
+    // Returns a whole chain.  Any thread.
+    //
+    void Release(RecordingChunk* chain)
+    {
+        while (chain)
+        {
+            RecordingChunk* next = chain->m_next;
+            Push(chain->m_slot);
+            chain = next;
+        }
+    }
+
+    // A RecordingBuffer counts itself while it records, which raises ReadyTarget.  Audio thread.
+    //
+    void AddRecorder()
+    {
+        m_numRecorders.fetch_add(1, std::memory_order_relaxed);
+        m_refillWake.Signal();
+    }
+
+    void RemoveRecorder()
+    {
+        m_numRecorders.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    size_t ReadyTarget() const
+    {
+        size_t target = m_numRecorders.load(std::memory_order_relaxed) * x_readyChunksPerRecorder;
+        return target > x_readyChunks ? target : x_readyChunks;
+    }
+
+    // Tops the free list up to ReadyTarget() within the budget and frees chunks beyond that.  Never on the
+    // audio thread.
+    //
+    void Refill()
+    {
+        std::lock_guard<std::mutex> lock(m_refillMutex);
+        size_t budget = m_budgetChunks.load(std::memory_order_relaxed);
+        size_t target = ReadyTarget();
+        while (m_numFree.load() < target && m_numAllocated.load() < budget)
+        {
+            uint32_t slot = 0;
+            while (slot < x_maxChunks && m_slots[slot])
+            {
+                ++slot;
+            }
+
+            if (slot == x_maxChunks)
+            {
+                break;
+            }
+
+            RecordingChunk* chunk = new RecordingChunk;
+            chunk->m_slot = slot;
+            m_slots[slot] = chunk;
+            m_numAllocated.fetch_add(1);
+            Push(slot);
+        }
+
+        while (m_numFree.load() > target || (m_numAllocated.load() > budget && m_numFree.load() > 0))
+        {
+            RecordingChunk* chunk = Pop();
+            if (!chunk)
+            {
+                break;
+            }
+
+            m_slots[chunk->m_slot] = nullptr;
+            m_numAllocated.fetch_sub(1);
+            delete chunk;
+        }
+    }
+
+    // Each IoTaskThread registers while it runs; the first starts the refill thread and the last stops it.
+    //
+    void AddRefillUser()
+    {
+        std::lock_guard<std::mutex> lock(m_refillThreadMutex);
+        if (m_numRefillUsers++ == 0)
+        {
+            m_refillRunning.store(true);
+            m_refillThread = std::thread(&RecordingChunkPool::RunRefill, this);
+        }
+    }
+
+    void RemoveRefillUser()
+    {
+        std::lock_guard<std::mutex> lock(m_refillThreadMutex);
+        if (m_numRefillUsers > 0 && --m_numRefillUsers == 0)
+        {
+            StopRefillThread();
+        }
+    }
+
+    void StopRefillThread()
+    {
+        m_refillRunning.store(false);
+        m_refillWake.Signal();
+        if (m_refillThread.joinable())
+        {
+            m_refillThread.join();
+        }
+    }
+
+    void RunRefill()
+    {
+        SetCurrentThreadId(ThreadId::ChunkRefill);
+        while (m_refillRunning.load())
+        {
+            Refill();
+            m_refillWake.Wait();
+        }
+    }
+
+    // Takes effect at the next Refill.  Chunks in use above a lowered budget are freed as they come back.
+    //
+    void SetBudgetBytes(size_t bytes)
+    {
+        size_t chunks = bytes / x_chunkBytes;
+        m_budgetChunks.store(chunks < x_maxChunks ? chunks : x_maxChunks);
+    }
+
+    size_t BudgetBytes() const
+    {
+        return m_budgetChunks.load() * x_chunkBytes;
+    }
+
+    // The two counts are read separately, so this is approximate while Refill runs.
+    //
+    size_t NumInUse() const
+    {
+        size_t allocated = m_numAllocated.load(std::memory_order_relaxed);
+        size_t free = m_numFree.load(std::memory_order_relaxed);
+        return allocated > free ? allocated - free : 0;
+    }
+
+    Stats GetStats() const
+    {
+        return Stats{m_numAllocated.load(), m_numFree.load(), m_peakInUse.load(), m_overflowCount.load()};
+    }
+
+    RecordingChunk* Pop()
+    {
+        uint64_t head = m_freeHead.load(std::memory_order_acquire);
+        while (true)
+        {
+            uint32_t index = static_cast<uint32_t>(head);
+            if (index == 0)
+            {
+                return nullptr;
+            }
+
+            uint32_t next = m_freeNext[index - 1].load(std::memory_order_relaxed);
+            uint64_t newHead = (((head >> 32) + 1) << 32) | next;
+            if (m_freeHead.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                m_numFree.fetch_sub(1, std::memory_order_relaxed);
+                return m_slots[index - 1];
+            }
+        }
+    }
+
+    void Push(uint32_t slot)
+    {
+        m_numFree.fetch_add(1, std::memory_order_relaxed);
+        uint64_t head = m_freeHead.load(std::memory_order_relaxed);
+        while (true)
+        {
+            m_freeNext[slot].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            uint64_t newHead = (((head >> 32) + 1) << 32) | (slot + 1);
+            if (m_freeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+    }
+};
+
+inline RecordingChunkPool RecordingChunkPool::s_instance;
@@ -22,12 +22,17 @@ struct RecordingManager
     IoTaskThread* m_ioTaskThread;
     int m_numRecording;
 
+    // Persist takes through LosslessWavWriter instead of as 24-bit PCM.
+    //
+    bool m_losslessRecording;
+
     RecordingManager()
         : m_voiceRecordingBuffers{}
         , m_voiceBufferWriters{}
         , m_voiceConfig{}
         , m_ioTaskThread(nullptr)
         , m_numRecording(0)
+        , m_losslessRecording(false)
     {
     }
 
@@ -65,6 +70,9 @@ struct RecordingManager
         }
     }
 
+    // Detaches the finished take and hands it to the I/O thread, which returns its chunks to the pool once
+    // written.  If the queue is full the take is dropped here.
+    //
     bool PersistRecordingForVoice(int voiceID)
     {
         SquiggleBoyVoiceConfig* voiceConfig = m_voiceConfig[static_cast<size_t>(voiceID)];
@@ -78,12 +86,20 @@ struct RecordingManager
             relativePath = bank->m_directoryName.c_str();
         }
 
-        return m_ioTaskThread->PushPersistRecording(
-            relativePath,
-            m_voiceRecordingBuffers[static_cast<size_t>(voiceID)],
-            createDirectory,
-            &voiceConfig->m_audioBufferBank,
-            voiceID);
+        RecordingTake take = m_voiceRecordingBuffers[static_cast<size_t>(voiceID)]->DetachTake();
+        take.m_lossless = m_losslessRecording;
+        if (m_ioTaskThread->PushPersistRecording(
+                relativePath,
+                take,
+                createDirectory,
+                &voiceConfig->m_audioBufferBank,
+                voiceID))
+        {
+            return true;
+        }
+
+        take.Release();
+        return false;
     }
 
     void StartRecording(int voiceID)
@@ -159,17 +175,14 @@ struct RecordingManager
 
         --m_numRecording;
 
+        // The voice can record again at once; a Done take persists in the background.
+        //
         if (buf->m_state == RecordingBuffer::State::Done)
         {
-            if (!PersistRecordingForVoice(voiceID))
-            {
-                buf->Reset();
-            }
-        }
-        else if (buf->m_state == RecordingBuffer::State::Error)
-        {
-            buf->Reset();
+            PersistRecordingForVoice(voiceID);
         }
+
+        buf->Reset();
     }
 
     void StopRecording(int voiceID)
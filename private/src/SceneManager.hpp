@@ -58,9 +58,26 @@ struct SceneManager
     {
     }
 
-    float GetSceneValue(float* values)
+    // Scene values are stored scene-major, values[scene][lane], so the two active scenes are two contiguous
+    // rows: a scene switch only changes which rows are read, and a blend move is one lerp pass over them.
+    //
+    template<size_t NumLanes>
+    float GetSceneValue(const float (&values)[x_numScenes][NumLanes], size_t lane)
+    {
+        return values[m_scene1][lane] * (1.0f - m_blendFactor) + values[m_scene2][lane] * m_blendFactor;
+    }
+
+    template<size_t NumLanes>
+    void GetSceneValues(const float (&values)[x_numScenes][NumLanes], float* output)
     {
-        return values[m_scene1] * (1.0f - m_blendFactor) + values[m_scene2] * m_blendFactor;
+        const float* row1 = values[m_scene1];
+        const float* row2 = values[m_scene2];
+        float blend1 = 1.0f - m_blendFactor;
+        float blend2 = m_blendFactor;
+        for (size_t i = 0; i < NumLanes; ++i)
+        {
+            output[i] = row1[i] * blend1 + row2[i] * blend2;
+        }
     }
 
     bool Scene1Active()
@@ -188,6 +188,58 @@ struct ParamSlew
     }
 };
 
+// Control-rate parameters smoothed as linear ramps over one micro-block, replacing one ParamSlew per
+// parameter. All of a voice's parameters live contiguously: Update sets targets once per control frame,
+// Ramp fills m_ramp[param][0..BlockSize) for every parameter in one pass (landing on the target at the
+// last sample), and the per-sample DSP reads m_ramp[param][i]. Like ParamSlew, everything starts at 0.
+//
+template<size_t NumParams, size_t BlockSize>
+struct ParamRampBlock
+{
+    float m_start[NumParams];
+    float m_target[NumParams];
+    float m_ramp[NumParams][BlockSize];
+
+    ParamRampBlock()
+        : m_start{}
+        , m_target{}
+        , m_ramp{}
+    {
+    }
+
+    void Update(size_t param, float value)
+    {
+        m_target[param] = value;
+    }
+
+    void Ramp()
+    {
+        for (size_t param = 0; param < NumParams; ++param)
+        {
+            float start = m_start[param];
+            float step = (m_target[param] - start) / BlockSize;
+            for (size_t i = 0; i < BlockSize; ++i)
+            {
+                m_ramp[param][i] = start + step * static_cast<float>(i + 1);
+            }
+
+            m_start[param] = m_target[param];
+        }
+    }
+
+    float Get(size_t param, size_t i) const
+    {
+        return m_ramp[param][i];
+    }
+
+    // Where the last Ramp ended, i.e. the current smoothed value.
+    //
+    float Current(size_t param) const
+    {
+        return m_start[param];
+    }
+};
+
 struct ParamSlewDouble
 {
     OPLowPassFilterDouble m_filter;
@@ -8,9 +8,20 @@ struct SmartBusGeneric
     std::atomic<uint64_t> m_epoch;
     std::atomic<BusInput> m_messages[x_gridMaxSize][x_gridMaxSize];
 
+    // One bit per cell (bit j of row i), set by Store when the payload actually changes.  A single consumer
+    // may take the bits with TakeDirtyRow to visit only changed cells; epoch-based iteration is unaffected.
+    //
+    std::atomic<uint32_t> m_dirty[x_gridMaxSize];
+
+    static_assert(x_gridMaxSize <= 32, "dirty rows are 32 bit");
+
     SmartBusGeneric()
         : m_epoch(0)
     {
+        for (int i = 0; i < x_gridMaxSize; ++i)
+        {
+            m_dirty[i].store(0);
+        }
     }
     
     void Put(int i, int j, BusInput payload, bool* changed)
@@ -28,13 +39,29 @@ struct SmartBusGeneric
         return &m_messages[i - x_gridXMin][j - x_gridYMin];
     }
 
+    // Each bus has one writer, so a plain load tells whether the cell changes.  Unchanged cells, the common
+    // case when a grid is pushed every frame, cost no store and no cache line handed to the reader.
+    //
     void Store(size_t i, size_t j, BusInput payload, bool* changed)
-    {        
-        BusInput newPayload = m_messages[i][j].exchange(payload);
-        if (payload != newPayload)
+    {
+        if (m_messages[i][j].load(std::memory_order_relaxed) == payload)
+        {
+            return;
+        }
+
+        m_messages[i][j].store(payload);
+        m_dirty[i].fetch_or(1u << j);
+        *changed = true;
+    }
+
+    uint32_t TakeDirtyRow(size_t i)
+    {
+        if (m_dirty[i].load(std::memory_order_relaxed) == 0)
         {
-            *changed = true;
+            return 0;
         }
+
+        return m_dirty[i].exchange(0);
     }
 
     BusInput Load(size_t i, size_t j)
@@ -387,6 +414,9 @@ inline void AbstractGrid::OutputToBus()
     }
 }
 
+// Polls every cell: colours are computed from live engine state with no change notification, so the grid cannot
+// know which cells changed.  Put discards unchanged colours, so only real changes reach the dirty masks.
+//
 inline void AbstractGrid::OutputToBus(SmartBusColor* bus)
 {
     bool changed = false;
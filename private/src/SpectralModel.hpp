@@ -2,6 +2,7 @@
 
 #include "AdaptiveWaveTable.hpp"
 #include "Array.hpp"
+#include "FastMath.hpp"
 #include "FixedAllocator.hpp"
 #include "FrequencyDependentParameter.hpp"
 #include "Slew.hpp"
@@ -370,15 +371,15 @@ struct SpectralModelGeneric
             float mag = mags[k];
             if (mags[k - 1] < mag && mags[k + 1] < mag && input.m_gainThreshold <= mag)
             {
-                // Log-domain parabolic interpolation
+                // Log-domain parabolic interpolation (log2 domain: the peak offset is base-independent)
                 //
                 float magLo = std::max(mags[k - 1], x_logEps);
                 float magMid = std::max(mag, x_logEps);
                 float magHi = std::max(mags[k + 1], x_logEps);
 
-                float alpha = std::log(magLo);
-                float beta = std::log(magMid);
-                float gamma = std::log(magHi);
+                float alpha = FastMath::Log2Precise(magLo);
+                float beta = FastMath::Log2Precise(magMid);
+                float gamma = FastMath::Log2Precise(magHi);
                 float denom = alpha - 2.0f * beta + gamma;
 
                 float p = 0.0f;
@@ -386,7 +387,7 @@ struct SpectralModelGeneric
                 if (1e-10f < std::abs(denom))
                 {
                     p = 0.5f * (alpha - gamma) / denom;
-                    peakMag = std::exp(beta - 0.25f * (alpha - gamma) * p);
+                    peakMag = FastMath::Exp2Precise(beta - 0.25f * (alpha - gamma) * p);
                 }
 
                 float peakOmega = (static_cast<float>(k) + p) / static_cast<float>(x_tableSize);
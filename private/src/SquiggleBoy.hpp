@@ -77,25 +77,24 @@ struct SquiggleBoyVoice
 
         ScopeWriterHolder m_scopeWriter;
 
-        // Slewed parameters
+        // Slewed parameters, ramped across each micro-block
         //
-        ParamSlew m_vcoBaseFreqSlew;
-        ParamSlew m_lpCutoffSlew;
-        ParamSlew m_hpCutoffSlew;
-        ParamSlew m_lpResonanceSlew;
-        ParamSlew m_hpResonanceSlew;
-        ParamSlew m_saturationGainSlew;
-        ParamSlew m_sampleRateReducerFreqSlew;
+        enum RampParam : size_t
+        {
+            VcoBaseFreqRamp,
+            LPCutoffRamp,
+            HPCutoffRamp,
+            LPResonanceRamp,
+            HPResonanceRamp,
+            SaturationGainRamp,
+            SampleRateReducerFreqRamp,
+            NumRampParams
+        };
+
+        ParamRampBlock<NumRampParams, x_uBlockSize> m_ramps;
 
         FilterSection()
             : m_output(0)
-            , m_vcoBaseFreqSlew(x_oversample)
-            , m_lpCutoffSlew(x_oversample)
-            , m_hpCutoffSlew(x_oversample)
-            , m_lpResonanceSlew(x_oversample)
-            , m_hpResonanceSlew(x_oversample)
-            , m_saturationGainSlew(x_oversample)
-            , m_sampleRateReducerFreqSlew(x_oversample)
         {
             // 5 Hz at 192kHz (48kHz * 4x oversample)
             //
@@ -163,25 +162,26 @@ struct SquiggleBoyVoice
                 baseFreq = 80.0 / SampleTimer::x_sampleRate;
             }
 
-            // Update slew targets
+            // Set ramp targets and generate the whole micro-block of parameter values
             //
-            m_vcoBaseFreqSlew.Update(baseFreq);
-            m_lpCutoffSlew.Update(input.m_lpCutoffFactor.m_expParam);
-            m_hpCutoffSlew.Update(input.m_hpCutoffFactor.m_expParam);
-            m_lpResonanceSlew.Update(input.m_lpResonance.m_expParam);
-            m_hpResonanceSlew.Update(input.m_hpResonance.m_expParam);
-            m_saturationGainSlew.Update(input.m_saturationGain.m_expParam);
-            m_sampleRateReducerFreqSlew.Update(input.m_sampleRateReducerFreq.m_expParam);
+            m_ramps.Update(VcoBaseFreqRamp, baseFreq);
+            m_ramps.Update(LPCutoffRamp, input.m_lpCutoffFactor.m_expParam);
+            m_ramps.Update(HPCutoffRamp, input.m_hpCutoffFactor.m_expParam);
+            m_ramps.Update(LPResonanceRamp, input.m_lpResonance.m_expParam);
+            m_ramps.Update(HPResonanceRamp, input.m_hpResonance.m_expParam);
+            m_ramps.Update(SaturationGainRamp, input.m_saturationGain.m_expParam);
+            m_ramps.Update(SampleRateReducerFreqRamp, input.m_sampleRateReducerFreq.m_expParam);
+            m_ramps.Ramp();
 
             for (size_t i = 0; i < x_uBlockSize; ++i)
             {
-                float vcoBaseFreq = m_vcoBaseFreqSlew.Process();
-                float lpCutoff = m_lpCutoffSlew.Process();
-                float hpCutoff = m_hpCutoffSlew.Process();
-                float lpResonance = m_lpResonanceSlew.Process();
-                float hpResonance = m_hpResonanceSlew.Process();
-                float sampleRateReducerFreq = m_sampleRateReducerFreqSlew.Process();
-                float saturationGain = m_saturationGainSlew.Process();
+                float vcoBaseFreq = m_ramps.Get(VcoBaseFreqRamp, i);
+                float lpCutoff = m_ramps.Get(LPCutoffRamp, i);
+                float hpCutoff = m_ramps.Get(HPCutoffRamp, i);
+                float lpResonance = m_ramps.Get(LPResonanceRamp, i);
+                float hpResonance = m_ramps.Get(HPResonanceRamp, i);
+                float sampleRateReducerFreq = m_ramps.Get(SampleRateReducerFreqRamp, i);
+                float saturationGain = m_ramps.Get(SaturationGainRamp, i);
 
                 // Compute filter frequencies adjusted for oversampled rate
                 //
@@ -694,6 +694,19 @@ struct SquiggleBoy
         m_mixer.m_recordingDirectory = directory;
     }
 
+    // Compress stem recordings and persisted voice takes from the next recording on.
+    //
+    void SetLosslessRecording(bool lossless)
+    {
+        m_mixer.m_losslessRecording = lossless;
+        m_recordingManager.m_losslessRecording = lossless;
+    }
+
+    bool IsLosslessRecording() const
+    {
+        return m_recordingManager.m_losslessRecording;
+    }
+
     void ProcessSends()
     {
         m_delayState.m_input = m_mixer.m_send[0];
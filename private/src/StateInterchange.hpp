@@ -1,6 +1,7 @@
 #pragma once
 
 #include "JuceSon.hpp"
+#include "PatchBinary.hpp"
 #include <atomic>
 
 // StateInterchange — lock-free handshake for patch save/load between the audio
@@ -154,6 +155,22 @@ struct StateInterchange
         return parsed;
     }
 
+    // Message thread: load a patch file into the load arena, decoding a binary patch without parsing or
+    // falling back to parsing JSON text (PatchBinary::LoadFile).  Same lifetime as ParseForLoad.
+    //
+    JSON LoadFileForLoad(const char* fileName)
+    {
+        m_loadArena.Reset();
+        JSON loaded = PatchBinary::LoadFile(fileName, m_loadArena);
+        while (loaded.IsNull() && m_loadArena.Failed())
+        {
+            m_loadArena.GrowAndReset();
+            loaded = PatchBinary::LoadFile(fileName, m_loadArena);
+        }
+
+        return loaded;
+    }
+
     bool RequestLoad(JSON toLoad, bool restoreFaders)
     {
         if (m_loadRequested.load())
@@ -0,0 +1,412 @@
+#pragma once
+
+#include "LosslessWavWriter.hpp"
+#include "WavWriter.hpp"
+#include "QuadUtils.hpp"
+#include "StereoUtils.hpp"
+#include "AsyncLogger.hpp"
+#include "ThreadId.hpp"
+#include "WakeSignal.hpp"
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <cassert>
+
+// Multitrack recorder for the mixer.  The audio thread writes each frame as floats straight into a preallocated
+// interleaved block and publishes the block when it fills; the writer thread converts whole blocks to 24-bit
+// and appends them to an RF64 file.  Nothing on the audio thread touches a byte queue or rounds a sample.
+//
+// Opened lossless, the writer thread hands the 24-bit samples to a LosslessWavWriter instead, which compresses
+// them on its own workers; the file is then about half the size and half the write bandwidth.
+//
+// Channels not written in a frame record silence.  If the writer thread falls x_numBlocks behind, the frame is
+// dropped and m_error is set, so the owner can stop recording.
+//
+struct StemRecorder
+{
+    static constexpr size_t x_bytesPerSample = 3;
+    static constexpr size_t x_framesPerBlock = 256;
+    static constexpr size_t x_numBlocks = 32;
+
+    Rf64Header m_header;
+    uint16_t m_numChannels;
+    bool m_isOpen;
+    bool m_error;
+    bool m_lossless;
+    std::string m_filename;
+
+    // Ring of interleaved float blocks.  The audio thread fills block m_head, the writer thread drains m_tail.
+    //
+    std::vector<float> m_blocks;
+    size_t m_blockFrames[x_numBlocks];
+    std::atomic<size_t> m_head;
+    std::atomic<size_t> m_tail;
+    float* m_frame;
+    size_t m_framesInBlock;
+    size_t m_droppedFrames;
+
+    // Writer thread state.
+    //
+    std::thread m_writeThread;
+    std::atomic<bool> m_done;
+    std::atomic<bool> m_writeError;
+    WakeSignal m_wake;
+    std::vector<int32_t> m_intSamples;
+    std::vector<uint8_t> m_bytes;
+    uint64_t m_dataSize;
+    uint64_t m_framesWritten;
+
+    // Created on the first lossless Open and kept, with its workers, for later recordings.
+    //
+    std::unique_ptr<LosslessWavWriter> m_losslessWriter;
+
+    StemRecorder()
+        : m_numChannels(0)
+        , m_isOpen(false)
+        , m_error(false)
+        , m_lossless(false)
+        , m_blockFrames{}
+        , m_head(0)
+        , m_tail(0)
+        , m_frame(nullptr)
+        , m_framesInBlock(0)
+        , m_droppedFrames(0)
+        , m_done(false)
+        , m_writeError(false)
+        , m_dataSize(0)
+        , m_framesWritten(0)
+    {
+    }
+
+    ~StemRecorder()
+    {
+        Close();
+    }
+
+    bool IsOpen() const
+    {
+        return m_isOpen;
+    }
+
+    bool Open(uint16_t numChannels, const std::string& filename, uint32_t sampleRate, bool lossless = false)
+    {
+        if (m_isOpen)
+        {
+            assert(false);
+        }
+
+        m_numChannels = numChannels;
+        m_filename = filename;
+        m_error = false;
+        m_lossless = lossless;
+        m_header.Init(numChannels, sampleRate);
+        if (lossless && !m_losslessWriter)
+        {
+            m_losslessWriter = std::make_unique<LosslessWavWriter>();
+        }
+
+        // Buffers only grow, so reopening with the same channel count does not allocate.
+        //
+        size_t blockSize = x_framesPerBlock * numChannels;
+        if (m_blocks.size() < x_numBlocks * blockSize)
+        {
+            m_blocks.resize(x_numBlocks * blockSize);
+            m_intSamples.resize(blockSize);
+            m_bytes.resize(blockSize * x_bytesPerSample);
+        }
+
+        m_head.store(0);
+        m_tail.store(0);
+        m_framesInBlock = 0;
+        m_droppedFrames = 0;
+        m_dataSize = 0;
+        m_framesWritten = 0;
+        m_done.store(false);
+        m_writeError.store(false);
+        m_frame = StartBlock();
+
+        INFO("Opening stem recording: %s", filename.c_str());
+        m_writeThread = std::thread([this]()
+        {
+            SetCurrentThreadId(ThreadId::FileWriter);
+            WriteThreadFunction();
+        });
+
+        m_isOpen = true;
+        return true;
+    }
+
+    bool OpenQuad(uint16_t numChannels, const std::string& filename, uint32_t sampleRate, bool lossless = false)
+    {
+        return Open(numChannels * 4, filename, sampleRate, lossless);
+    }
+
+    // Audio thread.  Writes into the current frame; the frame is only handed to the writer by CommitFrame.
+    // A write that would reach past the frame is dropped, since the next frame in the block follows it.
+    //
+    bool FitsFrame(uint16_t channel, uint16_t width) const
+    {
+        return m_frame && channel + width <= m_numChannels;
+    }
+
+    void Write(uint16_t channel, float sample)
+    {
+        if (FitsFrame(channel, 1))
+        {
+            m_frame[channel] = sample;
+        }
+    }
+
+    void Write(uint16_t channel, const QuadFloat& quadSample)
+    {
+        if (FitsFrame(channel, 4))
+        {
+            std::memcpy(m_frame + channel, quadSample.m_values, 4 * sizeof(float));
+        }
+    }
+
+    void Write(uint16_t channel, const StereoFloat& stereoSample)
+    {
+        if (FitsFrame(channel, 2))
+        {
+            m_frame[channel] = stereoSample[0];
+            m_frame[channel + 1] = stereoSample[1];
+        }
+    }
+
+    void CommitFrame()
+    {
+        if (!m_isOpen)
+        {
+            return;
+        }
+
+        if (!m_frame)
+        {
+            // The previous block could not be started, so this frame is lost.  Try again for the next one.
+            //
+            ++m_droppedFrames;
+            m_frame = StartBlock();
+            return;
+        }
+
+        ++m_framesInBlock;
+        if (m_framesInBlock == x_framesPerBlock)
+        {
+            PublishBlock();
+            m_frame = StartBlock();
+        }
+        else
+        {
+            m_frame += m_numChannels;
+        }
+    }
+
+    void Close()
+    {
+        if (!m_isOpen)
+        {
+            return;
+        }
+
+        if (m_frame && m_framesInBlock > 0)
+        {
+            PublishBlock();
+        }
+
+        m_frame = nullptr;
+        m_done.store(true);
+        m_wake.Signal();
+        m_writeThread.join();
+        m_isOpen = false;
+
+        if (m_writeError.load())
+        {
+            m_error = true;
+            INFO("StemRecorder error: write failed for %s", m_filename.c_str());
+            return;
+        }
+
+        if (m_droppedFrames > 0)
+        {
+            INFO("StemRecorder error: dropped %llu frames, writer fell behind", static_cast<unsigned long long>(m_droppedFrames));
+        }
+
+        // The lossless writer finished its own header when the writer thread closed it.
+        //
+        if (m_lossless)
+        {
+            return;
+        }
+
+        // Patch the header with the final sizes.
+        //
+        m_header.Finish(m_dataSize, m_framesWritten);
+        std::fstream file(m_filename, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file.is_open())
+        {
+            m_error = true;
+            INFO("StemRecorder error: Failed to open file for header update: %s", m_filename.c_str());
+            return;
+        }
+
+        file.write(reinterpret_cast<const char*>(&m_header), sizeof(Rf64Header));
+        if (!file.good())
+        {
+            m_error = true;
+            INFO("StemRecorder error: Failed to write header update");
+        }
+    }
+
+    float* BlockData(size_t block)
+    {
+        return m_blocks.data() + (block % x_numBlocks) * x_framesPerBlock * m_numChannels;
+    }
+
+    // Returns the first frame of a fresh block, zeroed, or nullptr if every block is still waiting to be written.
+    //
+    float* StartBlock()
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == x_numBlocks)
+        {
+            m_error = true;
+            return nullptr;
+        }
+
+        m_framesInBlock = 0;
+        float* block = BlockData(head);
+        std::memset(block, 0, x_framesPerBlock * m_numChannels * sizeof(float));
+        return block;
+    }
+
+    void PublishBlock()
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        m_blockFrames[head % x_numBlocks] = m_framesInBlock;
+        m_head.store(head + 1, std::memory_order_release);
+        m_wake.Signal();
+    }
+
+    // Same rounding as MultichannelWavWriter::WriteSample, as flat loops over the block so they vectorize.
+    //
+    static void ConvertToInt24(const float* samples, size_t count, int32_t* intSamples)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            double scaled = std::max<double>(-1.0, std::min<double>(1.0, samples[i])) * 8388607;
+            intSamples[i] = static_cast<int32_t>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+        }
+    }
+
+    static void ConvertTo24Bit(const float* samples, size_t count, int32_t* intSamples, uint8_t* bytes)
+    {
+        ConvertToInt24(samples, count, intSamples);
+        for (size_t i = 0; i < count; ++i)
+        {
+            bytes[3 * i] = static_cast<uint8_t>(intSamples[i] & 0xFF);
+            bytes[3 * i + 1] = static_cast<uint8_t>((intSamples[i] >> 8) & 0xFF);
+            bytes[3 * i + 2] = static_cast<uint8_t>((intSamples[i] >> 16) & 0xFF);
+        }
+    }
+
+    void WriteThreadFunction()
+    {
+        if (m_lossless)
+        {
+            LosslessWriteThreadFunction();
+            return;
+        }
+
+        std::ofstream file(m_filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            m_writeError.store(true);
+            INFO("StemRecorder error: Failed to open file %s", m_filename.c_str());
+            return;
+        }
+
+        file.write(reinterpret_cast<const char*>(&m_header), sizeof(Rf64Header));
+
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            bool done = m_done.load();
+            if (tail == m_head.load(std::memory_order_acquire))
+            {
+                if (done)
+                {
+                    break;
+                }
+
+                m_wake.Wait();
+                continue;
+            }
+
+            size_t count = m_blockFrames[tail % x_numBlocks] * m_numChannels;
+            ConvertTo24Bit(BlockData(tail), count, m_intSamples.data(), m_bytes.data());
+            file.write(reinterpret_cast<const char*>(m_bytes.data()), count * x_bytesPerSample);
+            if (!file.good())
+            {
+                m_writeError.store(true);
+                INFO("StemRecorder error: Write failed for file %s", m_filename.c_str());
+                break;
+            }
+
+            m_dataSize += count * x_bytesPerSample;
+            m_framesWritten += m_blockFrames[tail % x_numBlocks];
+            ++tail;
+            m_tail.store(tail, std::memory_order_release);
+        }
+    }
+
+    void LosslessWriteThreadFunction()
+    {
+        if (!m_losslessWriter->Open(m_numChannels, m_filename, m_header.sampleRate))
+        {
+            m_writeError.store(true);
+            return;
+        }
+
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            bool done = m_done.load();
+            if (tail == m_head.load(std::memory_order_acquire))
+            {
+                if (done)
+                {
+                    break;
+                }
+
+                m_wake.Wait();
+                continue;
+            }
+
+            size_t numFrames = m_blockFrames[tail % x_numBlocks];
+            ConvertToInt24(BlockData(tail), numFrames * m_numChannels, m_intSamples.data());
+            m_losslessWriter->Write(m_intSamples.data(), numFrames);
+            if (m_losslessWriter->m_error)
+            {
+                m_writeError.store(true);
+                break;
+            }
+
+            m_framesWritten += numFrames;
+            ++tail;
+            m_tail.store(tail, std::memory_order_release);
+        }
+
+        if (!m_losslessWriter->Close())
+        {
+            m_writeError.store(true);
+        }
+    }
+};
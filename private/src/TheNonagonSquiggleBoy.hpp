@@ -111,6 +111,16 @@ struct TheNonagonSquiggleBoyInternal
         m_squiggleBoy.SetRecordingDirectory(directory);
     }
 
+    void SetLosslessRecording(bool lossless)
+    {
+        m_squiggleBoy.SetLosslessRecording(lossless);
+    }
+
+    bool IsLosslessRecording() const
+    {
+        return m_squiggleBoy.IsLosslessRecording();
+    }
+
     JSON ToJSON(JsonArena& a)
     {
         JSON rootJ = a.Object();
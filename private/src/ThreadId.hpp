@@ -14,6 +14,7 @@ enum class ThreadId : size_t
     AsyncIo,
     FileWriter,
     SampleLoader,
+    ChunkRefill,
     Logger,
     Count
 };
@@ -47,6 +48,7 @@ inline const char* ThreadIdToString(ThreadId threadId)
         case ThreadId::AsyncIo: return "AsyncIo";
         case ThreadId::FileWriter: return "FileWriter";
         case ThreadId::SampleLoader: return "SampleLoader";
+        case ThreadId::ChunkRefill: return "ChunkRefill";
         case ThreadId::Logger: return "Logger";
         case ThreadId::Count: return "Count";
     }
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+#if defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#elif !defined(_WIN32)
+#include <cerrno>
+#include <ctime>
+#include <semaphore.h>
+#if defined(__GLIBC__) && defined(__USE_GNU) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 30))
+#define WAKE_SEMAPHORE_CLOCKWAIT 1
+#endif
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+// Counting semaphore with a timed wait.  Post never blocks and a Post is never lost: a Wait that starts after it
+// returns at once.  macOS uses a dispatch semaphore and other POSIX systems sem_t (sem_init is not supported on
+// macOS).  Elsewhere it falls back to a condition variable, whose Post takes the mutex.
+//
+struct WakeSemaphore
+{
+#if defined(__APPLE__)
+    dispatch_semaphore_t m_semaphore;
+
+    WakeSemaphore()
+        : m_semaphore(dispatch_semaphore_create(0))
+    {
+    }
+
+    ~WakeSemaphore()
+    {
+        dispatch_release(m_semaphore);
+    }
+
+    void Post()
+    {
+        dispatch_semaphore_signal(m_semaphore);
+    }
+
+    bool Wait(std::chrono::nanoseconds timeout)
+    {
+        return dispatch_semaphore_wait(m_semaphore, dispatch_time(DISPATCH_TIME_NOW, timeout.count())) == 0;
+    }
+#elif !defined(_WIN32)
+    sem_t m_semaphore;
+
+    WakeSemaphore()
+    {
+        sem_init(&m_semaphore, 0, 0);
+    }
+
+    ~WakeSemaphore()
+    {
+        sem_destroy(&m_semaphore);
+    }
+
+    void Post()
+    {
+        sem_post(&m_semaphore);
+    }
+
+    // sem_clockwait (glibc 2.30) measures the deadline on the monotonic clock; sem_timedwait only takes
+    // CLOCK_REALTIME, so a wall clock step can stretch or shorten that wait.
+    //
+    bool Wait(std::chrono::nanoseconds timeout)
+    {
+#if defined(WAKE_SEMAPHORE_CLOCKWAIT)
+        const clockid_t clock = CLOCK_MONOTONIC;
+#else
+        const clockid_t clock = CLOCK_REALTIME;
+#endif
+        timespec deadline;
+        clock_gettime(clock, &deadline);
+        long long ns = deadline.tv_nsec + (timeout.count() > 0 ? static_cast<long long>(timeout.count()) : 0);
+        deadline.tv_sec += static_cast<time_t>(ns / 1000000000);
+        deadline.tv_nsec = static_cast<long>(ns % 1000000000);
+        while (true)
+        {
+#if defined(WAKE_SEMAPHORE_CLOCKWAIT)
+            int result = sem_clockwait(&m_semaphore, clock, &deadline);
+#else
+            int result = sem_timedwait(&m_semaphore, &deadline);
+#endif
+            if (result == 0)
+            {
+                return true;
+            }
+
+            if (errno != EINTR)
+            {
+                return false;
+            }
+        }
+    }
+#else
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    size_t m_count = 0;
+
+    void Post()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_count;
+        }
+
+        m_condition.notify_one();
+    }
+
+    bool Wait(std::chrono::nanoseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_condition.wait_for(lock, timeout, [this]() { return m_count > 0; }))
+        {
+            return false;
+        }
+
+        --m_count;
+        return true;
+    }
+#endif
+
+    WakeSemaphore(const WakeSemaphore&) = delete;
+    WakeSemaphore& operator=(const WakeSemaphore&) = delete;
+};
+
+// Wakes one background worker when there is work for it.  Any thread may Signal; one worker calls Wait.
+//
+// Signal never blocks, except on the condition variable fallback.  While a signal is already pending it is one
+// fence and a relaxed load, so the audio thread can call it freely; the first Signal after the worker last woke
+// posts the semaphore.  The semaphore keeps that post until the worker waits, so a wakeup is never lost however
+// Signal races the worker going to sleep, and the worker sleeps until signalled instead of polling.  The timeout
+// only bounds idle sleeps and deadlines.
+//
+// m_pending makes sure at most one post is outstanding: only the Signal that sets it posts, and only the Wait
+// that takes that post clears it.
+//
+struct WakeSignal
+{
+    static constexpr std::chrono::milliseconds x_idleTimeout{100};
+
+    // Counted by the worker, readable from any thread.
+    //
+    struct Metrics
+    {
+        std::atomic<size_t> m_waitCount{0};
+        std::atomic<size_t> m_signalledCount{0};
+        std::atomic<size_t> m_timeoutCount{0};
+    };
+
+    WakeSemaphore m_semaphore;
+    std::atomic<bool> m_pending;
+    std::atomic<bool> m_sleeping;
+    std::atomic<size_t> m_notifyCount;
+    Metrics m_metrics;
+
+    WakeSignal()
+        : m_pending(false)
+        , m_sleeping(false)
+        , m_notifyCount(0)
+    {
+    }
+
+    void Signal()
+    {
+        // Pairs with the fence in Wait.  A Signal that finds m_pending still set is ordered before the worker
+        // clears it, so the work published before this call is visible to the drain that follows the wakeup.
+        //
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_pending.load(std::memory_order_relaxed) || m_pending.exchange(true))
+        {
+            return;
+        }
+
+        m_notifyCount.fetch_add(1, std::memory_order_relaxed);
+        m_semaphore.Post();
+    }
+
+    // Sleeps until Signal or timeout, returning true if signalled.  Consumes the signal, so the caller must
+    // drain all its work before waiting again.
+    //
+    template<class Rep, class Period>
+    bool Wait(std::chrono::duration<Rep, Period> timeout)
+    {
+        Increment(m_metrics.m_waitCount);
+        m_sleeping.store(true, std::memory_order_relaxed);
+        bool signalled = m_semaphore.Wait(std::chrono::duration_cast<std::chrono::nanoseconds>(timeout));
+        m_sleeping.store(false, std::memory_order_relaxed);
+        if (signalled)
+        {
+            m_pending.store(false, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            Increment(m_metrics.m_signalledCount);
+        }
+        else
+        {
+            Increment(m_metrics.m_timeoutCount);
+        }
+
+        return signalled;
+    }
+
+    bool Wait()
+    {
+        return Wait(x_idleTimeout);
+    }
+
+    // Only the worker writes the metrics, so a relaxed load and store is enough.
+    //
+    static void Increment(std::atomic<size_t>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+};
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <algorithm>
+#include <cctype>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
-#include <fstream>
 #include <vector>
 
+#include "LosslessCodec.hpp"
+#include "MappedFile.hpp"
+
 namespace WavReaderDetail
 {
     static inline uint16_t ReadU16LE(const uint8_t* p)
@@ -45,42 +49,31 @@ namespace WavReaderDetail
         std::memcpy(&f, &u, sizeof(float));
         return f;
     }
-
-    static inline bool ReadEntireFile(const char* fileName, std::vector<uint8_t>& out)
-    {
-        std::ifstream file(fileName, std::ios::binary | std::ios::ate);
-        if (!file)
-        {
-            return false;
-        }
-
-        std::streamoff end = file.tellg();
-        if (end <= 0)
-        {
-            return false;
-        }
-
-        out.resize(static_cast<size_t>(end));
-        file.seekg(0, std::ios::beg);
-        if (!file.read(reinterpret_cast<char*>(out.data()), end))
-        {
-            return false;
-        }
-
-        return true;
-    }
 }
 
+// Parses a WAV / RF64 file over a MappedFile; samples are decoded on request rather than all up front.
+//
+// Every read copies the bytes it needs out of the file with MappedFile::Read instead of dereferencing the
+// mapping, so a file truncated while a streamed buffer holds it decodes as silence rather than raising SIGBUS.
+//
+// Lossless files (LosslessWavWriter) are decoded a block at a time through a one-block cache, so a reader is
+// used from one thread at a time.  They load only under LosslessCodec::x_fileExtension, and other formats only
+// as .wav, so the file name always says which decoder a file needs.
+//
 struct WavReader
 {
+    static constexpr size_t x_noBlock = ~size_t(0);
+    static constexpr size_t x_readFrames = 8192;
+
     enum class Format
     {
         Unknown,
         Pcm,
-        Float
+        Float,
+        Lossless
     };
 
-    std::vector<uint8_t> m_fileBytes;
+    MappedFile m_file;
     Format m_format{Format::Unknown};
     uint16_t m_numChannels{0};
     uint32_t m_sampleRate{0};
@@ -92,9 +85,24 @@ struct WavReader
     bool m_isRf64{false};
     bool m_ready{false};
 
+    // Lossless only: the seek chunk's block offsets, and the last block decoded.
+    //
+    size_t m_seekOffset{0};
+    size_t m_seekSize{0};
+    size_t m_codecBlockFrames{0};
+    size_t m_numBlocks{0};
+    std::vector<uint64_t> m_blockOffsets;
+    mutable size_t m_cachedBlock{x_noBlock};
+    mutable std::vector<int32_t> m_blockSamples;
+    mutable LosslessCodec::Scratch m_scratch;
+
+    // File bytes copied out for decoding: PCM frames, or one lossless block.
+    //
+    mutable std::vector<uint8_t> m_readBuffer;
+
     void Reset()
     {
-        m_fileBytes.clear();
+        m_file.Close();
         m_format = Format::Unknown;
         m_numChannels = 0;
         m_sampleRate = 0;
@@ -105,14 +113,61 @@ struct WavReader
         m_numFrames = 0;
         m_isRf64 = false;
         m_ready = false;
+        m_seekOffset = 0;
+        m_seekSize = 0;
+        m_codecBlockFrames = 0;
+        m_numBlocks = 0;
+        m_blockOffsets.clear();
+        m_cachedBlock = x_noBlock;
+    }
+
+    // False if the file, as opened, is shorter than the range.
+    //
+    bool ReadBytes(size_t offset, uint8_t* dest, size_t length) const
+    {
+        return m_file.Read(offset, dest, length) == length;
+    }
+
+    // Case-insensitive; extension includes the dot.
+    //
+    static bool HasExtension(const char* fileName, const char* extension)
+    {
+        size_t nameLength = std::strlen(fileName);
+        size_t extensionLength = std::strlen(extension);
+        if (nameLength <= extensionLength)
+        {
+            return false;
+        }
+
+        const char* suffix = fileName + nameLength - extensionLength;
+        for (size_t i = 0; i < extensionLength; ++i)
+        {
+            if (std::tolower(static_cast<unsigned char>(suffix[i])) != std::tolower(static_cast<unsigned char>(extension[i])))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static bool IsLosslessFileName(const char* fileName)
+    {
+        return HasExtension(fileName, LosslessCodec::x_fileExtension);
+    }
+
+    // The names LoadFromFile accepts.
+    //
+    static bool IsReadableFileName(const char* fileName)
+    {
+        return HasExtension(fileName, ".wav") || IsLosslessFileName(fileName);
     }
 
     bool LoadFromFile(const char* fileName)
     {
         Reset();
 
-        using namespace WavReaderDetail;
-        if (!ReadEntireFile(fileName, m_fileBytes))
+        if (!m_file.Open(fileName))
         {
             return false;
         }
@@ -131,27 +186,40 @@ struct WavReader
             return false;
         }
 
-        if (!IsSupported())
+        if (!IsSupported() || (m_format == Format::Lossless) != IsLosslessFileName(fileName))
         {
             Reset();
             return false;
         }
 
-        m_numFrames = m_dataSize / m_blockAlign;
+        if (m_format == Format::Lossless)
+        {
+            if (!ParseSeekTable())
+            {
+                Reset();
+                return false;
+            }
+        }
+        else
+        {
+            m_numFrames = m_dataSize / m_blockAlign;
+        }
+
         m_ready = true;
         return true;
     }
 
     bool FindFmtAndData(size_t& fmtOffset, size_t& fmtSize)
     {
-        if (m_fileBytes.size() < 12)
+        uint8_t header[12];
+        if (!ReadBytes(0, header, sizeof(header)))
         {
             return false;
         }
 
-        bool isRiff = 0 == std::memcmp(m_fileBytes.data(), "RIFF", 4);
-        m_isRf64 = 0 == std::memcmp(m_fileBytes.data(), "RF64", 4);
-        if ((!isRiff && !m_isRf64) || 0 != std::memcmp(m_fileBytes.data() + 8, "WAVE", 4))
+        bool isRiff = 0 == std::memcmp(header, "RIFF", 4);
+        m_isRf64 = 0 == std::memcmp(header, "RF64", 4);
+        if ((!isRiff && !m_isRf64) || 0 != std::memcmp(header + 8, "WAVE", 4))
         {
             return false;
         }
@@ -163,16 +231,27 @@ struct WavReader
         uint64_t rf64DataSize = 0;
 
         size_t pos = 12;
-        while (pos + 8 <= m_fileBytes.size())
+        while (pos + 8 <= m_file.m_size)
         {
-            const uint8_t* id = m_fileBytes.data() + pos;
-            uint32_t chunkSize = WavReaderDetail::ReadU32LE(m_fileBytes.data() + pos + 4);
+            uint8_t id[8];
+            if (!ReadBytes(pos, id, sizeof(id)))
+            {
+                return false;
+            }
+
+            uint32_t chunkSize = WavReaderDetail::ReadU32LE(id + 4);
             uint64_t effectiveChunkSize = chunkSize;
             size_t payload = pos + 8;
 
             if (0 == std::memcmp(id, "ds64", 4) && 16 <= chunkSize)
             {
-                rf64DataSize = WavReaderDetail::ReadU64LE(m_fileBytes.data() + payload + 8);
+                uint8_t dataSize[8];
+                if (!ReadBytes(payload + 8, dataSize, sizeof(dataSize)))
+                {
+                    return false;
+                }
+
+                rf64DataSize = WavReaderDetail::ReadU64LE(dataSize);
             }
 
             if (m_isRf64 && 0 == std::memcmp(id, "data", 4) && chunkSize == 0xFFFFFFFFu)
@@ -180,7 +259,7 @@ struct WavReader
                 effectiveChunkSize = rf64DataSize;
             }
 
-            if (static_cast<uint64_t>(m_fileBytes.size() - payload) < effectiveChunkSize)
+            if (static_cast<uint64_t>(m_file.m_size - payload) < effectiveChunkSize)
             {
                 return false;
             }
@@ -195,6 +274,11 @@ struct WavReader
                 m_dataOffset = payload;
                 m_dataSize = static_cast<size_t>(effectiveChunkSize);
             }
+            else if (0 == std::memcmp(id, LosslessCodec::x_seekChunkId, 4))
+            {
+                m_seekOffset = payload;
+                m_seekSize = static_cast<size_t>(effectiveChunkSize);
+            }
 
             pos = payload + static_cast<size_t>(effectiveChunkSize) + (static_cast<size_t>(effectiveChunkSize) & 1u);
         }
@@ -209,7 +293,12 @@ struct WavReader
             return false;
         }
 
-        const uint8_t* fmt = m_fileBytes.data() + fmtOffset;
+        uint8_t fmt[40] = {};
+        if (!ReadBytes(fmtOffset, fmt, std::min(fmtSize, sizeof(fmt))))
+        {
+            return false;
+        }
+
         uint16_t audioFormat = WavReaderDetail::ReadU16LE(fmt + 0);
         m_numChannels = WavReaderDetail::ReadU16LE(fmt + 2);
         m_sampleRate = WavReaderDetail::ReadU32LE(fmt + 4);
@@ -229,12 +318,18 @@ struct WavReader
         {
             m_format = Format::Float;
         }
+        else if (audioFormat == LosslessCodec::x_formatTag)
+        {
+            m_format = Format::Lossless;
+        }
         else
         {
             m_format = Format::Unknown;
         }
 
-        return 0 < m_numChannels && 0 < m_blockAlign && m_dataSize % m_blockAlign == 0;
+        // Lossless blocks are variable length, so only PCM data divides into frames.
+        //
+        return 0 < m_numChannels && 0 < m_blockAlign && (m_format == Format::Lossless || m_dataSize % m_blockAlign == 0);
     }
 
     bool IsSupported() const
@@ -254,9 +349,114 @@ struct WavReader
             return m_blockAlign == m_numChannels * 4;
         }
 
+        if (m_format == Format::Lossless && m_bitsPerSample == 24)
+        {
+            return m_blockAlign == m_numChannels * 3;
+        }
+
         return false;
     }
 
+    // Seek chunk payload: u32 frames per block, u32 reserved, u64 frames, then a u64 offset into the data chunk
+    // per block.  Offsets must start at 0 and increase within the data, so every block has bytes to decode.
+    //
+    bool ParseSeekTable()
+    {
+        if (m_seekSize < 16)
+        {
+            return false;
+        }
+
+        uint8_t seek[16];
+        if (!ReadBytes(m_seekOffset, seek, sizeof(seek)))
+        {
+            return false;
+        }
+
+        m_codecBlockFrames = WavReaderDetail::ReadU32LE(seek);
+        uint64_t numFrames = WavReaderDetail::ReadU64LE(seek + 8);
+
+        // Every block takes at least a byte of data, which also bounds numFrames.  Bounding the block size and the
+        // channel count bounds m_blockSamples, so a damaged header is rejected rather than sizing a huge buffer.
+        //
+        if (m_numChannels == 0 || LosslessCodec::x_maxChannels < m_numChannels)
+        {
+            return false;
+        }
+
+        if (m_codecBlockFrames == 0 || 0xFFFF < m_codecBlockFrames || numFrames == 0 || m_dataSize < numFrames / m_codecBlockFrames)
+        {
+            return false;
+        }
+
+        m_numBlocks = static_cast<size_t>((numFrames + m_codecBlockFrames - 1) / m_codecBlockFrames);
+        if (m_seekSize != 16 + 8 * m_numBlocks)
+        {
+            return false;
+        }
+
+        std::vector<uint8_t> table(8 * m_numBlocks);
+        if (!ReadBytes(m_seekOffset + 16, table.data(), table.size()))
+        {
+            return false;
+        }
+
+        m_blockOffsets.resize(m_numBlocks);
+        for (size_t block = 0; block < m_numBlocks; ++block)
+        {
+            m_blockOffsets[block] = WavReaderDetail::ReadU64LE(table.data() + 8 * block);
+        }
+
+        for (size_t block = 0; block < m_numBlocks; ++block)
+        {
+            uint64_t offset = BlockOffset(block);
+            if ((block == 0 && offset != 0) || (0 < block && offset <= BlockOffset(block - 1)) || m_dataSize <= offset)
+            {
+                return false;
+            }
+        }
+
+        m_numFrames = static_cast<size_t>(numFrames);
+        m_blockSamples.resize(m_codecBlockFrames * m_numChannels);
+        m_cachedBlock = x_noBlock;
+        return true;
+    }
+
+    size_t BlockOffset(size_t block) const
+    {
+        return block < m_numBlocks ? static_cast<size_t>(m_blockOffsets[block]) : m_dataSize;
+    }
+
+    // Decodes block into m_blockSamples unless it is already there.  False if the block is malformed.
+    //
+    bool DecodeBlock(size_t block) const
+    {
+        if (block == m_cachedBlock)
+        {
+            return true;
+        }
+
+        size_t offset = BlockOffset(block);
+        size_t size = BlockOffset(block + 1) - offset;
+        size_t expectedFrames = std::min(m_codecBlockFrames, m_numFrames - block * m_codecBlockFrames);
+        m_cachedBlock = x_noBlock;
+        m_readBuffer.resize(size);
+        if (!ReadBytes(m_dataOffset + offset, m_readBuffer.data(), size))
+        {
+            return false;
+        }
+
+        const uint8_t* data = m_readBuffer.data();
+        if (LosslessCodec::BlockFrames(data, size) != expectedFrames
+            || !LosslessCodec::DecodeBlock(data, size, m_numChannels, m_blockSamples.data(), m_scratch))
+        {
+            return false;
+        }
+
+        m_cachedBlock = block;
+        return true;
+    }
+
     float GetSample(size_t frameIndex, size_t channelIndex) const
     {
         if (!m_ready || m_numFrames <= frameIndex || m_numChannels <= channelIndex)
@@ -264,8 +464,27 @@ struct WavReader
             return 0.0f;
         }
 
-        const uint8_t* frame = m_fileBytes.data() + m_dataOffset + frameIndex * m_blockAlign;
-        const uint8_t* sample = frame + channelIndex * BytesPerSample();
+        if (m_format == Format::Lossless)
+        {
+            size_t block = frameIndex / m_codecBlockFrames;
+            if (!DecodeBlock(block))
+            {
+                return 0.0f;
+            }
+
+            size_t offset = (frameIndex - block * m_codecBlockFrames) * m_numChannels + channelIndex;
+            return static_cast<float>(m_blockSamples[offset]) * (1.0f / 8388608.0f);
+        }
+
+        uint8_t sample[4] = {};
+        ReadBytes(m_dataOffset + frameIndex * m_blockAlign + channelIndex * BytesPerSample(), sample, BytesPerSample());
+        return DecodePcmSample(sample);
+    }
+
+    // One PCM or float sample in the file's format.
+    //
+    float DecodePcmSample(const uint8_t* sample) const
+    {
         if (m_format == Format::Pcm && m_bitsPerSample == 16)
         {
             int16_t v = static_cast<int16_t>(WavReaderDetail::ReadU16LE(sample));
@@ -299,10 +518,97 @@ struct WavReader
     void WriteLeftRightSum(std::vector<float>& out) const
     {
         out.resize(m_numFrames);
-        for (size_t i = 0; i < m_numFrames; ++i)
+        DecodeLeftRightSum(0, m_numFrames, out.data());
+    }
+
+    // Decodes frames [firstFrame, firstFrame + count) as left+right sums, reading only those bytes of the file
+    // (for lossless files, the blocks holding them).  Frames past the end, or in a malformed block, decode as zero.
+    //
+    void DecodeLeftRightSum(size_t firstFrame, size_t count, float* out) const
+    {
+        if (m_ready && m_format == Format::Lossless)
         {
-            out[i] = GetLeftRightSum(i);
+            DecodeLosslessLeftRightSum(firstFrame, count, out);
+            return;
         }
+
+        size_t end = m_ready ? std::min(m_numFrames, firstFrame + count) : 0;
+        size_t i = 0;
+        for (size_t frame = firstFrame; frame < end; frame += x_readFrames)
+        {
+            size_t numFrames = std::min(x_readFrames, end - frame);
+            m_readBuffer.resize(numFrames * m_blockAlign);
+            ReadBytes(m_dataOffset + frame * m_blockAlign, m_readBuffer.data(), m_readBuffer.size());
+            const uint8_t* bytes = m_readBuffer.data();
+            for (size_t j = 0; j < numFrames; ++j, ++i, bytes += m_blockAlign)
+            {
+                float sum = DecodePcmSample(bytes);
+                if (1 < m_numChannels)
+                {
+                    sum += DecodePcmSample(bytes + BytesPerSample());
+                }
+
+                out[i] = sum;
+            }
+        }
+
+        std::fill(out + i, out + count, 0.0f);
+    }
+
+    void DecodeLosslessLeftRightSum(size_t firstFrame, size_t count, float* out) const
+    {
+        size_t i = 0;
+        while (i < count)
+        {
+            size_t frame = firstFrame + i;
+            if (m_numFrames <= frame)
+            {
+                std::fill(out + i, out + count, 0.0f);
+                return;
+            }
+
+            size_t block = frame / m_codecBlockFrames;
+            size_t blockStart = block * m_codecBlockFrames;
+            size_t end = std::min(count, i + std::min(m_numFrames, blockStart + m_codecBlockFrames) - frame);
+            if (!DecodeBlock(block))
+            {
+                std::fill(out + i, out + end, 0.0f);
+                i = end;
+                continue;
+            }
+
+            const int32_t* samples = m_blockSamples.data() + (frame - blockStart) * m_numChannels;
+            for (; i < end; ++i, samples += m_numChannels)
+            {
+                float sum = static_cast<float>(samples[0]) * (1.0f / 8388608.0f);
+                if (1 < m_numChannels)
+                {
+                    sum += static_cast<float>(samples[1]) * (1.0f / 8388608.0f);
+                }
+
+                out[i] = sum;
+            }
+        }
+    }
+
+    // Hints that frames [firstFrame, firstFrame + count) will be decoded soon.
+    //
+    void WillNeed(size_t firstFrame, size_t count) const
+    {
+        if (m_format == Format::Lossless)
+        {
+            if (m_ready && firstFrame < m_numFrames)
+            {
+                size_t firstBlock = firstFrame / m_codecBlockFrames;
+                size_t endBlock = std::min(m_numBlocks, (firstFrame + count + m_codecBlockFrames - 1) / m_codecBlockFrames);
+                size_t offset = BlockOffset(firstBlock);
+                m_file.WillNeed(m_dataOffset + offset, BlockOffset(endBlock) - offset);
+            }
+
+            return;
+        }
+
+        m_file.WillNeed(m_dataOffset + firstFrame * m_blockAlign, count * m_blockAlign);
     }
 
     size_t BytesPerSample() const
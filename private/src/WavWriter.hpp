@@ -48,6 +48,27 @@ struct Rf64Header
     //
     char dataId[4] = {'d', 'a', 't', 'a'};
     uint32_t dataSize32 = 0xFFFFFFFF; // Always 0xFFFFFFFF for RF64
+
+    // 24-bit PCM, sizes zeroed until Finish.
+    //
+    void Init(uint16_t channels, uint32_t rate)
+    {
+        numChannels = channels;
+        sampleRate = rate;
+        bitsPerSample = 24;
+        blockAlign = channels * 3;
+        byteRate = rate * blockAlign;
+        riffSize = 0;
+        dataSize = 0;
+        sampleCount = 0;
+    }
+
+    void Finish(uint64_t dataBytes, uint64_t frames)
+    {
+        dataSize = dataBytes;
+        riffSize = sizeof(Rf64Header) + dataBytes - 8;
+        sampleCount = frames;
+    }
 };
 #pragma pack(pop)
 
@@ -92,14 +113,7 @@ struct MultichannelWavWriter
         
         // Initialize RF64 header
         //
-        m_header.numChannels = numChannels;
-        m_header.sampleRate = sampleRate;
-        m_header.bitsPerSample = 24;
-        m_header.blockAlign = numChannels * x_bytesPerSample;
-        m_header.byteRate = sampleRate * m_header.blockAlign;
-        m_header.riffSize = 0;
-        m_header.dataSize = 0;
-        m_header.sampleCount = 0;
+        m_header.Init(numChannels, sampleRate);
         
         // Open file writer
         //
@@ -126,7 +140,7 @@ struct MultichannelWavWriter
         if (!m_isOpen || channel >= m_numChannels)
         {
             m_error = true;
-            INFO("WavWriter error: WriteSample called when not open or invalid channel (channel=%d, numChannels=%d, isOpen=%d)", channel, m_numChannels, m_isOpen);
+            INFO_RATE_LIMITED("WavWriter error: WriteSample called when not open or invalid channel (channel=%d, numChannels=%d, isOpen=%d)", channel, m_numChannels, m_isOpen);
             return;
         }
         
@@ -169,7 +183,7 @@ struct MultichannelWavWriter
         if (!m_isOpen || m_numChannels < 4)
         {
             m_error = true;
-            INFO("WavWriter error: WriteSample QuadFloat called when not open or insufficient channels (channel=%d, numChannels=%d, isOpen=%d)", channel, m_numChannels, m_isOpen);
+            INFO_RATE_LIMITED("WavWriter error: WriteSample QuadFloat called when not open or insufficient channels (channel=%d, numChannels=%d, isOpen=%d)", channel, m_numChannels, m_isOpen);
             return;
         }
         
@@ -239,8 +253,7 @@ struct MultichannelWavWriter
         
         // Update header with final sizes
         //
-        m_header.riffSize = sizeof(Rf64Header) + m_header.dataSize - 8;
-        m_header.sampleCount = m_samplesWritten;
+        m_header.Finish(m_header.dataSize, m_samplesWritten);
         
         // Patch the header in the file
         //
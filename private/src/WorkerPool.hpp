@@ -0,0 +1,133 @@
+#pragma once
+
+#include "ThreadId.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small fixed pool of background threads for file loading and decoding on the I/O side.  Jobs run in
+// submission order across up to x_maxWorkers threads; Submit never waits for them.  Not for the audio thread:
+// Submit allocates and takes a mutex.
+//
+// Destroying the pool drops jobs that have not started and waits for running ones.  A job must therefore own
+// (or share ownership of) whatever it writes.
+//
+struct WorkerPool
+{
+    static constexpr size_t x_maxWorkers = 4;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::condition_variable m_idleCondition;
+    std::deque<std::function<void()>> m_jobs;
+    std::vector<std::thread> m_threads;
+    size_t m_running;
+    bool m_stopping;
+
+    explicit WorkerPool(size_t numWorkers = DefaultNumWorkers())
+        : m_running(0)
+        , m_stopping(false)
+    {
+        numWorkers = std::max<size_t>(1, std::min(numWorkers, x_maxWorkers));
+        for (size_t i = 0; i < numWorkers; ++i)
+        {
+            m_threads.emplace_back(&WorkerPool::Run, this);
+        }
+    }
+
+    ~WorkerPool()
+    {
+        Shutdown();
+    }
+
+    static size_t DefaultNumWorkers()
+    {
+        size_t hardware = std::thread::hardware_concurrency();
+        return hardware <= 2 ? 1 : std::min(hardware - 2, x_maxWorkers);
+    }
+
+    // Idempotent.
+    //
+    void Shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+            m_jobs.clear();
+        }
+
+        m_condition.notify_all();
+        for (std::thread& thread : m_threads)
+        {
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+
+        m_idleCondition.notify_all();
+    }
+
+    void Submit(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping)
+            {
+                return;
+            }
+
+            m_jobs.push_back(std::move(job));
+        }
+
+        m_condition.notify_one();
+    }
+
+    // Blocks until every submitted job has finished.
+    //
+    void WaitIdle()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idleCondition.wait(lock, [this]()
+        {
+            return m_stopping || (m_jobs.empty() && m_running == 0);
+        });
+    }
+
+    void Run()
+    {
+        SetCurrentThreadId(ThreadId::AsyncIo);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_condition.wait(lock, [this]()
+            {
+                return m_stopping || !m_jobs.empty();
+            });
+
+            if (m_stopping)
+            {
+                return;
+            }
+
+            std::function<void()> job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            ++m_running;
+            lock.unlock();
+            job();
+            job = nullptr;
+            lock.lock();
+            --m_running;
+            if (m_jobs.empty() && m_running == 0)
+            {
+                m_idleCondition.notify_all();
+            }
+        }
+    }
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+// LPSysex.hpp -- decodes the Launchpad RGB sysex that LPSysexWriter emits, for LED output tests.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "doctest.h"
+
+#include "LaunchPadMidi.hpp"
+
+namespace TestLPSysex
+{
+
+// One pad (as a note) from an RGB sysex, with its red component.
+//
+struct Pad
+{
+    uint8_t m_note;
+    uint8_t m_red;
+};
+
+// Pads in one RGB sysex, in message order. Checks the framing and the per-pad RGB type byte.
+//
+inline std::vector<Pad> ParseSysex(const uint8_t* buffer, size_t size)
+{
+    std::vector<Pad> pads;
+    DOCTEST_REQUIRE(size >= SmartGrid::LPSysexWriter::x_headerSize + 1);
+    DOCTEST_CHECK(buffer[0] == 240);
+    DOCTEST_CHECK(buffer[size - 1] == 247);
+    for (size_t pos = SmartGrid::LPSysexWriter::x_headerSize; pos + 1 < size; pos += SmartGrid::LPSysexWriter::x_bytesPerPad)
+    {
+        DOCTEST_CHECK(buffer[pos] == 3);
+        pads.push_back(Pad{buffer[pos + 1], buffer[pos + 2]});
+    }
+
+    return pads;
+}
+
+} // namespace TestLPSysex
@@ -0,0 +1,81 @@
+#pragma once
+
+// WavFile.hpp -- writes small WAV files for tests that load samples from disk.
+//
+// Plain RIFF, stereo, at the host rate; PCM16, PCM24 or 32-bit float.
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "SampleTimer.hpp"
+
+namespace TestWav
+{
+
+inline void PutU16(std::vector<uint8_t>& out, uint16_t v)
+{
+    out.push_back(static_cast<uint8_t>(v & 0xFF));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+inline void PutU32(std::vector<uint8_t>& out, uint32_t v)
+{
+    PutU16(out, static_cast<uint16_t>(v & 0xFFFF));
+    PutU16(out, static_cast<uint16_t>(v >> 16));
+}
+
+// Writes an interleaved stereo RIFF WAV at the host rate.  format 1 = PCM (16 or 24 bit), 3 = float.
+//
+inline void WriteStereoWav(const std::string& path, uint16_t format, uint16_t bits, const std::vector<float>& left, const std::vector<float>& right)
+{
+    uint16_t channels = 2;
+    uint16_t blockAlign = static_cast<uint16_t>(channels * bits / 8);
+    uint32_t dataSize = static_cast<uint32_t>(left.size() * blockAlign);
+
+    std::vector<uint8_t> bytes;
+    bytes.insert(bytes.end(), {'R', 'I', 'F', 'F'});
+    PutU32(bytes, 36 + dataSize);
+    bytes.insert(bytes.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    PutU32(bytes, 16);
+    PutU16(bytes, format);
+    PutU16(bytes, channels);
+    PutU32(bytes, static_cast<uint32_t>(SampleTimer::x_sampleRate));
+    PutU32(bytes, static_cast<uint32_t>(SampleTimer::x_sampleRate) * blockAlign);
+    PutU16(bytes, blockAlign);
+    PutU16(bytes, bits);
+    bytes.insert(bytes.end(), {'d', 'a', 't', 'a'});
+    PutU32(bytes, dataSize);
+
+    for (size_t i = 0; i < left.size(); ++i)
+    {
+        for (float sample : {left[i], right[i]})
+        {
+            if (format == 3)
+            {
+                uint32_t u;
+                std::memcpy(&u, &sample, sizeof(u));
+                PutU32(bytes, u);
+            }
+            else if (bits == 16)
+            {
+                PutU16(bytes, static_cast<uint16_t>(static_cast<int16_t>(std::lround(sample * 32767.0f))));
+            }
+            else
+            {
+                uint32_t u = static_cast<uint32_t>(static_cast<int32_t>(std::lround(sample * 8388607.0f)));
+                bytes.push_back(static_cast<uint8_t>(u & 0xFF));
+                bytes.push_back(static_cast<uint8_t>((u >> 8) & 0xFF));
+                bytes.push_back(static_cast<uint8_t>((u >> 16) & 0xFF));
+            }
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+} // namespace TestWav
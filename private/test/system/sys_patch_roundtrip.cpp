@@ -9,6 +9,10 @@
 //      are NOT serialised, so the JSON itself is deterministic and repeatable).
 //   4. Malformed JSON: LoadPatch returns false, system stays NaN-clean.
 //   5. Round-trip while sequencer runs: no crash, no NaN.
+//   6. Binary patch file: save → write .sgpatch → load into a fresh rig through
+//      StateInterchange::LoadFileForLoad → save again gives the same JSON.
+//   7. Streamed save: DumpTo through a FileWriter or the FileSink SavePatch uses
+//      writes exactly the Dumps text, and the file loads back into a fresh rig.
 //
 // Tolerance: 14-bit quantisation (1/16383 ≈ 6e-5) plus slew lag (up to ~5e-3
 // after kSettleFrames).  We use kTol = 5e-3f throughout.
@@ -32,10 +36,16 @@
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <fstream>
+#include <iterator>
 #include <string>
 #include <vector>
 
 #include "../support/SynthRig.hpp"
+#include "../support/TempDir.hpp"
+
+#include "FileWriter.hpp"
+#include "PatchBinary.hpp"
 
 namespace
 {
@@ -677,3 +687,96 @@ DOCTEST_TEST_CASE("sys_patch_roundtrip: save-pad and load-pad physical paths wor
 
     DOCTEST_CHECK_FALSE(rig.SawNaN());
 }
+
+// ---------------------------------------------------------------------------
+// Test 6: Binary patch files load like JSON ones
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("sys_patch_roundtrip: binary patch file restores the same state as JSON")
+{
+    synthrig::SynthRig source;
+    source.RunFrames(2);
+
+    auto encoders = FindConnectedEncoders(source);
+    DOCTEST_REQUIRE_FALSE(encoders.empty());
+    if (encoders.size() > 6)
+    {
+        encoders.resize(6);
+    }
+
+    RandomiseEncoders(source, encoders, /*seed=*/0xB1A2B1A2ULL);
+    JSON saved = source.SavePatchJSON();
+    DOCTEST_REQUIRE_FALSE(saved.IsNull());
+    std::string json = DumpJSON(saved);
+
+    synthrig::TempDir dir;
+    std::string path = (dir.Path() / (std::string("patch") + PatchBinary::x_extension)).string();
+    DOCTEST_REQUIRE(PatchBinary::WriteFile(path.c_str(), saved));
+
+    synthrig::SynthRig loaded;
+    loaded.RunFrames(2);
+    JSON fromFile = loaded.Internal().m_stateInterchange.LoadFileForLoad(path.c_str());
+    DOCTEST_REQUIRE_FALSE(fromFile.IsNull());
+    DOCTEST_CHECK(DumpJSON(fromFile) == json);
+    DOCTEST_REQUIRE(loaded.LoadPatchJSON(fromFile));
+    loaded.RunFrames(kSettleFrames);
+
+    DOCTEST_CHECK(loaded.SavePatch() == json);
+    DOCTEST_CHECK_FALSE(loaded.SawNaN());
+}
+
+// ---------------------------------------------------------------------------
+// Test 7: Streamed patch files match Dumps
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("sys_patch_roundtrip: patch streamed through a FileWriter loads back")
+{
+    synthrig::SynthRig source;
+    source.RunFrames(2);
+
+    auto encoders = FindConnectedEncoders(source);
+    DOCTEST_REQUIRE_FALSE(encoders.empty());
+    if (encoders.size() > 6)
+    {
+        encoders.resize(6);
+    }
+
+    RandomiseEncoders(source, encoders, /*seed=*/0x5713EA3DULL);
+    JSON saved = source.SavePatchJSON();
+    DOCTEST_REQUIRE_FALSE(saved.IsNull());
+    std::string json = DumpJSON(saved);
+
+    synthrig::TempDir dir;
+    std::string path = (dir.Path() / "patch.json").string();
+    FileWriter writer;
+    writer.Open(path);
+    DOCTEST_REQUIRE(saved.DumpTo(writer));
+    writer.Close();
+    DOCTEST_REQUIRE_FALSE(writer.m_error.load());
+
+    std::ifstream file(path, std::ios::binary);
+    std::string streamed((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    DOCTEST_CHECK(streamed.size() > JsonDetail::Writer<FileWriter>::x_bufferSize);
+    DOCTEST_CHECK(streamed == json);
+
+    std::string sinkPath = (dir.Path() / "patch-sink.json").string();
+    JsonDetail::FileSink sink(sinkPath.c_str());
+    DOCTEST_REQUIRE(saved.DumpTo(sink));
+    DOCTEST_REQUIRE(sink.Close());
+
+    std::ifstream sinkFile(sinkPath, std::ios::binary);
+    std::string sunk((std::istreambuf_iterator<char>(sinkFile)), std::istreambuf_iterator<char>());
+    DOCTEST_CHECK(sunk == json);
+
+    JsonDetail::FileSink missing((dir.Path() / "missing" / "patch.json").string().c_str());
+    DOCTEST_CHECK(missing.Write(reinterpret_cast<const uint8_t*>(json.data()), json.size()) == 0);
+    DOCTEST_CHECK_FALSE(missing.Close());
+
+    synthrig::SynthRig loaded;
+    loaded.RunFrames(2);
+    DOCTEST_REQUIRE(loaded.LoadPatch(streamed));
+    loaded.RunFrames(kSettleFrames);
+
+    DOCTEST_CHECK(loaded.SavePatch() == json);
+    DOCTEST_CHECK_FALSE(loaded.SawNaN());
+}
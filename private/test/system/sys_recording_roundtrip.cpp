@@ -48,7 +48,9 @@
 //
 //   reload:   On the next ProcessFrame, IoTaskThread::Acknowledge installs that
 //             AudioBufferBank pointer into the voice config (the SampleSource
-//             then plays it). RecordingBuffer::Reset is also acked here.
+//             then plays it). The RecordingBuffer itself was Reset at stop:
+//             the persist task owns the detached take and returns its chunks
+//             to the RecordingChunkPool once the file is written.
 //             PostStopRecording additionally pushes a ReloadDirectory for any
 //             voice that already had a bank.
 //
@@ -234,12 +236,19 @@ float KnownSignalAt(size_t i)
 // StopRecording hands it to the I/O thread) and with no frames running in
 // between, so the writer cannot append more samples.
 //
-void OverwriteWithKnownSignal(std::vector<float>& buffer)
+// Writes the known signal over every captured sample (across the buffer's
+// chunks) and returns a copy of it.
+//
+std::vector<float> OverwriteWithKnownSignal(RecordingBuffer& buffer)
 {
-    for (size_t i = 0; i < buffer.size(); ++i)
+    std::vector<float> written(buffer.NumSamples());
+    for (size_t i = 0; i < written.size(); ++i)
     {
-        buffer[i] = KnownSignalAt(i);
+        written[i] = KnownSignalAt(i);
+        *buffer.SampleAt(i) = written[i];
     }
+
+    return written;
 }
 
 // Arm trio Water, capture ~0.9 master loop, inject the known signal into voice
@@ -256,9 +265,7 @@ std::vector<float> RecordKnownSignalIntoVoice0(SynthRig& rig)
     rm.StartRecording(TheNonagonInternal::Trio::Water);
     rig.RunSeconds(3.6);
 
-    std::vector<float>& buf = boy.m_voices[0].m_recordingBuffer.m_buffer;
-    OverwriteWithKnownSignal(buf);
-    std::vector<float> captured = buf;
+    std::vector<float> captured = OverwriteWithKnownSignal(boy.m_voices[0].m_recordingBuffer);
 
     rm.StopRecording(TheNonagonInternal::Trio::Water);
     return captured;
@@ -297,7 +304,7 @@ DOCTEST_TEST_CASE("WP-9: record -> persist writes a well-formed master-loop WAV"
     rig.RunSeconds(3.6);
 
     RecordingBuffer& buf0 = boy.m_voices[0].m_recordingBuffer;
-    DOCTEST_CHECK(buf0.m_buffer.size() > 0);
+    DOCTEST_CHECK(buf0.NumSamples() > 0);
 
     // Inject a known, deterministic signal into voice 0's captured buffer BEFORE
     // StopRecording hands it to the I/O thread (no frames run in between, so the
@@ -305,8 +312,7 @@ DOCTEST_TEST_CASE("WP-9: record -> persist writes a well-formed master-loop WAV"
     // this is what lets us verify the persisted CONTENT exactly. Voices 1 and 2
     // keep their (silent) captures.
     //
-    OverwriteWithKnownSignal(buf0.m_buffer);
-    std::vector<float> captured = buf0.m_buffer; // reference copy for verification
+    std::vector<float> captured = OverwriteWithKnownSignal(buf0); // reference copy for verification
     const float capturedPeak = Peak(captured);
     DOCTEST_CHECK(capturedPeak > 0.0f);
 
@@ -642,7 +648,7 @@ DOCTEST_TEST_CASE("WP-9: shutdown after draining an in-flight persist is safe (U
         RecordKnownSignalIntoVoice0(rig); // arms, records, StopRecording (pushes persist)
 
         // SAFE contract: pump until the I/O thread has finished persisting AND the
-        // audio thread has Acknowledged (sink installed, RecordingBuffer Reset), so
+        // audio thread has Acknowledged (sink installed, take released), so
         // no in-flight task references anything owned by the soon-to-be-destroyed
         // audio core.
         //
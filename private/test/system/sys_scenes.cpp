@@ -10,7 +10,7 @@
 //   m_blendFactor < 0.5  → scene pad sets RIGHT scene (m_scene2)
 //   m_blendFactor >= 0.5 → scene pad sets LEFT scene  (m_scene1)
 //   shift + scene pad    → CopyToScene(scene)
-//   GetSceneValue        → values[scene1]*(1-blend) + values[scene2]*blend
+//   GetSceneValue        → values[scene1][t]*(1-blend) + values[scene2][t]*blend
 //   UIState::GetValue    → slewed output — run a few frames to settle
 //
 // NOTE on tolerance: EncoderValue reports the slewed output; after one frame
@@ -0,0 +1,206 @@
+// audio_buffer_bank_loading.cpp -- unit tests for parallel AudioBufferBank loading (private/src/WorkerPool.hpp)
+//
+// With a WorkerPool, LoadFromDirectory loads the first new file itself and hands the rest to the pool.
+//
+// Tests:
+//   1. Buffers come out in filename order whatever order readdir and the workers use, the first is playable
+//      at once, the rest read as empty until loaded, and the result matches a serial load.
+//   2. Reload reuses loaded buffers and sends only new files to the pool; the UI snapshot reports progress.
+//   3. IoTaskThread installs a bank whose first buffer is loaded and finishes the rest in the background.
+
+#include "doctest.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../support/GlobalEnv.hpp"
+#include "../support/TempDir.hpp"
+#include "../support/WavFile.hpp"
+
+#include "AudioBuffer.hpp"
+#include "IOTaskThread.hpp"
+#include "WorkerPool.hpp"
+
+namespace
+{
+    // Writes file i of a bank: a constant level of i / 16 so each buffer is recognizable.
+    //
+    void WriteLevelFile(const synthrig::TempDir& dir, size_t i, size_t frames)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "take_%02zu.wav", i);
+        std::vector<float> left(frames, static_cast<float>(i) / 32.0f);
+        std::vector<float> right(frames, static_cast<float>(i) / 32.0f);
+        TestWav::WriteStereoWav((dir.Path() / name).string(), 3, 32, left, right);
+    }
+
+    float Level(size_t i)
+    {
+        return static_cast<float>(i) / 16.0f;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 1. Order, partial availability, equivalence
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("AudioBufferBank loading: parallel load is ordered and matches a serial load")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    const size_t numFiles = 12;
+
+    // Written out of order so readdir order is unlikely to be filename order.
+    //
+    for (size_t k = 0; k < numFiles; ++k)
+    {
+        WriteLevelFile(dir, (k * 5) % numFiles, 20000 + 100 * k);
+    }
+
+    AudioBufferBank serial;
+    serial.LoadFromDirectory(dir.String().c_str(), "bank", nullptr);
+    DOCTEST_REQUIRE(serial.m_audioBuffers.size() == numFiles);
+    DOCTEST_CHECK(serial.NumLoaded() == numFiles);
+
+    WorkerPool pool(3);
+    AudioBufferBank parallel;
+    parallel.LoadFromDirectory(dir.String().c_str(), "bank", nullptr, &pool);
+    DOCTEST_REQUIRE(parallel.m_audioBuffers.size() == numFiles);
+    DOCTEST_CHECK(parallel.m_directoryName == "bank");
+
+    // The first buffer is ready when LoadFromDirectory returns.
+    //
+    DOCTEST_CHECK(parallel.m_audioBuffers[0]->IsLoaded());
+    DOCTEST_CHECK(parallel.m_audioBuffers[0]->ReadRealTime(10.0) == Level(0));
+
+    // A buffer still loading reads as empty rather than half-written.
+    //
+    for (const std::shared_ptr<AudioBuffer>& buf : parallel.m_audioBuffers)
+    {
+        if (!buf->IsLoaded())
+        {
+            DOCTEST_CHECK(buf->NumFrames() == 0);
+            DOCTEST_CHECK(buf->ReadRealTime(10.0) == 0.0f);
+        }
+    }
+
+    pool.WaitIdle();
+    DOCTEST_CHECK(parallel.NumLoaded() == numFiles);
+    for (size_t i = 0; i < numFiles; ++i)
+    {
+        DOCTEST_CAPTURE(i);
+        const AudioBuffer& a = *serial.m_audioBuffers[i];
+        const AudioBuffer& b = *parallel.m_audioBuffers[i];
+        char name[32];
+        std::snprintf(name, sizeof(name), "take_%02zu.wav", i);
+        DOCTEST_CHECK(a.m_fileName == name);
+        DOCTEST_CHECK(b.m_fileName == name);
+        DOCTEST_CHECK(a.m_buffer == b.m_buffer);
+        DOCTEST_CHECK(a.m_sectionMaximums == b.m_sectionMaximums);
+        DOCTEST_CHECK(b.ReadRealTime(100.0) == Level(i));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 2. Reload and progress
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("AudioBufferBank loading: reload reuses buffers and the UI sees progress")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        WriteLevelFile(dir, i, 8000);
+    }
+
+    WorkerPool pool(2);
+    AudioBufferBank bank;
+    bank.LoadFromDirectory(dir.String().c_str(), "", nullptr, &pool);
+    pool.WaitIdle();
+
+    for (size_t i = 3; i < 6; ++i)
+    {
+        WriteLevelFile(dir, i, 8000);
+    }
+
+    AudioBufferBank* reloaded = bank.ReloadFromDirectory(dir.String().c_str(), "", &pool);
+    DOCTEST_REQUIRE(reloaded->m_audioBuffers.size() == 6);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        DOCTEST_CHECK(reloaded->m_audioBuffers[i] == bank.m_audioBuffers[i]);
+    }
+
+    // The first new file loads inline; nothing earlier in the bank is waiting on the pool.
+    //
+    DOCTEST_CHECK(reloaded->m_audioBuffers[3]->IsLoaded());
+    DOCTEST_CHECK(reloaded->NumLoaded() >= 4);
+
+    pool.WaitIdle();
+    AudioBufferBank::UIState uiState;
+    reloaded->PopulateUIState(&uiState);
+    DOCTEST_CHECK(uiState.GetCurrentSnapshot().m_numLoaded == 6);
+    DOCTEST_CHECK(uiState.GetCurrentSnapshot().m_numBuffers == 6);
+    for (size_t i = 0; i < 6; ++i)
+    {
+        DOCTEST_CHECK(reloaded->m_audioBuffers[i]->ReadRealTime(5.0) == Level(i));
+    }
+
+    delete reloaded;
+}
+
+// ---------------------------------------------------------------------------
+// 3. Through IoTaskThread
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("AudioBufferBank loading: IoTaskThread installs a playable bank before it finishes loading")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    std::filesystem::create_directories(dir.Path() / "kit");
+    for (size_t i = 0; i < 8; ++i)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "kit/take_%02zu.wav", i);
+        std::vector<float> level(30000, Level(i) / 2.0f);
+        TestWav::WriteStereoWav((dir.Path() / name).string(), 1, 16, level, level);
+    }
+
+    IoTaskThread io;
+    io.SetSampleDirectoryRootAbsolute(dir.Path());
+    AudioBufferBank* sink = nullptr;
+    DOCTEST_REQUIRE(io.PushLoadAudioBufferBankFromDirectory("kit", &sink));
+
+    auto start = std::chrono::steady_clock::now();
+    while (!sink && std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+    {
+        io.Acknowledge();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    DOCTEST_REQUIRE(sink != nullptr);
+    DOCTEST_REQUIRE(sink->m_audioBuffers.size() == 8);
+    DOCTEST_CHECK(sink->m_audioBuffers[0]->IsLoaded());
+
+    start = std::chrono::steady_clock::now();
+    while (sink->NumLoaded() < 8 && std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    DOCTEST_CHECK(sink->NumLoaded() == 8);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        DOCTEST_CHECK(std::abs(sink->m_audioBuffers[i]->ReadRealTime(1000.0) - Level(i)) < 1.0e-3f);
+    }
+
+    io.Shutdown();
+    delete sink;
+}
@@ -0,0 +1,310 @@
+// audio_buffer_paging.cpp -- unit tests for streamed AudioBuffers (private/src/AudioBufferPageCache.hpp)
+//
+// A long WAV file at the host rate is decoded page by page on the pager thread instead of being decoded up
+// front.  Reads must match a fully decoded buffer once their pages are resident.
+//
+// Tests:
+//   1. PCM16, PCM24 and float files stream: the first pages are playable at once, every read matches the
+//      decoded buffer once paged in, and the overview fills in to match (a copy taken mid-scan holds only
+//      finished sections).
+//   2. A read far from the play head misses (silence) and is paged in; Prefetch decodes ahead of the play head.
+//   3. Short files still decode up front.
+//   4. Truncating a streamed file turns the lost pages into silence instead of a SIGBUS.
+
+#include "doctest.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../support/GlobalEnv.hpp"
+#include "../support/TempDir.hpp"
+#include "../support/WavFile.hpp"
+
+#include "AudioBuffer.hpp"
+#include "SampleTimer.hpp"
+
+namespace
+{
+    void MakeSignal(size_t frames, std::vector<float>& left, std::vector<float>& right)
+    {
+        left.resize(frames);
+        right.resize(frames);
+        for (size_t i = 0; i < frames; ++i)
+        {
+            left[i] = 0.45f * std::sin(0.0031f * static_cast<float>(i));
+            right[i] = 0.3f * std::sin(0.00017f * static_cast<float>(i) * static_cast<float>(i % 97));
+        }
+    }
+
+    // Reads realTime from a streamed buffer, waiting for the pager if the page is not resident yet.
+    //
+    float ReadPagedIn(const AudioBuffer& buffer, double realTime)
+    {
+        size_t page = static_cast<size_t>(std::max(0.0, realTime)) / AudioBufferPageCache::x_pageFrames;
+        page = std::min(page, buffer.m_pages->m_numPages - 1);
+        buffer.ReadRealTime(realTime);
+        auto start = std::chrono::steady_clock::now();
+        while (!buffer.m_pages->IsResident(static_cast<int64_t>(page))
+               && std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+
+        return buffer.ReadRealTime(realTime);
+    }
+
+    bool WaitForExtrema(const AudioBuffer& buffer)
+    {
+        auto start = std::chrono::steady_clock::now();
+        while (!buffer.m_pages->ExtremaComplete())
+        {
+            if (std::chrono::steady_clock::now() - start > std::chrono::seconds(10))
+            {
+                return false;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return true;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 1. Streamed reads match the decoded buffer
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("AudioBuffer paging: streamed PCM16, PCM24 and float files read like decoded ones")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    const size_t frames = 100 * AudioBufferPageCache::x_pageFrames + 123;
+    std::vector<float> left;
+    std::vector<float> right;
+    MakeSignal(frames, left, right);
+
+    struct Case
+    {
+        uint16_t m_format;
+        uint16_t m_bits;
+    };
+
+    for (Case c : {Case{1, 16}, Case{1, 24}, Case{3, 32}})
+    {
+        DOCTEST_CAPTURE(c.m_bits);
+        std::string path = (dir.Path() / ("paged" + std::to_string(c.m_bits) + ".wav")).string();
+        TestWav::WriteStereoWav(path, c.m_format, c.m_bits, left, right);
+
+        AudioBuffer decoded;
+        decoded.LoadFromFile(path.c_str(), frames + 1);
+        DOCTEST_REQUIRE(decoded.m_pages == nullptr);
+        DOCTEST_REQUIRE(decoded.NumFrames() == frames);
+
+        AudioBuffer streamed;
+        streamed.LoadFromFile(path.c_str(), frames);
+        DOCTEST_REQUIRE(streamed.m_pages != nullptr);
+        DOCTEST_CHECK(streamed.m_buffer.empty());
+        DOCTEST_CHECK(streamed.NumFrames() == frames);
+        DOCTEST_CHECK(streamed.GetRealTime(0.5) == decoded.GetRealTime(0.5));
+
+        // Playable from the start as soon as the load returns.
+        //
+        size_t missesBefore = streamed.m_pages->m_missCount.load();
+        for (size_t i = 0; i < AudioBufferPageCache::x_readaheadPages * AudioBufferPageCache::x_pageFrames; i += 37)
+        {
+            double realTime = static_cast<double>(i) + 0.25;
+            DOCTEST_CHECK(streamed.ReadRealTime(realTime) == decoded.ReadRealTime(realTime));
+        }
+
+        DOCTEST_CHECK(streamed.m_pages->m_missCount.load() == missesBefore);
+
+        // Everywhere else, including page boundaries and both ends, once paged in.
+        //
+        std::vector<double> times = {-3.0, 0.0, static_cast<double>(frames - 1), static_cast<double>(frames) + 5.0};
+        for (size_t page = 1; page < 100; page += 7)
+        {
+            double boundary = static_cast<double>(page * AudioBufferPageCache::x_pageFrames);
+            times.push_back(boundary - 0.5);
+            times.push_back(boundary);
+            times.push_back(boundary + 0.75);
+        }
+
+        for (double realTime : times)
+        {
+            DOCTEST_CAPTURE(realTime);
+            DOCTEST_CHECK(ReadPagedIn(streamed, realTime) == decoded.ReadRealTime(realTime));
+        }
+
+        // The overview fills in on the pager thread and matches the decoded one.  Any copy holds each section
+        // either finished or zero.
+        //
+        std::array<float, AudioBuffer::x_numSections> decodedMaximums;
+        std::array<float, AudioBuffer::x_numSections> decodedMinimums;
+        std::array<float, AudioBuffer::x_numSections> streamedMaximums;
+        std::array<float, AudioBuffer::x_numSections> streamedMinimums;
+        decoded.CopySectionExtrema(decodedMaximums, decodedMinimums);
+        streamed.CopySectionExtrema(streamedMaximums, streamedMinimums);
+        bool partialValid = true;
+        for (size_t i = 0; i < AudioBuffer::x_numSections; ++i)
+        {
+            bool unpublished = streamedMaximums[i] == 0.0f && streamedMinimums[i] == 0.0f;
+            partialValid = partialValid && (unpublished || (streamedMaximums[i] == decodedMaximums[i] && streamedMinimums[i] == decodedMinimums[i]));
+        }
+
+        DOCTEST_CHECK(partialValid);
+        DOCTEST_REQUIRE(WaitForExtrema(streamed));
+        streamed.CopySectionExtrema(streamedMaximums, streamedMinimums);
+        for (size_t i = 0; i < AudioBuffer::x_numSections; ++i)
+        {
+            DOCTEST_CHECK(streamedMaximums[i] == decodedMaximums[i]);
+            DOCTEST_CHECK(streamedMinimums[i] == decodedMinimums[i]);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 2. Misses and readahead
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("AudioBuffer paging: misses read silence and Prefetch decodes ahead of the play head")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    const size_t pageFrames = AudioBufferPageCache::x_pageFrames;
+    const size_t frames = 300 * pageFrames;
+    std::vector<float> left(frames, 0.25f);
+    std::vector<float> right(frames, 0.25f);
+    std::string path = (dir.Path() / "long.wav").string();
+    TestWav::WriteStereoWav(path, 3, 32, left, right);
+
+    AudioBuffer buffer;
+    buffer.LoadFromFile(path.c_str(), 0);
+    DOCTEST_REQUIRE(buffer.m_pages != nullptr);
+
+    // Far from anything decoded: silence now, and the pager brings the page in.
+    //
+    double farTime = static_cast<double>(200 * pageFrames + 10);
+    DOCTEST_CHECK(buffer.m_pages->IsResident(0));
+    DOCTEST_CHECK_FALSE(buffer.m_pages->IsResident(200));
+    size_t missesBefore = buffer.m_pages->m_missCount.load();
+    DOCTEST_CHECK(buffer.ReadRealTime(farTime) == 0.0f);
+    DOCTEST_CHECK(buffer.m_pages->m_missCount.load() == missesBefore + 1);
+    DOCTEST_CHECK(ReadPagedIn(buffer, farTime) == 0.5f);
+
+    // Prefetch at a normalized position decodes the play head page and the readahead after it, and keeps
+    // the loop start page.
+    //
+    double t = 0.5;
+    double loopStart = 0.05;
+    size_t playHeadPage = static_cast<size_t>(buffer.GetRealTime(t)) / pageFrames;
+    size_t loopStartPage = static_cast<size_t>(buffer.GetRealTime(loopStart)) / pageFrames;
+    buffer.Prefetch(t, loopStart);
+
+    std::vector<size_t> wanted = {loopStartPage};
+    for (size_t i = 0; i <= AudioBufferPageCache::x_readaheadPages; ++i)
+    {
+        wanted.push_back(playHeadPage + i);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool allResident = false;
+    while (!allResident && std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+    {
+        allResident = true;
+        for (size_t page : wanted)
+        {
+            allResident = allResident && buffer.m_pages->IsResident(static_cast<int64_t>(page));
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    DOCTEST_CHECK(allResident);
+    missesBefore = buffer.m_pages->m_missCount.load();
+    for (size_t page : wanted)
+    {
+        DOCTEST_CHECK(buffer.ReadRealTime(static_cast<double>(page * pageFrames + 17)) == 0.5f);
+    }
+
+    DOCTEST_CHECK(buffer.m_pages->m_missCount.load() == missesBefore);
+
+    // A bank forwards Prefetch to the buffer it is reading.
+    //
+    AudioBufferBank bank;
+    bank.m_audioBuffers.push_back(std::make_shared<AudioBuffer>());
+    bank.m_audioBuffers[0]->LoadFromFile(path.c_str(), 0);
+    bank.Prefetch(0.9, 0.0);
+    DOCTEST_CHECK(bank.m_audioBuffers[0]->m_pages->m_playHeadPage.load() == static_cast<int64_t>(bank.GetRealTime(0.9)) / static_cast<int64_t>(pageFrames));
+}
+
+// ---------------------------------------------------------------------------
+// 3. Short files
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("AudioBuffer paging: short files decode up front")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    std::vector<float> left;
+    std::vector<float> right;
+    MakeSignal(5000, left, right);
+    std::string path = (dir.Path() / "short.wav").string();
+    TestWav::WriteStereoWav(path, 1, 16, left, right);
+
+    AudioBuffer buffer;
+    buffer.LoadFromFile(path.c_str());
+    DOCTEST_CHECK(buffer.m_pages == nullptr);
+    DOCTEST_REQUIRE(buffer.m_buffer.size() == 5000);
+    DOCTEST_CHECK(std::abs(buffer.m_buffer[1234] - (left[1234] + right[1234])) < 1.0e-4f);
+}
+
+// ---------------------------------------------------------------------------
+// 4. Truncation
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("AudioBuffer paging: a streamed file truncated under the pager reads silence")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    const size_t pageFrames = AudioBufferPageCache::x_pageFrames;
+    const size_t frames = 100 * pageFrames;
+    std::vector<float> left(frames, 0.25f);
+    std::vector<float> right(frames, 0.25f);
+    std::string path = (dir.Path() / "truncated.wav").string();
+    TestWav::WriteStereoWav(path, 3, 32, left, right);
+
+    AudioBuffer buffer;
+    buffer.LoadFromFile(path.c_str(), 0);
+    DOCTEST_REQUIRE(buffer.m_pages != nullptr);
+    DOCTEST_REQUIRE(buffer.NumFrames() == frames);
+
+    // Keep the 44-byte header and 20 pages of 8-byte frames.
+    //
+    std::filesystem::resize_file(path, 44 + 20 * pageFrames * 8);
+
+    DOCTEST_CHECK(ReadPagedIn(buffer, static_cast<double>(10 * pageFrames + 3)) == 0.5f);
+    DOCTEST_CHECK(ReadPagedIn(buffer, static_cast<double>(60 * pageFrames + 3)) == 0.0f);
+    DOCTEST_CHECK(ReadPagedIn(buffer, static_cast<double>(frames - 2)) == 0.0f);
+    DOCTEST_CHECK(WaitForExtrema(buffer));
+
+    // The reader itself decodes what is left of the file and zeros for the rest.
+    //
+    WavReader reader;
+    std::filesystem::resize_file(path, 44 + frames * 8);
+    DOCTEST_REQUIRE(reader.LoadFromFile(path.c_str()));
+    std::filesystem::resize_file(path, 44 + 3 * 8);
+    std::vector<float> decoded(6, -1.0f);
+    reader.DecodeLeftRightSum(0, decoded.size(), decoded.data());
+    DOCTEST_CHECK(decoded == std::vector<float>({0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 0.0f}));
+    DOCTEST_CHECK(reader.GetSample(5, 0) == 0.0f);
+}
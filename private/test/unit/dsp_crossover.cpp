@@ -9,6 +9,8 @@
 //   3. Passband of LP is near 0 dB well below crossover; HP near 0 dB well above.
 //   4. Measured LP and HP responses match the class's own FrequencyResponse model.
 //   5. NaN-clean across a crossover-frequency sweep.
+//   6. MultichannelLinkwitzRileyCrossover lanes match independent scalar crossovers exactly.
+//   7. MultibandSaturator at unity gains and low level reconstructs its input (allpass bands).
 
 #include "doctest.h"
 
@@ -22,6 +24,7 @@
 #include "../support/NanScan.hpp"
 
 #include "LinkwitzRileyCrossover.hpp"
+#include "MultibandSaturator.hpp"
 
 using namespace TestSpectral;
 using namespace TestSignal;
@@ -286,3 +289,92 @@ DOCTEST_TEST_CASE("LinkwitzRileyCrossover: NaN-clean across crossover sweep")
         TestNan::AssertClean(outHP.data(), nSamples);
     }
 }
+
+// ---------------------------------------------------------------------------
+// 6. Lane crossover is bit-identical to one scalar crossover per channel,
+//    including across a cutoff change mid-stream.
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("MultichannelLinkwitzRileyCrossover: lanes match scalar crossovers")
+{
+    GlobalEnv::ResetPerTest();
+
+    constexpr std::size_t kChannels = 4;
+    TestSignal::WhiteNoise noise(0xA0B1C2D3E4F50006ull);
+
+    LinkwitzRileyCrossover scalar[kChannels];
+    MultichannelLinkwitzRileyCrossover<kChannels> lanes;
+
+    for (std::size_t n = 0; n < 4096; ++n)
+    {
+        float cps = n < 2048 ? 0.02f : 0.13f;
+        lanes.SetCyclesPerSample(cps);
+
+        float in[kChannels];
+        float lowPass[kChannels];
+        float highPass[kChannels];
+        for (std::size_t c = 0; c < kChannels; ++c)
+        {
+            in[c] = noise.Next();
+        }
+
+        lanes.Process(in, lowPass, highPass);
+        for (std::size_t c = 0; c < kChannels; ++c)
+        {
+            scalar[c].SetCyclesPerSample(cps);
+            auto r = scalar[c].Process(in[c]);
+            DOCTEST_REQUIRE(lowPass[c] == r.m_lowPass);
+            DOCTEST_REQUIRE(highPass[c] == r.m_highPass);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 7. LR4 bands sum to an allpass, so at low level (saturators ~linear) and unity
+//    gains the multiband output keeps the input's RMS, per channel.
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("MultibandSaturator: unity gains preserve low-level RMS per channel")
+{
+    GlobalEnv::ResetPerTest();
+
+    MultibandSaturator<4, 4> saturator;
+    MultibandSaturator<4, 4>::Input input;
+
+    TestSignal::WhiteNoise noise(0xA0B1C2D3E4F50007ull);
+    const float amps[4] = { 0.01f, 0.02f, 0.0f, 0.015f };
+
+    double sumIn[4] = {};
+    double sumOut[4] = {};
+    for (std::size_t n = 0; n < 48000; ++n)
+    {
+        float in[4];
+        for (std::size_t c = 0; c < 4; ++c)
+        {
+            in[c] = amps[c] * noise.Next();
+        }
+
+        saturator.Process(input, in, false /* monoTheBass */);
+        if (4800 <= n)
+        {
+            for (std::size_t c = 0; c < 4; ++c)
+            {
+                sumIn[c] += in[c] * in[c];
+                sumOut[c] += saturator.m_output[c] * saturator.m_output[c];
+            }
+        }
+    }
+
+    for (std::size_t c = 0; c < 4; ++c)
+    {
+        DOCTEST_INFO("channel " << c);
+        if (amps[c] == 0.0f)
+        {
+            DOCTEST_CHECK(sumOut[c] < 1e-12);
+        }
+        else
+        {
+            DOCTEST_CHECK(std::sqrt(sumOut[c] / sumIn[c]) == doctest::Approx(1.0).epsilon(0.05));
+        }
+    }
+}
@@ -8,6 +8,8 @@
 //   4. Sweeping the read position: no clicks beyond a threshold.
 //   5. Ring-buffer wraparound: correct after many passes around the buffer.
 //   6. QuadDelayLine: SIMD write/read, all four channels independent.
+//   7. GrainManager overlap-add bus: matches direct per-grain mixing, and the
+//      live-grain metric tracks overlapping grains.
 //
 // NOTE: DOCTEST_CONFIG_NO_SHORT_MACRO_NAMES is active; use DOCTEST_ prefixes.
 
@@ -421,3 +423,113 @@ DOCTEST_TEST_CASE("QuadDelayLine: four independent channels, impulse response")
         DOCTEST_CHECK(peakIdx == D - 1);  // arrives at D-1 (same D-1 rule as DelayLine)
     }
 }
+
+// ---------------------------------------------------------------------------
+// 7. GrainManager overlap-add bus
+// ---------------------------------------------------------------------------
+
+namespace
+{
+
+struct RampAudioBuffer
+{
+    double GetRealTime(double warpedTime)
+    {
+        return warpedTime;
+    }
+
+    float ReadRealTime(double realTime)
+    {
+        return 0.1f * static_cast<float>(std::sin(realTime * 0.01));
+    }
+};
+
+} // namespace
+
+DOCTEST_TEST_CASE("GrainManager: overlap-add bus equals direct mixing of grain tables")
+{
+    GlobalEnv::ResetPerTest();
+
+    using Manager = GrainManager<RampAudioBuffer>;
+    constexpr size_t kTable = Resynthesizer::x_tableSize;
+    constexpr size_t kSamples = 5 * kTable + 123;
+
+    static Manager manager;
+
+    // Reference: every grain's table kept alive and read sample by sample, like a voice list.
+    //
+    struct RefGrain
+    {
+        std::vector<float> m_table;
+        size_t m_index;
+    };
+
+    std::vector<RefGrain> live;
+    uint32_t seed = 12345;
+    auto nextRandom = [&seed]()
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<float>(seed >> 8) / static_cast<float>(1u << 24) - 0.5f;
+    };
+
+    float maxErr = 0.0f;
+    for (size_t n = 0; n < kSamples; ++n)
+    {
+        float got = manager.ReadBus();
+
+        float want = 0.0f;
+        for (RefGrain& g : live)
+        {
+            want += Manager::x_grainGain * g.m_table[g.m_index];
+            ++g.m_index;
+        }
+
+        live.erase(std::remove_if(live.begin(), live.end(), [](const RefGrain& g) { return g.m_index == kTable; }), live.end());
+        maxErr = std::max(maxErr, std::abs(got - want));
+        DOCTEST_REQUIRE(manager.m_numGrains == live.size());
+
+        // Irregular launch spacing, including several grains in a row.
+        //
+        if (n % 700 == 0 || n % 1733 < 3)
+        {
+            RefGrain g;
+            g.m_table.resize(kTable);
+            g.m_index = 0;
+            for (size_t i = 0; i < kTable; ++i)
+            {
+                g.m_table[i] = nextRandom();
+                manager.m_grain.m_grain.m_buffer.m_table[i] = g.m_table[i];
+            }
+
+            manager.AccumulateGrain();
+            live.push_back(std::move(g));
+        }
+    }
+
+    DOCTEST_MESSAGE("max |bus - direct| = " << maxErr);
+    DOCTEST_CHECK(maxErr < 1e-5f);
+}
+
+DOCTEST_TEST_CASE("GrainManager: steady launches keep a bounded live-grain count")
+{
+    GlobalEnv::ResetPerTest();
+
+    using Manager = GrainManager<RampAudioBuffer>;
+    static Manager manager;
+    static RampAudioBuffer buffer;
+    manager.m_audioBuffer = &buffer;
+
+    Manager::Input input;
+    const size_t overlap = Resynthesizer::x_tableSize / Resynthesizer::GetGrainLaunchSamples();
+    std::vector<float> out(6 * Resynthesizer::x_tableSize);
+    size_t maxLive = 0;
+    for (size_t n = 0; n < out.size(); ++n)
+    {
+        out[n] = manager.Process(static_cast<double>(n), 0.0, input);
+        maxLive = std::max(maxLive, manager.m_numGrains);
+    }
+
+    DOCTEST_CHECK(maxLive == overlap);
+    DOCTEST_CHECK(manager.m_grainsStarted == out.size() / Resynthesizer::GetGrainLaunchSamples());
+    TestNan::AssertClean(out.data(), out.size());
+}
@@ -0,0 +1,246 @@
+// dsp_fastmath.cpp -- accuracy table and micro-benchmark for FastMath (private/src/FastMath.hpp)
+//
+// Tests:
+//   1. Accuracy table: every tier is swept densely over its domain against the double-precision
+//      reference and must stay inside the max error documented in FastMath.hpp.
+//   2. Edge cases: integer exp2 is exact, Log2 of powers of two is exact, Log2(0) is finite.
+//   3. Apply<> block and QuadFloat forms match the scalar functions bit for bit.
+//   4. TanhPade matches the old TanhSaturator curve exactly.
+//   5. Benchmark: ns/call for each tier vs the libm call it replaces (reported, not asserted).
+
+#include "doctest.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../support/GlobalEnv.hpp"
+
+#include "FastMath.hpp"
+
+namespace
+{
+
+struct ErrorRow
+{
+    std::string m_name;
+    double m_maxError;
+    double m_bound;
+};
+
+// Sweeps [lo, hi] in n steps and returns the max (absolute or relative) error of approx vs reference.
+//
+double MaxError(std::function<float(float)> approx, std::function<double(double)> reference, double lo, double hi, bool relative)
+{
+    const int n = 200000;
+    double worst = 0.0;
+    for (int i = 0; i <= n; ++i)
+    {
+        float x = static_cast<float>(lo + (hi - lo) * i / n);
+        double want = reference(static_cast<double>(x));
+        double got = static_cast<double>(approx(x));
+        double err = std::abs(got - want);
+        if (relative)
+        {
+            err /= std::max(std::abs(want), 1e-30);
+        }
+
+        worst = std::max(worst, err);
+    }
+
+    return worst;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// 1. Accuracy table
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("FastMath: accuracy table within documented bounds")
+{
+    GlobalEnv::ResetPerTest();
+
+    auto exp2Ref = [](double x) { return std::exp2(x); };
+    auto log2Ref = [](double x) { return std::log2(x); };
+    auto sinRef = [](double x) { return std::sin(2.0 * M_PI * x); };
+    auto cosRef = [](double x) { return std::cos(2.0 * M_PI * x); };
+    auto tanhRef = [](double x) { return std::tanh(x); };
+
+    std::vector<ErrorRow> rows = {
+        {"Exp2Fast", MaxError(FastMath::Exp2Fast, exp2Ref, -20.0, 20.0, true), 2.3e-4},
+        {"Exp2Precise", MaxError(FastMath::Exp2Precise, exp2Ref, -20.0, 20.0, true), 3e-7},
+        {"Log2Fast", MaxError(FastMath::Log2Fast, log2Ref, 1e-6, 1000.0, false), 2.2e-4},
+        {"Log2Precise", MaxError(FastMath::Log2Precise, log2Ref, 1e-6, 1000.0, false), 6e-7},
+        {"Log2Precise [0.5,2]", MaxError(FastMath::Log2Precise, log2Ref, 0.5, 2.0, false), 3e-7},
+        {"PowFast(x,3.7)", MaxError([](float x) { return FastMath::PowFast(x, 3.7f); }, [](double x) { return std::pow(x, 3.7); }, 0.01, 10.0, true), 1.6e-4 * (1.0 + 3.7 * std::log2(100.0))},
+        {"PowPrecise(x,3.7)", MaxError([](float x) { return FastMath::PowPrecise(x, 3.7f); }, [](double x) { return std::pow(x, 3.7); }, 0.01, 10.0, true), 3e-7 * (1.0 + 3.7 * std::log2(100.0))},
+        {"Sin2piFast", MaxError(FastMath::Sin2piFast, sinRef, -3.0, 3.0, false), 1.1e-4},
+        {"Sin2piPrecise", MaxError(FastMath::Sin2piPrecise, sinRef, -3.0, 3.0, false), 5e-7},
+        {"Cos2piFast", MaxError(FastMath::Cos2piFast, cosRef, -3.0, 3.0, false), 1.1e-4},
+        {"Cos2piPrecise", MaxError(FastMath::Cos2piPrecise, cosRef, -3.0, 3.0, false), 8e-7},
+        {"TanhPade", MaxError(FastMath::TanhPade, tanhRef, -12.0, 12.0, false), 2.4e-2},
+        {"TanhPrecise", MaxError(FastMath::TanhPrecise, tanhRef, -12.0, 12.0, false), 3e-7},
+    };
+
+    for (const ErrorRow& row : rows)
+    {
+        DOCTEST_MESSAGE(row.m_name << ": max error " << row.m_maxError << " (bound " << row.m_bound << ")");
+        DOCTEST_CHECK_MESSAGE(row.m_maxError <= row.m_bound, row.m_name);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 2. Edge cases
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("FastMath: exact points and clamped inputs")
+{
+    for (int i = -126; i <= 127; ++i)
+    {
+        DOCTEST_CHECK(FastMath::Exp2Precise(static_cast<float>(i)) == std::ldexp(1.0f, i));
+        DOCTEST_CHECK(FastMath::Exp2Fast(static_cast<float>(i)) == std::ldexp(1.0f, i));
+    }
+
+    for (int i = -120; i <= 120; ++i)
+    {
+        DOCTEST_CHECK(FastMath::Log2Precise(std::ldexp(1.0f, i)) == static_cast<float>(i));
+    }
+
+    DOCTEST_CHECK(std::isfinite(FastMath::Log2Precise(0.0f)));
+    DOCTEST_CHECK(std::isfinite(FastMath::Log2Fast(-1.0f)));
+    DOCTEST_CHECK(std::isfinite(FastMath::Exp2Precise(1000.0f)));
+    DOCTEST_CHECK(FastMath::Exp2Precise(-1000.0f) >= 0.0f);
+    DOCTEST_CHECK(FastMath::Exp2Precise(std::nanf("")) == std::ldexp(1.0f, -126));
+    DOCTEST_CHECK(FastMath::Exp2Fast(std::nanf("")) == std::ldexp(1.0f, -126));
+    DOCTEST_CHECK(FastMath::TanhPrecise(100.0f) == doctest::Approx(1.0f));
+    DOCTEST_CHECK(FastMath::TanhPrecise(-100.0f) == doctest::Approx(-1.0f));
+    DOCTEST_CHECK(FastMath::PowInt<4>(1.5f) == 1.5f * 1.5f * 1.5f * 1.5f);
+    DOCTEST_CHECK(FastMath::PowInt<0>(3.0f) == 1.0f);
+}
+
+// ---------------------------------------------------------------------------
+// 3. Lane-parallel forms agree with the scalar functions
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("FastMath: Apply block and QuadFloat forms match scalar")
+{
+    const size_t n = 257;
+    std::vector<float> in(n);
+    std::vector<float> out(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        in[i] = -8.0f + 16.0f * static_cast<float>(i) / static_cast<float>(n);
+    }
+
+    FastMath::Apply<FastMath::TanhPrecise>(in.data(), out.data(), n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        DOCTEST_CHECK(out[i] == FastMath::TanhPrecise(in[i]));
+    }
+
+    std::vector<float> bases(n, 1.7f);
+    FastMath::Apply<FastMath::PowPrecise>(bases.data(), in.data(), out.data(), n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        DOCTEST_CHECK(out[i] == FastMath::PowPrecise(1.7f, in[i]));
+    }
+
+    QuadFloat q(-0.3f, 0.1f, 0.6f, 2.2f);
+    QuadFloat s = FastMath::Apply<FastMath::Sin2piPrecise>(q);
+    for (int i = 0; i < 4; ++i)
+    {
+        DOCTEST_CHECK(s[i] == FastMath::Sin2piPrecise(q[i]));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 4. TanhPade is the saturator's historic curve
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("FastMath: TanhPade reproduces the rational saturator")
+{
+    for (int i = -4000; i <= 4000; ++i)
+    {
+        float x = static_cast<float>(i) / 500.0f;
+        float y = x * (27.0f + x * x) / (27.0f + 9.0f * x * x);
+        y = std::min(1.0f, std::max(-1.0f, y));
+        DOCTEST_CHECK(FastMath::TanhPade(x) == y);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 5. Benchmark (informational)
+// ---------------------------------------------------------------------------
+//
+namespace
+{
+
+template<float (*Fn)(float)>
+double NsPerCall(const std::vector<float>& in, std::vector<float>& out)
+{
+    const int reps = 50;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r)
+    {
+        FastMath::Apply<Fn>(in.data(), out.data(), in.size());
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return ns / (reps * static_cast<double>(in.size()));
+}
+
+float LibmExp2(float x) { return std::exp2(x); }
+float LibmLog2(float x) { return std::log2(x); }
+float LibmPow(float x) { return std::pow(x, 1.37f); }
+float LibmSin2pi(float x) { return std::sin(2.0f * static_cast<float>(M_PI) * x); }
+float LibmTanh(float x) { return std::tanh(x); }
+float FastPow(float x) { return FastMath::PowFast(x, 1.37f); }
+float PrecisePow(float x) { return FastMath::PowPrecise(x, 1.37f); }
+
+} // namespace
+
+DOCTEST_TEST_CASE("FastMath: benchmark vs libm")
+{
+    const size_t n = 4096;
+    std::vector<float> in(n);
+    std::vector<float> out(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        in[i] = 0.01f + 4.0f * static_cast<float>(i) / static_cast<float>(n);
+    }
+
+    struct Row
+    {
+        std::string m_name;
+        double m_ns;
+    };
+
+    Row rows[] = {
+        {"std::exp2", NsPerCall<LibmExp2>(in, out)},
+        {"Exp2Fast", NsPerCall<FastMath::Exp2Fast>(in, out)},
+        {"Exp2Precise", NsPerCall<FastMath::Exp2Precise>(in, out)},
+        {"std::log2", NsPerCall<LibmLog2>(in, out)},
+        {"Log2Fast", NsPerCall<FastMath::Log2Fast>(in, out)},
+        {"Log2Precise", NsPerCall<FastMath::Log2Precise>(in, out)},
+        {"std::pow", NsPerCall<LibmPow>(in, out)},
+        {"PowFast", NsPerCall<FastPow>(in, out)},
+        {"PowPrecise", NsPerCall<PrecisePow>(in, out)},
+        {"std::sin", NsPerCall<LibmSin2pi>(in, out)},
+        {"Sin2piFast", NsPerCall<FastMath::Sin2piFast>(in, out)},
+        {"Sin2piPrecise", NsPerCall<FastMath::Sin2piPrecise>(in, out)},
+        {"std::tanh", NsPerCall<LibmTanh>(in, out)},
+        {"TanhPade", NsPerCall<FastMath::TanhPade>(in, out)},
+        {"TanhPrecise", NsPerCall<FastMath::TanhPrecise>(in, out)},
+    };
+
+    for (const Row& row : rows)
+    {
+        DOCTEST_MESSAGE(row.m_name << ": " << row.m_ns << " ns/call");
+        DOCTEST_CHECK(std::isfinite(row.m_ns));
+    }
+}
@@ -0,0 +1,71 @@
+// dsp_param_ramp.cpp -- unit tests for ParamRampBlock (private/src/Slew.hpp)
+//
+// ParamRampBlock replaces per-parameter ParamSlew objects inside oversampled micro-blocks:
+// targets are set once per control frame and Ramp() writes a linear ramp from the previous
+// target to the new one for every parameter.
+//
+// Tests:
+//   1. Ramp is linear, starts one step after the previous target and lands on the new target.
+//   2. Parameters are independent and a held target gives a flat block.
+
+#include "doctest.h"
+
+#include "../support/GlobalEnv.hpp"
+
+#include "Slew.hpp"
+
+// ---------------------------------------------------------------------------
+// 1. Linear ramp between consecutive targets.
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("ParamRampBlock: linear ramp from previous target to new target")
+{
+    GlobalEnv::ResetPerTest();
+
+    const size_t blockSize = 32;
+    ParamRampBlock<1, blockSize> ramps;
+
+    ramps.Update(0, 1.0f);
+    ramps.Ramp();
+    for (size_t i = 0; i < blockSize; ++i)
+    {
+        DOCTEST_CHECK(ramps.Get(0, i) == doctest::Approx(static_cast<float>(i + 1) / blockSize));
+    }
+
+    DOCTEST_CHECK(ramps.Get(0, blockSize - 1) == doctest::Approx(1.0f));
+    DOCTEST_CHECK(ramps.Current(0) == 1.0f);
+
+    ramps.Update(0, -3.0f);
+    ramps.Ramp();
+    float step = -4.0f / blockSize;
+    for (size_t i = 0; i < blockSize; ++i)
+    {
+        DOCTEST_CHECK(ramps.Get(0, i) == doctest::Approx(1.0f + step * (i + 1)));
+    }
+
+    DOCTEST_CHECK(ramps.Current(0) == -3.0f);
+}
+
+// ---------------------------------------------------------------------------
+// 2. Independent parameters, held targets.
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("ParamRampBlock: parameters are independent and held targets are flat")
+{
+    GlobalEnv::ResetPerTest();
+
+    const size_t blockSize = 8;
+    ParamRampBlock<3, blockSize> ramps;
+
+    ramps.Update(0, 2.0f);
+    ramps.Update(2, 0.5f);
+    ramps.Ramp();
+    ramps.Ramp();
+
+    for (size_t i = 0; i < blockSize; ++i)
+    {
+        DOCTEST_CHECK(ramps.Get(0, i) == 2.0f);
+        DOCTEST_CHECK(ramps.Get(1, i) == 0.0f);
+        DOCTEST_CHECK(ramps.Get(2, i) == 0.5f);
+    }
+}
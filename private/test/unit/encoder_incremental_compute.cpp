@@ -0,0 +1,476 @@
+// encoder_incremental_compute.cpp -- incremental vs full recompute of the encoder modulation graph
+// (private/src/EncoderBankBank.hpp, private/src/EncoderBank.hpp)
+//
+// BankedEncoderCell::Compute only recomputes when the cell was forced or an affecting modulator/gesture
+// changed, EncoderBankBank::Process skips modes with nothing pending, and a scene blend move only forces
+// cells whose blended values actually moved. Every one of those shortcuts must be invisible: the outputs
+// must equal what a full recompute of every cell (children included) produces on every control frame.
+//
+// Two rigs are driven through identical edit sequences; the reference rig forces every cell in the
+// tree before each Process.
+//
+// Tests:
+//   1. Each edit kind on its own (knobs, track select, selecting a cell and turning its modulator depths,
+//      deselecting, modulator values, gestures, gesture weights, blend moves, scene switches) matches full
+//      recompute bit for bit.
+//   2. Random interleavings of all edit kinds over many seeds match full recompute bit for bit.
+//   3. A static patch does no recompute; edits only recompute their own mode; a blend move between
+//      scenes that agree on a parameter leaves that parameter alone.
+//   4. The compiled modulation routes evaluate the documented blend and drop routes whose depth goes to zero.
+
+#include "doctest.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "../support/GlobalEnv.hpp"
+
+#include "EncoderBankBank.hpp"
+
+namespace
+{
+
+constexpr size_t kNumModes = 2;
+constexpr size_t kNumEncoders = 8;
+constexpr size_t kNumConnectedModulators = 6;
+constexpr size_t kNumTracks[kNumModes] = {3, 2};
+constexpr size_t kNumVoices[kNumModes] = {2, 4};
+
+const char* const kNames[kNumEncoders] = {"A", "B", "C", "D", "E", "F", "G", "H"};
+
+struct Rig
+{
+    SmartGrid::SceneManager m_sceneManager;
+    EncoderBankBank m_bank;
+
+    Rig()
+        : m_bank(kNumModes, kNumModes, kNumEncoders)
+    {
+        m_bank.InitSceneManager(&m_sceneManager);
+        for (size_t i = 0; i < kNumModes; ++i)
+        {
+            m_bank.InitMode(i, kNumTracks[i], kNumVoices[i]);
+            m_bank.InitBank(i, i, SmartGrid::Color::White);
+            for (size_t j = 0; j < kNumConnectedModulators; ++j)
+            {
+                m_bank.m_bankModes[i].m_modulatorValues.SetModulatorColor(j, SmartGrid::Color::White);
+            }
+        }
+
+        for (size_t i = 0; i < kNumEncoders; ++i)
+        {
+            m_bank.CreateEncoder(&m_sceneManager, i, ModeOf(i), 0.25f + 0.05f * i, kNames[i], kNames[i], SmartGrid::Color::White, 0);
+            m_bank.PlaceEncoder(i, ModeOf(i), static_cast<int>(i / 2) % 4, 0);
+        }
+    }
+
+    static size_t ModeOf(size_t encoderIx)
+    {
+        return encoderIx % kNumModes;
+    }
+
+    SmartGrid::BankedEncoderCell* Cell(size_t encoderIx)
+    {
+        return m_bank.GetEncoder(encoderIx);
+    }
+
+    SmartGrid::BankedEncoderCell::ModulatorValues& Values(size_t modeIx)
+    {
+        return m_bank.m_bankModes[modeIx].m_modulatorValues;
+    }
+};
+
+void ForceTree(SmartGrid::BankedEncoderCell* cell)
+{
+    cell->SetForceUpdate();
+    for (size_t i = 0; i < SmartGrid::BankedEncoderCell::x_numModulators; ++i)
+    {
+        if (cell->m_modulators.m_modulators[i])
+        {
+            ForceTree(cell->m_modulators.m_modulators[i].get());
+        }
+    }
+
+    for (size_t i = 0; i < SmartGrid::BankedEncoderCell::x_numGestureParams; ++i)
+    {
+        if (cell->m_modulators.m_gestures[i])
+        {
+            ForceTree(cell->m_modulators.m_gestures[i].get());
+        }
+    }
+}
+
+enum class Edit : int
+{
+    Knob,
+    Track,
+    Select,
+    ModulatorDepth,
+    Deselect,
+    ModulatorValue,
+    GestureKnob,
+    GestureWeight,
+    Blend,
+    SceneSwitch,
+    Idle,
+    NumEdits
+};
+
+// One randomly drawn edit, applied identically to both rigs.
+//
+struct EditParams
+{
+    Edit m_edit;
+    size_t m_encoder;
+    size_t m_mode;
+    size_t m_index;
+    size_t m_track;
+    float m_delta;
+    float m_value;
+    float m_values[16];
+    int m_frames;
+
+    EditParams(std::mt19937& rng, Edit edit)
+        : m_edit(edit)
+    {
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        m_encoder = rng() % kNumEncoders;
+        m_mode = rng() % kNumModes;
+        m_index = rng() % kNumConnectedModulators;
+        m_track = rng();
+        m_delta = unit(rng) * 0.6f - 0.3f;
+        uint32_t endpoint = rng() % 4;
+        m_value = endpoint == 0 ? 0.0f : (endpoint == 1 ? 1.0f : unit(rng));
+        for (size_t i = 0; i < 16; ++i)
+        {
+            m_values[i] = unit(rng) * 2.0f - 1.0f;
+        }
+
+        m_frames = 1 + static_cast<int>(rng() % 12);
+    }
+
+    void Apply(Rig& rig) const
+    {
+        SmartGrid::BankedEncoderCell* cell = rig.Cell(m_encoder);
+        size_t mode = Rig::ModeOf(m_encoder);
+        switch (m_edit)
+        {
+            case Edit::Knob:
+            {
+                cell->Increment(m_delta);
+                break;
+            }
+            case Edit::Track:
+            {
+                rig.m_bank.SetTrack(m_mode, m_track % kNumTracks[m_mode]);
+                break;
+            }
+            case Edit::Select:
+            {
+                rig.m_bank.m_banks[mode].Deselect();
+                rig.m_bank.m_banks[mode].MakeSelection(static_cast<int>(m_encoder / 2) % 4, 0, cell);
+                break;
+            }
+            case Edit::ModulatorDepth:
+            {
+                SmartGrid::BankedEncoderCell* selected = rig.m_bank.m_banks[m_mode].m_selected;
+                if (selected)
+                {
+                    selected->m_modulators.m_modulators[m_index]->Increment(m_delta);
+                }
+
+                break;
+            }
+            case Edit::Deselect:
+            {
+                rig.m_bank.m_banks[m_mode].Deselect();
+                break;
+            }
+            case Edit::ModulatorValue:
+            {
+                for (size_t i = 0; i < 16; ++i)
+                {
+                    rig.Values(mode).m_value[m_index][i] = m_values[i];
+                }
+
+                break;
+            }
+            case Edit::GestureKnob:
+            {
+                BitSet16 gesture;
+                gesture.Set(m_index, true);
+                rig.m_bank.SelectGesture(gesture);
+                cell->Increment(m_delta);
+                rig.m_bank.SelectGesture(BitSet16());
+                break;
+            }
+            case Edit::GestureWeight:
+            {
+                rig.Values(m_mode).m_gestureWeights[m_index] = m_value;
+                break;
+            }
+            case Edit::Blend:
+            {
+                rig.m_sceneManager.m_blendFactor = m_value;
+                break;
+            }
+            case Edit::SceneSwitch:
+            {
+                rig.m_sceneManager.m_scene2 = m_track % SmartGrid::SceneManager::x_numScenes;
+                break;
+            }
+            case Edit::Idle:
+            case Edit::NumEdits:
+            {
+                break;
+            }
+        }
+    }
+};
+
+// Advances both rigs by one sample; the reference forces its whole tree first.
+//
+void Step(Rig& incremental, Rig& reference)
+{
+    for (size_t i = 0; i < kNumEncoders; ++i)
+    {
+        ForceTree(reference.Cell(i));
+    }
+
+    incremental.m_sceneManager.Process();
+    incremental.m_bank.Process();
+    reference.m_sceneManager.Process();
+    reference.m_bank.Process();
+    SampleTimer::IncrementSample();
+}
+
+// Counts output words that differ between the rigs, and describes the first one.
+//
+size_t CountMismatches(Rig& incremental, Rig& reference, std::string& first)
+{
+    size_t mismatches = 0;
+    for (size_t i = 0; i < kNumEncoders; ++i)
+    {
+        SmartGrid::BankedEncoderCell* a = incremental.Cell(i);
+        SmartGrid::BankedEncoderCell* b = reference.Cell(i);
+        size_t mode = Rig::ModeOf(i);
+        for (size_t k = 0; k < kNumTracks[mode] * kNumVoices[mode]; ++k)
+        {
+            if (a->m_output[k] != b->m_output[k] ||
+                a->m_minValue[k] != b->m_minValue[k] ||
+                a->m_maxValue[k] != b->m_maxValue[k])
+            {
+                if (mismatches == 0)
+                {
+                    first = std::string(kNames[i]) + "[" + std::to_string(k) + "]: " +
+                        std::to_string(a->m_output[k]) + " vs " + std::to_string(b->m_output[k]);
+                }
+
+                ++mismatches;
+            }
+        }
+    }
+
+    return mismatches;
+}
+
+// Runs a sequence of edits drawn by pick() and checks equivalence after every control frame.
+//
+template<typename Pick>
+void RunSequence(uint32_t seed, size_t numEdits, Pick pick)
+{
+    GlobalEnv::ResetPerTest();
+    std::mt19937 rng(seed);
+    Rig incremental;
+    Rig reference;
+    size_t checked = 0;
+    size_t mismatches = 0;
+    std::string first;
+    for (size_t e = 0; e < numEdits; ++e)
+    {
+        EditParams params(rng, pick(rng));
+        params.Apply(incremental);
+        params.Apply(reference);
+        for (int f = 0; f < params.m_frames * static_cast<int>(SampleTimer::x_controlFrameRate); ++f)
+        {
+            bool controlFrame = SampleTimer::IsControlFrame();
+            Step(incremental, reference);
+            if (controlFrame)
+            {
+                ++checked;
+                std::string where;
+                size_t bad = CountMismatches(incremental, reference, where);
+                if (bad > 0 && mismatches == 0)
+                {
+                    first = "edit " + std::to_string(e) + " (kind " + std::to_string(static_cast<int>(params.m_edit)) + ") " + where;
+                }
+
+                mismatches += bad;
+            }
+        }
+    }
+
+    DOCTEST_CHECK(checked > numEdits);
+    DOCTEST_CHECK_MESSAGE(mismatches == 0, "seed " << seed << ": " << first);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// 1. Each edit kind in isolation
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("EncoderBankBank: each edit kind matches full recompute")
+{
+    for (int kind = 0; kind < static_cast<int>(Edit::NumEdits); ++kind)
+    {
+        DOCTEST_CAPTURE(kind);
+        for (uint32_t seed = 1; seed <= 8; ++seed)
+        {
+            // Interleave with knob, select and depth edits so there is something for the edit to act on.
+            //
+            RunSequence(
+                seed * 131 + kind,
+                60,
+                [kind](std::mt19937& rng)
+                {
+                    uint32_t r = rng() % 6;
+                    return r == 0 ? Edit::Knob : (r == 1 ? Edit::Select : (r == 2 ? Edit::ModulatorDepth : static_cast<Edit>(kind)));
+                });
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 2. Random interleavings
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("EncoderBankBank: random edit sequences match full recompute")
+{
+    for (uint32_t seed = 1; seed <= 40; ++seed)
+    {
+        RunSequence(
+            seed,
+            150,
+            [](std::mt19937& rng)
+            {
+                return static_cast<Edit>(rng() % static_cast<uint32_t>(Edit::NumEdits));
+            });
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 3. Skipped work
+// ---------------------------------------------------------------------------
+//
+namespace
+{
+
+void RunControlFrames(Rig& rig, int frames)
+{
+    for (int f = 0; f < frames * static_cast<int>(SampleTimer::x_controlFrameRate); ++f)
+    {
+        rig.m_sceneManager.Process();
+        rig.m_bank.Process();
+        SampleTimer::IncrementSample();
+    }
+}
+
+} // namespace
+
+DOCTEST_TEST_CASE("EncoderBankBank: static patches and unrelated edits do not recompute")
+{
+    GlobalEnv::ResetPerTest();
+    Rig rig;
+    RunControlFrames(rig, 2);
+
+    DOCTEST_CHECK(!rig.m_bank.m_bankModes[0].NeedsCompute());
+    DOCTEST_CHECK(!rig.m_bank.m_bankModes[1].NeedsCompute());
+
+    // A sentinel written over an output survives as long as nothing it depends on moves.
+    //
+    const float sentinel = -7.0f;
+    rig.Cell(1)->m_output[0] = sentinel;
+    RunControlFrames(rig, 4);
+    DOCTEST_CHECK(rig.Cell(1)->m_output[0] == sentinel);
+
+    // A knob in mode 0 recomputes that cell only; mode 1 is untouched. At blend 0 the edit lands in scene 0
+    // alone, so cell 0 now differs between scenes 0 and 1.
+    //
+    rig.Cell(0)->Increment(0.1f);
+    RunControlFrames(rig, 1);
+    DOCTEST_CHECK(rig.Cell(0)->m_output[0] == doctest::Approx(0.35f));
+    DOCTEST_CHECK(rig.Cell(1)->m_output[0] == sentinel);
+
+    // Leaving the end of the blend forces everything.
+    //
+    rig.m_sceneManager.m_blendFactor = 0.5f;
+    RunControlFrames(rig, 1);
+    DOCTEST_CHECK(rig.Cell(0)->m_output[0] == doctest::Approx(0.3f));
+    DOCTEST_CHECK(rig.Cell(1)->m_output[0] == doctest::Approx(0.3f));
+
+    // Moving the blend in between only recomputes cells whose two scenes disagree; cell 1 still has its
+    // default in every scene.
+    //
+    rig.Cell(1)->m_output[0] = sentinel;
+    rig.m_sceneManager.m_blendFactor = 0.75f;
+    RunControlFrames(rig, 1);
+    DOCTEST_CHECK(rig.Cell(0)->m_output[0] == doctest::Approx(0.275f));
+    DOCTEST_CHECK(rig.Cell(1)->m_output[0] == sentinel);
+
+    // A scene switch forces everything.
+    //
+    rig.m_sceneManager.m_scene2 = 3;
+    RunControlFrames(rig, 1);
+    DOCTEST_CHECK(rig.Cell(1)->m_output[0] == doctest::Approx(0.3f));
+}
+
+// ---------------------------------------------------------------------------
+// 4. Compiled modulation routes
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("EncoderBankBank: compiled routes evaluate the modulation blend")
+{
+    GlobalEnv::ResetPerTest();
+    Rig rig;
+    SmartGrid::BankedEncoderCell* cell = rig.Cell(0);
+    SmartGrid::BankedEncoderCell::ModulatorValues& values = rig.Values(0);
+    size_t numLanes = kNumTracks[0] * kNumVoices[0];
+
+    // Selecting fills in (and shows) every modulator cell; they need one frame before they take knob turns.
+    //
+    rig.m_bank.m_banks[0].MakeSelection(0, 0, cell);
+    RunControlFrames(rig, 1);
+    cell->m_modulators.m_modulators[1]->Increment(0.3f);
+    cell->m_modulators.m_modulators[4]->Increment(0.5f);
+    rig.m_bank.m_banks[0].Deselect();
+    for (size_t k = 0; k < 16; ++k)
+    {
+        values.m_value[1][k] = 0.1f * static_cast<float>(k % 5);
+        values.m_value[4][k] = 1.0f - 0.05f * static_cast<float>(k);
+        values.m_amplitude[4][k] = 0.5f;
+    }
+
+    RunControlFrames(rig, 1);
+
+    DOCTEST_CHECK(cell->m_modulators.m_numRoutes == 2);
+    for (size_t k = 0; k < numLanes; ++k)
+    {
+        float depth1 = cell->m_modulators.m_modulators[1]->m_output[k];
+        float depth4 = cell->m_modulators.m_modulators[4]->m_output[k];
+        float modValue = depth1 * values.m_value[1][k] + depth4 * values.m_value[4][k] * 0.5f;
+        float modWeight = depth1 + depth4 * 0.5f;
+        float base = cell->m_postGestureValue[k / kNumVoices[0]];
+        DOCTEST_CHECK(cell->m_output[k] == doctest::Approx(base * (1 - modWeight) + modValue));
+    }
+
+    // Zeroing a depth drops its route.
+    //
+    cell->m_modulators.m_modulators[1]->Increment(-1.0f);
+    cell->SetModulatorsAffecting();
+    RunControlFrames(rig, 1);
+
+    DOCTEST_CHECK(cell->m_modulators.m_numRoutes == 1);
+    DOCTEST_CHECK(cell->m_modulators.m_routeSource[0] == 4);
+}
@@ -0,0 +1,178 @@
+// encoder_midi_delta.cpp -- unit tests for EncoderMidiWriter's delta stream (private/src/EncoderMidi.hpp)
+//
+// The writer sends a Twister CC only when the code the hardware would display changes, and rate limits
+// each encoder's value ring, keeping counts of CCs sent and raw changes suppressed.
+//
+// Tests:
+//   1. The first pass sends every indicator once; an unchanged state sends nothing.
+//   2. Value changes below one CC step are suppressed and counted; a real step is sent on the current track.
+//   3. A ring modulated every frame is rate limited, and converges on its latest value.
+
+#include "doctest.h"
+
+#include <vector>
+
+#include "../support/GlobalEnv.hpp"
+
+#include "BitSet.hpp"
+#include "EncoderMidi.hpp"
+
+namespace
+{
+    std::vector<SmartGrid::BasicMidi> Drain(SmartGrid::EncoderMidiWriter& writer)
+    {
+        std::vector<SmartGrid::BasicMidi> msgs;
+        for (SmartGrid::BasicMidi msg : writer)
+        {
+            msgs.push_back(msg);
+        }
+
+        return msgs;
+    }
+
+    void SetAll(EncoderBankUIState& state, float brightness, float value)
+    {
+        for (size_t i = 0; i < 4; ++i)
+        {
+            for (size_t j = 0; j < 4; ++j)
+            {
+                state.m_states[i][j].m_color.store(SmartGrid::Color(200, 40, 0));
+                state.m_states[i][j].m_brightness.store(brightness);
+                for (size_t k = 0; k < 4; ++k)
+                {
+                    state.m_states[i][j].m_values[k].store(value);
+                }
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 1. Initial state, then silence
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("EncoderMidiWriter: sends each indicator once, then only changes")
+{
+    GlobalEnv::ResetPerTest();
+
+    static EncoderBankUIState state;
+    SetAll(state, 0.5f, 0.5f);
+    SmartGrid::EncoderMidiWriter writer(&state);
+
+    std::vector<SmartGrid::BasicMidi> msgs = Drain(writer);
+    DOCTEST_CHECK(msgs.size() == 16 * 3);
+    DOCTEST_CHECK(writer.m_sentCount == 16 * 3);
+
+    for (int frame = 0; frame < 10; ++frame)
+    {
+        writer.ProcessCoolDown();
+        DOCTEST_CHECK(Drain(writer).empty());
+    }
+
+    // Brightness is sent as 17 + 30 * brightness, so a change of under 1/30 is invisible.
+    //
+    state.m_states[1][2].m_brightness.store(0.51f);
+    DOCTEST_CHECK(Drain(writer).empty());
+    DOCTEST_CHECK(writer.m_suppressedCount == 1);
+
+    state.m_states[1][2].m_brightness.store(0.8f);
+    msgs = Drain(writer);
+    DOCTEST_REQUIRE(msgs.size() == 1);
+    DOCTEST_CHECK(msgs[0].Channel() == 2);
+    DOCTEST_CHECK(msgs[0].GetCC() == SmartGrid::EncoderMidi::PosToNote(1, 2));
+    DOCTEST_CHECK(msgs[0].GetValue() == 41);
+
+    writer.Reset();
+    DOCTEST_CHECK(Drain(writer).size() == 16 * 3);
+}
+
+// ---------------------------------------------------------------------------
+// 2. Quantized values on the current track
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("EncoderMidiWriter: value rings send only whole CC steps")
+{
+    GlobalEnv::ResetPerTest();
+
+    static EncoderBankUIState state;
+    SetAll(state, 1.0f, 0.5f);
+    state.m_currentTrack.store(2);
+    state.m_numVoices.store(1);
+    SmartGrid::EncoderMidiWriter writer(&state);
+    Drain(writer);
+    writer.ProcessCoolDown();
+    writer.ProcessCoolDown();
+
+    // Another track's value is not shown.
+    //
+    state.m_states[3][0].m_values[0].store(0.9f);
+    DOCTEST_CHECK(Drain(writer).empty());
+
+    state.m_states[3][0].m_values[2].store(0.5f + 0.3f / 127);
+    DOCTEST_CHECK(Drain(writer).empty());
+    DOCTEST_CHECK(writer.m_suppressedCount == 1);
+
+    state.m_states[3][0].m_values[2].store(0.5f + 1.0f / 127);
+    std::vector<SmartGrid::BasicMidi> msgs = Drain(writer);
+    DOCTEST_REQUIRE(msgs.size() == 1);
+    DOCTEST_CHECK(msgs[0].Channel() == 0);
+    DOCTEST_CHECK(msgs[0].GetCC() == SmartGrid::EncoderMidi::PosToNote(3, 0));
+    DOCTEST_CHECK(msgs[0].GetValue() == 64);
+}
+
+// ---------------------------------------------------------------------------
+// 3. Rate limit under modulation
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("EncoderMidiWriter: modulated rings are rate limited and converge")
+{
+    GlobalEnv::ResetPerTest();
+
+    static EncoderBankUIState state;
+    SetAll(state, 1.0f, 0.0f);
+    SmartGrid::EncoderMidiWriter writer(&state);
+    Drain(writer);
+    size_t sentBefore = writer.m_sentCount;
+
+    // All 16 rings sweep one CC step per frame for 60 frames.
+    //
+    const int frames = 60;
+    size_t valueMsgs = 0;
+    for (int frame = 1; frame <= frames; ++frame)
+    {
+        writer.ProcessCoolDown();
+        SetAll(state, 1.0f, frame / 127.0f + 0.25f / 127);
+        for (SmartGrid::BasicMidi msg : Drain(writer))
+        {
+            DOCTEST_CHECK(msg.Channel() == 0);
+            ++valueMsgs;
+        }
+    }
+
+    DOCTEST_CHECK(valueMsgs <= 16 * (frames / SmartGrid::EncoderMidiWriter::x_valueCoolDownFrames + 1));
+    DOCTEST_CHECK(valueMsgs >= 16 * (frames / SmartGrid::EncoderMidiWriter::x_valueCoolDownFrames - 1));
+    DOCTEST_CHECK(writer.m_sentCount - sentBefore == valueMsgs);
+    DOCTEST_CHECK(writer.m_suppressedCount + valueMsgs == 16 * frames);
+
+    // Once modulation stops, each ring lands on its final value.
+    //
+    for (int frame = 0; frame < SmartGrid::EncoderMidiWriter::x_valueCoolDownFrames; ++frame)
+    {
+        writer.ProcessCoolDown();
+        for (SmartGrid::BasicMidi msg : Drain(writer))
+        {
+            DOCTEST_CHECK(msg.GetValue() == frames);
+        }
+    }
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        for (size_t j = 0; j < 4; ++j)
+        {
+            DOCTEST_CHECK(writer.m_valueCode[i][j] == frames);
+        }
+    }
+
+    writer.ProcessCoolDown();
+    DOCTEST_CHECK(Drain(writer).empty());
+}
@@ -327,3 +327,93 @@ DOCTEST_TEST_CASE("async logger creates one timestamped session file in configur
 
     AsyncLogQueue::s_instance.ResetForTesting();
 }
+
+DOCTEST_TEST_CASE("async logger formats arguments on the drain thread")
+{
+    AsyncLogQueue::s_instance.ResetForTesting();
+    synthrig::TempDir tempDir;
+    DOCTEST_REQUIRE(tempDir.Valid());
+    AsyncLogQueue::s_instance.SetLogDirectoryForTesting(tempDir.String().c_str());
+
+    {
+        ScopedThreadId scopedThreadId(ThreadId::Audio);
+
+        // The string is gone before the drain runs; its characters were copied at the call.
+        //
+        std::string name = "voice-name";
+        INFO("args %d %zu %.2f %s %c %%", -7, static_cast<size_t>(42), 0.5f, name.c_str(), 'x');
+        name.assign(name.size(), '#');
+
+        char buffer[16] = "array";
+        const char* nullString = nullptr;
+        INFO("strings %s %s", buffer, nullString);
+
+        std::string longString(1000, 'a');
+        INFO("long %s end %d", longString.c_str(), 3);
+        INFO("no args keeps %d literally");
+    }
+
+    StdoutCapture capture(tempDir.Path() / "stdout.txt");
+    DOCTEST_REQUIRE(capture.Valid());
+    AsyncLogQueue::s_instance.DoLog();
+    capture.Stop();
+
+    std::string log = ReadTextFile(AsyncLogQueue::s_instance.LogFilePathForTesting());
+    DOCTEST_CHECK(log.find("args -7 42 0.50 voice-name x %") != std::string::npos);
+    DOCTEST_CHECK(log.find("strings array (null)") != std::string::npos);
+    DOCTEST_CHECK(log.find("no args keeps %d literally") != std::string::npos);
+
+    size_t longLine = log.find("long aaaa");
+    DOCTEST_REQUIRE(longLine != std::string::npos);
+    std::string line = log.substr(longLine, log.find('\n', longLine) - longLine);
+    DOCTEST_CHECK(line.size() < LogMessage::x_maxMessageLength);
+
+    AsyncLogQueue::s_instance.ResetForTesting();
+}
+
+DOCTEST_TEST_CASE("async logger rate limits per call site and reports suppressed messages")
+{
+    AsyncLogQueue::s_instance.ResetForTesting();
+    SampleTimer::Init(SampleTimer::x_samplesPerProcessFrame);
+    synthrig::TempDir tempDir;
+    DOCTEST_REQUIRE(tempDir.Valid());
+    AsyncLogQueue::s_instance.SetLogDirectoryForTesting(tempDir.String().c_str());
+    ScopedThreadId scopedThreadId(ThreadId::Audio);
+
+    auto logBoth = [](int i)
+    {
+        INFO_RATE_LIMITED("limited a %d", i);
+        INFO_RATE_LIMITED("limited b %d", i);
+    };
+
+    for (int i = 0; i < 100; ++i)
+    {
+        logBoth(i);
+    }
+
+    DOCTEST_CHECK(AsyncLogQueue::s_instance.QueueSizeForTesting(ThreadId::Audio) == 2);
+
+    // The audio clock stays stopped: the limit must still reopen once the interval has passed.
+    //
+    size_t sample = SampleTimer::GetSample();
+    std::this_thread::sleep_for(LogRateLimit::x_defaultInterval);
+    DOCTEST_CHECK(SampleTimer::GetSample() == sample);
+
+    logBoth(100);
+    DOCTEST_CHECK(AsyncLogQueue::s_instance.QueueSizeForTesting(ThreadId::Audio) == 4);
+
+    StdoutCapture capture(tempDir.Path() / "stdout.txt");
+    DOCTEST_REQUIRE(capture.Valid());
+    AsyncLogQueue::s_instance.DoLog();
+    capture.Stop();
+
+    std::string log = ReadTextFile(AsyncLogQueue::s_instance.LogFilePathForTesting());
+    DOCTEST_CHECK(log.find("limited a 0\n") != std::string::npos);
+    DOCTEST_CHECK(log.find("limited b 0\n") != std::string::npos);
+    DOCTEST_CHECK(log.find("limited a 1\n") == std::string::npos);
+    DOCTEST_CHECK(log.find("limited a 100 (99 similar suppressed)") != std::string::npos);
+    DOCTEST_CHECK(log.find("limited b 100 (99 similar suppressed)") != std::string::npos);
+
+    SampleTimer::Init(SampleTimer::x_samplesPerProcessFrame);
+    AsyncLogQueue::s_instance.ResetForTesting();
+}
@@ -0,0 +1,215 @@
+// infra_mpsc_queue.cpp -- unit tests for MPSCQueue (private/src/MPSCQueue.hpp) and its use as the
+// MessageInBus ingress ring
+//
+// Tests:
+//   1. Single-threaded: FIFO order across wrap-around, batch pop, overflow counting and the high-water mark.
+//   2. Four producer threads racing one batch-popping consumer lose nothing and keep each producer's order.
+//   3. MessageInBus takes pushes from several threads at once and reports them in its queue metrics.
+
+#include "doctest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../support/GlobalEnv.hpp"
+
+#include "BitSet.hpp"
+#include "MPSCQueue.hpp"
+#include "MessageIn.hpp"
+#include "MessageInBus.hpp"
+
+// ---------------------------------------------------------------------------
+// 1. Single-threaded semantics
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("MPSCQueue: FIFO, batch pop and overflow metrics")
+{
+    GlobalEnv::ResetPerTest();
+
+    MPSCQueue<int, 8> queue;
+    DOCTEST_CHECK(queue.IsEmpty());
+
+    int value = -1;
+    DOCTEST_CHECK_FALSE(queue.Pop(value));
+    DOCTEST_CHECK(queue.PeekPtr() == nullptr);
+
+    // Go round the ring a few times with a partly full queue.
+    //
+    int next = 0;
+    int expected = 0;
+    for (int lap = 0; lap < 5; ++lap)
+    {
+        for (int i = 0; i < 5; ++i)
+        {
+            DOCTEST_CHECK(queue.Push(next++));
+        }
+
+        for (int i = 0; i < 5; ++i)
+        {
+            DOCTEST_REQUIRE(queue.Pop(value));
+            DOCTEST_CHECK(value == expected++);
+        }
+    }
+
+    // Fill, overflow, then drain in batches.
+    //
+    for (int i = 0; i < 8; ++i)
+    {
+        DOCTEST_CHECK(queue.Push(100 + i));
+    }
+
+    DOCTEST_CHECK_FALSE(queue.Push(999));
+    DOCTEST_CHECK_FALSE(queue.Push(999));
+    DOCTEST_CHECK(queue.Size() == 8);
+
+    DOCTEST_REQUIRE(queue.Peek(value));
+    DOCTEST_CHECK(value == 100);
+
+    int batch[8];
+    DOCTEST_CHECK(queue.PopBatch(batch, 3) == 3);
+    DOCTEST_CHECK(batch[0] == 100);
+    DOCTEST_CHECK(batch[2] == 102);
+    DOCTEST_CHECK(queue.PopBatch(batch, 8) == 5);
+    DOCTEST_CHECK(batch[0] == 103);
+    DOCTEST_CHECK(batch[4] == 107);
+    DOCTEST_CHECK(queue.PopBatch(batch, 8) == 0);
+    DOCTEST_CHECK(queue.IsEmpty());
+
+    MPSCQueue<int, 8>::Metrics metrics = queue.GetMetrics();
+    DOCTEST_CHECK(metrics.m_pushCount == 33);
+    DOCTEST_CHECK(metrics.m_overflowCount == 2);
+    DOCTEST_CHECK(metrics.m_highWater == 8);
+}
+
+// ---------------------------------------------------------------------------
+// 2. Concurrent producers
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("MPSCQueue: concurrent producers lose nothing and keep per-producer order")
+{
+    GlobalEnv::ResetPerTest();
+
+    const int numProducers = 4;
+    const int perProducer = 50000;
+    static MPSCQueue<int, 1024> queue;
+
+    std::atomic<bool> go(false);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < numProducers; ++p)
+    {
+        producers.emplace_back([&go, p]()
+        {
+            while (!go.load())
+            {
+            }
+
+            for (int i = 0; i < perProducer; ++i)
+            {
+                while (!queue.Push(p * perProducer + i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    go.store(true);
+
+    int lastSeen[numProducers] = {-1, -1, -1, -1};
+    int received = 0;
+    int outOfOrder = 0;
+    int batch[64];
+    while (received < numProducers * perProducer)
+    {
+        size_t count = queue.PopBatch(batch, 64);
+        for (size_t i = 0; i < count; ++i)
+        {
+            int producer = batch[i] / perProducer;
+            int index = batch[i] % perProducer;
+            if (index != lastSeen[producer] + 1)
+            {
+                ++outOfOrder;
+            }
+
+            lastSeen[producer] = index;
+        }
+
+        received += static_cast<int>(count);
+    }
+
+    for (std::thread& producer : producers)
+    {
+        producer.join();
+    }
+
+    DOCTEST_CHECK(outOfOrder == 0);
+    DOCTEST_CHECK(queue.IsEmpty());
+    for (int p = 0; p < numProducers; ++p)
+    {
+        DOCTEST_CHECK(lastSeen[p] == perProducer - 1);
+    }
+
+    MPSCQueue<int, 1024>::Metrics metrics = queue.GetMetrics();
+    DOCTEST_CHECK(metrics.m_pushCount == static_cast<size_t>(numProducers * perProducer));
+    DOCTEST_CHECK(metrics.m_highWater <= 1024);
+}
+
+// ---------------------------------------------------------------------------
+// 3. MessageInBus ingress
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("MPSCQueue: MessageInBus accepts pushes from several threads")
+{
+    GlobalEnv::ResetPerTest();
+
+    struct Counter
+    {
+        int m_count[3] = {0, 0, 0};
+        int m_last[3] = {-1, -1, -1};
+        int m_outOfOrder = 0;
+
+        void Apply(SmartGrid::MessageIn msg)
+        {
+            if (msg.m_x != m_last[msg.m_routeId] + 1)
+            {
+                ++m_outOfOrder;
+            }
+
+            m_last[msg.m_routeId] = msg.m_x;
+            ++m_count[msg.m_routeId];
+        }
+    };
+
+    const int perRoute = 3000;
+    static SmartGrid::MessageInBus bus;
+    bus.SetFixedLatency(0);
+
+    std::vector<std::thread> producers;
+    for (int route = 0; route < 3; ++route)
+    {
+        producers.emplace_back([route]()
+        {
+            for (int i = 0; i < perRoute; ++i)
+            {
+                bus.Push(SmartGrid::MessageIn(static_cast<size_t>(i), route, SmartGrid::MessageIn::Mode::PadPress, i, 0));
+            }
+        });
+    }
+
+    for (std::thread& producer : producers)
+    {
+        producer.join();
+    }
+
+    Counter counter;
+    bus.ProcessMessages(&counter, perRoute);
+    for (int route = 0; route < 3; ++route)
+    {
+        DOCTEST_CHECK(counter.m_count[route] == perRoute);
+    }
+
+    DOCTEST_CHECK(counter.m_outOfOrder == 0);
+    DOCTEST_CHECK(bus.GetQueueMetrics().m_pushCount == 3 * perRoute);
+    DOCTEST_CHECK(bus.GetQueueMetrics().m_overflowCount == 0);
+}
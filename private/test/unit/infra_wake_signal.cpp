@@ -0,0 +1,241 @@
+// infra_wake_signal.cpp -- unit tests for WakeSignal (private/src/WakeSignal.hpp) and the workers that sleep on it
+//
+// Waits that only a Signal may end use timeouts far longer than the test, so a lost or late wakeup shows up as a
+// timeout count rather than as a wall clock threshold.
+//
+// Tests:
+//   1. A waiting thread is woken by Signal, never by its timeout, and a Signal sent while it is busy is not lost.
+//   2. Signals racing the worker going to sleep are never lost.
+//   3. An idle IoTaskThread wakes only on its idle timeout, and Shutdown wakes it by signal.
+//   4. FileWriter's idle writer thread does not poll, and a buffer wakes it by signal.
+
+#include "doctest.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include "../support/GlobalEnv.hpp"
+#include "../support/TempDir.hpp"
+
+#include "WakeSignal.hpp"
+#include "FileWriter.hpp"
+#include "IOTaskThread.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Blocks until the worker sleeping on wake has timed out count more times, then returns the time it took.
+    // Called right after a timeout, the worker has a full idle timeout of sleep ahead of it.
+    //
+    Clock::duration WaitForTimeouts(const WakeSignal& wake, size_t count)
+    {
+        Clock::time_point start = Clock::now();
+        size_t target = wake.m_metrics.m_timeoutCount.load() + count;
+        while (wake.m_metrics.m_timeoutCount.load() < target)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return Clock::now() - start;
+    }
+
+    // An idle worker wakes once per idle timeout: every wait ends in a timeout, and count timeouts span at least
+    // count - 1 whole idle timeouts.  A polling loop fails the first check, a short timeout the second.
+    //
+    void CheckIdle(const WakeSignal& wake, size_t count)
+    {
+        WaitForTimeouts(wake, 1);
+        size_t waits = wake.m_metrics.m_waitCount.load();
+        size_t signalled = wake.m_metrics.m_signalledCount.load();
+        Clock::duration elapsed = WaitForTimeouts(wake, count);
+        DOCTEST_CHECK(wake.m_metrics.m_signalledCount.load() == signalled);
+        DOCTEST_CHECK(wake.m_metrics.m_waitCount.load() - waits <= count + 1);
+        DOCTEST_CHECK(elapsed >= (count - 1) * WakeSignal::x_idleTimeout);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 1. Signal / Wait
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("WakeSignal: Signal wakes the waiter and is never lost")
+{
+    GlobalEnv::ResetPerTest();
+
+    WakeSignal wake;
+
+    // Nothing signalled: Wait times out.
+    //
+    DOCTEST_CHECK_FALSE(wake.Wait(std::chrono::milliseconds(1)));
+    DOCTEST_CHECK(wake.m_metrics.m_timeoutCount == 1);
+
+    // A Signal before Wait is consumed without sleeping, and only once.
+    //
+    wake.Signal();
+    wake.Signal();
+    DOCTEST_CHECK(wake.Wait(std::chrono::seconds(5)));
+    DOCTEST_CHECK_FALSE(wake.Wait(std::chrono::milliseconds(1)));
+
+    // Each round the waiter sleeps with a timeout far longer than the test, and must see the signal flag set
+    // when it wakes: it was woken by that Signal, never by its timeout.
+    //
+    constexpr int x_rounds = 50;
+    std::atomic<int> round{0};
+    std::atomic<bool> waiting{false};
+    std::atomic<bool> signalled{false};
+    std::atomic<int> earlyWakes{0};
+    std::thread waiter([&]()
+    {
+        for (int i = 0; i < x_rounds; ++i)
+        {
+            waiting.store(true);
+            while (!wake.Wait(std::chrono::seconds(10)))
+            {
+            }
+
+            earlyWakes.fetch_add(signalled.exchange(false) ? 0 : 1);
+            waiting.store(false);
+            round.fetch_add(1);
+        }
+    });
+
+    for (int i = 0; i < x_rounds; ++i)
+    {
+        while (!waiting.load() || round.load() != i)
+        {
+            std::this_thread::yield();
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        signalled.store(true);
+        wake.Signal();
+        while (round.load() == i)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    waiter.join();
+    DOCTEST_CHECK(earlyWakes.load() == 0);
+    DOCTEST_CHECK(wake.m_metrics.m_timeoutCount == 2);
+    DOCTEST_CHECK(wake.m_metrics.m_signalledCount == x_rounds + 1);
+}
+
+// ---------------------------------------------------------------------------
+// 2. Racing Signal and Wait
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("WakeSignal: signals racing the worker going to sleep are never lost")
+{
+    GlobalEnv::ResetPerTest();
+
+    // The producer publishes a count and signals; the worker drains, then sleeps.  Any lost wakeup leaves the
+    // worker asleep with work outstanding until its 10 s timeout, which the timeout count records.
+    //
+    constexpr size_t x_count = 20000;
+    WakeSignal wake;
+    std::atomic<size_t> published{0};
+    std::thread worker([&]()
+    {
+        size_t seen = 0;
+        while (seen < x_count)
+        {
+            size_t now = published.load();
+            if (now != seen)
+            {
+                seen = now;
+                continue;
+            }
+
+            wake.Wait(std::chrono::seconds(10));
+        }
+    });
+
+    for (size_t i = 1; i <= x_count; ++i)
+    {
+        published.store(i);
+        wake.Signal();
+        if (i % 64 == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    worker.join();
+    DOCTEST_CHECK(wake.m_metrics.m_timeoutCount == 0);
+    DOCTEST_CHECK(wake.m_metrics.m_signalledCount == wake.m_metrics.m_waitCount);
+    DOCTEST_CHECK(wake.m_notifyCount.load() >= wake.m_metrics.m_signalledCount.load());
+}
+
+// ---------------------------------------------------------------------------
+// 3. IoTaskThread idle wakeups
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("WakeSignal: an idle IoTaskThread does not poll and shuts down by signal")
+{
+    GlobalEnv::ResetPerTest();
+
+    IoTaskThread io;
+    CheckIdle(io.m_wake, 3);
+
+    // Shutdown right after an idle timeout: the worker is asleep for another idle timeout, so it can only have
+    // stopped this soon because the Shutdown signal woke it.
+    //
+    WaitForTimeouts(io.m_wake, 1);
+    size_t timeouts = io.m_wake.m_metrics.m_timeoutCount.load();
+    size_t signalled = io.m_wake.m_metrics.m_signalledCount.load();
+    io.Shutdown();
+    DOCTEST_CHECK(io.m_wake.m_metrics.m_timeoutCount.load() == timeouts);
+    DOCTEST_CHECK(io.m_wake.m_metrics.m_signalledCount.load() == signalled + 1);
+}
+
+// ---------------------------------------------------------------------------
+// 4. FileWriter
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("WakeSignal: FileWriter is woken by writes and does not poll")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    std::string path = (dir.Path() / "wake.bin").string();
+
+    FileWriter writer;
+    DOCTEST_REQUIRE(writer.Open(path));
+    CheckIdle(writer.m_wake, 2);
+
+    // One full buffer reaches the file by signal, not by waiting out the idle timeout.
+    //
+    std::vector<uint8_t> data(FileWriter::x_bufferSize);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    WaitForTimeouts(writer.m_wake, 1);
+    size_t timeouts = writer.m_wake.m_metrics.m_timeoutCount.load();
+    size_t signalled = writer.m_wake.m_metrics.m_signalledCount.load();
+    writer.Write(data.data(), data.size());
+    while (!writer.m_queue.IsEmpty())
+    {
+        std::this_thread::yield();
+    }
+
+    DOCTEST_CHECK(writer.m_wake.m_metrics.m_timeoutCount.load() == timeouts);
+    DOCTEST_CHECK(writer.m_wake.m_metrics.m_signalledCount.load() == signalled + 1);
+
+    writer.Write(data.data(), 10);
+    writer.Close();
+    DOCTEST_CHECK_FALSE(writer.m_error.load());
+
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    DOCTEST_REQUIRE(contents.size() == data.size() + 10);
+    DOCTEST_CHECK(std::equal(data.begin(), data.end(), contents.begin()));
+    DOCTEST_CHECK(std::equal(data.begin(), data.begin() + 10, contents.begin() + data.size()));
+}
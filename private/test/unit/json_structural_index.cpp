@@ -0,0 +1,266 @@
+// json_structural_index.cpp -- unit tests for the two-stage parser and streaming writer (private/src/Json.hpp)
+//
+// Stage 1 (StructuralIndex) finds every token 64 bytes at a time; stage 2 (Parser) builds the tree from the
+// token offsets.  JSON::DumpTo streams the serialized text to a sink in fixed chunks.
+//
+// Tests:
+//   1. The SIMD and scalar classifiers produce the same tokens, on the patch fixture and on strings whose
+//      quotes and backslashes straddle block boundaries.
+//   2. Escapes decode at every alignment; malformed texts are rejected and well-formed edge cases accepted.
+//   3. DumpTo streams exactly the Dumps text in chunks no larger than the writer's buffer.
+//   4. Benchmark: MB/s for indexing, parsing and serializing the patch fixture (reported, not asserted).
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "Json.hpp"
+
+#ifndef SMARTGRID_REPO_ROOT
+#define SMARTGRID_REPO_ROOT "."
+#endif
+
+namespace
+{
+    std::string ReadFixture()
+    {
+        std::ifstream f(std::string(SMARTGRID_REPO_ROOT) + "/private/test/fixtures_espace_etale_2026-06-24T10-40-13.json", std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    }
+
+    std::vector<uint32_t> Tokens(const std::string& text, bool simd)
+    {
+        JsonDetail::StructuralIndex index;
+        index.Build(text.c_str(), text.size(), simd);
+        return std::vector<uint32_t>(index.m_tokens.begin(), index.m_tokens.begin() + index.m_numTokens);
+    }
+
+    std::string Dump(JSON json)
+    {
+        char* dumped = json.Dumps(0);
+        std::string result = dumped ? std::string(dumped) : std::string();
+        free(dumped);
+        return result;
+    }
+
+    // Records each chunk the writer hands over.
+    //
+    struct ChunkSink
+    {
+        std::string m_text;
+        std::vector<size_t> m_chunks;
+
+        size_t Write(const uint8_t* data, size_t length)
+        {
+            m_text.append(reinterpret_cast<const char*>(data), length);
+            m_chunks.push_back(length);
+            return length;
+        }
+    };
+}
+
+// ---------------------------------------------------------------------------
+// 1. Stage 1
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("json_structural_index: tokens are structural characters, quotes and scalar starts")
+{
+    std::string text = " {\"a b\": [1, -2.5e3,true] ,\"c\\\"{\":null}";
+    std::vector<uint32_t> want = {1, 2, 6, 7, 9, 10, 11, 13, 19, 20, 24, 26, 27, 32, 33, 34, 38};
+    DOCTEST_CHECK(Tokens(text, false) == want);
+    DOCTEST_CHECK(Tokens(text, true) == want);
+
+    JsonDetail::StructuralIndex index;
+    DOCTEST_CHECK_FALSE(index.Build("[\"open", 6));
+    DOCTEST_CHECK_FALSE(index.Build("\"\\\"", 3));
+    DOCTEST_CHECK(index.Build("\"\\\\\"", 4));
+}
+
+DOCTEST_TEST_CASE("json_structural_index: SIMD and scalar classifiers agree")
+{
+    std::string fixture = ReadFixture();
+    DOCTEST_REQUIRE_FALSE(fixture.empty());
+    DOCTEST_CHECK(Tokens(fixture, true) == Tokens(fixture, false));
+    DOCTEST_CHECK(Tokens(fixture, true).size() > fixture.size() / 4);
+
+    // Runs of backslashes and escaped quotes at every offset across a block boundary.
+    //
+    for (size_t shift = 0; shift < 2 * JsonDetail::StructuralIndex::x_blockSize; ++shift)
+    {
+        DOCTEST_CAPTURE(shift);
+        std::string text = std::string(shift, ' ') + "[\"x\\\\\\\\\",\"y\\\"\\\\\\\"\",7,\"\\\\\"]";
+        DOCTEST_CHECK(Tokens(text, true) == Tokens(text, false));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 2. Stage 2
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("json_structural_index: escapes decode at every alignment")
+{
+    for (size_t shift = 0; shift < 2 * JsonDetail::StructuralIndex::x_blockSize; ++shift)
+    {
+        DOCTEST_CAPTURE(shift);
+        std::string text = std::string(shift, '\n') + "{\"k\\\\\":[\"a\\\\\",\"b\\\"c\",\"\\u00e9\\ud83d\\ude00\\n\",12345678901234567890]}";
+        JsonArena arena(4096);
+        JSON root = arena.Loads(text.c_str());
+        DOCTEST_REQUIRE_FALSE(root.IsNull());
+        JSON values = root.Get("k\\");
+        DOCTEST_REQUIRE(values.Size() == 4);
+        DOCTEST_CHECK(std::string(values.GetAt(0).StringValue()) == "a\\");
+        DOCTEST_CHECK(std::string(values.GetAt(1).StringValue()) == "b\"c");
+        DOCTEST_CHECK(std::string(values.GetAt(2).StringValue()) == "\xC3\xA9\xF0\x9F\x98\x80\n");
+        DOCTEST_CHECK(values.GetAt(3).m_node->m_int == INT64_MAX);
+    }
+}
+
+DOCTEST_TEST_CASE("json_structural_index: malformed texts are rejected")
+{
+    const char* bad[] = {
+        "", "   ", "1x", "[1 2]", "{\"a\" 1}", "\"abc", "[1,]", "tru", "nul", "truex",
+        "{\"a\":1}}", "[\"a\\q\"]", "1 2", "{1:2}", "[-]", "{\"a\":}", "[1]x", ",", "]",
+    };
+
+    for (const char* text : bad)
+    {
+        DOCTEST_CAPTURE(text);
+        JsonArena arena(4096);
+        DOCTEST_CHECK(arena.Loads(text).IsNull());
+        DOCTEST_CHECK_FALSE(arena.Failed());
+    }
+
+    JsonArena arena(4096);
+    DOCTEST_CHECK(arena.Loads(" 42 \n").IntegerValue() == 42);
+    DOCTEST_CHECK(arena.Loads("-0.5e3").RealValue() == -500.0);
+    DOCTEST_CHECK(arena.Loads("-9").IntegerValue() == -9);
+    DOCTEST_CHECK(std::string(arena.Loads("\"\"").StringValue()).empty());
+    DOCTEST_CHECK(Dump(arena.Loads("[ true ,false,null,{ },[]]")) == "[true,false,null,{},[]]");
+}
+
+DOCTEST_TEST_CASE("json_structural_index: a large text does not pin its scratch buffers")
+{
+    JsonDetail::ParseScratch& scratch = JsonDetail::ParseScratch::ForThread();
+    JsonArena arena(JsonArena::kDefaultCapacity);
+
+    std::string fixture = ReadFixture();
+    DOCTEST_REQUIRE_FALSE(arena.Loads(fixture.c_str()).IsNull());
+    DOCTEST_CHECK(scratch.m_index.m_tokens.capacity() >= fixture.size());
+    DOCTEST_CHECK(scratch.m_index.m_tokens.capacity() <= JsonDetail::ParseScratch::x_retainedEntries);
+
+    // One more value than is retained, and about twice as many tokens.
+    //
+    const size_t numValues = JsonDetail::ParseScratch::x_retainedEntries + 1;
+    std::string large = "[";
+    for (size_t i = 0; i < numValues; ++i)
+    {
+        large += i ? ",1" : "1";
+    }
+
+    large += "]";
+    JsonArena largeArena(4 * JsonArena::kDefaultCapacity);
+    JSON root = largeArena.Loads(large.c_str());
+    DOCTEST_REQUIRE_FALSE(root.IsNull());
+    DOCTEST_CHECK(root.Size() == numValues);
+    DOCTEST_CHECK(scratch.m_index.m_tokens.capacity() == 0);
+    DOCTEST_CHECK(scratch.m_values.capacity() == 0);
+
+    // Later small texts grow it back only to their own size.
+    //
+    arena.Reset();
+    DOCTEST_REQUIRE_FALSE(arena.Loads(fixture.c_str()).IsNull());
+    DOCTEST_CHECK(scratch.m_index.m_tokens.capacity() >= fixture.size());
+    DOCTEST_CHECK(scratch.m_index.m_tokens.capacity() < 2 * fixture.size());
+}
+
+// ---------------------------------------------------------------------------
+// 3. Streaming writer
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("json_structural_index: DumpTo streams the Dumps text in buffer-sized chunks")
+{
+    std::string fixture = ReadFixture();
+    DOCTEST_REQUIRE_FALSE(fixture.empty());
+    JsonArena arena(JsonArena::kDefaultCapacity);
+    JSON root = arena.Loads(fixture.c_str());
+    DOCTEST_REQUIRE_FALSE(root.IsNull());
+
+    // A string longer than the buffer goes to the sink directly, and escapes survive.
+    //
+    root.SetNew("long", arena.String((std::string(10000, 'z') + "\"\\\x01\t").c_str()));
+    root.SetNew("min", arena.Integer(INT64_MIN));
+
+    ChunkSink sink;
+    DOCTEST_REQUIRE(root.DumpTo(sink));
+    DOCTEST_CHECK(sink.m_text == Dump(root));
+    DOCTEST_CHECK(sink.m_chunks.size() > 1);
+    size_t largest = 0;
+    for (size_t chunk : sink.m_chunks)
+    {
+        if (chunk != 10000)
+        {
+            largest = std::max(largest, chunk);
+        }
+    }
+
+    DOCTEST_CHECK(largest <= JsonDetail::Writer<ChunkSink>::x_bufferSize);
+    DOCTEST_CHECK(sink.m_text.find("\"min\":-9223372036854775808") != std::string::npos);
+    DOCTEST_CHECK(sink.m_text.find("\\\"\\\\\\u0001\\t\"") != std::string::npos);
+
+    ChunkSink none;
+    DOCTEST_CHECK_FALSE(JSON::Null().DumpTo(none));
+    DOCTEST_CHECK(none.m_chunks.empty());
+}
+
+// ---------------------------------------------------------------------------
+// 4. Benchmark (informational)
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("json_structural_index: benchmark on the patch fixture")
+{
+    std::string fixture = ReadFixture();
+    DOCTEST_REQUIRE_FALSE(fixture.empty());
+    const int reps = 200;
+    double megabytes = static_cast<double>(fixture.size()) * reps / 1.0e6;
+
+    auto time = [&](auto&& body)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r)
+        {
+            body();
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return megabytes / seconds;
+    };
+
+    JsonDetail::StructuralIndex index;
+    double indexSimd = time([&]() { index.Build(fixture.c_str(), fixture.size(), true); });
+    double indexScalar = time([&]() { index.Build(fixture.c_str(), fixture.size(), false); });
+
+    JsonArena arena(JsonArena::kDefaultCapacity);
+    JSON root;
+    double parse = time([&]()
+    {
+        arena.Reset();
+        root = arena.Loads(fixture.c_str());
+    });
+
+    DOCTEST_REQUIRE_FALSE(root.IsNull());
+    double dump = time([&]()
+    {
+        char* dumped = root.Dumps(0);
+        free(dumped);
+    });
+
+    DOCTEST_MESSAGE("JSON fixture (" << fixture.size() << " bytes, SIMD " << std::string(JsonDetail::StructuralIndex::x_simd ? "on" : "off") << ")");
+    DOCTEST_MESSAGE("stage 1 SIMD: " << indexSimd << " MB/s, stage 1 scalar: " << indexScalar << " MB/s");
+    DOCTEST_MESSAGE("Loads: " << parse << " MB/s, Dumps: " << dump << " MB/s");
+}
@@ -0,0 +1,217 @@
+// lamejuis_truth_table.cpp -- compiled truth tables for LameJuis (private/src/LameJuis.hpp, HarmonicSheaf.hpp)
+//
+// Each LogicOperation compiles its matrix switches and RHS table into a 64-bit truth table over all time
+// slices, the sheaf is rebuilt from those tables, and lens classes are enumerated from a bitsliced class
+// mask. All of it must agree with evaluating the documented definitions one time slice at a time.
+//
+// Tests:
+//   1. Random operation configurations: the truth table matches countHigh -> m_rhs at every time slice.
+//   2. Every lens and time slice: the class mask and class iterator match Lens::Equivalent, in order.
+//   3. LameJuisInternal::Process: gates and the rebuilt sheaf match a per-slice reference through edits.
+
+#include "doctest.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../support/GlobalEnv.hpp"
+
+#include "LameJuis.hpp"
+
+namespace
+{
+    using Op = LameJuisInternal::LogicOperation;
+    using MatrixSwitch = LameJuisInternal::MatrixSwitch;
+
+    // The operation's definition evaluated directly at one time slice.
+    //
+    bool Reference(const MatrixSwitch* elements, const bool* rhs, uint8_t timeSlice)
+    {
+        size_t countHigh = 0;
+        for (size_t i = 0; i < LameJuisInternal::x_numInputs; ++i)
+        {
+            bool bit = (timeSlice >> i) & 1;
+            if (elements[i] == MatrixSwitch::Normal)
+            {
+                countHigh += bit ? 1 : 0;
+            }
+            else if (elements[i] == MatrixSwitch::Inverted)
+            {
+                countHigh += bit ? 0 : 1;
+            }
+        }
+
+        return rhs[countHigh];
+    }
+
+    void Randomize(LameJuisInternal::LogicOperation::Input& input, std::mt19937& rng)
+    {
+        for (size_t i = 0; i < LameJuisInternal::x_numInputs; ++i)
+        {
+            input.m_elements[i] = static_cast<MatrixSwitch>(rng() % 3);
+        }
+
+        for (size_t i = 0; i < LameJuisInternal::x_numInputs + 1; ++i)
+        {
+            input.m_rhs[i] = rng() % 2 == 1;
+        }
+
+        input.m_switch = static_cast<Op::SwitchVal>(rng() % 3);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 1. Operation truth tables
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("LameJuis: compiled operation truth tables match the per-slice definition")
+{
+    GlobalEnv::ResetPerTest();
+
+    std::mt19937 rng(4011);
+    for (int trial = 0; trial < 500; ++trial)
+    {
+        LameJuisInternal::LogicOperation::Input input;
+        Randomize(input, rng);
+
+        Op op;
+        for (size_t i = 0; i < LameJuisInternal::x_numInputs; ++i)
+        {
+            op.m_elements[i] = input.m_elements[i];
+        }
+
+        for (size_t i = 0; i < LameJuisInternal::x_numInputs + 1; ++i)
+        {
+            op.m_rhs[i] = input.m_rhs[i];
+        }
+
+        op.SetBitVectors();
+        op.CompileTruthTable();
+        for (uint8_t p = 0; p < HarmonicSheaf::x_numBasePoints; ++p)
+        {
+            DOCTEST_CHECK(op.GetValue(HarmonicSheaf::BitVector(p)) == Reference(input.m_elements, input.m_rhs, p));
+        }
+    }
+
+    // All inputs muted: only m_rhs[0] matters.
+    //
+    Op op;
+    for (size_t i = 0; i < LameJuisInternal::x_numInputs; ++i)
+    {
+        op.m_elements[i] = MatrixSwitch::Muted;
+    }
+
+    op.m_rhs[0] = true;
+    op.SetBitVectors();
+    op.CompileTruthTable();
+    DOCTEST_CHECK(op.m_truthTable == ~0ull);
+}
+
+// ---------------------------------------------------------------------------
+// 2. Lens classes
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("HarmonicSheaf: lens class masks and iteration match Equivalent")
+{
+    GlobalEnv::ResetPerTest();
+
+    for (uint8_t lensBits = 0; lensBits < HarmonicSheaf::x_numBasePoints; ++lensBits)
+    {
+        HarmonicSheaf::Lens lens(lensBits);
+        for (uint8_t x = 0; x < HarmonicSheaf::x_numBasePoints; ++x)
+        {
+            std::vector<uint8_t> expected;
+            for (uint8_t y = 0; y < HarmonicSheaf::x_numBasePoints; ++y)
+            {
+                if (lens.Equivalent(HarmonicSheaf::BitVector(x), HarmonicSheaf::BitVector(y)))
+                {
+                    expected.push_back(y);
+                }
+            }
+
+            std::vector<uint8_t> visited;
+            HarmonicSheaf::TimeSliceClassIterator iterator(lens, HarmonicSheaf::BitVector(x));
+            while (!iterator.Done())
+            {
+                visited.push_back(iterator.Get().m_bits);
+                iterator.Next();
+            }
+
+            DOCTEST_CHECK(visited == expected);
+            DOCTEST_CHECK(expected.size() == (size_t(1) << (HarmonicSheaf::x_dimension - lens.CountSetBits())));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 3. Process keeps gates and the sheaf in step with the configuration
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("LameJuis: gates and sheaf follow configuration edits")
+{
+    GlobalEnv::ResetPerTest();
+
+    static LameJuisInternal lameJuis;
+    static LameJuisInternal::Input input;
+    std::mt19937 rng(40);
+
+    for (int step = 0; step < 400; ++step)
+    {
+        // An operation only picks up configuration edits for inputs that change, so its gate is checked
+        // against its own current configuration.
+        //
+        if (step % 20 == 0)
+        {
+            for (size_t j = 0; j < LameJuisInternal::x_numOperations; ++j)
+            {
+                Randomize(input.m_operationInput[j], rng);
+            }
+        }
+
+        for (size_t i = 0; i < LameJuisInternal::x_numInputs; ++i)
+        {
+            input.m_inputBitInput[i].m_value = rng() % 2 == 1;
+        }
+
+        lameJuis.Process(input);
+
+        uint8_t timeSlice = lameJuis.m_inputVector.m_bits;
+        for (size_t j = 0; j < LameJuisInternal::x_numOperations; ++j)
+        {
+            bool anyChanged = false;
+            for (size_t i = 0; i < LameJuisInternal::x_numInputs; ++i)
+            {
+                anyChanged = anyChanged || (lameJuis.m_inputs[i].m_changed && input.m_operationInput[j].m_elements[i] != MatrixSwitch::Muted);
+            }
+
+            if (anyChanged)
+            {
+                Op& op = lameJuis.m_operations[j];
+                DOCTEST_CHECK(op.m_gate == Reference(op.m_elements, op.m_rhs, timeSlice));
+            }
+        }
+
+        for (uint8_t p = 0; p < HarmonicSheaf::x_numBasePoints; ++p)
+        {
+            HarmonicSheaf::Section expected;
+            for (size_t j = 0; j < LameJuisInternal::x_numOperations; ++j)
+            {
+                Op& op = lameJuis.m_operations[j];
+                size_t target = op.GetOutputTarget();
+                size_t countTotal;
+                size_t countHigh;
+                op.GetTotalAndHigh(HarmonicSheaf::BitVector(p), &countTotal, &countHigh);
+                ++expected.m_total[target];
+                expected.m_high[target] += op.ComputeOperation(countHigh) ? 1 : 0;
+            }
+
+            HarmonicSheaf::Section& section = lameJuis.m_sheaf.m_sections[p];
+            for (size_t k = 0; k < HarmonicSheaf::x_rank; ++k)
+            {
+                DOCTEST_CHECK(section.m_high[k] == expected.m_high[k]);
+                DOCTEST_CHECK(section.m_total[k] == expected.m_total[k]);
+            }
+        }
+    }
+}
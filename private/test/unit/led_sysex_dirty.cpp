@@ -0,0 +1,199 @@
+// led_sysex_dirty.cpp -- unit tests for dirty-cell LED output (private/src/SmartBus.hpp, LaunchPadMidi.hpp)
+//
+// SmartBusGeneric::Store marks a per-cell dirty bit only when a payload changes, and LPSysexWriter visits
+// only dirty pads, so an unchanged grid costs no sysex and a small change sends only the changed pads.
+//
+// Tests:
+//   1. Storing the same colour leaves no dirty bit and no epoch bump; a change marks exactly that cell.
+//   2. The writer sends every supported pad once, then only changed pads, then nothing; Reset resends all.
+//   3. Grids pushed with OutputToBus produce a sysex with just the recoloured pad.
+
+#include "doctest.h"
+
+#include <vector>
+
+#include "../support/GlobalEnv.hpp"
+#include "../support/LPSysex.hpp"
+
+#include "SmartGrid.hpp"
+#include "SmartBus.hpp"
+#include "LaunchPadMidi.hpp"
+
+namespace
+{
+    using SmartGrid::Color;
+    using TestLPSysex::Pad;
+    using TestLPSysex::ParseSysex;
+
+    size_t CountSupported(SmartGrid::ControllerShape shape)
+    {
+        size_t count = 0;
+        for (int x = SmartGrid::x_gridXMin; x < SmartGrid::x_gridXMax; ++x)
+        {
+            for (int y = SmartGrid::x_gridYMin; y < SmartGrid::x_gridYMax; ++y)
+            {
+                count += SmartGrid::LPMidi::ShapeSupports(shape, x, y) ? 1 : 0;
+            }
+        }
+
+        return count;
+    }
+
+    void PutAndBump(SmartGrid::SmartBusColor& bus, int x, int y, Color c)
+    {
+        bool changed = false;
+        bus.Put(x, y, c, &changed);
+        if (changed)
+        {
+            bus.m_epoch.fetch_add(1);
+        }
+    }
+
+    struct PaletteGrid : public SmartGrid::AbstractGrid
+    {
+        PaletteGrid()
+        {
+            for (int x = 0; x < 8; ++x)
+            {
+                for (int y = 0; y < 8; ++y)
+                {
+                    m_colors[x][y] = Color(static_cast<uint8_t>(2 * (x + 8 * y)), 0, 0);
+                }
+            }
+        }
+
+        virtual void Apply(SmartGrid::Message) override
+        {
+        }
+
+        virtual Color GetColor(int i, int j) override
+        {
+            if (0 <= i && i < 8 && 0 <= j && j < 8)
+            {
+                return m_colors[i][j];
+            }
+
+            return Color::Off;
+        }
+
+        Color m_colors[8][8];
+    };
+}
+
+// ---------------------------------------------------------------------------
+// 1. Dirty bits
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("SmartBus: dirty bits mark only changed cells")
+{
+    GlobalEnv::ResetPerTest();
+
+    static SmartGrid::SmartBusColor bus;
+    for (int i = 0; i < SmartGrid::x_gridMaxSize; ++i)
+    {
+        bus.TakeDirtyRow(i);
+    }
+
+    bool changed = false;
+    bus.Put(0, 0, Color::Off, &changed);
+    DOCTEST_CHECK_FALSE(changed);
+    DOCTEST_CHECK(bus.TakeDirtyRow(0 - SmartGrid::x_gridXMin) == 0);
+
+    bus.Put(2, 3, Color::Red, &changed);
+    DOCTEST_CHECK(changed);
+    DOCTEST_CHECK(bus.Get(2, 3) == Color::Red);
+    DOCTEST_CHECK(bus.TakeDirtyRow(2 - SmartGrid::x_gridXMin) == 1u << (3 - SmartGrid::x_gridYMin));
+    DOCTEST_CHECK(bus.TakeDirtyRow(2 - SmartGrid::x_gridXMin) == 0);
+
+    changed = false;
+    bus.Put(2, 3, Color::Red, &changed);
+    DOCTEST_CHECK_FALSE(changed);
+    DOCTEST_CHECK(bus.TakeDirtyRow(2 - SmartGrid::x_gridXMin) == 0);
+}
+
+// ---------------------------------------------------------------------------
+// 2. Sysex writer sends only changed pads
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("LPSysexWriter: sends all pads once, then only changed pads")
+{
+    GlobalEnv::ResetPerTest();
+
+    const SmartGrid::ControllerShape shapes[] = {SmartGrid::ControllerShape::LaunchPadX, SmartGrid::ControllerShape::LaunchPadProMk3};
+    for (SmartGrid::ControllerShape shape : shapes)
+    {
+        static SmartGrid::SmartBusColor bus;
+        static uint8_t buffer[SmartGrid::LPSysexWriter::x_maxMessageSize];
+        SmartGrid::LPSysexWriter writer(shape, &bus);
+
+        size_t size = writer.Write(buffer);
+        DOCTEST_CHECK(ParseSysex(buffer, size).size() == CountSupported(shape));
+        DOCTEST_CHECK(writer.Write(buffer) == 0);
+
+        PutAndBump(bus, 1, 1, Color(100, 0, 0));
+        PutAndBump(bus, 5, 6, Color(60, 0, 0));
+        std::vector<Pad> pads = ParseSysex(buffer, writer.Write(buffer));
+        DOCTEST_REQUIRE(pads.size() == 2);
+        DOCTEST_CHECK(pads[0].m_note == SmartGrid::LPMidi::PosToNote(1, 1));
+        DOCTEST_CHECK(pads[0].m_red == 50);
+        DOCTEST_CHECK(pads[1].m_note == SmartGrid::LPMidi::PosToNote(5, 6));
+        DOCTEST_CHECK(pads[1].m_red == 30);
+        DOCTEST_CHECK(writer.Write(buffer) == 0);
+
+        // A pad that changes and changes back before the write sends nothing.
+        //
+        PutAndBump(bus, 3, 3, Color(8, 0, 0));
+        PutAndBump(bus, 3, 3, Color::Off);
+        DOCTEST_CHECK(writer.Write(buffer) == 0);
+
+        // Pads the shape does not have are never sent.
+        //
+        PutAndBump(bus, -1, 4, Color(40, 0, 0));
+        size = writer.Write(buffer);
+        if (SmartGrid::LPMidi::ShapeSupports(shape, -1, 4))
+        {
+            DOCTEST_CHECK(ParseSysex(buffer, size).size() == 1);
+        }
+        else
+        {
+            DOCTEST_CHECK(size == 0);
+        }
+
+        writer.Reset();
+        DOCTEST_CHECK(ParseSysex(buffer, writer.Write(buffer)).size() == CountSupported(shape));
+
+        PutAndBump(bus, 1, 1, Color::Off);
+        PutAndBump(bus, 5, 6, Color::Off);
+        PutAndBump(bus, -1, 4, Color::Off);
+        writer.Write(buffer);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 3. Grid to bus to sysex
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("LPSysexWriter: a recoloured grid cell sends one pad")
+{
+    GlobalEnv::ResetPerTest();
+
+    static SmartGrid::SmartBusColor bus;
+    static uint8_t buffer[SmartGrid::LPSysexWriter::x_maxMessageSize];
+    PaletteGrid grid;
+    SmartGrid::LPSysexWriter writer(SmartGrid::ControllerShape::LaunchPadX, &bus);
+
+    grid.OutputToBus(&bus);
+    DOCTEST_CHECK(ParseSysex(buffer, writer.Write(buffer)).size() == CountSupported(SmartGrid::ControllerShape::LaunchPadX));
+
+    uint64_t epoch = bus.m_epoch.load();
+    grid.OutputToBus(&bus);
+    DOCTEST_CHECK(bus.m_epoch.load() == epoch);
+    DOCTEST_CHECK(writer.Write(buffer) == 0);
+
+    grid.m_colors[4][2] = Color(200, 0, 0);
+    grid.OutputToBus(&bus);
+    std::vector<Pad> pads = ParseSysex(buffer, writer.Write(buffer));
+    DOCTEST_REQUIRE(pads.size() == 1);
+    DOCTEST_CHECK(pads[0].m_note == SmartGrid::LPMidi::PosToNote(4, 2));
+    DOCTEST_CHECK(pads[0].m_red == 100);
+}
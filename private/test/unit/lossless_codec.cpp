@@ -0,0 +1,460 @@
+// lossless_codec.cpp -- unit tests for lossless recording files (private/src/LosslessCodec.hpp, LosslessWavWriter.hpp)
+//
+// LosslessCodec codes 24-bit blocks with fixed or LPC prediction and partitioned Rice residuals.
+// LosslessWavWriter encodes blocks on worker threads into an RF64 file with a seek chunk, which WavReader
+// decodes by block.
+//
+// Tests:
+//   1. Blocks of every kind and length decode to exactly the samples encoded; tonal material and silence
+//      compress, and white noise costs little more than verbatim.
+//   2. Truncated or damaged blocks are rejected without reading past their bytes.
+//   3. WavReader reads a lossless file back sample for sample, across block boundaries and from any offset,
+//      and worker and inline encoding write the same bytes.  Files with too many channels are rejected.
+//   4. StemRecorder and RecordingTake write lossless files that load to the same audio as their PCM ones, in
+//      less space: under half for stems with idle channels, and under three quarters for a take whose noise
+//      floor costs several bits a sample.  A take encoded on a shared pool matches the inline bytes.
+//      Lossless files load only under their own extension, banks list them, and takes of both kinds share
+//      one file numbering.
+//   5. Benchmark: encode throughput with and without workers, and the compression ratio (reported, not
+//      asserted).
+
+#include "doctest.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../support/GlobalEnv.hpp"
+#include "../support/TempDir.hpp"
+
+#include "AudioBuffer.hpp"
+#include "IOTaskThread.hpp"
+#include "LosslessCodec.hpp"
+#include "LosslessWavWriter.hpp"
+#include "RecordingBuffer.hpp"
+#include "RecordingChunkPool.hpp"
+#include "StemRecorder.hpp"
+#include "WavReader.hpp"
+#include "WorkerPool.hpp"
+
+namespace
+{
+    // A few partials and a little noise, like a synth voice; channel c is detuned and phase shifted.
+    //
+    int32_t TonalSample(size_t frame, size_t channel, std::mt19937& rng)
+    {
+        double t = static_cast<double>(frame) / 48000.0;
+        double c = static_cast<double>(channel);
+        double value = 0.4 * std::sin(2.0 * M_PI * (110.0 + c) * t + c)
+            + 0.15 * std::sin(2.0 * M_PI * 331.0 * t)
+            + 0.05 * std::sin(2.0 * M_PI * 2750.0 * t + 0.5 * c);
+        return static_cast<int32_t>(std::lround(value * 8388607.0)) + static_cast<int32_t>(rng() % 33) - 16;
+    }
+
+    std::vector<int32_t> MakeBlock(int kind, size_t numFrames, size_t numChannels, std::mt19937& rng)
+    {
+        std::vector<int32_t> samples(numFrames * numChannels);
+        for (size_t i = 0; i < numFrames; ++i)
+        {
+            for (size_t c = 0; c < numChannels; ++c)
+            {
+                int32_t value = 0;
+                switch (kind)
+                {
+                    case 0: value = 0; break;
+                    case 1: value = -1234567; break;
+                    case 2: value = TonalSample(i, c, rng); break;
+                    case 3: value = static_cast<int32_t>(rng() % 16777216) - 8388608; break;
+                    case 4: value = (i + c) % 2 ? 8388607 : -8388608; break;
+                    default: value = (i / 5) % 2 ? 8388607 : -8388607; break;
+                }
+
+                samples[i * numChannels + c] = value;
+            }
+        }
+
+        return samples;
+    }
+
+    bool RoundTrips(const std::vector<int32_t>& samples, size_t numFrames, size_t numChannels, size_t* encodedBytes)
+    {
+        LosslessCodec::Scratch scratch;
+        std::vector<uint8_t> encoded;
+        LosslessCodec::EncodeBlock(samples.data(), numFrames, numChannels, encoded, scratch);
+        *encodedBytes = encoded.size();
+
+        std::vector<int32_t> decoded(numFrames * numChannels, 12345);
+        return LosslessCodec::BlockFrames(encoded.data(), encoded.size()) == numFrames
+            && LosslessCodec::DecodeBlock(encoded.data(), encoded.size(), numChannels, decoded.data(), scratch)
+            && decoded == samples;
+    }
+
+    std::string WriteLosslessFile(const std::filesystem::path& path, const std::vector<int32_t>& samples, uint16_t numChannels, size_t numWorkers)
+    {
+        LosslessWavWriter writer(numWorkers);
+        DOCTEST_REQUIRE(writer.Open(numChannels, path.string(), 48000));
+
+        // Uneven writes, so blocks fill across calls.
+        //
+        size_t numFrames = samples.size() / numChannels;
+        size_t frame = 0;
+        for (size_t step = 1; frame < numFrames; step = step * 3 % 1000 + 1)
+        {
+            size_t count = std::min(step, numFrames - frame);
+            writer.Write(samples.data() + frame * numChannels, count);
+            frame += count;
+        }
+
+        DOCTEST_CHECK(writer.Close());
+        return path.string();
+    }
+
+    std::vector<char> ReadBytes(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 1. Block round trip
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("LosslessCodec: blocks round-trip exactly and tonal material compresses")
+{
+    GlobalEnv::ResetPerTest();
+
+    std::mt19937 rng(7);
+    const size_t lengths[] = {1, 2, 4, 5, 31, 33, 100, 1000, 4095, 4096};
+    for (int kind = 0; kind < 6; ++kind)
+    {
+        for (size_t numFrames : lengths)
+        {
+            for (size_t numChannels : {size_t(1), size_t(3)})
+            {
+                DOCTEST_CAPTURE(kind);
+                DOCTEST_CAPTURE(numFrames);
+                DOCTEST_CAPTURE(numChannels);
+                size_t encodedBytes = 0;
+                DOCTEST_CHECK(RoundTrips(MakeBlock(kind, numFrames, numChannels, rng), numFrames, numChannels, &encodedBytes));
+            }
+        }
+    }
+
+    const size_t n = LosslessCodec::x_blockFrames;
+    const size_t pcmBytes = n * 2 * 3;
+    size_t silence = 0;
+    size_t tonal = 0;
+    size_t noise = 0;
+    DOCTEST_CHECK(RoundTrips(MakeBlock(0, n, 2, rng), n, 2, &silence));
+    DOCTEST_CHECK(RoundTrips(MakeBlock(2, n, 2, rng), n, 2, &tonal));
+    DOCTEST_CHECK(RoundTrips(MakeBlock(3, n, 2, rng), n, 2, &noise));
+    DOCTEST_CHECK(silence < 16);
+    DOCTEST_CHECK(tonal < pcmBytes / 2);
+    DOCTEST_CHECK(noise <= pcmBytes + 16);
+}
+
+// ---------------------------------------------------------------------------
+// 2. Damaged blocks
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("LosslessCodec: truncated and damaged blocks are rejected")
+{
+    GlobalEnv::ResetPerTest();
+
+    std::mt19937 rng(11);
+    const size_t n = 2000;
+    std::vector<int32_t> samples = MakeBlock(2, n, 2, rng);
+    LosslessCodec::Scratch scratch;
+    std::vector<uint8_t> encoded;
+    LosslessCodec::EncodeBlock(samples.data(), n, 2, encoded, scratch);
+
+    std::vector<int32_t> decoded(n * 2);
+    for (size_t size : {size_t(0), size_t(1), size_t(2), size_t(40), encoded.size() / 2, encoded.size() - 1})
+    {
+        DOCTEST_CAPTURE(size);
+        DOCTEST_CHECK_FALSE(LosslessCodec::DecodeBlock(encoded.data(), size, 2, decoded.data(), scratch));
+    }
+
+    // Random damage may still decode (to wrong samples), but only within the block's frame count.
+    //
+    for (int trial = 0; trial < 200; ++trial)
+    {
+        std::vector<uint8_t> damaged = encoded;
+        for (int flips = 0; flips < 4; ++flips)
+        {
+            damaged[2 + rng() % (damaged.size() - 2)] ^= static_cast<uint8_t>(1 + rng() % 255);
+        }
+
+        LosslessCodec::DecodeBlock(damaged.data(), damaged.size(), 2, decoded.data(), scratch);
+    }
+
+    DOCTEST_CHECK(LosslessCodec::DecodeBlock(encoded.data(), encoded.size(), 2, decoded.data(), scratch));
+    DOCTEST_CHECK(decoded == samples);
+}
+
+// ---------------------------------------------------------------------------
+// 3. Files
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("LosslessWavWriter: WavReader reads the file back from any offset")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    DOCTEST_REQUIRE(dir.Valid());
+
+    std::mt19937 rng(3);
+    const uint16_t numChannels = 3;
+    const size_t numFrames = 5 * LosslessCodec::x_blockFrames + 777;
+    std::vector<int32_t> samples = MakeBlock(2, numFrames, numChannels, rng);
+
+    std::string pooled = WriteLosslessFile(dir.Path() / "pooled.sgwav", samples, numChannels, 3);
+    std::string inline_ = WriteLosslessFile(dir.Path() / "inline.sgwav", samples, numChannels, 0);
+    DOCTEST_CHECK(ReadBytes(pooled) == ReadBytes(inline_));
+
+    WavReader reader;
+    DOCTEST_REQUIRE(reader.LoadFromFile(pooled.c_str()));
+    DOCTEST_CHECK(reader.m_format == WavReader::Format::Lossless);
+    DOCTEST_CHECK(reader.m_isRf64);
+    DOCTEST_CHECK(reader.m_numChannels == numChannels);
+    DOCTEST_CHECK(reader.m_sampleRate == 48000);
+    DOCTEST_REQUIRE(reader.m_numFrames == numFrames);
+
+    bool exact = true;
+    for (size_t i = 0; i < numFrames; i += 97)
+    {
+        for (size_t c = 0; c < numChannels; ++c)
+        {
+            exact = exact && reader.GetSample(i, c) == static_cast<float>(samples[i * numChannels + c]) * (1.0f / 8388608.0f);
+        }
+    }
+
+    DOCTEST_CHECK(exact);
+
+    // Ranges straddling blocks and running past the end.
+    //
+    for (size_t first : {size_t(0), size_t(4000), LosslessCodec::x_blockFrames, numFrames - 100})
+    {
+        DOCTEST_CAPTURE(first);
+        std::vector<float> sums(9000, -1.0f);
+        reader.WillNeed(first, sums.size());
+        reader.DecodeLeftRightSum(first, sums.size(), sums.data());
+        bool match = true;
+        for (size_t i = 0; i < sums.size(); ++i)
+        {
+            size_t frame = first + i;
+            float want = frame < numFrames
+                ? static_cast<float>(samples[frame * numChannels]) * (1.0f / 8388608.0f)
+                    + static_cast<float>(samples[frame * numChannels + 1]) * (1.0f / 8388608.0f)
+                : 0.0f;
+            match = match && sums[i] == want;
+        }
+
+        DOCTEST_CHECK(match);
+    }
+
+    // A file cut short loses its seek chunk and does not load.
+    //
+    std::vector<char> bytes = ReadBytes(pooled);
+    std::string truncated = (dir.Path() / "truncated.sgwav").string();
+    {
+        std::ofstream file(truncated, std::ios::binary);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 20));
+    }
+
+    WavReader broken;
+    DOCTEST_CHECK_FALSE(broken.LoadFromFile(truncated.c_str()));
+
+    // A channel count past the recorder's is rejected before it sizes the block buffer, even with a consistent
+    // block align.
+    //
+    size_t fmt = std::string(bytes.begin(), bytes.end()).find("fmt ");
+    DOCTEST_REQUIRE(fmt != std::string::npos);
+    for (uint16_t channels : {uint16_t(0), uint16_t(LosslessCodec::x_maxChannels + 1), uint16_t(21845)})
+    {
+        DOCTEST_CAPTURE(channels);
+        std::vector<char> damaged = bytes;
+        uint16_t blockAlign = static_cast<uint16_t>(channels * 3);
+        std::memcpy(damaged.data() + fmt + 10, &channels, sizeof(channels));
+        std::memcpy(damaged.data() + fmt + 20, &blockAlign, sizeof(blockAlign));
+        std::string path = (dir.Path() / "channels.sgwav").string();
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file.write(damaged.data(), static_cast<std::streamsize>(damaged.size()));
+        }
+
+        DOCTEST_CHECK_FALSE(broken.LoadFromFile(path.c_str()));
+    }
+
+    LosslessWavWriter wide(size_t(0));
+    DOCTEST_CHECK_FALSE(wide.Open(static_cast<uint16_t>(LosslessCodec::x_maxChannels + 1), (dir.Path() / "wide.sgwav").string(), 48000));
+
+    // A lossless file loads only under its own extension.
+    //
+    std::string mislabelled = (dir.Path() / "mislabelled.wav").string();
+    std::filesystem::copy_file(pooled, mislabelled);
+    DOCTEST_CHECK_FALSE(broken.LoadFromFile(mislabelled.c_str()));
+    DOCTEST_CHECK(WavReader::IsLosslessFileName("take.SGWAV"));
+    DOCTEST_CHECK(WavReader::IsReadableFileName("take.Wav"));
+    DOCTEST_CHECK_FALSE(WavReader::IsReadableFileName("take.flac"));
+    DOCTEST_CHECK_FALSE(WavReader::IsReadableFileName(".sgwav"));
+}
+
+// ---------------------------------------------------------------------------
+// 4. Recorders
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("LosslessWavWriter: stems and takes load the same as PCM in less space")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    DOCTEST_REQUIRE(dir.Valid());
+    std::mt19937 rng(5);
+
+    // Stems: a quad of tonal material and a quad left silent, as unused mixer channels are.
+    //
+    const uint16_t numChannels = 8;
+    const size_t numFrames = 6000;
+    std::string pcmPath = (dir.Path() / "pcm.wav").string();
+    std::string losslessPath = (dir.Path() / "lossless.sgwav").string();
+    static StemRecorder pcm;
+    static StemRecorder lossless;
+    DOCTEST_REQUIRE(pcm.Open(numChannels, pcmPath, 48000));
+    DOCTEST_REQUIRE(lossless.Open(numChannels, losslessPath, 48000, true));
+    for (size_t frame = 0; frame < numFrames; ++frame)
+    {
+        float v[4];
+        for (size_t c = 0; c < 4; ++c)
+        {
+            v[c] = static_cast<float>(TonalSample(frame, c, rng)) / 8388607.0f;
+        }
+
+        QuadFloat quad(v[0], v[1], v[2], v[3]);
+        pcm.Write(0, quad);
+        lossless.Write(0, quad);
+        pcm.CommitFrame();
+        lossless.CommitFrame();
+    }
+
+    pcm.Close();
+    lossless.Close();
+    DOCTEST_CHECK_FALSE(pcm.m_error);
+    DOCTEST_CHECK_FALSE(lossless.m_error);
+
+    WavReader pcmReader;
+    WavReader losslessReader;
+    DOCTEST_REQUIRE(pcmReader.LoadFromFile(pcmPath.c_str()));
+    DOCTEST_REQUIRE(losslessReader.LoadFromFile(losslessPath.c_str()));
+    DOCTEST_CHECK(losslessReader.m_format == WavReader::Format::Lossless);
+    DOCTEST_REQUIRE(losslessReader.m_numFrames == numFrames);
+    bool same = true;
+    for (size_t frame = 0; frame < numFrames; ++frame)
+    {
+        for (size_t c = 0; c < numChannels; ++c)
+        {
+            same = same && pcmReader.GetSample(frame, c) == losslessReader.GetSample(frame, c);
+        }
+    }
+
+    DOCTEST_CHECK(same);
+    DOCTEST_CHECK(std::filesystem::file_size(losslessPath) < std::filesystem::file_size(pcmPath) / 2);
+
+    // A take persisted both ways loads into the same AudioBuffer (decoded whole rather than streamed).
+    //
+    auto pool = std::make_unique<RecordingChunkPool>();
+    pool->Refill();
+    RecordingTake take;
+    take.m_pool = pool.get();
+    take.m_head = pool->Acquire();
+    DOCTEST_REQUIRE(take.m_head != nullptr);
+    for (size_t i = 0; i < 50000; ++i)
+    {
+        take.m_head->m_samples[take.m_head->m_size++] = static_cast<float>(TonalSample(i, 0, rng)) / 8388607.0f;
+    }
+
+    take.m_numSamples = take.m_head->m_size;
+    take.m_loopPositionRecordingStop = 1.0;
+    take.m_recordingRepeats = 1;
+    std::string takePcm = (dir.Path() / "take_pcm.wav").string();
+    std::string takeLossless = (dir.Path() / "take_lossless.sgwav").string();
+    DOCTEST_REQUIRE(take.WriteToFile(takePcm.c_str()));
+    take.m_lossless = true;
+    DOCTEST_REQUIRE(take.WriteToFile(takeLossless.c_str()));
+
+    // Encoding on a pool shared with the caller writes the same bytes as inline.
+    //
+    WorkerPool sharedPool(2);
+    std::string takeShared = (dir.Path() / "take_shared.sgwav").string();
+    DOCTEST_REQUIRE(take.WriteToFile(takeShared.c_str(), &sharedPool));
+    DOCTEST_CHECK(ReadBytes(takeShared) == ReadBytes(takeLossless));
+    take.Release();
+
+    // A PCM file under the lossless extension is rejected too.
+    //
+    std::string pcmMislabelled = (dir.Path() / "pcm_mislabelled.sgwav").string();
+    std::filesystem::copy_file(takePcm, pcmMislabelled);
+    WavReader mislabelledReader;
+    DOCTEST_CHECK_FALSE(mislabelledReader.LoadFromFile(pcmMislabelled.c_str()));
+    std::filesystem::remove(pcmMislabelled);
+
+    // A bank lists both kinds, and persisted takes number PCM and lossless files in one sequence.
+    //
+    AudioBufferBank bank;
+    bank.LoadFromDirectory(dir.Path().string().c_str(), "", nullptr);
+    DOCTEST_CHECK(bank.m_audioBuffers.size() == 5);
+
+    std::ofstream(dir.Path() / "_recording_00003.wav").put(0);
+    IoTaskElement persist;
+    std::error_code ec;
+    std::filesystem::path next = persist.MakeNextRecordingFilePath(dir.Path(), LosslessCodec::x_fileExtension, ec);
+    DOCTEST_CHECK(next.filename().string() == "_recording_00004.sgwav");
+
+    AudioBuffer a;
+    AudioBuffer b;
+    a.LoadFromFile(takePcm.c_str(), std::numeric_limits<size_t>::max());
+    b.LoadFromFile(takeLossless.c_str(), std::numeric_limits<size_t>::max());
+    DOCTEST_REQUIRE(a.m_buffer.size() == 50000);
+    DOCTEST_CHECK(a.m_buffer == b.m_buffer);
+    DOCTEST_CHECK(std::filesystem::file_size(takeLossless) < std::filesystem::file_size(takePcm) * 3 / 4);
+}
+
+// ---------------------------------------------------------------------------
+// 5. Benchmark (informational)
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("LosslessWavWriter: benchmark on tonal stems")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    DOCTEST_REQUIRE(dir.Valid());
+    std::mt19937 rng(9);
+    const uint16_t numChannels = 8;
+    const size_t numFrames = 48000 * 10;
+    std::vector<int32_t> samples = MakeBlock(2, numFrames, numChannels, rng);
+
+    auto time = [&](size_t numWorkers, const char* name)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::string path = WriteLosslessFile(dir.Path() / name, samples, numChannels, numWorkers);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return std::make_pair(static_cast<double>(samples.size()) / seconds / 1.0e6, std::filesystem::file_size(path));
+    };
+
+    auto inline_ = time(0, "inline.sgwav");
+    auto pooled = time(WorkerPool::DefaultNumWorkers(), "pooled.sgwav");
+    double ratio = static_cast<double>(pooled.second) / static_cast<double>(sizeof(Rf64Header) + samples.size() * 3);
+
+    DOCTEST_MESSAGE("Lossless stems (" << numChannels << " channels, " << numFrames / 48000 << " s)");
+    DOCTEST_MESSAGE("inline: " << inline_.first << " Msamples/s, " << WorkerPool::DefaultNumWorkers() << " workers: " << pooled.first << " Msamples/s");
+    DOCTEST_MESSAGE("size: " << ratio << " of PCM");
+}
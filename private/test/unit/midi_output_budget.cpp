@@ -0,0 +1,197 @@
+// midi_output_budget.cpp -- unit tests for MIDI output bandwidth limiting (private/src/MidiOutputBudget.hpp)
+//
+// MidiOutputBudget is a per-route byte rate limit: realtime output (clock, encoder feedback) is always
+// charged, and LED colour output spends only what is left.  LPSysexWriter takes a pad limit and keeps
+// pads it could not send pending, coalesced to the latest colour.
+//
+// Tests:
+//   1. Available refills at the configured rate up to the burst allowance; realtime spending can go into debt.
+//   2. Routes are independent, and out-of-range routes have no budget.
+//   3. A pad-limited sysex writer sends the rest later, each pad once, with the last colour written.
+//   4. A full-grid recolour paced by the budget converges without starving realtime traffic.
+
+#include "doctest.h"
+
+#include <map>
+#include <vector>
+
+#include "../support/GlobalEnv.hpp"
+#include "../support/LPSysex.hpp"
+
+#include "SmartGrid.hpp"
+#include "SmartBus.hpp"
+#include "LaunchPadMidi.hpp"
+#include "MidiOutputBudget.hpp"
+
+namespace
+{
+    using SmartGrid::Color;
+    using SmartGrid::MidiOutputBudget;
+    using TestLPSysex::Pad;
+    using TestLPSysex::ParseSysex;
+
+    void PutAndBump(SmartGrid::SmartBusColor& bus, int x, int y, Color c)
+    {
+        bool changed = false;
+        bus.Put(x, y, c, &changed);
+        if (changed)
+        {
+            bus.m_epoch.fetch_add(1);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 1. Refill and debt
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("MidiOutputBudget: refills at the byte rate up to the burst")
+{
+    GlobalEnv::ResetPerTest();
+
+    MidiOutputBudget budget;
+    const size_t burstBytes = MidiOutputBudget::x_burstUs * MidiOutputBudget::x_defaultBytesPerMs / 1000;
+    size_t nowUs = 1000000;
+    DOCTEST_CHECK(budget.Available(0, nowUs) == burstBytes);
+
+    budget.Spend(0, burstBytes, nowUs, MidiOutputBudget::Priority::Bulk);
+    DOCTEST_CHECK(budget.Available(0, nowUs) == 0);
+    DOCTEST_CHECK(budget.Available(0, nowUs + 1000) == MidiOutputBudget::x_defaultBytesPerMs);
+    DOCTEST_CHECK(budget.Available(0, nowUs + 100000) == burstBytes);
+
+    // Realtime traffic is charged even with nothing left, which holds bulk traffic back until it drains.
+    //
+    nowUs += 100000;
+    budget.Spend(0, burstBytes, nowUs, MidiOutputBudget::Priority::Bulk);
+    budget.Spend(0, 3 * MidiOutputBudget::x_defaultBytesPerMs, nowUs, MidiOutputBudget::Priority::Realtime);
+    DOCTEST_CHECK(budget.Available(0, nowUs) == 0);
+    DOCTEST_CHECK(budget.Available(0, nowUs + 2000) == 0);
+    DOCTEST_CHECK(budget.Available(0, nowUs + 4000) == MidiOutputBudget::x_defaultBytesPerMs);
+    DOCTEST_CHECK(budget.GetBytes(0, MidiOutputBudget::Priority::Realtime) == 3 * MidiOutputBudget::x_defaultBytesPerMs);
+    DOCTEST_CHECK(budget.GetBytes(0, MidiOutputBudget::Priority::Bulk) == 2 * burstBytes);
+}
+
+// ---------------------------------------------------------------------------
+// 2. Routes
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("MidiOutputBudget: routes are independent")
+{
+    GlobalEnv::ResetPerTest();
+
+    MidiOutputBudget budget;
+    const size_t burstBytes = MidiOutputBudget::x_burstUs * MidiOutputBudget::x_defaultBytesPerMs / 1000;
+    budget.Spend(2, 10 * burstBytes, 0, MidiOutputBudget::Priority::Realtime);
+    DOCTEST_CHECK(budget.Available(2, 0) == 0);
+    DOCTEST_CHECK(budget.Available(3, 0) == burstBytes);
+
+    DOCTEST_CHECK(budget.Available(-1, 0) == 0);
+    DOCTEST_CHECK(budget.Available(MidiOutputBudget::x_maxRoutes, 0) == 0);
+    budget.Spend(-1, 100, 0, MidiOutputBudget::Priority::Realtime);
+
+    budget.Defer(3);
+    budget.Defer(3);
+    DOCTEST_CHECK(budget.GetDeferredCount(3) == 2);
+    DOCTEST_CHECK(budget.GetDeferredCount(2) == 0);
+}
+
+// ---------------------------------------------------------------------------
+// 3. Pad-limited writes coalesce
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("LPSysexWriter: pads over the limit stay pending with their latest colour")
+{
+    GlobalEnv::ResetPerTest();
+
+    static SmartGrid::SmartBusColor bus;
+    static uint8_t buffer[SmartGrid::LPSysexWriter::x_maxMessageSize];
+    SmartGrid::LPSysexWriter writer(SmartGrid::ControllerShape::LaunchPadX, &bus);
+    writer.Write(buffer);
+    DOCTEST_CHECK_FALSE(writer.HasPending());
+
+    DOCTEST_CHECK(SmartGrid::LPSysexWriter::PadsForBytes(0) == 0);
+    DOCTEST_CHECK(SmartGrid::LPSysexWriter::PadsForBytes(8 + 2 * 5) == 2);
+    DOCTEST_CHECK(SmartGrid::LPSysexWriter::PadsForBytes(8 + 2 * 5 + 4) == 2);
+
+    for (int y = 0; y < 5; ++y)
+    {
+        PutAndBump(bus, 0, y, Color(20, 0, 0));
+    }
+
+    DOCTEST_CHECK(writer.Write(buffer, 0) == 0);
+    DOCTEST_CHECK(writer.HasPending());
+
+    size_t size = writer.Write(buffer, 2);
+    DOCTEST_CHECK(size == 8 + 2 * 5);
+    DOCTEST_CHECK(ParseSysex(buffer, size).size() == 2);
+    DOCTEST_CHECK(writer.HasPending());
+
+    // A pending pad recoloured twice goes out once, with the last colour.
+    //
+    PutAndBump(bus, 0, 4, Color(40, 0, 0));
+    PutAndBump(bus, 0, 4, Color(80, 0, 0));
+    std::vector<Pad> pads = ParseSysex(buffer, writer.Write(buffer, 2));
+    DOCTEST_CHECK(pads.size() == 2);
+    pads = ParseSysex(buffer, writer.Write(buffer, 2));
+    DOCTEST_REQUIRE(pads.size() == 1);
+    DOCTEST_CHECK(pads[0].m_note == SmartGrid::LPMidi::PosToNote(0, 4));
+    DOCTEST_CHECK(pads[0].m_red == 40);
+    DOCTEST_CHECK_FALSE(writer.HasPending());
+    DOCTEST_CHECK(writer.Write(buffer, 2) == 0);
+}
+
+// ---------------------------------------------------------------------------
+// 4. Paced full recolour
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("LPSysexWriter + MidiOutputBudget: a full recolour converges at the byte rate")
+{
+    GlobalEnv::ResetPerTest();
+
+    static SmartGrid::SmartBusColor bus;
+    static uint8_t buffer[SmartGrid::LPSysexWriter::x_maxMessageSize];
+    SmartGrid::LPSysexWriter writer(SmartGrid::ControllerShape::LaunchPadX, &bus);
+    MidiOutputBudget budget;
+    const int route = 1;
+
+    // Frames every 5 ms, each with a 3-byte encoder message charged first.
+    //
+    size_t nowUs = 0;
+    size_t frames = 0;
+    size_t bulkBytes = 0;
+    std::map<uint8_t, uint8_t> seen;
+    while (true)
+    {
+        budget.Spend(route, 3, nowUs, MidiOutputBudget::Priority::Realtime);
+        size_t available = budget.Available(route, nowUs);
+        size_t size = writer.Write(buffer, SmartGrid::LPSysexWriter::PadsForBytes(available));
+        DOCTEST_CHECK(size <= available);
+        if (size > 0)
+        {
+            budget.Spend(route, size, nowUs, MidiOutputBudget::Priority::Bulk);
+            bulkBytes += size;
+            for (auto& pad : ParseSysex(buffer, size))
+            {
+                DOCTEST_CHECK(seen.count(pad.m_note) == 0);
+                seen[pad.m_note] = pad.m_red;
+            }
+        }
+
+        ++frames;
+        nowUs += 5000;
+        if (!writer.HasPending() || frames > 1000)
+        {
+            break;
+        }
+    }
+
+    DOCTEST_CHECK_FALSE(writer.HasPending());
+    DOCTEST_CHECK(seen.size() == 81);
+    DOCTEST_CHECK(frames > 1);
+    DOCTEST_CHECK(budget.GetBytes(route, MidiOutputBudget::Priority::Realtime) == 3 * frames);
+
+    // The link never ran more than the burst allowance ahead of real time.
+    //
+    size_t totalBytes = bulkBytes + 3 * frames;
+    DOCTEST_CHECK(totalBytes * 1000 / MidiOutputBudget::x_defaultBytesPerMs <= nowUs + MidiOutputBudget::x_burstUs);
+}
@@ -0,0 +1,228 @@
+// midi_send_scheduler.cpp -- unit tests for MidiSendScheduler (private/src/MidiSendScheduler.hpp)
+//
+// MidiSender's realtime thread drives this scheduler: Dispatch(now) sends what is due, WaitUntil sleeps
+// until the next due time or a Push.
+//
+// Tests:
+//   1. Messages go out at timestamp plus latency, immediate ones first, in order, one burst per route.
+//   2. NextDueUs tracks the heap, and late dispatch shows up in the send jitter metrics.
+//   3. A sender sleeping with a far deadline wakes on Push; one with nothing pushed times out.
+//   4. A push due after the sleeper's deadline does not signal; one due before it does.
+
+#include "doctest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../support/GlobalEnv.hpp"
+
+#include "MidiSendScheduler.hpp"
+
+namespace
+{
+    struct BurstSink
+    {
+        struct Burst
+        {
+            int m_routeId;
+            std::vector<uint8_t> m_notes;
+        };
+
+        std::vector<Burst> m_bursts;
+
+        void SendBurst(int routeId, const SmartGrid::BasicMidi* msgs, size_t count)
+        {
+            Burst burst;
+            burst.m_routeId = routeId;
+            for (size_t i = 0; i < count; ++i)
+            {
+                DOCTEST_CHECK(msgs[i].m_routeId == routeId);
+                burst.m_notes.push_back(msgs[i].m_msg[1]);
+            }
+
+            m_bursts.push_back(burst);
+        }
+    };
+
+    SmartGrid::BasicMidi Note(size_t timestamp, int routeId, uint8_t note)
+    {
+        return SmartGrid::BasicMidi(timestamp, routeId, 0x90, note, 100);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 1. Due times, ordering and per-route bursts
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("MidiSendScheduler: sends due messages in order, one burst per route")
+{
+    GlobalEnv::ResetPerTest();
+
+    SmartGrid::MidiSendScheduler scheduler(10000);
+    scheduler.Push(Note(5000, 1, 3));
+    scheduler.Push(Note(1000, 2, 1));
+    scheduler.Push(Note(1000, 1, 2));
+    scheduler.Push(Note(0, 1, 0));
+    scheduler.Push(Note(1000, 2, 4));
+    scheduler.Push(Note(9000, 3, 5));
+
+    BurstSink sink;
+    DOCTEST_CHECK(scheduler.Dispatch(10999, &sink) == 1);
+    DOCTEST_REQUIRE(sink.m_bursts.size() == 1);
+    DOCTEST_CHECK(sink.m_bursts[0].m_routeId == 1);
+    DOCTEST_CHECK(sink.m_bursts[0].m_notes == std::vector<uint8_t>{0});
+
+    sink.m_bursts.clear();
+    DOCTEST_CHECK(scheduler.Dispatch(15000, &sink) == 4);
+    DOCTEST_REQUIRE(sink.m_bursts.size() == 2);
+    DOCTEST_CHECK(sink.m_bursts[0].m_routeId == 1);
+    DOCTEST_CHECK(sink.m_bursts[0].m_notes == std::vector<uint8_t>{2, 3});
+    DOCTEST_CHECK(sink.m_bursts[1].m_routeId == 2);
+    DOCTEST_CHECK(sink.m_bursts[1].m_notes == std::vector<uint8_t>{1, 4});
+
+    sink.m_bursts.clear();
+    DOCTEST_CHECK(scheduler.Dispatch(18999, &sink) == 0);
+    DOCTEST_CHECK(sink.m_bursts.empty());
+    DOCTEST_CHECK(scheduler.Dispatch(19000, &sink) == 1);
+    DOCTEST_CHECK(scheduler.NextDueUs() == SmartGrid::MidiSendScheduler::x_never);
+
+    // A long run on one route is split at x_maxBurst.
+    //
+    for (size_t i = 0; i < SmartGrid::MidiSendScheduler::x_maxBurst + 10; ++i)
+    {
+        scheduler.Push(Note(20000, 4, static_cast<uint8_t>(i)));
+    }
+
+    sink.m_bursts.clear();
+    scheduler.Dispatch(30000, &sink);
+    DOCTEST_REQUIRE(sink.m_bursts.size() == 2);
+    DOCTEST_CHECK(sink.m_bursts[0].m_notes.size() == SmartGrid::MidiSendScheduler::x_maxBurst);
+    DOCTEST_CHECK(sink.m_bursts[1].m_notes.size() == 10);
+    DOCTEST_CHECK(sink.m_bursts[1].m_notes.back() == SmartGrid::MidiSendScheduler::x_maxBurst + 9);
+}
+
+// ---------------------------------------------------------------------------
+// 2. Next due time and send jitter
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("MidiSendScheduler: next due time and send jitter metrics")
+{
+    GlobalEnv::ResetPerTest();
+
+    SmartGrid::MidiSendScheduler scheduler(2000);
+    DOCTEST_CHECK(scheduler.NextDueUs() == SmartGrid::MidiSendScheduler::x_never);
+
+    scheduler.Push(Note(7000, 0, 1));
+    scheduler.Push(Note(3000, 0, 2));
+    DOCTEST_CHECK(scheduler.NextDueUs() == 5000);
+
+    BurstSink sink;
+    scheduler.Dispatch(5000, &sink);
+    DOCTEST_CHECK(scheduler.m_metrics.m_maxJitterUs == 0);
+    DOCTEST_CHECK(scheduler.NextDueUs() == 9000);
+
+    scheduler.Dispatch(9400, &sink);
+    DOCTEST_CHECK(scheduler.m_metrics.m_maxJitterUs == 400);
+    DOCTEST_CHECK(scheduler.m_metrics.m_jitterUs == doctest::Approx(25.0f));
+    DOCTEST_CHECK(scheduler.m_metrics.m_sentCount == 2);
+    DOCTEST_CHECK(scheduler.m_metrics.m_burstCount == 2);
+
+    // Messages for unallocated routes are dropped.
+    //
+    scheduler.Push(Note(0, -1, 9));
+    scheduler.Push(Note(0, 16, 9));
+    DOCTEST_CHECK(scheduler.Dispatch(10000, &sink) == 0);
+    DOCTEST_CHECK(scheduler.NextDueUs() == SmartGrid::MidiSendScheduler::x_never);
+}
+
+// ---------------------------------------------------------------------------
+// 3. Wake on push
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("MidiSendScheduler: a push wakes the sleeping sender")
+{
+    GlobalEnv::ResetPerTest();
+
+    static SmartGrid::MidiSendScheduler scheduler(0);
+    DOCTEST_CHECK_FALSE(scheduler.WaitUntil(0, 2000));
+
+    std::atomic<bool> woken(false);
+    std::thread sender([&woken]()
+    {
+        // Ten seconds: only the push can end this wait within the test.
+        //
+        woken.store(scheduler.WaitUntil(0, 10 * 1000 * 1000));
+    });
+
+    while (!scheduler.m_wake.m_sleeping.load())
+    {
+        std::this_thread::yield();
+    }
+
+    scheduler.Push(Note(0, 0, 1));
+    sender.join();
+    DOCTEST_CHECK(woken.load());
+
+    // A message already queued means there is no sleep at all.
+    //
+    DOCTEST_CHECK(scheduler.WaitUntil(0, 10 * 1000 * 1000));
+
+    BurstSink sink;
+    DOCTEST_CHECK(scheduler.Dispatch(0, &sink) == 1);
+}
+
+// ---------------------------------------------------------------------------
+// 4. Only pushes due before the deadline wake
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("MidiSendScheduler: only a push due before the sleeper's deadline signals")
+{
+    GlobalEnv::ResetPerTest();
+
+    static SmartGrid::MidiSendScheduler scheduler(1000);
+
+    // Sleeping until 300 ms: a message due at 1 s leaves the sender asleep, one due at 2 ms wakes it.
+    //
+    std::atomic<bool> woken(false);
+    std::thread sender([&woken]()
+    {
+        woken.store(scheduler.WaitUntil(0, 300 * 1000));
+    });
+
+    while (!scheduler.m_wake.m_sleeping.load())
+    {
+        std::this_thread::yield();
+    }
+
+    scheduler.Push(Note(1000 * 1000, 0, 1));
+    DOCTEST_CHECK(scheduler.m_wake.m_notifyCount.load() == 0);
+    DOCTEST_CHECK_FALSE(scheduler.m_wake.m_pending.load());
+    sender.join();
+    DOCTEST_CHECK_FALSE(woken.load());
+    DOCTEST_CHECK(scheduler.m_deadlineUs.load() == 0);
+
+    // The message due at 1 s is pending now, so the next sleep must end before it.
+    //
+    sender = std::thread([&woken]()
+    {
+        woken.store(scheduler.WaitUntil(0, 500 * 1000));
+    });
+
+    while (!scheduler.m_wake.m_sleeping.load())
+    {
+        std::this_thread::yield();
+    }
+
+    scheduler.Push(Note(1000, 0, 2));
+    sender.join();
+    DOCTEST_CHECK(woken.load());
+
+    // Awake, a push never signals: the sender drains before it sleeps.
+    //
+    scheduler.Push(Note(0, 0, 3));
+    DOCTEST_CHECK_FALSE(scheduler.m_wake.m_pending.load());
+
+    BurstSink sink;
+    DOCTEST_CHECK(scheduler.Dispatch(1000 * 1000 + 1000, &sink) == 3);
+}
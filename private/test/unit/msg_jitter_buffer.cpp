@@ -0,0 +1,308 @@
+// msg_jitter_buffer.cpp -- unit tests for the MessageInBus de-jitter scheduler (private/src/MessageInBus.hpp,
+// MessageInLatency.hpp)
+//
+// The bus measures, per route, the delay between each message's source timestamp and the first poll that
+// sees it, and releases the message at source time plus the smallest latency that keeps the late fraction
+// under the target.  The simulations below push each message when its arrival time passes and poll the
+// bus once per sample, as the audio thread does.
+//
+// Tests:
+//   1. A route starts at the fixed latency, then settles just above its measured delays; on-time messages
+//      release on the first sample at or after source time plus latency.
+//   2. The late target picks the delay quantile, and spikes above the chosen latency are counted late.
+//   3. Routes adapt independently, and a low-latency route is not held behind a high-latency one.
+//   4. Fixed mode keeps the latency and reports late arrivals; a latency drop never reorders a route.
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "../support/GlobalEnv.hpp"
+
+#include "BitSet.hpp"
+#include "MessageIn.hpp"
+#include "MessageInBus.hpp"
+#include "MessageInLatency.hpp"
+
+namespace
+{
+    using SmartGrid::MessageIn;
+    using SmartGrid::MessageInBus;
+    using SmartGrid::MessageInLatency;
+
+    struct Arrival
+    {
+        size_t m_sourceUs;
+        size_t m_arrivalUs;
+        int m_routeId;
+        int m_index;
+    };
+
+    struct Release
+    {
+        int m_routeId;
+        int m_index;
+        size_t m_timestamp;
+        size_t m_pollUs;
+    };
+
+    struct Recorder
+    {
+        std::vector<Release> m_releases;
+        size_t m_pollUs = 0;
+
+        void Apply(MessageIn msg)
+        {
+            m_releases.push_back(Release{msg.m_routeId, msg.m_x, msg.m_timestamp, m_pollUs});
+        }
+    };
+
+    size_t SampleTimeUs(size_t sample)
+    {
+        return sample * 1000 * 1000 / 48000;
+    }
+
+    // Pushes each arrival (sorted by arrival time) once its arrival time has passed, polling every sample
+    // until endUs.
+    //
+    void Simulate(MessageInBus& bus, const std::vector<Arrival>& arrivals, size_t endUs, Recorder& recorder)
+    {
+        size_t next = 0;
+        for (size_t sample = 0; SampleTimeUs(sample) <= endUs; ++sample)
+        {
+            size_t nowUs = SampleTimeUs(sample);
+            while (next < arrivals.size() && arrivals[next].m_arrivalUs <= nowUs)
+            {
+                const Arrival& a = arrivals[next];
+                bus.Push(MessageIn(a.m_sourceUs, a.m_routeId, MessageIn::Mode::PadPress, a.m_index, 0));
+                ++next;
+            }
+
+            recorder.m_pollUs = nowUs;
+            bus.ProcessMessages(&recorder, nowUs);
+        }
+    }
+
+    // One message every periodUs on routeId, delayed by baseUs plus a deterministic spread in [0, spreadUs).
+    //
+    std::vector<Arrival> Periodic(int routeId, size_t count, size_t startUs, size_t periodUs, size_t baseUs, size_t spreadUs)
+    {
+        std::vector<Arrival> arrivals;
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t sourceUs = startUs + i * periodUs;
+            size_t delayUs = baseUs + (i * 7919) % spreadUs;
+            arrivals.push_back(Arrival{sourceUs, sourceUs + delayUs, routeId, static_cast<int>(i)});
+        }
+
+        return arrivals;
+    }
+
+    size_t MaxDelayUs(const std::vector<Arrival>& arrivals, int routeId)
+    {
+        size_t maxDelayUs = 0;
+        for (const Arrival& a : arrivals)
+        {
+            if (a.m_routeId == routeId)
+            {
+                maxDelayUs = std::max(maxDelayUs, a.m_arrivalUs - a.m_sourceUs);
+            }
+        }
+
+        return maxDelayUs;
+    }
+
+    void SortByArrival(std::vector<Arrival>& arrivals)
+    {
+        std::stable_sort(arrivals.begin(), arrivals.end(), [](const Arrival& a, const Arrival& b)
+        {
+            return a.m_arrivalUs < b.m_arrivalUs;
+        });
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 1. Warm-up, then settle just above the measured delays.
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("MessageInBus: adaptive latency settles above the measured delays")
+{
+    GlobalEnv::ResetPerTest();
+
+    MessageInBus bus;
+    std::vector<Arrival> arrivals = Periodic(2, 600, 100000, 5000, 300, 900);
+    Recorder recorder;
+    Simulate(bus, arrivals, 100000 + 600 * 5000 + 30000, recorder);
+
+    DOCTEST_REQUIRE(recorder.m_releases.size() == arrivals.size());
+
+    // Settled below the fixed warm-up latency but still covering every measured delay, so nothing is late.
+    //
+    const MessageInLatency::Metrics& metrics = bus.GetMetrics(2);
+    DOCTEST_CHECK(metrics.m_messageCount == arrivals.size());
+    DOCTEST_CHECK(metrics.m_lateCount == 0);
+    DOCTEST_CHECK(metrics.m_latencyUs >= MaxDelayUs(arrivals, 2));
+    DOCTEST_CHECK(metrics.m_latencyUs < MessageInLatency::x_latencyUs);
+    DOCTEST_CHECK(metrics.m_jitterUs > 0.0f);
+    DOCTEST_CHECK(metrics.m_jitterUs < 900.0f);
+
+    // The first messages use the fixed latency.  Every release lands on the first sample at or after its
+    // scheduled time.
+    //
+    DOCTEST_CHECK(recorder.m_releases[0].m_timestamp == arrivals[0].m_sourceUs + MessageInLatency::x_latencyUs);
+    for (size_t i = 0; i < recorder.m_releases.size(); ++i)
+    {
+        const Release& release = recorder.m_releases[i];
+        DOCTEST_CHECK(release.m_index == static_cast<int>(i));
+        DOCTEST_CHECK(release.m_pollUs >= release.m_timestamp);
+        DOCTEST_CHECK(release.m_pollUs - release.m_timestamp <= 21);
+    }
+
+    DOCTEST_CHECK(recorder.m_releases.back().m_timestamp == arrivals.back().m_sourceUs + metrics.m_latencyUs);
+}
+
+// ---------------------------------------------------------------------------
+// 2. The late target picks the delay quantile.
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("MessageInBus: late target trades latency against late messages")
+{
+    GlobalEnv::ResetPerTest();
+
+    // 3% of messages are delayed by 8 ms, the rest by at most 1 ms.
+    //
+    std::vector<Arrival> arrivals = Periodic(0, 2000, 50000, 10000, 100, 900);
+    size_t bodyDelayUs = MaxDelayUs(arrivals, 0);
+    size_t spikeCount = 0;
+    for (size_t i = 0; i < arrivals.size(); i += 33)
+    {
+        arrivals[i].m_arrivalUs = arrivals[i].m_sourceUs + 8000;
+        ++spikeCount;
+    }
+
+    MessageInBus loose;
+    loose.SetAdaptiveLatency(0.05f);
+    Recorder looseRecorder;
+    Simulate(loose, arrivals, 50000 + 2000 * 10000 + 30000, looseRecorder);
+
+    MessageInBus strict;
+    strict.SetAdaptiveLatency(0.01f);
+    Recorder strictRecorder;
+    Simulate(strict, arrivals, 50000 + 2000 * 10000 + 30000, strictRecorder);
+
+    DOCTEST_CHECK(looseRecorder.m_releases.size() == arrivals.size());
+    DOCTEST_CHECK(strictRecorder.m_releases.size() == arrivals.size());
+
+    // Loose: the latency covers the 1 ms body but not the spikes, so only spikes arrive late, and they are
+    // still delivered.
+    //
+    const MessageInLatency::Metrics& looseMetrics = loose.GetMetrics(0);
+    DOCTEST_CHECK(looseMetrics.m_latencyUs >= bodyDelayUs);
+    DOCTEST_CHECK(looseMetrics.m_latencyUs < 8000);
+    DOCTEST_CHECK(looseMetrics.m_lateCount > 0);
+    DOCTEST_CHECK(looseMetrics.m_lateCount <= spikeCount);
+
+    // Strict: the spikes are over 1% so the latency has to cover them, and fewer messages are late.
+    //
+    const MessageInLatency::Metrics& strictMetrics = strict.GetMetrics(0);
+    DOCTEST_CHECK(strictMetrics.m_latencyUs >= 8000);
+    DOCTEST_CHECK(strictMetrics.m_latencyUs < MessageInLatency::x_latencyUs);
+    DOCTEST_CHECK(strictMetrics.m_lateCount < looseMetrics.m_lateCount);
+}
+
+// ---------------------------------------------------------------------------
+// 3. Routes adapt independently.
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("MessageInBus: routes adapt independently and do not block each other")
+{
+    GlobalEnv::ResetPerTest();
+
+    std::vector<Arrival> arrivals = Periodic(0, 400, 10000, 3000, 200, 400);
+    std::vector<Arrival> slow = Periodic(1, 150, 10500, 12000, 1000, 9000);
+    arrivals.insert(arrivals.end(), slow.begin(), slow.end());
+    SortByArrival(arrivals);
+
+    MessageInBus bus;
+    Recorder recorder;
+    Simulate(bus, arrivals, 10500 + 150 * 12000 + 30000, recorder);
+    DOCTEST_REQUIRE(recorder.m_releases.size() == arrivals.size());
+
+    // The fast route settles at or below the slow route's smallest delay, so it cannot be waiting on that route.
+    //
+    size_t fastLatency = bus.GetMetrics(0).m_latencyUs;
+    size_t slowLatency = bus.GetMetrics(1).m_latencyUs;
+    DOCTEST_CHECK(fastLatency >= MaxDelayUs(arrivals, 0));
+    DOCTEST_CHECK(fastLatency <= 1000);
+    DOCTEST_CHECK(slowLatency > fastLatency);
+    DOCTEST_CHECK(bus.GetMetrics(1).m_jitterUs > bus.GetMetrics(0).m_jitterUs);
+
+    // Route 0 messages are released on schedule even while older route 1 messages are still waiting, and
+    // each route keeps its own order.
+    //
+    int nextIndex[2] = {0, 0};
+    for (const Release& release : recorder.m_releases)
+    {
+        DOCTEST_CHECK(release.m_index == nextIndex[release.m_routeId]);
+        ++nextIndex[release.m_routeId];
+        if (release.m_routeId == 0)
+        {
+            DOCTEST_CHECK(release.m_pollUs - release.m_timestamp <= 21);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 4. Fixed mode, and no reordering when the latency drops.
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("MessageInBus: fixed latency mode and in-order release")
+{
+    GlobalEnv::ResetPerTest();
+
+    std::vector<Arrival> arrivals = Periodic(3, 200, 20000, 10000, 500, 2000);
+    arrivals[150].m_arrivalUs = arrivals[150].m_sourceUs + 7000;
+
+    MessageInBus bus;
+    bus.SetFixedLatency(5000);
+    Recorder recorder;
+    Simulate(bus, arrivals, 20000 + 200 * 10000 + 30000, recorder);
+    DOCTEST_REQUIRE(recorder.m_releases.size() == arrivals.size());
+
+    const MessageInLatency::Metrics& metrics = bus.GetMetrics(3);
+    DOCTEST_CHECK(metrics.m_latencyUs == 5000);
+    DOCTEST_CHECK(metrics.m_lateCount == 1);
+    for (const Release& release : recorder.m_releases)
+    {
+        if (release.m_index != 150)
+        {
+            DOCTEST_CHECK(release.m_timestamp == 20000 + release.m_index * 10000 + 5000);
+            DOCTEST_CHECK(release.m_pollUs - release.m_timestamp <= 21);
+        }
+    }
+
+    // Adaptive warm-up: every message in a burst waits for the fixed latency.  Once the latency drops, a
+    // message with an earlier source time plus the new latency still releases after the burst.
+    //
+    MessageInBus adaptive;
+    for (int i = 0; i < 70; ++i)
+    {
+        adaptive.Push(MessageIn(1000 + i, 4, MessageIn::Mode::PadPress, i, 0));
+    }
+
+    Recorder burst;
+    burst.m_pollUs = 1100;
+    adaptive.ProcessMessages(&burst, 1100);
+    DOCTEST_CHECK(burst.m_releases.empty());
+    DOCTEST_CHECK(adaptive.GetMetrics(4).m_latencyUs < MessageInLatency::x_latencyUs);
+
+    adaptive.Push(MessageIn(1090, 4, MessageIn::Mode::PadPress, 70, 0));
+    burst.m_pollUs = 1000 + 69 + MessageInLatency::x_latencyUs;
+    adaptive.ProcessMessages(&burst, burst.m_pollUs);
+    DOCTEST_REQUIRE(burst.m_releases.size() == 71);
+    for (int i = 0; i < 71; ++i)
+    {
+        DOCTEST_CHECK(burst.m_releases[i].m_index == i);
+    }
+}
@@ -0,0 +1,208 @@
+// patch_binary.cpp -- unit tests for binary patch files (private/src/PatchBinary.hpp)
+//
+// A binary patch is a JSON tree flattened into node, entry and string tables.  Decoding is a table walk into a
+// JsonArena, and converting JSON -> binary -> JSON must give back the same tree.
+//
+// Tests:
+//   1. Every value type, nesting, member order, duplicate keys, escapes and bit-exact reals round-trip;
+//      repeated keys are stored once.
+//   2. Truncated, corrupted, wrong-version and cyclic data is rejected instead of decoded.
+//   3. LoadFile reads binary patches and falls back to JSON text; arena exhaustion is reported as Failed().
+
+#include "doctest.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../support/TempDir.hpp"
+
+#include "PatchBinary.hpp"
+
+namespace
+{
+    std::string Dump(JSON json)
+    {
+        char* dumped = json.Dumps(0);
+        std::string result = dumped ? dumped : "";
+        free(dumped);
+        return result;
+    }
+
+    JSON BuildSample(JsonArena& a)
+    {
+        JSON root = a.Object();
+        root.SetNew("name", a.String("quote \" slash \\ tab \t unicode \xc3\xa9"));
+        root.SetNew("int", a.Integer(-1234567890123LL));
+        root.SetNew("real", a.Real(0.1));
+        root.SetNew("tiny", a.Real(std::numeric_limits<double>::denorm_min()));
+        root.SetNew("wholeReal", a.Real(3.0));
+        root.SetNew("yes", a.Boolean(true));
+        root.SetNew("no", a.Boolean(false));
+        root.SetNew("nothing", JSON::Null());
+        root.SetNew("empty", a.String(""));
+        root.SetNew("emptyArray", a.Array());
+        root.SetNew("emptyObject", a.Object());
+
+        JSON scenes = a.Array();
+        for (int scene = 0; scene < 8; ++scene)
+        {
+            JSON sceneJ = a.Object();
+            sceneJ.SetNew("value", a.Real(static_cast<double>(scene) / 7.0));
+            sceneJ.SetNew("gestures", a.Integer(scene * 3));
+            JSON routes = a.Array();
+            routes.Append(a.Integer(scene));
+            routes.Append(a.Array());
+            sceneJ.SetNew("routes", routes);
+            scenes.Append(sceneJ);
+        }
+
+        root.SetNew("scenes", scenes);
+        root.SetNew("int", a.Integer(7));
+        return root;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 1. Round trip
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("PatchBinary: JSON round-trips through the binary format")
+{
+    JsonArena source(1 << 16);
+    JSON root = BuildSample(source);
+    DOCTEST_REQUIRE_FALSE(source.Failed());
+
+    std::vector<uint8_t> bytes;
+    DOCTEST_REQUIRE(PatchBinary::Encode(root, bytes));
+    DOCTEST_CHECK(PatchBinary::IsBinary(bytes.data(), bytes.size()));
+
+    JsonArena target(1 << 16);
+    JSON decoded = PatchBinary::Decode(bytes.data(), bytes.size(), target);
+    DOCTEST_REQUIRE_FALSE(decoded.IsNull());
+    DOCTEST_CHECK(Dump(decoded) == Dump(root));
+
+    // Types and exact values, not just the text.
+    //
+    DOCTEST_CHECK(decoded.Get("real").RealValue() == 0.1);
+    DOCTEST_CHECK(decoded.Get("tiny").RealValue() == std::numeric_limits<double>::denorm_min());
+    DOCTEST_CHECK(decoded.Get("wholeReal").m_node->m_type == JsonType::Real);
+    DOCTEST_CHECK(decoded.Get("int").IntegerValue() == static_cast<int>(-1234567890123LL));
+    DOCTEST_CHECK(decoded.Get("nothing").IsNull());
+    DOCTEST_CHECK(decoded.Size() == root.Size());
+    DOCTEST_CHECK(decoded.Get("scenes").GetAt(5).Get("value").RealValue() == 5.0 / 7.0);
+
+    // Binary -> JSON text -> binary -> JSON text is stable.
+    //
+    JsonArena reparsed(1 << 16);
+    std::vector<uint8_t> again;
+    DOCTEST_REQUIRE(PatchBinary::Encode(reparsed.Loads(Dump(decoded).c_str()), again));
+    JsonArena redecoded(1 << 16);
+    DOCTEST_CHECK(Dump(PatchBinary::Decode(again.data(), again.size(), redecoded)) == Dump(root));
+
+    // The duplicate "int" key is kept in place, and the decoded tree is an ordinary, growable tree.
+    //
+    const JsonMember* members = static_cast<const JsonMember*>(decoded.m_node->m_container.m_entries);
+    DOCTEST_CHECK(std::strcmp(members[decoded.Size() - 1].m_key, "int") == 0);
+    decoded.SetNew("added", target.Integer(1));
+    DOCTEST_CHECK(decoded.Get("added").IntegerValue() == 1);
+
+    // "value", "gestures" and "routes" appear once in the string table, not once per scene.
+    //
+    std::string strings(bytes.end() - reinterpret_cast<const PatchBinary::Header*>(bytes.data())->m_stringBytes, bytes.end());
+    DOCTEST_CHECK(strings.find("gestures") == strings.rfind("gestures"));
+
+    DOCTEST_CHECK_FALSE(PatchBinary::Encode(JSON::Null(), bytes));
+}
+
+// ---------------------------------------------------------------------------
+// 2. Validation
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("PatchBinary: corrupt data is rejected")
+{
+    JsonArena source(1 << 16);
+    std::vector<uint8_t> bytes;
+    DOCTEST_REQUIRE(PatchBinary::Encode(BuildSample(source), bytes));
+    PatchBinary::Header header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    JsonArena target(1 << 16);
+    auto decodes = [&target](const std::vector<uint8_t>& data)
+    {
+        target.Reset();
+        return !PatchBinary::Decode(data.data(), data.size(), target).IsNull();
+    };
+
+    DOCTEST_REQUIRE(decodes(bytes));
+
+    std::vector<uint8_t> truncated(bytes.begin(), bytes.end() - 1);
+    DOCTEST_CHECK_FALSE(decodes(truncated));
+
+    std::vector<uint8_t> badMagic = bytes;
+    badMagic[0] = 'X';
+    DOCTEST_CHECK_FALSE(decodes(badMagic));
+
+    std::vector<uint8_t> badVersion = bytes;
+    badVersion[8] = static_cast<uint8_t>(PatchBinary::x_version + 1);
+    DOCTEST_CHECK_FALSE(decodes(badVersion));
+
+    // Point the root object's first child back at the root.
+    //
+    size_t entriesOffset = sizeof(PatchBinary::Header) + header.m_numNodes * sizeof(PatchBinary::Node);
+    PatchBinary::Node rootNode;
+    std::memcpy(&rootNode, bytes.data() + sizeof(PatchBinary::Header), sizeof(rootNode));
+    std::vector<uint8_t> cyclic = bytes;
+    uint32_t self = 0;
+    std::memcpy(cyclic.data() + entriesOffset + (rootNode.m_value + 1) * sizeof(uint32_t), &self, sizeof(self));
+    DOCTEST_CHECK_FALSE(decodes(cyclic));
+
+    // A container running past the entry table.
+    //
+    std::vector<uint8_t> overrun = bytes;
+    rootNode.m_count = header.m_numEntries;
+    std::memcpy(overrun.data() + sizeof(PatchBinary::Header), &rootNode, sizeof(rootNode));
+    DOCTEST_CHECK_FALSE(decodes(overrun));
+
+    // An unknown node type.
+    //
+    std::vector<uint8_t> badType = bytes;
+    badType[sizeof(PatchBinary::Header) + sizeof(PatchBinary::Node)] = 0x7f;
+    DOCTEST_CHECK_FALSE(decodes(badType));
+}
+
+// ---------------------------------------------------------------------------
+// 3. Files and fallback
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("PatchBinary: LoadFile reads binary patches and falls back to JSON text")
+{
+    synthrig::TempDir dir;
+    JsonArena source(1 << 16);
+    JSON root = BuildSample(source);
+
+    std::string binaryPath = (dir.Path() / (std::string("patch") + PatchBinary::x_extension)).string();
+    DOCTEST_REQUIRE(PatchBinary::WriteFile(binaryPath.c_str(), root));
+
+    std::string jsonPath = (dir.Path() / "patch.json").string();
+    {
+        std::ofstream out(jsonPath);
+        out << Dump(root);
+    }
+
+    JsonArena target(1 << 16);
+    DOCTEST_CHECK(Dump(PatchBinary::LoadFile(binaryPath.c_str(), target)) == Dump(root));
+    target.Reset();
+    DOCTEST_CHECK(Dump(PatchBinary::LoadFile(jsonPath.c_str(), target)) == Dump(root));
+    target.Reset();
+    DOCTEST_CHECK(PatchBinary::LoadFile((dir.Path() / "missing.sgpatch").string().c_str(), target).IsNull());
+
+    JsonArena small(256);
+    DOCTEST_CHECK(PatchBinary::LoadFile(binaryPath.c_str(), small).IsNull());
+    DOCTEST_CHECK(small.Failed());
+}
@@ -0,0 +1,394 @@
+// recording_chunk_pool.cpp -- unit tests for RecordingChunkPool and chunked recording (private/src/RecordingChunkPool.hpp)
+//
+// Every RecordingBuffer takes fixed-size chunks from one pool as its take grows and returns them when the
+// take is dropped or persisted.  Acquire and Release are lock-free; Refill allocates within a byte budget.
+//
+// Tests:
+//   1. Refill keeps x_readyChunks free, Acquire/Release move chunks in and out, and extras are freed.
+//   2. The budget caps allocation; Acquire past it returns nullptr and counts an overflow.
+//   3. Threads acquiring and releasing concurrently never share a chunk and lose none.
+//   4. A RecordingBuffer that exhausts the pool drops its take and returns every chunk.
+//   5. A take spanning several chunks is written from the right chunk and offset, and releasing it empties
+//      the pool.
+//   6. The ready list grows by x_readyChunksPerRecorder for each recording buffer and shrinks back after.
+//   7. Nine voices keep recording for many chunks while a task holds the I/O thread busy.
+
+#include "doctest.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../support/GlobalEnv.hpp"
+#include "../support/TempDir.hpp"
+
+#include "IOTaskThread.hpp"
+#include "RecordingBuffer.hpp"
+#include "RecordingChunkPool.hpp"
+#include "TheoryOfTime.hpp"
+#include "WavReader.hpp"
+
+// ---------------------------------------------------------------------------
+// 1. Ready list
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("RecordingChunkPool: Refill keeps the ready list full and frees extras")
+{
+    GlobalEnv::ResetPerTest();
+
+    auto pool = std::make_unique<RecordingChunkPool>();
+    DOCTEST_CHECK(pool->Acquire() == nullptr);
+    DOCTEST_CHECK(pool->GetStats().m_overflowCount == 1);
+
+    pool->Refill();
+    DOCTEST_CHECK(pool->GetStats().m_numAllocated == RecordingChunkPool::x_readyChunks);
+    DOCTEST_CHECK(pool->GetStats().m_numFree == RecordingChunkPool::x_readyChunks);
+
+    RecordingChunk* a = pool->Acquire();
+    RecordingChunk* b = pool->Acquire();
+    DOCTEST_REQUIRE(a != nullptr);
+    DOCTEST_REQUIRE(b != nullptr);
+    DOCTEST_CHECK(a != b);
+    DOCTEST_CHECK(a->m_size == 0);
+    DOCTEST_CHECK(a->m_next == nullptr);
+    DOCTEST_CHECK(pool->NumInUse() == 2);
+
+    pool->Refill();
+    DOCTEST_CHECK(pool->GetStats().m_numAllocated == RecordingChunkPool::x_readyChunks + 2);
+    DOCTEST_CHECK(pool->GetStats().m_numFree == RecordingChunkPool::x_readyChunks);
+
+    // Released chunks are free again; the next Refill trims back to the ready count.
+    //
+    a->m_next = b;
+    pool->Release(a);
+    DOCTEST_CHECK(pool->NumInUse() == 0);
+    DOCTEST_CHECK(pool->GetStats().m_peakInUse == 2);
+    pool->Refill();
+    DOCTEST_CHECK(pool->GetStats().m_numAllocated == RecordingChunkPool::x_readyChunks);
+    DOCTEST_CHECK(pool->GetStats().m_numFree == RecordingChunkPool::x_readyChunks);
+}
+
+// ---------------------------------------------------------------------------
+// 2. Budget
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("RecordingChunkPool: the budget caps allocation and overflows are counted")
+{
+    GlobalEnv::ResetPerTest();
+
+    auto pool = std::make_unique<RecordingChunkPool>();
+    pool->SetBudgetBytes(3 * RecordingChunkPool::x_chunkBytes);
+    DOCTEST_CHECK(pool->BudgetBytes() == 3 * RecordingChunkPool::x_chunkBytes);
+    pool->Refill();
+    DOCTEST_CHECK(pool->GetStats().m_numAllocated == 3);
+
+    std::vector<RecordingChunk*> held;
+    for (int i = 0; i < 3; ++i)
+    {
+        held.push_back(pool->Acquire());
+        DOCTEST_REQUIRE(held.back() != nullptr);
+    }
+
+    pool->Refill();
+    DOCTEST_CHECK(pool->Acquire() == nullptr);
+    DOCTEST_CHECK(pool->Acquire() == nullptr);
+    DOCTEST_CHECK(pool->GetStats().m_overflowCount == 2);
+
+    // Lowering the budget frees chunks as they come back rather than taking them away.
+    //
+    pool->SetBudgetBytes(RecordingChunkPool::x_chunkBytes);
+    pool->Refill();
+    DOCTEST_CHECK(pool->GetStats().m_numAllocated == 3);
+    for (RecordingChunk* chunk : held)
+    {
+        pool->Release(chunk);
+    }
+
+    pool->Refill();
+    DOCTEST_CHECK(pool->GetStats().m_numAllocated == 1);
+    DOCTEST_CHECK(pool->GetStats().m_numFree == 1);
+}
+
+// ---------------------------------------------------------------------------
+// 3. Concurrency
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("RecordingChunkPool: concurrent Acquire and Release never share a chunk")
+{
+    GlobalEnv::ResetPerTest();
+
+    auto pool = std::make_unique<RecordingChunkPool>();
+    pool->Refill();
+
+    const int numThreads = 4;
+    const int iterations = 20000;
+    std::atomic<bool> shared(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            for (int i = 0; i < iterations; ++i)
+            {
+                RecordingChunk* chunk = pool->Acquire();
+                if (!chunk)
+                {
+                    continue;
+                }
+
+                // Another owner of the same chunk would overwrite the mark.
+                //
+                chunk->m_samples[0] = static_cast<float>(t);
+                chunk->m_size = 1;
+                std::this_thread::yield();
+                if (chunk->m_samples[0] != static_cast<float>(t))
+                {
+                    shared.store(true);
+                }
+
+                pool->Release(chunk);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    DOCTEST_CHECK_FALSE(shared.load());
+    DOCTEST_CHECK(pool->NumInUse() == 0);
+
+    std::set<RecordingChunk*> distinct;
+    while (RecordingChunk* chunk = pool->Pop())
+    {
+        distinct.insert(chunk);
+    }
+
+    DOCTEST_CHECK(distinct.size() == RecordingChunkPool::x_readyChunks);
+    for (RecordingChunk* chunk : distinct)
+    {
+        pool->Push(chunk->m_slot);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 4. Overflow while recording
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("RecordingChunkPool: a RecordingBuffer that runs out of chunks drops its take")
+{
+    GlobalEnv::ResetPerTest();
+
+    auto pool = std::make_unique<RecordingChunkPool>();
+    pool->SetBudgetBytes(2 * RecordingChunkPool::x_chunkBytes);
+    TheoryOfTime theoryOfTime;
+    RecordingBuffer buffer;
+    buffer.m_pool = pool.get();
+    buffer.m_theoryOfTime = &theoryOfTime;
+
+    // No chunk: StartRecording stays Idle.
+    //
+    buffer.StartRecording();
+    DOCTEST_CHECK(buffer.m_state == RecordingBuffer::State::Idle);
+
+    pool->Refill();
+    buffer.StartRecording();
+    DOCTEST_REQUIRE(buffer.m_state == RecordingBuffer::State::Recording);
+    for (size_t i = 0; i < 2 * RecordingChunk::x_numSamples; ++i)
+    {
+        buffer.Process(static_cast<float>(i));
+    }
+
+    DOCTEST_CHECK(buffer.m_state == RecordingBuffer::State::Recording);
+    DOCTEST_CHECK(buffer.NumSamples() == 2 * RecordingChunk::x_numSamples);
+    DOCTEST_CHECK(*buffer.SampleAt(RecordingChunk::x_numSamples + 5) == static_cast<float>(RecordingChunk::x_numSamples + 5));
+    DOCTEST_CHECK(pool->NumInUse() == 2);
+
+    buffer.Process(1.0f);
+    DOCTEST_CHECK(buffer.m_state == RecordingBuffer::State::Error);
+    DOCTEST_CHECK(buffer.NumSamples() == 0);
+    DOCTEST_CHECK(pool->NumInUse() == 0);
+    DOCTEST_CHECK(buffer.DetachTake().IsEmpty());
+
+    buffer.Reset();
+    buffer.StartRecording();
+    DOCTEST_CHECK(buffer.m_state == RecordingBuffer::State::Recording);
+    buffer.Reset();
+    DOCTEST_CHECK(pool->NumInUse() == 0);
+}
+
+// ---------------------------------------------------------------------------
+// 5. Writing a take
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("RecordingChunkPool: a take spanning chunks is written in order")
+{
+    GlobalEnv::ResetPerTest();
+
+    auto pool = std::make_unique<RecordingChunkPool>();
+    pool->Refill();
+
+    // Two and a bit chunks.  Start 0, stop 1 and one repeat write the take back at its own length.
+    //
+    const size_t numSamples = 2 * RecordingChunk::x_numSamples + 1000;
+    auto level = [](size_t i) { return static_cast<float>(static_cast<int>(i % 2001) - 1000) / 1024.0f; };
+    RecordingTake take;
+    take.m_pool = pool.get();
+    take.m_numSamples = numSamples;
+    take.m_loopPositionRecordingStop = 1.0;
+    take.m_recordingRepeats = 1;
+
+    RecordingChunk* tail = nullptr;
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        if (!tail || tail->m_size == RecordingChunk::x_numSamples)
+        {
+            RecordingChunk* next = pool->Acquire();
+            DOCTEST_REQUIRE(next != nullptr);
+            (tail ? tail->m_next : take.m_head) = next;
+            tail = next;
+        }
+
+        tail->m_samples[tail->m_size++] = level(i);
+    }
+
+    DOCTEST_CHECK(pool->NumInUse() == 3);
+
+    synthrig::TempDir dir;
+    DOCTEST_REQUIRE(dir.Valid());
+    std::string path = (dir.Path() / "take.wav").string();
+    DOCTEST_REQUIRE(take.WriteToFile(path.c_str()));
+
+    WavReader reader;
+    DOCTEST_REQUIRE(reader.LoadFromFile(path.c_str()));
+    DOCTEST_REQUIRE(reader.m_numFrames == numSamples);
+
+    // Within one 24-bit step of the source sample, or of the one before it where the position math rounds
+    // down: either way the sample came from the right chunk and offset.
+    //
+    bool exact = true;
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        float got = reader.GetSample(i, 0);
+        exact = exact
+            && (std::fabs(got - level(i)) < 2.0f / 8388608.0f
+                || (i > 0 && std::fabs(got - level(i - 1)) < 2.0f / 8388608.0f));
+    }
+
+    DOCTEST_CHECK(exact);
+
+    take.Release();
+    DOCTEST_CHECK(take.IsEmpty());
+    DOCTEST_CHECK(pool->NumInUse() == 0);
+}
+
+// ---------------------------------------------------------------------------
+// 6. Ready list per recorder
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("RecordingChunkPool: the ready list grows with the number of recording buffers")
+{
+    GlobalEnv::ResetPerTest();
+
+    auto pool = std::make_unique<RecordingChunkPool>();
+    pool->Refill();
+    TheoryOfTime theoryOfTime;
+    const size_t numVoices = 9;
+    std::vector<std::unique_ptr<RecordingBuffer>> buffers;
+    for (size_t i = 0; i < numVoices; ++i)
+    {
+        buffers.push_back(std::make_unique<RecordingBuffer>());
+        buffers.back()->m_pool = pool.get();
+        buffers.back()->m_theoryOfTime = &theoryOfTime;
+        buffers.back()->StartRecording();
+        DOCTEST_REQUIRE(buffers.back()->m_state == RecordingBuffer::State::Recording);
+    }
+
+    const size_t target = numVoices * RecordingChunkPool::x_readyChunksPerRecorder;
+    DOCTEST_CHECK(pool->ReadyTarget() == target);
+    pool->Refill();
+    DOCTEST_CHECK(pool->GetStats().m_numFree == target);
+
+    // Stopping, failing and resetting all stop counting a buffer.
+    //
+    buffers[0]->StopRecording();
+    DOCTEST_CHECK(buffers[0]->m_state != RecordingBuffer::State::Recording);
+    buffers[1]->Reset();
+    DOCTEST_CHECK(pool->ReadyTarget() == (numVoices - 2) * RecordingChunkPool::x_readyChunksPerRecorder);
+
+    buffers.clear();
+    DOCTEST_CHECK(pool->ReadyTarget() == RecordingChunkPool::x_readyChunks);
+    pool->Refill();
+    DOCTEST_CHECK(pool->GetStats().m_numFree == RecordingChunkPool::x_readyChunks);
+}
+
+// ---------------------------------------------------------------------------
+// 7. Busy I/O thread
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("RecordingChunkPool: recording survives an I/O thread held busy for many chunks")
+{
+    GlobalEnv::ResetPerTest();
+
+    RecordingChunkPool& pool = RecordingChunkPool::s_instance;
+    pool.SetBudgetBytes(RecordingChunkPool::x_defaultBudgetBytes);
+    IoTaskThread io;
+
+    // DeleteAudioBuffer trims the sample cache, so holding the cache's mutex blocks the I/O thread in that
+    // task until the end of the test.
+    //
+    std::unique_lock<std::mutex> cacheLock(SampleCache::s_instance.m_mutex);
+    DOCTEST_REQUIRE(io.PushDeleteAudioBuffer(nullptr));
+
+    TheoryOfTime theoryOfTime;
+    const size_t numVoices = 9;
+    std::vector<std::unique_ptr<RecordingBuffer>> buffers;
+    for (size_t i = 0; i < numVoices; ++i)
+    {
+        buffers.push_back(std::make_unique<RecordingBuffer>());
+        buffers.back()->m_theoryOfTime = &theoryOfTime;
+        buffers.back()->StartRecording();
+        DOCTEST_REQUIRE(buffers.back()->m_state == RecordingBuffer::State::Recording);
+    }
+
+    // Forty chunks per voice, far past the old ready list of sixteen, at a few tens of ms per chunk where real
+    // time would be over a second.
+    //
+    size_t overflows = pool.GetStats().m_overflowCount;
+    const int numChunks = 40;
+    for (int c = 0; c < numChunks; ++c)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        for (std::unique_ptr<RecordingBuffer>& buffer : buffers)
+        {
+            for (size_t i = 0; i < RecordingChunk::x_numSamples; ++i)
+            {
+                buffer->Process(0.5f);
+            }
+        }
+    }
+
+    for (std::unique_ptr<RecordingBuffer>& buffer : buffers)
+    {
+        DOCTEST_CHECK(buffer->m_state == RecordingBuffer::State::Recording);
+        DOCTEST_CHECK(buffer->NumSamples() == numChunks * RecordingChunk::x_numSamples);
+    }
+
+    DOCTEST_CHECK(pool.GetStats().m_overflowCount == overflows);
+
+    // The delete task is still blocked, so every chunk came from the refill thread.
+    //
+    IoTaskElement acknowledged;
+    DOCTEST_CHECK_FALSE(io.m_acknowledgmentQueue.Pop(acknowledged));
+
+    buffers.clear();
+    cacheLock.unlock();
+    io.Shutdown();
+}
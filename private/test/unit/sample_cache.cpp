@@ -0,0 +1,310 @@
+// sample_cache.cpp -- unit tests for SampleCache (private/src/AudioBuffer.hpp)
+//
+// Banks loaded through a SampleCache share one AudioBuffer per file, checked against the file's size and
+// modification time.  Unreferenced buffers stay cached within a byte budget and are evicted oldest first.
+//
+// Tests:
+//   1. Two banks on the same directory share every buffer, and the second load decodes nothing.
+//   2. A rewritten file gets a fresh buffer; the bank still holding the old one keeps it.
+//   3. Trim evicts unreferenced buffers least recently used first, down to the budget, and never a
+//      referenced one.
+//   4. Through IoTaskThread, two sinks loading one directory share buffers, and retiring the banks trims
+//      the process-wide cache.
+//   5. A streamed buffer is not shared while it is held, whether it has finished loading or not.
+
+#include "doctest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../support/GlobalEnv.hpp"
+#include "../support/TempDir.hpp"
+#include "../support/WavFile.hpp"
+
+#include "AudioBuffer.hpp"
+#include "IOTaskThread.hpp"
+
+namespace
+{
+    void WriteLevelFile(const std::filesystem::path& dir, size_t i, size_t frames, float level)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "take_%02zu.wav", i);
+        std::vector<float> samples(frames, level);
+        TestWav::WriteStereoWav((dir / name).string(), 3, 32, samples, samples);
+    }
+
+    bool WaitForSink(IoTaskThread& io, AudioBufferBank* const& sink, AudioBufferBank* previous)
+    {
+        auto start = std::chrono::steady_clock::now();
+        while (sink == previous && std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+        {
+            io.Acknowledge();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return sink != previous;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 1. Sharing
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("SampleCache: banks on the same directory share buffers")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        WriteLevelFile(dir.Path(), i, 5000 + i, 0.125f * static_cast<float>(i));
+    }
+
+    SampleCache cache;
+    WorkerPool pool(2);
+    AudioBufferBank a;
+    a.LoadFromDirectory(dir.String().c_str(), "", nullptr, &pool, &cache);
+    pool.WaitIdle();
+    DOCTEST_REQUIRE(a.m_audioBuffers.size() == 4);
+    DOCTEST_CHECK(cache.NumEntries() == 4);
+    DOCTEST_CHECK(cache.m_hitCount == 0);
+
+    AudioBufferBank b;
+    b.LoadFromDirectory(dir.String().c_str(), "", nullptr, &pool, &cache);
+    DOCTEST_REQUIRE(b.m_audioBuffers.size() == 4);
+    DOCTEST_CHECK(cache.m_hitCount == 4);
+    DOCTEST_CHECK(cache.NumEntries() == 4);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        DOCTEST_CAPTURE(i);
+        DOCTEST_CHECK(a.m_audioBuffers[i] == b.m_audioBuffers[i]);
+        DOCTEST_CHECK(b.m_audioBuffers[i]->NumFrames() == 5000 + i);
+        DOCTEST_CHECK(b.m_audioBuffers[i]->ReadRealTime(100.0) == 0.25f * static_cast<float>(i));
+    }
+
+    // Without a cache nothing is shared.
+    //
+    AudioBufferBank c;
+    c.LoadFromDirectory(dir.String().c_str(), "", nullptr);
+    DOCTEST_REQUIRE(c.m_audioBuffers.size() == 4);
+    DOCTEST_CHECK(c.m_audioBuffers[0] != a.m_audioBuffers[0]);
+    DOCTEST_CHECK(c.m_audioBuffers[0]->m_buffer == a.m_audioBuffers[0]->m_buffer);
+}
+
+// ---------------------------------------------------------------------------
+// 2. Invalidation
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("SampleCache: a rewritten file is loaded again")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    WriteLevelFile(dir.Path(), 0, 3000, 0.125f);
+
+    SampleCache cache;
+    AudioBufferBank before;
+    before.LoadFromDirectory(dir.String().c_str(), "", nullptr, nullptr, &cache);
+    DOCTEST_REQUIRE(before.m_audioBuffers.size() == 1);
+
+    WriteLevelFile(dir.Path(), 0, 4000, 0.25f);
+
+    AudioBufferBank after;
+    after.LoadFromDirectory(dir.String().c_str(), "", nullptr, nullptr, &cache);
+    DOCTEST_REQUIRE(after.m_audioBuffers.size() == 1);
+    DOCTEST_CHECK(after.m_audioBuffers[0] != before.m_audioBuffers[0]);
+    DOCTEST_CHECK(after.m_audioBuffers[0]->NumFrames() == 4000);
+    DOCTEST_CHECK(after.m_audioBuffers[0]->ReadRealTime(10.0) == 0.5f);
+    DOCTEST_CHECK(before.m_audioBuffers[0]->NumFrames() == 3000);
+    DOCTEST_CHECK(before.m_audioBuffers[0]->ReadRealTime(10.0) == 0.25f);
+    DOCTEST_CHECK(cache.NumEntries() == 1);
+}
+
+// ---------------------------------------------------------------------------
+// 3. Eviction
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("SampleCache: Trim evicts unreferenced buffers oldest first within the budget")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    std::vector<std::filesystem::path> subdirs;
+    for (size_t d = 0; d < 4; ++d)
+    {
+        subdirs.push_back(dir.Path() / ("bank" + std::to_string(d)));
+        std::filesystem::create_directories(subdirs.back());
+        WriteLevelFile(subdirs.back(), 0, 10000, 0.125f);
+    }
+
+    SampleCache cache;
+    std::vector<AudioBufferBank*> banks;
+    for (const std::filesystem::path& subdir : subdirs)
+    {
+        banks.push_back(new AudioBufferBank());
+        banks.back()->LoadFromDirectory(subdir.string().c_str(), "", nullptr, nullptr, &cache);
+    }
+
+    size_t bufferBytes = banks[0]->m_audioBuffers[0]->MemoryBytes();
+    DOCTEST_REQUIRE(bufferBytes >= 10000 * sizeof(float));
+    cache.SetBudgetBytes(2 * bufferBytes);
+
+    // Referenced buffers are kept whatever the budget.
+    //
+    cache.SetBudgetBytes(0);
+    cache.Trim();
+    DOCTEST_CHECK(cache.NumEntries() == 4);
+    cache.SetBudgetBytes(2 * bufferBytes);
+
+    // Touch bank 0 again so bank 1 is the least recently used, then release all four.
+    //
+    AudioBufferBank touch;
+    touch.LoadFromDirectory(subdirs[0].string().c_str(), "", nullptr, nullptr, &cache);
+    touch.m_audioBuffers.clear();
+    std::weak_ptr<AudioBuffer> weak[4];
+    for (size_t d = 0; d < 4; ++d)
+    {
+        weak[d] = banks[d]->m_audioBuffers[0];
+        delete banks[d];
+    }
+
+    cache.Trim();
+    DOCTEST_CHECK(cache.NumEntries() == 2);
+    DOCTEST_CHECK(cache.m_evictionCount == 2);
+    DOCTEST_CHECK(weak[1].expired());
+    DOCTEST_CHECK(weak[2].expired());
+    DOCTEST_CHECK_FALSE(weak[0].expired());
+    DOCTEST_CHECK_FALSE(weak[3].expired());
+
+    // A cached, unreferenced buffer is reused without loading.
+    //
+    size_t hits = cache.m_hitCount;
+    AudioBufferBank again;
+    again.LoadFromDirectory(subdirs[3].string().c_str(), "", nullptr, nullptr, &cache);
+    DOCTEST_CHECK(cache.m_hitCount == hits + 1);
+    DOCTEST_CHECK(again.m_audioBuffers[0] == weak[3].lock());
+}
+
+// ---------------------------------------------------------------------------
+// 4. Through IoTaskThread
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("SampleCache: IoTaskThread shares buffers between sinks and trims on delete")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    std::filesystem::create_directories(dir.Path() / "shared");
+    std::filesystem::create_directories(dir.Path() / "other");
+    for (size_t i = 0; i < 3; ++i)
+    {
+        WriteLevelFile(dir.Path() / "shared", i, 6000, 0.125f);
+    }
+
+    WriteLevelFile(dir.Path() / "other", 0, 6000, 0.125f);
+
+    IoTaskThread io;
+    io.SetSampleDirectoryRootAbsolute(dir.Path());
+    AudioBufferBank* sinkA = nullptr;
+    AudioBufferBank* sinkB = nullptr;
+    DOCTEST_REQUIRE(io.PushLoadAudioBufferBankFromDirectory("shared", &sinkA));
+    DOCTEST_REQUIRE(WaitForSink(io, sinkA, nullptr));
+    DOCTEST_REQUIRE(io.PushLoadAudioBufferBankFromDirectory("shared", &sinkB));
+    DOCTEST_REQUIRE(WaitForSink(io, sinkB, nullptr));
+
+    DOCTEST_REQUIRE(sinkA->m_audioBuffers.size() == 3);
+    DOCTEST_REQUIRE(sinkB->m_audioBuffers.size() == 3);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        DOCTEST_CHECK(sinkA->m_audioBuffers[i] == sinkB->m_audioBuffers[i]);
+    }
+
+    // Replacing both banks retires them through deferred deletion, which trims the cache.
+    //
+    std::weak_ptr<AudioBuffer> shared = sinkA->m_audioBuffers[0];
+    SampleCache::s_instance.SetBudgetBytes(0);
+    AudioBufferBank* previousA = sinkA;
+    AudioBufferBank* previousB = sinkB;
+    DOCTEST_REQUIRE(io.PushLoadAudioBufferBankFromDirectory("other", &sinkA));
+    DOCTEST_REQUIRE(WaitForSink(io, sinkA, previousA));
+    DOCTEST_REQUIRE(io.PushLoadAudioBufferBankFromDirectory("other", &sinkB));
+    DOCTEST_REQUIRE(WaitForSink(io, sinkB, previousB));
+
+    auto start = std::chrono::steady_clock::now();
+    while (!shared.expired() && std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+    {
+        io.Acknowledge();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    DOCTEST_CHECK(shared.expired());
+    DOCTEST_CHECK(sinkA->m_audioBuffers[0] == sinkB->m_audioBuffers[0]);
+
+    io.Shutdown();
+    SampleCache::s_instance.SetBudgetBytes(SampleCache::x_defaultBudgetBytes);
+    delete sinkA;
+    delete sinkB;
+}
+
+// ---------------------------------------------------------------------------
+// 5. Streamed buffers
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("SampleCache: a held streamed buffer is not shared")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    WriteLevelFile(dir.Path(), 0, AudioBuffer::x_streamMinFrames, 0.125f);
+    WriteLevelFile(dir.Path(), 1, 3000, 0.125f);
+    std::string longPath = (dir.Path() / "take_00.wav").string();
+    DOCTEST_CHECK(AudioBuffer::WouldStream(longPath.c_str()));
+    DOCTEST_CHECK_FALSE(AudioBuffer::WouldStream((dir.Path() / "take_01.wav").string().c_str()));
+
+    SampleCache cache;
+    AudioBufferBank a;
+    a.LoadFromDirectory(dir.String().c_str(), "", nullptr, nullptr, &cache);
+    DOCTEST_REQUIRE(a.m_audioBuffers.size() == 2);
+    DOCTEST_REQUIRE(a.m_audioBuffers[0]->IsStreamed());
+
+    // The second bank gets its own streamed buffer, which stays out of the cache, and shares the short one.
+    //
+    AudioBufferBank b;
+    b.LoadFromDirectory(dir.String().c_str(), "", nullptr, nullptr, &cache);
+    DOCTEST_REQUIRE(b.m_audioBuffers.size() == 2);
+    DOCTEST_CHECK(b.m_audioBuffers[0] != a.m_audioBuffers[0]);
+    DOCTEST_CHECK(b.m_audioBuffers[0]->IsStreamed());
+    DOCTEST_CHECK(b.m_audioBuffers[0]->ReadRealTime(10.0) == 0.25f);
+    DOCTEST_CHECK(b.m_audioBuffers[1] == a.m_audioBuffers[1]);
+    DOCTEST_CHECK(cache.m_unsharedCount == 1);
+    DOCTEST_CHECK(cache.m_hitCount == 1);
+    DOCTEST_CHECK(cache.NumEntries() == 2);
+
+    // Once nothing else holds the cached one, it is handed out again.
+    //
+    std::shared_ptr<AudioBuffer> cached = a.m_audioBuffers[0];
+    a.m_audioBuffers.clear();
+    cached.reset();
+    AudioBufferBank c;
+    c.LoadFromDirectory(dir.String().c_str(), "", nullptr, nullptr, &cache);
+    DOCTEST_REQUIRE(c.m_audioBuffers.size() == 2);
+    DOCTEST_CHECK(c.m_audioBuffers[0]->IsStreamed());
+    DOCTEST_CHECK(cache.m_unsharedCount == 1);
+    DOCTEST_CHECK(cache.m_hitCount == 3);
+
+    // A buffer still loading is checked against the file itself.
+    //
+    SampleCache loading;
+    bool isNew = false;
+    std::shared_ptr<AudioBuffer> first = loading.Acquire(longPath, &isNew);
+    DOCTEST_CHECK(isNew);
+    DOCTEST_REQUIRE_FALSE(first->IsLoaded());
+    std::shared_ptr<AudioBuffer> second = loading.Acquire(longPath, &isNew);
+    DOCTEST_CHECK(isNew);
+    DOCTEST_CHECK(second != first);
+    DOCTEST_CHECK(loading.m_unsharedCount == 1);
+}
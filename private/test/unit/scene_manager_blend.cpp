@@ -0,0 +1,122 @@
+// scene_manager_blend.cpp -- unit tests for scene-major scene values (private/src/SceneManager.hpp, Encoder.hpp)
+//
+// StateEncoderCell stores its values scene-major (m_values[scene][track]), and SceneManager blends the two
+// active scene rows in one pass.
+//
+// Tests:
+//   1. GetSceneValues over two rows matches the per-lane blend for every scene pair and blend, bit for bit.
+//   2. Encoder cells resolve every track from the active rows, and the saved JSON (one array of tracks per
+//      scene) round-trips the table.
+
+#include "doctest.h"
+
+#include "../support/GlobalEnv.hpp"
+
+#include "EncoderBankBank.hpp"
+#include "Json.hpp"
+
+// ---------------------------------------------------------------------------
+// 1. Row blend
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("SceneManager: row blend matches the per-lane blend")
+{
+    GlobalEnv::ResetPerTest();
+
+    const size_t numLanes = 16;
+    float values[SmartGrid::SceneManager::x_numScenes][numLanes];
+    for (size_t s = 0; s < SmartGrid::SceneManager::x_numScenes; ++s)
+    {
+        for (size_t i = 0; i < numLanes; ++i)
+        {
+            values[s][i] = static_cast<float>((s * 37 + i * 11) % 23) / 23.0f;
+        }
+    }
+
+    SmartGrid::SceneManager sceneManager;
+    const float blends[] = {0.0f, 0.1f, 0.5f, 0.77f, 1.0f};
+    for (size_t s1 = 0; s1 < SmartGrid::SceneManager::x_numScenes; ++s1)
+    {
+        for (size_t s2 = 0; s2 < SmartGrid::SceneManager::x_numScenes; ++s2)
+        {
+            for (float blend : blends)
+            {
+                sceneManager.SetScene1(s1);
+                sceneManager.SetScene2(s2);
+                sceneManager.SetBlendFactor(blend);
+
+                float output[numLanes];
+                sceneManager.GetSceneValues(values, output);
+                for (size_t i = 0; i < numLanes; ++i)
+                {
+                    float expected = values[s1][i] * (1.0f - blend) + values[s2][i] * blend;
+                    DOCTEST_CHECK(output[i] == expected);
+                    DOCTEST_CHECK(sceneManager.GetSceneValue(values, i) == expected);
+                }
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 2. Encoder cells
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("SceneManager: encoder cells blend scene rows and round-trip them through JSON")
+{
+    GlobalEnv::ResetPerTest();
+
+    const size_t numTracks = 3;
+    SmartGrid::SceneManager sceneManager;
+    EncoderBankBank bank(1, 1, 2);
+    bank.InitSceneManager(&sceneManager);
+    bank.InitMode(0, numTracks, 1);
+    bank.InitBank(0, 0, SmartGrid::Color::White);
+    bank.CreateEncoder(&sceneManager, 0, 0, 0.0f, "A", "A", SmartGrid::Color::White, 0);
+    bank.CreateEncoder(&sceneManager, 1, 0, 0.0f, "B", "B", SmartGrid::Color::White, 0);
+    SmartGrid::BankedEncoderCell* cell = bank.GetEncoder(0);
+
+    // Write scene s, track t = (s + 1) / 10 + t / 100 through the public edit path.
+    //
+    for (size_t s = 0; s < SmartGrid::SceneManager::x_numScenes; ++s)
+    {
+        sceneManager.SetScene1(s);
+        sceneManager.SetBlendFactor(0.0f);
+        for (size_t t = 0; t < numTracks; ++t)
+        {
+            bank.SetTrack(0, t);
+            cell->SetToValue(static_cast<float>(s + 1) / 10.0f + static_cast<float>(t) / 100.0f);
+        }
+    }
+
+    sceneManager.SetScene1(2);
+    sceneManager.SetScene2(5);
+    sceneManager.SetBlendFactor(0.25f);
+    cell->SetState();
+    for (size_t t = 0; t < numTracks; ++t)
+    {
+        float expected = cell->m_values[2][t] * 0.75f + cell->m_values[5][t] * 0.25f;
+        DOCTEST_CHECK(cell->m_values[2][t] == doctest::Approx(0.3f + t / 100.0f));
+        DOCTEST_CHECK(cell->m_bankedValue[t] == expected);
+        DOCTEST_CHECK(cell->GetNormalizedValueForTrack(t) == expected);
+    }
+
+    JsonArena arena(1 << 16);
+    JSON json = cell->StateEncoderCell::ToJSON(arena);
+    JSON values = json.Get("values");
+    DOCTEST_REQUIRE(values.Size() == SmartGrid::SceneManager::x_numScenes);
+    DOCTEST_CHECK(values.GetAt(4).Size() == numTracks);
+    DOCTEST_CHECK(values.GetAt(4).GetAt(1).NumberValue() == doctest::Approx(cell->m_values[4][1]));
+
+    SmartGrid::BankedEncoderCell* copy = bank.GetEncoder(1);
+    copy->StateEncoderCell::FromJSON(json);
+    for (size_t s = 0; s < SmartGrid::SceneManager::x_numScenes; ++s)
+    {
+        for (size_t t = 0; t < numTracks; ++t)
+        {
+            DOCTEST_CHECK(copy->m_values[s][t] == cell->m_values[s][t]);
+        }
+    }
+
+    DOCTEST_CHECK(copy->m_bankedValue[1] == cell->m_bankedValue[1]);
+}
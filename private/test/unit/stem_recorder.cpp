@@ -0,0 +1,209 @@
+// stem_recorder.cpp -- unit tests for the mixer's block stem recorder (private/src/StemRecorder.hpp)
+//
+// StemRecorder takes float frames on the audio thread and converts and writes whole blocks on its writer
+// thread.  Its files must be the same RF64 / 24-bit files MultichannelWavWriter writes sample by sample.
+//
+// Tests:
+//   1. A recording that ends mid-block is byte-identical to MultichannelWavWriter's, clamping included.
+//   2. Channels not written in a frame are silent, writes past the last channel are dropped, and a reopened
+//      recorder starts a fresh file.
+//   3. QuadMixerInternal records the master and stereo buses it returns.
+
+#include "doctest.h"
+
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../support/GlobalEnv.hpp"
+#include "../support/TempDir.hpp"
+
+#include "StemRecorder.hpp"
+#include "QuadMixer.hpp"
+#include "WavReader.hpp"
+
+namespace
+{
+    std::vector<char> ReadBytes(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    float TestSample(size_t frame, size_t channel)
+    {
+        // Runs past full scale on some channels to exercise clamping.
+        //
+        return 1.3f * std::sin(0.01f * static_cast<float>(frame) * static_cast<float>(channel + 1));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 1. Same file as the per-sample writer
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("StemRecorder: output matches MultichannelWavWriter byte for byte")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    DOCTEST_REQUIRE(dir.Valid());
+    std::string stemPath = (dir.Path() / "stem.wav").string();
+    std::string wavPath = (dir.Path() / "wav.wav").string();
+
+    // Two quads, a stereo pair and a mono channel.
+    //
+    const uint16_t numChannels = 11;
+    const size_t numFrames = 3 * StemRecorder::x_framesPerBlock + 37;
+
+    static StemRecorder stem;
+    static MultichannelWavWriter wav;
+    DOCTEST_REQUIRE(stem.Open(numChannels, stemPath, 48000));
+    DOCTEST_REQUIRE(wav.Open(numChannels, wavPath, 48000));
+    for (size_t frame = 0; frame < numFrames; ++frame)
+    {
+        QuadFloat a(TestSample(frame, 0), TestSample(frame, 1), TestSample(frame, 2), TestSample(frame, 3));
+        QuadFloat b(TestSample(frame, 4), TestSample(frame, 5), TestSample(frame, 6), TestSample(frame, 7));
+        StereoFloat c(TestSample(frame, 8), TestSample(frame, 9));
+        float d = TestSample(frame, 10);
+
+        stem.Write(0, a);
+        stem.Write(4, b);
+        stem.Write(8, c);
+        stem.Write(10, d);
+        stem.CommitFrame();
+
+        wav.WriteSampleIfOpen(0, a);
+        wav.WriteSampleIfOpen(4, b);
+        wav.WriteSampleIfOpen(8, c);
+        wav.WriteSampleIfOpen(10, d);
+    }
+
+    stem.Close();
+    wav.Close();
+    DOCTEST_CHECK_FALSE(stem.m_error);
+    DOCTEST_CHECK_FALSE(wav.m_error);
+    DOCTEST_CHECK(stem.m_droppedFrames == 0);
+
+    std::vector<char> stemBytes = ReadBytes(stemPath);
+    DOCTEST_CHECK(stemBytes.size() == sizeof(Rf64Header) + numFrames * numChannels * 3);
+    DOCTEST_CHECK(stemBytes == ReadBytes(wavPath));
+
+    WavReader reader;
+    DOCTEST_REQUIRE(reader.LoadFromFile(stemPath.c_str()));
+    DOCTEST_CHECK(reader.m_isRf64);
+    DOCTEST_CHECK(reader.m_numChannels == numChannels);
+    DOCTEST_CHECK(reader.m_numFrames == numFrames);
+}
+
+// ---------------------------------------------------------------------------
+// 2. Silence and reopen
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("StemRecorder: unwritten channels are silent, overruns are dropped and reopening starts over")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    DOCTEST_REQUIRE(dir.Valid());
+    static StemRecorder stem;
+
+    for (int take = 0; take < 2; ++take)
+    {
+        std::string path = (dir.Path() / ("take" + std::to_string(take) + ".wav")).string();
+        const size_t numFrames = StemRecorder::x_framesPerBlock + 10 * take;
+        DOCTEST_REQUIRE(stem.Open(4, path, 44100));
+        for (size_t frame = 0; frame < numFrames; ++frame)
+        {
+            if (frame % 2 == 0)
+            {
+                stem.Write(1, 0.5f);
+            }
+
+            // Each of these would reach past channel 3 into the next frame.
+            //
+            stem.Write(2, QuadFloat(0.75f, 0.75f, 0.75f, 0.75f));
+            stem.Write(3, StereoFloat(0.75f, 0.75f));
+            stem.Write(4, 0.75f);
+
+            stem.Write(3, -0.25f);
+            stem.CommitFrame();
+        }
+
+        stem.Close();
+        DOCTEST_CHECK_FALSE(stem.m_error);
+
+        WavReader reader;
+        DOCTEST_REQUIRE(reader.LoadFromFile(path.c_str()));
+        DOCTEST_CHECK(reader.m_sampleRate == 44100);
+        DOCTEST_REQUIRE(reader.m_numFrames == numFrames);
+        for (size_t frame = 0; frame < numFrames; ++frame)
+        {
+            DOCTEST_CHECK(reader.GetSample(frame, 0) == 0.0f);
+            DOCTEST_CHECK(reader.GetSample(frame, 1) == doctest::Approx(frame % 2 == 0 ? 0.5f : 0.0f).epsilon(1e-6));
+            DOCTEST_CHECK(reader.GetSample(frame, 2) == 0.0f);
+            DOCTEST_CHECK(reader.GetSample(frame, 3) == doctest::Approx(-0.25f).epsilon(1e-6));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 3. Mixer recording
+// ---------------------------------------------------------------------------
+//
+DOCTEST_TEST_CASE("QuadMixerInternal: the stem recording holds the master and stereo buses")
+{
+    GlobalEnv::ResetPerTest();
+
+    synthrig::TempDir dir;
+    DOCTEST_REQUIRE(dir.Valid());
+    std::string path = (dir.Path() / "mix.wav").string();
+
+    static QuadMixerInternal mixer;
+    static QuadMixerInternal::Input input;
+    const size_t numInputs = 3;
+    input.m_numInputs = numInputs;
+    for (size_t i = 0; i < numInputs; ++i)
+    {
+        input.m_gain[i].m_expParam = 0.5f;
+        input.m_x[i] = 0.25f * static_cast<float>(i);
+        input.m_y[i] = 0.5f;
+    }
+
+    DOCTEST_REQUIRE(mixer.Open(numInputs, path, 48000));
+    const size_t numFrames = 1000;
+    std::vector<QuadFloatWithStereoAndSub> outputs;
+    for (size_t frame = 0; frame < numFrames; ++frame)
+    {
+        for (size_t i = 0; i < numInputs; ++i)
+        {
+            input.m_input[i] = 0.3f * TestSample(frame, i);
+        }
+
+        outputs.push_back(mixer.Process(input));
+    }
+
+    mixer.Close();
+    DOCTEST_CHECK_FALSE(mixer.m_stemRecorder.m_error);
+
+    WavReader reader;
+    DOCTEST_REQUIRE(reader.LoadFromFile(path.c_str()));
+    DOCTEST_REQUIRE(reader.m_numChannels == (numInputs + QuadMixerInternal::x_numSends + 1) * 4 + 2);
+    DOCTEST_REQUIRE(reader.m_numFrames == numFrames);
+
+    const size_t masterChannel = 4 * (numInputs + QuadMixerInternal::x_numSends);
+    for (size_t frame = 0; frame < numFrames; ++frame)
+    {
+        for (size_t k = 0; k < 4; ++k)
+        {
+            DOCTEST_CHECK(std::abs(reader.GetSample(frame, masterChannel + k) - outputs[frame].m_output[k]) < 2.0f / 8388607);
+        }
+
+        for (size_t k = 0; k < 2; ++k)
+        {
+            DOCTEST_CHECK(std::abs(reader.GetSample(frame, masterChannel + 4 + k) - outputs[frame].m_stereoOutput[k]) < 2.0f / 8388607);
+        }
+    }
+}